@@ -0,0 +1,2531 @@
+/*
+ * Super Trunfo - Comparação de Cartas
+ *
+ * Este programa implementa um jogo simplificado de Super Trunfo com cidades brasileiras.
+ * Os três níveis do desafio são modos do mesmo executável e usam o núcleo
+ * compartilhado em supertrunfo/ (libsupertrunfo):
+ *
+ *   super trunfo novato        - compara todos os atributos de duas cartas
+ *   super trunfo aventureiro   - menu interativo com switch
+ *   super trunfo mestre        - menu com comparação de dois atributos (padrão)
+ *   super trunfo simular <baralho> <jogos> [semente] [--jogadores N] [--threads N]
+ *                              [--observar ms] [--distribuicao aleatoria|equilibrada]
+ *                              - simula partidas completas sobre um baralho
+ *   super trunfo replay <registro> [--jogo N] [--baralho arquivo]
+ *                              - recalcula estatísticas ou reproduz um jogo do log
+ *   super trunfo elo <baralho> <duelos> [semente] [--threads N] [--estrategia aleatoria|melhor]
+ *                              - classifica as cartas por rating Elo em duelos simulados
+ *   super trunfo balancear <baralho> <saida> [passos] [semente] [--threads N]
+ *                              - ajusta os atributos para equilibrar as taxas de vitória
+ *   super trunfo mesa [jogador...] [--escutar socket] [--rodadas N] [--tempo-limite s]
+ *                              - partidas simultâneas entre terminais, FIFOs, conexões e bots
+ *   super trunfo exportar <baralho> <comparacoes> [semente] [--formato jsonl|csv]
+ *                              - grava as cartas e comparações sorteadas na saída padrão
+ *   super trunfo matriz <baralho> [atributos] [--threads N]
+ *                              - pré-calcula os resultados de todos os pares e conta vitórias
+ *   super trunfo consultar <baralho> <predicado>... (ex.: estado=MG populacao>=100000)
+ *                              - cartas que satisfazem todos os predicados, via índices
+ *   super trunfo esquema <esquema> <baralho> [comparacoes] [semente]
+ *                              - baralho de outro tema (carros, animais, clubes) descrito
+ *                                por um esquema de atributos, em colunas
+ *   super trunfo semelhantes <baralho> [codigo] [k] [--threads N]
+ *                              - cidades mais parecidas com uma carta (árvore k-d) ou,
+ *                                sem código, os pares quase duplicados do baralho
+ *   super trunfo raridade <baralho> <saida> [classes] [semente] [--threads N]
+ *                              - agrupa as cartas em classes de raridade (k-means) e
+ *                                grava o baralho com a classe de cada carta
+ *   super trunfo distribuir <baralho> [maos] [distribuicoes] [semente]
+ *                              - compara mãos distribuídas ao acaso e equilibradas pela
+ *                                força das cartas
+ *   super trunfo mesas <jogadores> <por_mesa>
+ *                              - forma mesas de jogadores ("nome;rating") com ratings próximos
+ *   super trunfo varrer <baralho> [k]
+ *                              - resumo de um baralho maior que a memória, lido em blocos
+ *   super trunfo gerar <saida> <cartas> [semente] [texto|binario] [--threads N]
+ *                              - baralho sintético com distribuições realistas, para
+ *                                medir desempenho; o binário é uma foto do acervo e
+ *                                só abre nos modos do acervo, não como baralho
+ *   super trunfo ingerir <saida> <baralho>... [--threads N]
+ *                              - carrega vários baralhos em paralelo num cadastro sem
+ *                                trava global e grava as cartas, sem códigos repetidos
+ *   super trunfo classificar <baralho> <cascata> [exibir] (ex.: pib,populacao,pontos_turisticos)
+ *                              - ordena o baralho por uma cascata de desempate (radix LSD)
+ *   super trunfo regras <arquivo|padrao> <baralho> [comparacoes] [semente]
+ *                              - aplica regras da casa da comparação avançada em lotes
+ *   super trunfo compartilhar publicar|anexar|remover <nome> [baralho | codigo...]
+ *                              - baralho e índices em memória compartilhada POSIX; os
+ *                                modos aceitam "shm:<nome>" no lugar do arquivo
+ *   super trunfo acervo <arquivo> [listar|inserir|atualizar|remover|importar|exportar|
+ *                              compactar|conferir]
+ *                              - administra o acervo persistente de cartas
+ *
+ * Com --registro <arquivo>, todo duelo e toda rodada simulada são acrescentados
+ * ao log binário de partidas (ver supertrunfo/registro.h).
+ * Com --metricas <arquivo>, contadores e histogramas de latência do motor são
+ * exportados no formato texto do Prometheus ao sair e a cada SIGUSR1.
+ * Com --rastreio <arquivo.json>, as fases (carga, cálculo de atributos,
+ * simulação, saída) são gravadas como trace-event do Chrome/Perfetto.
+ * Com --acervo <arquivo>, as cartas cadastradas nos modos interativos ficam
+ * salvas entre execuções e podem ser escolhidas pelo código.
+ * Com --regras <arquivo>, a comparação avançada dos modos interativos usa as
+ * regras da casa do arquivo (ver supertrunfo/regras.h).
+ * Com --desempate <cascata> (ex.: 3,1,6), um empate nos modos interativos é
+ * desfeito pelo primeiro atributo da cascata em que as cartas diferem.
+ * Com --formato jsonl|csv, cartas e comparações saem como registros na saída
+ * padrão e o texto interativo (menus, placares) vai para a saída de erro.
+ * Com --retomada <arquivo>, simular e elo gravam pontos de retomada a cada
+ * --intervalo-retomada segundos (padrão 60) e, ao rodar de novo com os
+ * mesmos parâmetros, continuam do último ponto (ver supertrunfo/retomada.h).
+ *
+ * Atributos calculados:
+ * - Densidade populacional (população/área) - menor valor vence
+ * - PIB per capita (PIB/população) - maior valor vence
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <locale.h>  // Para suporte a acentos
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "supertrunfo/supertrunfo.h"
+
+// Maior baralho para o qual o modo elo pré-calcula a matriz (~24 MB)
+#define LIMITE_CARTAS_MATRIZ_ELO 4096
+
+// Níveis do jogo interativo
+#define NIVEL_NOVATO 1
+#define NIVEL_AVENTUREIRO 2
+#define NIVEL_MESTRE 3
+
+// Log binário opcional (--registro); nos modos interativos a carta 1 tem id 0
+static RegistroPartidas registro_partidas;
+static RegistroPartidas *registro = NULL;
+
+// Pontos de retomada opcionais das simulações e do Elo (--retomada)
+static PontoRetomada ponto_retomada;
+static PontoRetomada *retomada = NULL;
+
+// Acervo persistente opcional (--acervo)
+static Acervo acervo_cartas;
+static Acervo *acervo = NULL;
+
+// Regras da casa opcionais da comparação avançada (--regras)
+static ProgramaRegras regras_casa;
+static const ProgramaRegras *regras = NULL;
+
+// Cascata de desempate opcional dos modos interativos (--desempate)
+static Cascata cascata_desempate;
+static const Cascata *cascata = NULL;
+
+// Mãos de força equilibrada no simulador (--distribuicao equilibrada)
+static int distribuicao_equilibrada = 0;
+
+// Baralho anexado da memória compartilhada (caminho "shm:<nome>")
+static BaralhoCompartilhado compartilhado;
+
+// Grava um duelo interativo no log, se houver
+static void registrar_duelo_interativo(int atributo, int resultado) {
+    if (registro != NULL) {
+        registrar_duelo(registro, 0, 1, atributo, resultado);
+    }
+}
+
+// Desfaz o empate de uma comparação pela cascata, se houver
+static int desempatar(const Carta *c1, const Carta *c2, int resultado) {
+    if (resultado != 0 || cascata == NULL) {
+        return resultado;
+    }
+    char texto[128];
+    descrever_cascata(cascata, texto, sizeof(texto));
+    resultado = comparar_cascata(c1, c2, cascata);
+    printf("Desempate (%s): %s\n", texto,
+           resultado == 1 ? c1->nome : resultado == 2 ? c2->nome : "iguais em todos os níveis");
+    return resultado;
+}
+
+// Função para exibir as instruções de uso
+static void exibir_uso(const char *programa) {
+    fprintf(stderr, "Uso:\n");
+    fprintf(stderr, "  %s [novato|aventureiro|mestre]\n", programa);
+    fprintf(stderr, "  %s simular <baralho> <jogos> [semente] [--jogadores N]\n", programa);
+    fprintf(stderr, "  %s replay <registro> [--jogo N] [--baralho arquivo]\n", programa);
+    fprintf(stderr, "  %s elo <baralho> <duelos> [semente]\n", programa);
+    fprintf(stderr, "  %s balancear <baralho> <saida> [passos] [semente]\n", programa);
+    fprintf(stderr, "  %s mesa [-|bot|arquivo|entrada:saida]... [--baralho arquivo]\n", programa);
+    fprintf(stderr, "  %s exportar <baralho> <comparacoes> [semente]\n", programa);
+    fprintf(stderr, "  %s matriz <baralho> [atributos, ex.: 1,4,5]\n", programa);
+    fprintf(stderr, "  %s consultar <baralho> <atributo{=,<,<=,>,>=}valor>... (ex.: estado=MG)\n",
+            programa);
+    fprintf(stderr, "  %s esquema <esquema> <baralho> [comparacoes] [semente]\n", programa);
+    fprintf(stderr, "  %s semelhantes <baralho> [codigo] [k]\n", programa);
+    fprintf(stderr, "  %s raridade <baralho> <saida> [classes] [semente]\n", programa);
+    fprintf(stderr, "  %s distribuir <baralho> [maos] [distribuicoes] [semente]\n", programa);
+    fprintf(stderr, "  %s mesas <jogadores, linhas nome;rating> <por_mesa>\n", programa);
+    fprintf(stderr, "  %s varrer <baralho> [k]\n", programa);
+    fprintf(stderr, "  %s gerar <saida> <cartas> [semente] [texto|binario]\n", programa);
+    fprintf(stderr, "      (binario é uma foto do acervo: use com acervo/--acervo, não como"
+                    " baralho)\n");
+    fprintf(stderr, "  %s ingerir <saida> <baralho>...\n", programa);
+    fprintf(stderr, "  %s classificar <baralho> <cascata, ex.: 3,1,6> [exibir]\n", programa);
+    fprintf(stderr, "  %s regras <arquivo|padrao> <baralho> [comparacoes] [semente]\n", programa);
+    fprintf(stderr, "  %s compartilhar publicar <nome> <baralho> | anexar <nome> [codigo...] |"
+                    " remover <nome>\n", programa);
+    fprintf(stderr, "  %s acervo <arquivo> [listar | inserir <linha> | atualizar <linha> |\n", programa);
+    fprintf(stderr, "      remover <codigo> | importar <baralho> | exportar <baralho> | compactar |\n");
+    fprintf(stderr, "      conferir]\n");
+    fprintf(stderr, "Opções:\n");
+    fprintf(stderr, "  --registro <arquivo>  grava duelos e rodadas no log binário\n");
+    fprintf(stderr, "  --metricas <arquivo>  exporta métricas Prometheus (ao sair e com SIGUSR1)\n");
+    fprintf(stderr, "  --rastreio <arquivo>  grava o rastreio das fases (Chrome/Perfetto JSON)\n");
+    fprintf(stderr, "  --acervo <arquivo>    salva as cartas cadastradas entre execuções\n");
+    fprintf(stderr, "  --formato <nome>      texto (padrão), jsonl ou csv\n");
+    fprintf(stderr, "  --regras <arquivo>    regras da casa da comparação avançada\n");
+    fprintf(stderr, "  --desempate <lista>   cascata que desfaz empates (ex.: 3,1,6)\n");
+    fprintf(stderr, "  --threads <N>         threads dos modos paralelos (padrão: um por núcleo)\n");
+    fprintf(stderr, "  --estrategia <nome>   escolha de atributo: aleatoria (padrão) ou melhor\n");
+    fprintf(stderr, "  --jogadores <N>       simular: jogadores por partida (2 a %d, padrão: 2)\n",
+            MAXIMO_CARTAS_RODADA);
+    fprintf(stderr, "  --observar <ms>       simular: recarrega o baralho quando o arquivo muda\n");
+    fprintf(stderr, "  --distribuicao <nome> simular e replay: mãos aleatoria (padrão) ou equilibrada\n");
+    fprintf(stderr, "  --retomada <arquivo>  simular e elo: pontos de retomada, continua do último\n");
+    fprintf(stderr, "  --intervalo-retomada <s> segundos entre pontos de retomada (padrão: %.0f)\n",
+            INTERVALO_RETOMADA_PADRAO);
+    fprintf(stderr, "  --escutar <socket>    mesa: aceita jogadores num socket Unix\n");
+    fprintf(stderr, "  --rodadas <N>         mesa: rodadas por partida (padrão: %d)\n", RODADAS_PADRAO_MESA);
+    fprintf(stderr, "  --tempo-limite <s>    mesa: prazo de cada resposta (padrão: %d)\n",
+            TEMPO_LIMITE_PADRAO_MS / 1000);
+}
+
+// Escolhe uma carta salva no acervo ou cadastra uma nova (salva no acervo)
+static void obter_carta(Carta *c) {
+    if (acervo != NULL && acervo->quantidade > 0) {
+        char linha[64];
+        printf("\n%zu cartas no acervo. Código de uma delas (ENTER para cadastrar nova): ",
+               acervo->quantidade);
+        if (fgets(linha, sizeof(linha), stdin) != NULL) {
+            linha[strcspn(linha, "\r\n")] = '\0';
+            const Carta *salva = linha[0] != '\0' ? buscar_carta_acervo(acervo, linha) : NULL;
+            if (salva != NULL) {
+                *c = *salva;
+                calcular_atributos(c);
+                return;
+            }
+            if (linha[0] != '\0') {
+                printf("Carta '%s' não encontrada; cadastre uma nova.\n", linha);
+            }
+        }
+    }
+
+    ler_carta(c);
+    calcular_atributos(c);
+    if (acervo != NULL) {
+        int status = buscar_carta_acervo(acervo, c->codigo) != NULL
+                   ? atualizar_carta_acervo(acervo, c) : inserir_carta_acervo(acervo, c);
+        if (status != 0) {
+            printf("Aviso: não foi possível salvar a carta no acervo.\n");
+        } else {
+            printf("\nCarta %s salva no acervo.\n", c->codigo);
+        }
+    }
+}
+
+// Cadastra as duas cartas da partida interativa
+static void cadastrar_cartas(Carta *carta1, Carta *carta2) {
+    printf("\n====================================\n");
+    printf("    SUPER TRUNFO - CIDADES BRASILEIRAS    \n");
+    printf("====================================\n\n");
+
+    printf("=== CADASTRO DA CARTA 1 ===\n");
+    obter_carta(carta1);
+
+    printf("\nPressione ENTER para cadastrar a próxima carta...");
+    getchar();
+
+    system("cls");
+    printf("=== CADASTRO DA CARTA 2 ===\n");
+    obter_carta(carta2);
+
+    system("cls");
+    printf("=== CARTAS CADASTRADAS ===\n");
+    printf("\nCARTA 1:");
+    exibir_carta(carta1);
+    printf("\nCARTA 2:");
+    exibir_carta(carta2);
+}
+
+// Nível Novato: compara os cinco atributos principais e exibe o placar
+static int jogar_novato(void) {
+    Carta carta1, carta2;
+    int vitorias_carta1 = 0;
+    int vitorias_carta2 = 0;
+    int empates = 0;
+
+    cadastrar_cartas(&carta1, &carta2);
+
+    printf("\n=== RESULTADOS DAS COMPARACOES ===\n\n");
+
+    // Compara população, área, PIB, densidade e PIB per capita
+    for (int atributo = COMPARAR_POPULACAO; atributo <= COMPARAR_PIB_CAPITA; atributo++) {
+        exibir_comparacao(&carta1, &carta2, atributo);
+        int resultado = comparar_cartas(&carta1, &carta2, atributo);
+        registrar_duelo_interativo(atributo, resultado);
+        resultado = desempatar(&carta1, &carta2, resultado);
+        printf("%s: ", nome_atributo(atributo));
+        if (resultado == 1) printf("%s venceu!\n\n", carta1.nome);
+        else if (resultado == 2) printf("%s venceu!\n\n", carta2.nome);
+        else printf("Empate!\n\n");
+
+        if (resultado == 1) vitorias_carta1++;
+        else if (resultado == 2) vitorias_carta2++;
+        else empates++;
+    }
+
+    // Exibe o placar final
+    printf("\n====================================\n");
+    printf("          RESULTADO FINAL            \n");
+    printf("====================================\n\n");
+    printf("🏆 PLACAR:\n");
+    printf("%s: %d vitórias\n", carta1.nome, vitorias_carta1);
+    printf("%s: %d vitórias\n", carta2.nome, vitorias_carta2);
+    printf("Empates: %d\n\n", empates);
+
+    // Anuncia o vencedor geral
+    if (vitorias_carta1 > vitorias_carta2) {
+        printf("🎉 VENCEDOR GERAL: %s\n", carta1.nome);
+    } else if (vitorias_carta2 > vitorias_carta1) {
+        printf("🎉 VENCEDOR GERAL: %s\n", carta2.nome);
+    } else {
+        printf("🤝 EMPATE GERAL!\n");
+    }
+
+    printf("\nPressione ENTER para sair...");
+    getchar();
+
+    return 0;
+}
+
+// Função para exibir o menu principal
+static int exibir_menu(int nivel) {
+    int opcao;
+    printf("\n====================================\n");
+    printf("            MENU PRINCIPAL          \n");
+    printf("====================================\n");
+    printf("1. Comparar População\n");
+    printf("2. Comparar Área\n");
+    printf("3. Comparar PIB\n");
+    printf("4. Comparar Densidade Populacional\n");
+    printf("5. Comparar PIB per capita\n");
+    printf("6. Comparar Pontos Turísticos\n");
+    printf("7. Comparar Todos os Atributos\n");
+    printf("8. Comparação Avançada\n");
+    if (nivel >= NIVEL_MESTRE) {
+        printf("9. Comparar Dois Atributos\n");
+    }
+    printf("0. Sair\n");
+    printf("====================================\n");
+    printf("Escolha uma opção: ");
+    if (scanf("%d", &opcao) != 1) {
+        opcao = -1;
+    }
+    limpar_buffer();
+    return opcao;
+}
+
+// Níveis Aventureiro e Mestre: menu interativo com switch
+static int jogar_menu(int nivel) {
+    Carta carta1, carta2;
+    int opcao;
+
+    system("cls");
+    cadastrar_cartas(&carta1, &carta2);
+
+    do {
+        opcao = exibir_menu(nivel);
+        int resultado;
+
+        // Opção 9 só existe no nível Mestre
+        if (opcao == COMPARAR_DOIS_ATRIBUTOS && nivel < NIVEL_MESTRE) {
+            opcao = -1;
+        }
+
+        switch (opcao) {
+            case COMPARAR_POPULACAO:
+            case COMPARAR_AREA:
+            case COMPARAR_PIB:
+            case COMPARAR_DENSIDADE:
+            case COMPARAR_PIB_CAPITA:
+            case COMPARAR_PONTOS_TURISTICOS:
+                system("cls");
+                exibir_comparacao(&carta1, &carta2, opcao);
+                resultado = comparar_cartas(&carta1, &carta2, opcao);
+                registrar_duelo_interativo(opcao, resultado);
+                resultado = desempatar(&carta1, &carta2, resultado);
+                printf("\nRESULTADO: ");
+                if (resultado == 1) printf("%s venceu!\n", carta1.nome);
+                else if (resultado == 2) printf("%s venceu!\n", carta2.nome);
+                else printf("Empate!\n");
+                break;
+
+            case COMPARAR_TUDO:
+                system("cls");
+                printf("\n=== RESULTADOS DE TODAS AS COMPARAÇÕES ===\n\n");
+
+                int vitorias_carta1 = 0, vitorias_carta2 = 0, empates = 0;
+
+                // Compara todos os atributos
+                for (int i = 1; i <= NUM_ATRIBUTOS; i++) {
+                    exibir_comparacao(&carta1, &carta2, i);
+                    resultado = comparar_cartas(&carta1, &carta2, i);
+                    registrar_duelo_interativo(i, resultado);
+                    resultado = desempatar(&carta1, &carta2, resultado);
+                    if (resultado == 1) vitorias_carta1++;
+                    else if (resultado == 2) vitorias_carta2++;
+                    else empates++;
+                    printf("\n");
+                }
+
+                // Exibe placar final
+                printf("\n=== PLACAR FINAL ===\n");
+                printf("%s: %d vitórias\n", carta1.nome, vitorias_carta1);
+                printf("%s: %d vitórias\n", carta2.nome, vitorias_carta2);
+                printf("Empates: %d\n", empates);
+
+                if (vitorias_carta1 > vitorias_carta2)
+                    printf("\n🏆 Vencedor geral: %s!\n", carta1.nome);
+                else if (vitorias_carta2 > vitorias_carta1)
+                    printf("\n🏆 Vencedor geral: %s!\n", carta2.nome);
+                else
+                    printf("\n🤝 Empate geral!\n");
+                break;
+
+            case COMPARAR_AVANCADO:
+                system("cls");
+                exibir_resultado_avancado(&carta1, &carta2);
+                registrar_duelo_interativo(COMPARAR_AVANCADO,
+                                           regras != NULL ? aplicar_regras(regras, &carta1, &carta2)
+                                                          : comparacao_avancada(&carta1, &carta2));
+                break;
+
+            case COMPARAR_DOIS_ATRIBUTOS:
+                system("cls");
+                printf("\n=== COMPARAÇÃO COM DOIS ATRIBUTOS ===\n");
+
+                // Seleciona o primeiro atributo
+                int atrib1 = selecionar_atributo("PRIMEIRO", 0);
+
+                // Seleciona o segundo atributo (excluindo o primeiro)
+                int atrib2 = selecionar_atributo("SEGUNDO", atrib1);
+
+                // Realiza a comparação com os dois atributos
+                comparar_dois_atributos(&carta1, &carta2, atrib1, atrib2);
+                registrar_duelo_interativo(COMPARAR_DOIS_ATRIBUTOS,
+                                           resultado_dois_atributos(&carta1, &carta2, atrib1, atrib2));
+                break;
+
+            case SAIR:
+                system("cls");
+                printf("\n==================================\n");
+                printf("        OBRIGADO POR JOGAR!        \n");
+                printf("==================================\n\n");
+                break;
+
+            default:
+                printf("\nOpção inválida! Tente novamente.\n");
+        }
+
+        if (opcao != SAIR) {
+            printf("\nPressione ENTER para continuar...");
+            getchar();
+            system("cls");
+
+            // Mostra as cartas novamente
+            printf("=== CARTAS CADASTRADAS ===\n");
+            printf("\nCARTA 1:");
+            exibir_carta(&carta1);
+            printf("\nCARTA 2:");
+            exibir_carta(&carta2);
+        }
+    } while (opcao != SAIR);
+
+    return 0;
+}
+
+// Carrega o baralho do arquivo ou, com "shm:<nome>", anexa o baralho
+// publicado em memória compartilhada (somente leitura, sem cópia)
+static long abrir_baralho(Baralho *b, const char *caminho) {
+    if (strncmp(caminho, "shm:", 4) != 0) {
+        return carregar_baralho(b, caminho);
+    }
+    if (anexar_baralho_compartilhado(&compartilhado, caminho + 4) != 0) {
+        return -1;
+    }
+    visao_baralho_compartilhado(&compartilhado, b);
+    return (long)b->quantidade;
+}
+
+// Libera o baralho aberto com abrir_baralho
+static void fechar_baralho(Baralho *b) {
+    if (compartilhado.base != NULL && b->cartas == compartilhado.cartas) {
+        desanexar_baralho_compartilhado(&compartilhado);
+        iniciar_baralho(b);
+    } else {
+        liberar_baralho(b);
+    }
+}
+
+// Modo simulação: joga partidas automáticas sobre um baralho em arquivo
+static int executar_simulacao(int argc, char *argv[], int jogadores, int threads,
+                              const char *observar) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    long jogos = strtol(argv[3], NULL, 10);
+    uint64_t semente = argc > 4 ? strtoull(argv[4], NULL, 10) : 42;
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+    if (jogadores < 2 || jogadores > MAXIMO_CARTAS_RODADA
+        || baralho.quantidade < (size_t)jogadores || jogos <= 0) {
+        fprintf(stderr, "Erro: é preciso de 2 a %d jogadores, um baralho com ao menos uma carta "
+                        "por jogador e jogos > 0.\n", MAXIMO_CARTAS_RODADA);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    if (registro != NULL && jogadores != 2) {
+        fprintf(stderr, "Erro: o registro só grava partidas de dois jogadores.\n");
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    if (retomada != NULL && (registro != NULL || observar != NULL)) {
+        fprintf(stderr, "Erro: a retomada não combina com --registro nem --observar.\n");
+        fechar_baralho(&baralho);
+        return 1;
+    }
+
+    OpcoesSimulacao opcoes;
+    iniciar_opcoes_simulacao(&opcoes);
+    opcoes.jogadores = jogadores;
+    opcoes.threads = threads;
+    opcoes.registro = registro;
+    opcoes.retomada = retomada;
+
+    // Com --distribuicao equilibrada, a força das cartas guia a distribuição
+    double *forca = NULL;
+    if (distribuicao_equilibrada) {
+        forca = malloc(baralho.quantidade * sizeof(double));
+        if (observar != NULL || forca == NULL || calcular_forca_cartas(&baralho, forca) != 0) {
+            fprintf(stderr, "Erro: a distribuição equilibrada precisa de memória e de um "
+                            "baralho fixo (sem --observar).\n");
+            free(forca);
+            fechar_baralho(&baralho);
+            return 1;
+        }
+        opcoes.forca = forca;
+    }
+
+    // Com --observar, o arquivo é recarregado durante a simulação
+    RecargaBaralho recarga;
+    if (observar != NULL) {
+        if (iniciar_recarga(&recarga, caminho) != 0 || observar_recarga(&recarga, atoi(observar)) != 0) {
+            fprintf(stderr, "Erro: não foi possível observar o baralho '%s'.\n", caminho);
+            fechar_baralho(&baralho);
+            return 1;
+        }
+        opcoes.recarga = &recarga;
+    }
+
+    EstatisticasSimulacao e;
+    uint64_t inicio = relogio_ns();
+    int status = simular_partidas_opcoes(&baralho, jogos, semente, &opcoes, &e);
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+    int equilibrado = forca != NULL;
+    free(forca);
+    if (observar != NULL) {
+        printf("Versões do baralho: %llu (recargas: %llu, arquivos inválidos: %llu)\n",
+               (unsigned long long)versao_atual_recarga(&recarga),
+               (unsigned long long)atomic_load(&recarga.recargas),
+               (unsigned long long)atomic_load(&recarga.falhas));
+        encerrar_recarga(&recarga);
+    }
+    if (status != 0) {
+        fprintf(stderr, "Erro: memória insuficiente para a simulação.\n");
+        fechar_baralho(&baralho);
+        return 1;
+    }
+
+    {
+        RASTREAR_ESCOPO("formatar_saida");
+        printf("=== SIMULAÇÃO ===\n");
+        printf("Baralho: %s (%zu cartas)\n", caminho, baralho.quantidade);
+        printf("Jogos: %ld%s\n", e.jogos, equilibrado ? " (mãos equilibradas)" : "");
+        if (retomada != NULL && retomada->retomado > 0) {
+            printf("Retomada a partir do jogo %llu\n", (unsigned long long)retomada->retomado);
+        }
+        for (int p = 0; p < jogadores; p++) {
+            printf("Vitórias jogador %d: %ld\n", p + 1, e.vitorias[p]);
+        }
+        printf("Empates: %ld\n", e.empates);
+        printf("Rodadas por jogo (média): %.2f\n", (double)e.rodadas / e.jogos);
+        long rodados = e.jogos - (retomada != NULL ? (long)retomada->retomado : 0);
+        printf("Tempo: %.3f s (%.0f jogos/s)\n", segundos,
+               segundos > 0 ? rodados / segundos : 0.0);
+    }
+
+    fechar_baralho(&baralho);
+    return 0;
+}
+
+// Modo Elo: classifica as cartas do baralho por rating em duelos simulados
+static int executar_elo(int argc, char *argv[], int threads, int estrategia) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    OpcoesElo opcoes;
+    iniciar_opcoes_elo(&opcoes);
+    opcoes.duelos = strtol(argv[3], NULL, 10);
+    opcoes.semente = argc > 4 ? strtoull(argv[4], NULL, 10) : 42;
+    opcoes.threads = threads;
+    opcoes.estrategia = estrategia;
+    opcoes.retomada = retomada;
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+    AvaliacaoCarta *avaliacoes = malloc(baralho.quantidade * sizeof(AvaliacaoCarta));
+    uint32_t *ordem = malloc(baralho.quantidade * sizeof(uint32_t));
+    if (baralho.quantidade < 2 || opcoes.duelos <= 0 || avaliacoes == NULL || ordem == NULL) {
+        fprintf(stderr, "Erro: é preciso um baralho com 2 ou mais cartas e duelos > 0.\n");
+        free(avaliacoes);
+        free(ordem);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+
+    // Baralhos pequenos: cada duelo vira uma leitura na matriz de resultados
+    MatrizResultados matriz;
+    uint64_t inicio = relogio_ns();
+    if (baralho.quantidade <= LIMITE_CARTAS_MATRIZ_ELO
+        && construir_matriz_resultados(&matriz, &baralho, TODOS_ATRIBUTOS, threads) == 0) {
+        opcoes.matriz = &matriz;
+    }
+    int status = calcular_elo(&baralho, &opcoes, avaliacoes);
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+    if (status != 0) {
+        fprintf(stderr, "Erro: memória insuficiente para calcular os ratings.\n");
+    } else {
+        RASTREAR_ESCOPO("formatar_saida");
+        ordenar_por_rating(avaliacoes, baralho.quantidade, ordem);
+        printf("=== RATING ELO ===\n");
+        printf("Baralho: %s (%zu cartas)\n", caminho, baralho.quantidade);
+        printf("Duelos: %ld (estratégia %s)\n", opcoes.duelos,
+               estrategia == ESTRATEGIA_MELHOR_ATRIBUTO ? "melhor atributo" : "aleatória");
+        if (retomada != NULL && retomada->retomado > 0) {
+            printf("Retomado a partir do duelo %llu\n", (unsigned long long)retomada->retomado);
+        }
+        printf("%5s  %-10s %-2s  %-30s %8s %8s %7s\n",
+               "Pos", "Código", "UF", "Cidade", "Rating", "Jogos", "Vit.%");
+        for (size_t p = 0; p < baralho.quantidade; p++) {
+            const Carta *c = &baralho.cartas[ordem[p]];
+            const AvaliacaoCarta *a = &avaliacoes[ordem[p]];
+            printf("%5zu  %-10s %-2s  %-30s %8.1f %8ld %6.1f%%\n", p + 1, c->codigo, c->estado,
+                   c->nome, a->rating, a->jogos,
+                   a->jogos > 0 ? 100.0 * (double)a->vitorias / (double)a->jogos : 0.0);
+        }
+        printf("Tempo: %.3f s (%.0f duelos/s)\n", segundos,
+               segundos > 0 ? opcoes.duelos / segundos : 0.0);
+    }
+
+    if (opcoes.matriz != NULL) {
+        liberar_matriz_resultados(&matriz);
+    }
+    free(avaliacoes);
+    free(ordem);
+    fechar_baralho(&baralho);
+    return status == 0 ? 0 : 1;
+}
+
+// Modo balanceamento: ajusta o baralho e grava a versão equilibrada
+static int executar_balanceamento(int argc, char *argv[], int threads) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    const char *saida = argv[3];
+    OpcoesBalanceamento opcoes;
+    iniciar_opcoes_balanceamento(&opcoes);
+    if (argc > 4) {
+        opcoes.passos = strtol(argv[4], NULL, 10);
+    }
+    opcoes.semente = argc > 5 ? strtoull(argv[5], NULL, 10) : 42;
+    opcoes.threads = threads;
+
+    Baralho baralho, balanceado;
+    iniciar_baralho(&baralho);
+    iniciar_baralho(&balanceado);
+    if (carregar_baralho(&baralho, caminho) < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+    if (baralho.quantidade < 2 || opcoes.passos <= 0) {
+        fprintf(stderr, "Erro: é preciso um baralho com 2 ou mais cartas e passos > 0.\n");
+        liberar_baralho(&baralho);
+        return 1;
+    }
+
+    ResultadoBalanceamento r;
+    uint64_t inicio = relogio_ns();
+    int status = balancear_baralho(&baralho, &opcoes, &balanceado, &r);
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+    if (status != 0) {
+        fprintf(stderr, "Erro: memória insuficiente para balancear o baralho.\n");
+    } else if (salvar_baralho(&balanceado, saida) != 0) {
+        fprintf(stderr, "Erro: não foi possível gravar '%s'.\n", saida);
+        status = -1;
+    } else {
+        printf("=== BALANCEAMENTO ===\n");
+        printf("Baralho: %s (%zu cartas) -> %s\n", caminho, baralho.quantidade, saida);
+        printf("Ajuste máximo por campo: x%.2f\n", opcoes.fator_maximo);
+        printf("Desvio padrão das taxas de vitória: %.4f -> %.4f\n",
+               sqrt(r.variancia_inicial), sqrt(r.variancia_final));
+        printf("Propostas: %ld (%ld aceitas, %d cadeias)\n", r.propostas, r.aceitas,
+               opcoes.cadeias);
+        printf("Tempo: %.3f s (%.0f propostas/s)\n", segundos,
+               segundos > 0 ? r.propostas / segundos : 0.0);
+    }
+
+    liberar_baralho(&baralho);
+    liberar_baralho(&balanceado);
+    return status == 0 ? 0 : 1;
+}
+
+// Opções do modo mesa vindas da linha de comando
+typedef struct {
+    const char *baralho;
+    const char *escutar;
+    const char *rodadas;
+    const char *tempo_limite;
+} ArgumentosMesa;
+
+// Modo mesa: várias partidas simultâneas num laço de eventos
+static int executar_modo_mesa(int argc, char *argv[], const ArgumentosMesa *a) {
+    OpcoesMesa opcoes;
+    iniciar_opcoes_mesa(&opcoes);
+    opcoes.escutar = a->escutar;
+    opcoes.registro = registro;
+    if (a->rodadas != NULL) {
+        opcoes.rodadas = atoi(a->rodadas);
+    }
+    if (a->tempo_limite != NULL) {
+        opcoes.tempo_limite_ms = (int)(strtod(a->tempo_limite, NULL) * 1000);
+    }
+    if (opcoes.rodadas <= 0 || opcoes.tempo_limite_ms <= 0) {
+        fprintf(stderr, "Erro: rodadas e tempo limite devem ser positivos.\n");
+        return 1;
+    }
+
+    // Sem jogadores na linha de comando: terminal contra um bot
+    static const char *padrao[] = { "-", "bot" };
+    const char *const *jogadores = (const char *const *)&argv[2];
+    int quantidade = argc - 2;
+    if (quantidade <= 0 && a->escutar == NULL) {
+        jogadores = padrao;
+        quantidade = 2;
+    }
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    const char *caminho = a->baralho != NULL ? a->baralho : "baralhos/cidades.txt";
+    if (carregar_baralho(&baralho, caminho) > 0) {
+        opcoes.baralho = &baralho;
+    } else if (a->baralho != NULL) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+
+    int status = executar_mesa(jogadores, quantidade, &opcoes);
+    if (status != 0) {
+        fprintf(stderr, "Erro: não foi possível abrir os jogadores da mesa "
+                        "(bots precisam de um baralho).\n");
+    }
+    liberar_baralho(&baralho);
+    return status == 0 ? 0 : 1;
+}
+
+// Modo exportação: cartas e comparações sorteadas em JSON Lines ou CSV
+static int executar_exportacao(int argc, char *argv[], FormatadorSaida *f) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    long comparacoes = strtol(argv[3], NULL, 10);
+    uint64_t estado = argc > 4 ? strtoull(argv[4], NULL, 10) : 42;
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (carregar_baralho(&baralho, caminho) < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+    if (baralho.quantidade < 2 || comparacoes < 0) {
+        fprintf(stderr, "Erro: é preciso um baralho com 2 ou mais cartas e comparações >= 0.\n");
+        liberar_baralho(&baralho);
+        return 1;
+    }
+
+    uint64_t inicio = relogio_ns();
+    {
+        RASTREAR_ESCOPO("exportar");
+        uint32_t n = (uint32_t)baralho.quantidade;
+        for (uint32_t i = 0; i < n; i++) {
+            formatar_carta(f, &baralho.cartas[i]);
+        }
+        for (long k = 0; k < comparacoes; k++) {
+            uint32_t i = sortear(&estado, n);
+            uint32_t j = sortear(&estado, n - 1);
+            j += j >= i;
+            int atributo = 1 + (int)sortear(&estado, NUM_ATRIBUTOS);
+            const Carta *c1 = &baralho.cartas[i];
+            const Carta *c2 = &baralho.cartas[j];
+            formatar_comparacao(f, c1, c2, atributo, comparar_cartas(c1, c2, atributo));
+        }
+    }
+    int status = descarregar_formatador(f);
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+
+    if (status != 0) {
+        fprintf(stderr, "Erro: falha ao gravar a saída.\n");
+    } else {
+        double megabytes = (double)f->gravados / (1024.0 * 1024.0);
+        fprintf(stderr, "%zu cartas e %ld comparações em %.3f s (%.1f MB, %.1f MB/s)\n",
+                baralho.quantidade, comparacoes, segundos, megabytes,
+                segundos > 0 ? megabytes / segundos : 0.0);
+    }
+    liberar_baralho(&baralho);
+    return status == 0 ? 0 : 1;
+}
+
+// Modo matriz: resultados de todos os pares e vitórias de cada carta
+static int executar_matriz(int argc, char *argv[], int threads) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    unsigned atributos = TODOS_ATRIBUTOS;
+    if (argc > 3) {
+        atributos = 0;
+        for (const char *p = argv[3]; *p; p++) {
+            if (*p >= '1' && *p < '1' + NUM_ATRIBUTOS) {
+                atributos |= 1u << (*p - '1');
+            }
+        }
+    }
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0 || baralho.quantidade == 0 || atributos == 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s' ou atributos inválidos.\n",
+                caminho);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+
+    MatrizResultados m;
+    uint64_t inicio = relogio_ns();
+    if (construir_matriz_resultados(&m, &baralho, atributos, threads) != 0) {
+        fprintf(stderr, "Erro: memória insuficiente para a matriz.\n");
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    double construcao = (double)(relogio_ns() - inicio) / 1e9;
+
+    // Confere pares sorteados contra comparar_cartas
+    size_t n = baralho.quantidade;
+    uint64_t estado = 42;
+    long divergencias = 0;
+    for (int k = 0; k < 100000; k++) {
+        uint32_t i = sortear(&estado, (uint32_t)n);
+        uint32_t j = sortear(&estado, (uint32_t)n);
+        for (int a = 1; a <= NUM_ATRIBUTOS; a++) {
+            if ((atributos & (1u << (a - 1)))
+                && resultado_matriz(&m, a, i, j) != comparar_cartas(&baralho.cartas[i],
+                                                                    &baralho.cartas[j], a)) {
+                divergencias++;
+            }
+        }
+    }
+
+    // Vitórias de cada carta somadas nos atributos construídos
+    inicio = relogio_ns();
+    uint32_t *vitorias = malloc(n * sizeof(uint32_t));
+    uint32_t *ordem = malloc(n * sizeof(uint32_t));
+    if (vitorias == NULL || ordem == NULL) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        free(vitorias);
+        free(ordem);
+        liberar_matriz_resultados(&m);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        vitorias[i] = 0;
+        for (int a = 1; a <= NUM_ATRIBUTOS; a++) {
+            if (atributos & (1u << (a - 1))) {
+                vitorias[i] += (uint32_t)vitorias_matriz(&m, a, i);
+            }
+        }
+        ordem[i] = (uint32_t)i;
+    }
+    double contagem = (double)(relogio_ns() - inicio) / 1e9;
+
+    // Ordenação por inserção das 10 primeiras posições
+    size_t topo = n < 10 ? n : 10;
+    for (size_t p = 0; p < topo; p++) {
+        size_t melhor = p;
+        for (size_t q = p + 1; q < n; q++) {
+            if (vitorias[ordem[q]] > vitorias[ordem[melhor]]) {
+                melhor = q;
+            }
+        }
+        uint32_t t = ordem[p];
+        ordem[p] = ordem[melhor];
+        ordem[melhor] = t;
+    }
+
+    printf("=== MATRIZ DE RESULTADOS ===\n");
+    printf("Baralho: %s (%zu cartas)\n", caminho, n);
+    printf("Memória: %.1f MB\n", (double)memoria_matriz(&m) / (1024.0 * 1024.0));
+    printf("Construção: %.3f s; contagem de vitórias: %.3f s\n", construcao, contagem);
+    printf("Divergências em 100000 pares sorteados: %ld\n", divergencias);
+    printf("%5s  %-10s %-2s  %-30s %10s\n", "Pos", "Código", "UF", "Cidade", "Vitórias");
+    for (size_t p = 0; p < topo; p++) {
+        const Carta *c = &baralho.cartas[ordem[p]];
+        printf("%5zu  %-10s %-2s  %-30s %10u\n", p + 1, c->codigo, c->estado, c->nome,
+               vitorias[ordem[p]]);
+    }
+
+    free(vitorias);
+    free(ordem);
+    liberar_matriz_resultados(&m);
+    fechar_baralho(&baralho);
+    return divergencias == 0 ? 0 : 1;
+}
+
+// Grava a carta no formato de linha do baralho
+static void imprimir_linha_carta(const Carta *c) {
+    printf("%s;%s;%s;%d;%.2f;%.2f;%d\n", c->estado, c->codigo, c->nome,
+           c->populacao, c->area, c->pib, c->pontos_turisticos);
+}
+
+// Modo consulta: filtra o baralho por faixas de atributos com os índices
+static int executar_consulta(int argc, char *argv[], int threads, FormatadorSaida *f) {
+    if (argc < 4 || argc - 3 > MAXIMO_PREDICADOS) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    Predicado predicados[MAXIMO_PREDICADOS];
+    int quantidade = argc - 3;
+    for (int p = 0; p < quantidade; p++) {
+        if (interpretar_predicado(argv[3 + p], &predicados[p]) != 0) {
+            fprintf(stderr, "Erro: predicado inválido '%s'.\n", argv[3 + p]);
+            return 1;
+        }
+    }
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        return 1;
+    }
+
+    // Anexado da memória compartilhada, o índice já vem pronto
+    IndiceBaralho indice;
+    int indice_proprio = compartilhado.base == NULL;
+    uint32_t *resultado = malloc((baralho.quantidade + 1) * sizeof(uint32_t));
+    uint64_t inicio = relogio_ns();
+    if (!indice_proprio) {
+        visao_indice_compartilhado(&compartilhado, &baralho, &indice);
+    }
+    if (resultado == NULL
+        || (indice_proprio && construir_indice_baralho(&indice, &baralho, threads) != 0)) {
+        fprintf(stderr, "Erro: memória insuficiente para os índices.\n");
+        free(resultado);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    double construcao = (double)(relogio_ns() - inicio) / 1e9;
+
+    inicio = relogio_ns();
+    long total = consultar_baralho(&indice, predicados, quantidade, resultado);
+    double consulta = (double)(relogio_ns() - inicio) / 1e9;
+
+    // Varredura completa, só para comparação
+    inicio = relogio_ns();
+    long varridas = 0;
+    for (size_t i = 0; i < baralho.quantidade; i++) {
+        int aceita = 1;
+        for (int p = 0; p < quantidade && aceita; p++) {
+            aceita = carta_satisfaz(&baralho.cartas[i], &predicados[p]);
+        }
+        varridas += aceita;
+    }
+    double varredura = (double)(relogio_ns() - inicio) / 1e9;
+
+    for (long k = 0; k < total; k++) {
+        if (f != NULL) {
+            formatar_carta(f, &baralho.cartas[resultado[k]]);
+        } else {
+            imprimir_linha_carta(&baralho.cartas[resultado[k]]);
+        }
+    }
+    fprintf(stderr, "%ld de %zu cartas; índices em %.3f ms, consulta em %.3f ms "
+                    "(varredura completa: %.3f ms)\n",
+            total, baralho.quantidade, construcao * 1e3, consulta * 1e3, varredura * 1e3);
+    if (total >= 0 && total != varridas) {
+        fprintf(stderr, "Erro: a consulta achou %ld cartas e a varredura, %ld.\n", total, varridas);
+        total = -1;
+    }
+
+    if (indice_proprio) {
+        liberar_indice_baralho(&indice);
+    }
+    free(resultado);
+    fechar_baralho(&baralho);
+    return total >= 0 ? 0 : 1;
+}
+
+// Modo esquema: baralho de qualquer tema descrito por um arquivo de esquema
+static int executar_esquema(int argc, char *argv[]) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    static const char *const NOMES_CIDADES[NUM_ATRIBUTOS] = {
+        "populacao", "area", "pib", "densidade", "pib_per_capita", "pontos_turisticos",
+    };
+    const char *caminho = argv[3];
+    long comparacoes = argc > 4 ? atol(argv[4]) : 1000000;
+    uint64_t semente = argc > 5 ? strtoull(argv[5], NULL, 10) : 42;
+
+    static Esquema esquema;
+    if (carregar_esquema(&esquema, argv[2]) != 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o esquema '%s'.\n", argv[2]);
+        return 1;
+    }
+    BaralhoColunar colunas;
+    iniciar_baralho_colunar(&colunas, &esquema);
+    if (carregar_baralho_colunar(&colunas, caminho) < 0 || colunas.quantidade == 0
+        || comparacoes <= 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        liberar_baralho_colunar(&colunas);
+        return 1;
+    }
+    size_t n = colunas.quantidade;
+    int atributos = esquema.quantidade_atributos;
+
+    printf("=== ESQUEMA: %s ===\n", esquema.nome[0] ? esquema.nome : argv[2]);
+    for (int a = 0; a < atributos; a++) {
+        const AtributoEsquema *at = &esquema.atributos[a];
+        printf("%2d. %-20s %-8s %-16s %s vence\n", a + 1, at->nome,
+               at->derivado ? "derivado" : at->tipo == TIPO_INTEIRO ? "inteiro" : "real",
+               at->unidade, at->menor_vence ? "menor" : "maior");
+    }
+    printf("Baralho: %s (%zu cartas)\n", caminho, n);
+
+    // Pares e atributos sorteados antes, iguais para os dois caminhos
+    uint32_t *pares = malloc((size_t)comparacoes * 2 * sizeof(uint32_t));
+    uint8_t *escolhas = malloc((size_t)comparacoes);
+    uint32_t *vitorias = calloc(n, sizeof(uint32_t));
+    uint32_t *ordem = malloc(n * sizeof(uint32_t));
+    if (pares == NULL || escolhas == NULL || vitorias == NULL || ordem == NULL) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        free(pares);
+        free(escolhas);
+        free(vitorias);
+        free(ordem);
+        liberar_baralho_colunar(&colunas);
+        return 1;
+    }
+    uint64_t estado = semente;
+    for (long k = 0; k < comparacoes; k++) {
+        pares[2 * k] = sortear(&estado, (uint32_t)n);
+        pares[2 * k + 1] = sortear(&estado, (uint32_t)n);
+        escolhas[k] = (uint8_t)(1 + sortear(&estado, (uint32_t)atributos));
+    }
+
+    // Mesmo laço nos dois caminhos: soma dos resultados
+    long soma = 0;
+    uint64_t inicio = relogio_ns();
+    for (long k = 0; k < comparacoes; k++) {
+        soma += comparar_colunar(&colunas, pares[2 * k], pares[2 * k + 1], escolhas[k]);
+    }
+    double colunar = (double)(relogio_ns() - inicio) / 1e9;
+    printf("Comparações: %ld em %.3f s (%.1f ns cada; soma %ld)\n", comparacoes, colunar,
+           colunar * 1e9 / (double)comparacoes, soma);
+    for (long k = 0; k < comparacoes; k++) {
+        int r = comparar_colunar(&colunas, pares[2 * k], pares[2 * k + 1], escolhas[k]);
+        vitorias[pares[2 * k]] += r == 1;
+        vitorias[pares[2 * k + 1]] += r == 2;
+    }
+
+    // Baralho de cidades: confere e mede contra o caminho das structs
+    int cidades = atributos == NUM_ATRIBUTOS;
+    for (int a = 0; a < atributos && cidades; a++) {
+        cidades = strcmp(esquema.atributos[a].nome, NOMES_CIDADES[a]) == 0;
+    }
+    int status = 0;
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (cidades && carregar_baralho(&baralho, caminho) >= 0 && baralho.quantidade == n) {
+        long divergencias = 0;
+        soma = 0;
+        inicio = relogio_ns();
+        for (long k = 0; k < comparacoes; k++) {
+            int r = comparar_cartas(&baralho.cartas[pares[2 * k]],
+                                    &baralho.cartas[pares[2 * k + 1]], escolhas[k]);
+            soma += r;
+        }
+        double structs = (double)(relogio_ns() - inicio) / 1e9;
+        for (long k = 0; k < comparacoes; k++) {
+            uint32_t i = pares[2 * k];
+            uint32_t j = pares[2 * k + 1];
+            divergencias += comparar_colunar(&colunas, i, j, escolhas[k])
+                            != comparar_cartas(&baralho.cartas[i], &baralho.cartas[j], escolhas[k]);
+        }
+        printf("Caminho das structs: %.3f s (%.1f ns cada; soma %ld)\n", structs,
+               structs * 1e9 / (double)comparacoes, soma);
+        printf("Divergências: %ld\n", divergencias);
+        status = divergencias == 0 ? 0 : 1;
+    }
+    liberar_baralho(&baralho);
+
+    // Ordenação por seleção das 10 primeiras posições
+    for (size_t i = 0; i < n; i++) {
+        ordem[i] = (uint32_t)i;
+    }
+    size_t topo = n < 10 ? n : 10;
+    for (size_t p = 0; p < topo; p++) {
+        size_t melhor = p;
+        for (size_t q = p + 1; q < n; q++) {
+            if (vitorias[ordem[q]] > vitorias[ordem[melhor]]) {
+                melhor = q;
+            }
+        }
+        uint32_t t = ordem[p];
+        ordem[p] = ordem[melhor];
+        ordem[melhor] = t;
+    }
+    int nome = esquema.texto_nome >= 0 ? esquema.texto_nome : esquema.texto_codigo;
+    printf("%5s  %-10s %-30s %10s\n", "Pos", "Código", "Nome", "Vitórias");
+    for (size_t p = 0; p < topo; p++) {
+        printf("%5zu  %-10s %-30s %10u\n", p + 1,
+               texto_colunar(&colunas, esquema.texto_codigo, ordem[p]),
+               texto_colunar(&colunas, nome, ordem[p]), vitorias[ordem[p]]);
+    }
+
+    free(pares);
+    free(escolhas);
+    free(vitorias);
+    free(ordem);
+    liberar_baralho_colunar(&colunas);
+    return status;
+}
+
+// Modo compartilhar: publica, anexa ou remove o baralho em memória compartilhada
+static int executar_compartilhamento(int argc, char *argv[], int threads) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *comando = argv[2];
+    const char *nome = argv[3];
+
+    if (strcmp(comando, "publicar") == 0 && argc > 4) {
+        Baralho baralho;
+        iniciar_baralho(&baralho);
+        if (carregar_baralho(&baralho, argv[4]) < 0) {
+            fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", argv[4]);
+            return 1;
+        }
+        uint64_t inicio = relogio_ns();
+        long tamanho = publicar_baralho_compartilhado(nome, &baralho, threads);
+        double segundos = (double)(relogio_ns() - inicio) / 1e9;
+        liberar_baralho(&baralho);
+        if (tamanho < 0) {
+            fprintf(stderr, "Erro: não foi possível publicar o segmento '%s'.\n", nome);
+            return 1;
+        }
+        printf("Publicado: %s (%.1f MB, cartas e índices) em %.3f s\n", nome,
+               (double)tamanho / (1024.0 * 1024.0), segundos);
+        printf("Use \"shm:%s\" no lugar do arquivo do baralho.\n", nome);
+        return 0;
+    }
+    if (strcmp(comando, "remover") == 0) {
+        if (remover_baralho_compartilhado(nome) != 0) {
+            fprintf(stderr, "Erro: o segmento '%s' não existe.\n", nome);
+            return 1;
+        }
+        return 0;
+    }
+    if (strcmp(comando, "anexar") != 0) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    // Anexa e, com códigos, procura cada um pelo hash do segmento
+    BaralhoCompartilhado c;
+    uint64_t inicio = relogio_ns();
+    if (anexar_baralho_compartilhado(&c, nome) != 0) {
+        fprintf(stderr, "Erro: o segmento '%s' não existe ou não é deste build.\n", nome);
+        return 1;
+    }
+    double anexacao = (double)(relogio_ns() - inicio) / 1e9;
+    printf("Anexado: %s (%zu cartas, %.1f MB) em %.1f µs\n", nome, c.quantidade,
+           (double)c.tamanho / (1024.0 * 1024.0), anexacao * 1e6);
+    int status = 0;
+    for (int i = 4; i < argc; i++) {
+        const Carta *carta = buscar_carta_compartilhada(&c, argv[i]);
+        if (carta != NULL) {
+            imprimir_linha_carta(carta);
+        } else {
+            fprintf(stderr, "Carta '%s' não encontrada.\n", argv[i]);
+            status = 1;
+        }
+    }
+    desanexar_baralho_compartilhado(&c);
+    return status;
+}
+
+// Modo regras: compila as regras da casa e as aplica em lotes a pares sorteados
+static int executar_regras(int argc, char *argv[]) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *origem = argv[2];
+    const char *caminho = argv[3];
+    long comparacoes = argc > 4 ? atol(argv[4]) : 1000000;
+    uint64_t semente = argc > 5 ? strtoull(argv[5], NULL, 10) : 42;
+
+    // "padrao" = as regras fixas de comparacao_avancada
+    static ProgramaRegras programa;
+    int padrao = strcmp(origem, "padrao") == 0;
+    if ((padrao ? compilar_regras(&programa, REGRAS_AVANCADAS_PADRAO, origem)
+                : carregar_regras(&programa, origem)) != 0) {
+        fprintf(stderr, "Erro: não foi possível carregar as regras '%s'.\n", origem);
+        return 1;
+    }
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0 || baralho.quantidade == 0 || comparacoes <= 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    size_t n = baralho.quantidade;
+
+    printf("=== REGRAS: %s ===\n", origem);
+    for (int k = 0; k < programa.quantidade_regras; k++) {
+        printf("%2d. %s\n", k + 1, programa.nomes[k]);
+    }
+    printf("Programa: %d instruções, %d registradores\n", programa.instrucoes, programa.registros);
+    printf("Baralho: %s (%zu cartas)\n", caminho, n);
+
+    uint32_t *pares = malloc((size_t)comparacoes * 2 * sizeof(uint32_t));
+    uint8_t *resultados = malloc((size_t)comparacoes);
+    if (pares == NULL || resultados == NULL) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        free(pares);
+        free(resultados);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    uint64_t estado = semente;
+    for (long k = 0; k < 2 * comparacoes; k++) {
+        pares[k] = sortear(&estado, (uint32_t)n);
+    }
+
+    uint64_t inicio = relogio_ns();
+    aplicar_regras_lote(&programa, &baralho, pares, (size_t)comparacoes, resultados);
+    double lote = (double)(relogio_ns() - inicio) / 1e9;
+    long contagem[3] = { 0, 0, 0 };
+    for (long k = 0; k < comparacoes; k++) {
+        contagem[resultados[k]]++;
+    }
+    printf("Regras em lote: %ld comparações em %.3f s (%.1f ns cada)\n", comparacoes, lote,
+           lote * 1e9 / (double)comparacoes);
+    printf("Carta 1 vence: %ld | Carta 2 vence: %ld | Empates: %ld\n", contagem[1], contagem[2],
+           contagem[0]);
+
+    // Referência: as regras fixas escritas em C, sobre os mesmos pares
+    long divergencias = 0;
+    long soma = 0;
+    inicio = relogio_ns();
+    for (long k = 0; k < comparacoes; k++) {
+        soma += comparacao_avancada(&baralho.cartas[pares[2 * k]], &baralho.cartas[pares[2 * k + 1]]);
+    }
+    double fixas = (double)(relogio_ns() - inicio) / 1e9;
+    printf("comparacao_avancada: %.3f s (%.1f ns cada; soma %ld); regras/C = %.2f\n", fixas,
+           fixas * 1e9 / (double)comparacoes, soma, fixas > 0 ? lote / fixas : 0.0);
+    int status = 0;
+    if (padrao) {
+        for (long k = 0; k < comparacoes; k++) {
+            divergencias += resultados[k] != comparacao_avancada(&baralho.cartas[pares[2 * k]],
+                                                                &baralho.cartas[pares[2 * k + 1]]);
+        }
+        printf("Divergências: %ld\n", divergencias);
+        status = divergencias == 0 ? 0 : 1;
+    }
+
+    free(pares);
+    free(resultados);
+    fechar_baralho(&baralho);
+    return status;
+}
+
+// Baralho e cascata da conferência com qsort
+static const Baralho *baralho_conferencia;
+static const Cascata *cascata_conferencia;
+
+// Ordem da conferência: melhor na cascata primeiro, empates pela posição
+static int comparar_conferencia(const void *a, const void *b) {
+    uint32_t i = *(const uint32_t *)a;
+    uint32_t j = *(const uint32_t *)b;
+    int r = comparar_cascata(&baralho_conferencia->cartas[i], &baralho_conferencia->cartas[j],
+                             cascata_conferencia);
+    return r == 1 ? -1 : r == 2 ? 1 : (i > j) - (i < j);
+}
+
+// Modo classificar: ordena o baralho inteiro por uma cascata de atributos
+static int executar_classificacao(int argc, char *argv[]) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    size_t exibir = argc > 4 ? (size_t)atol(argv[4]) : 10;
+    Cascata k;
+    if (interpretar_cascata(&k, argv[3]) != 0) {
+        fprintf(stderr, "Erro: cascata inválida '%s' (até %d atributos distintos).\n", argv[3],
+                MAXIMO_NIVEIS_CASCATA);
+        return 1;
+    }
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0 || baralho.quantidade == 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    size_t n = baralho.quantidade;
+    uint32_t *ordem = malloc(n * sizeof(uint32_t));
+    uint32_t *conferencia = malloc(n * sizeof(uint32_t));
+    if (ordem == NULL || conferencia == NULL || classificar_cascata(&baralho, &k, ordem) != 0) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        free(ordem);
+        free(conferencia);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+
+    // Mede de novo com as páginas já tocadas
+    uint64_t inicio = relogio_ns();
+    classificar_cascata(&baralho, &k, ordem);
+    double radix = (double)(relogio_ns() - inicio) / 1e9;
+
+    // Conferência: qsort com a comparação carta a carta
+    for (size_t i = 0; i < n; i++) {
+        conferencia[i] = (uint32_t)i;
+    }
+    baralho_conferencia = &baralho;
+    cascata_conferencia = &k;
+    inicio = relogio_ns();
+    qsort(conferencia, n, sizeof(uint32_t), comparar_conferencia);
+    double ordenacao = (double)(relogio_ns() - inicio) / 1e9;
+    size_t divergencias = 0;
+    for (size_t i = 0; i < n; i++) {
+        divergencias += ordem[i] != conferencia[i];
+    }
+
+    char texto[128];
+    descrever_cascata(&k, texto, sizeof(texto));
+    printf("=== CLASSIFICAÇÃO ===\n");
+    printf("Baralho: %s (%zu cartas)\n", caminho, n);
+    printf("Cascata: %s (chave de %d bits)\n", texto, k.niveis <= 2 ? 64 : 128);
+    printf("%5s  %-10s %-2s  %-30s", "Pos", "Código", "UF", "Cidade");
+    for (int nivel = 0; nivel < k.niveis; nivel++) {
+        printf(" %16.16s", nome_atributo(k.atributos[nivel]));
+    }
+    printf("\n");
+    for (size_t p = 0; p < n && p < exibir; p++) {
+        const Carta *c = &baralho.cartas[ordem[p]];
+        printf("%5zu  %-10s %-2s  %-30s", p + 1, c->codigo, c->estado, c->nome);
+        for (int nivel = 0; nivel < k.niveis; nivel++) {
+            printf(" %16.2f", obter_valor_atributo(c, k.atributos[nivel]));
+        }
+        printf("\n");
+    }
+    printf("Radix LSD: %.3f s | qsort: %.3f s | divergências: %zu\n", radix, ordenacao,
+           divergencias);
+
+    free(ordem);
+    free(conferencia);
+    fechar_baralho(&baralho);
+    return divergencias == 0 ? 0 : 1;
+}
+
+// Modo semelhantes: cidades mais parecidas com uma carta, ou os pares quase
+// duplicados do baralho inteiro
+static int executar_semelhantes(int argc, char *argv[], int threads) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    const char *codigo = argc > 3 ? argv[3] : NULL;
+    int k = argc > 4 ? atoi(argv[4]) : 10;
+    if (k < 1 || k > MAXIMO_VIZINHOS) {
+        fprintf(stderr, "Erro: k deve estar entre 1 e %d.\n", MAXIMO_VIZINHOS);
+        return 1;
+    }
+    Baralho baralho;
+    ArvoreVizinhos arvore;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0 || baralho.quantidade < 2) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    size_t n = baralho.quantidade;
+    uint64_t inicio = relogio_ns();
+    if (construir_arvore_vizinhos(&arvore, &baralho) != 0) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    double construcao = (double)(relogio_ns() - inicio) / 1e6;
+    printf("=== CIDADES SEMELHANTES ===\n");
+    printf("Baralho: %s (%zu cartas), árvore em %.2f ms\n", caminho, n, construcao);
+
+    int status = 0;
+    if (codigo != NULL) {
+        // k vizinhos de uma carta, pela árvore e pela varredura
+        size_t alvo = n;
+        for (size_t i = 0; i < n && alvo == n; i++) {
+            if (strcmp(baralho.cartas[i].codigo, codigo) == 0) {
+                alvo = i;
+            }
+        }
+        if (alvo == n) {
+            fprintf(stderr, "Erro: carta '%s' não encontrada.\n", codigo);
+            liberar_arvore_vizinhos(&arvore);
+            fechar_baralho(&baralho);
+            return 1;
+        }
+        float ponto[DIMENSOES_VIZINHOS];
+        Vizinho vizinhos[MAXIMO_VIZINHOS];
+        Vizinho conferencia[MAXIMO_VIZINHOS];
+        projetar_carta(&arvore.espaco, &baralho.cartas[alvo], ponto);
+        int achados = 0;
+        int repeticoes = 1000;
+        inicio = relogio_ns();
+        for (int r = 0; r < repeticoes; r++) {
+            achados = buscar_vizinhos(&arvore, ponto, k, (uint32_t)alvo, vizinhos);
+        }
+        double arvore_us = (double)(relogio_ns() - inicio) / 1e3 / repeticoes;
+        inicio = relogio_ns();
+        for (int r = 0; r < repeticoes; r++) {
+            buscar_vizinhos_linear(&arvore, ponto, k, (uint32_t)alvo, conferencia);
+        }
+        double linear_us = (double)(relogio_ns() - inicio) / 1e3 / repeticoes;
+
+        const Carta *c = &baralho.cartas[alvo];
+        printf("Carta: %s - %s (%s)\n", c->codigo, c->nome, c->estado);
+        printf("%5s  %-10s %-2s  %-30s %10s\n", "Pos", "Código", "UF", "Cidade", "Distância");
+        for (int v = 0; v < achados; v++) {
+            const Carta *s = &baralho.cartas[vizinhos[v].carta];
+            printf("%5d  %-10s %-2s  %-30s %10.4f\n", v + 1, s->codigo, s->estado, s->nome,
+                   vizinhos[v].distancia);
+            status |= vizinhos[v].distancia != conferencia[v].distancia;
+        }
+        printf("Consulta: %.2f us pela árvore, %.2f us por varredura%s\n", arvore_us, linear_us,
+               status ? " (DIVERGENTE)" : "");
+    } else {
+        // Vizinho mais próximo de cada carta, em paralelo: pares quase duplicados
+        float *pontos = malloc(n * DIMENSOES_VIZINHOS * sizeof(float));
+        uint32_t *ignorar = malloc(n * sizeof(uint32_t));
+        Vizinho *vizinhos = malloc(n * sizeof(Vizinho));
+        uint32_t *ordem = malloc(n * sizeof(uint32_t));
+        if (pontos == NULL || ignorar == NULL || vizinhos == NULL || ordem == NULL) {
+            fprintf(stderr, "Erro: memória insuficiente.\n");
+            status = 1;
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                projetar_carta(&arvore.espaco, &baralho.cartas[i], pontos + i * DIMENSOES_VIZINHOS);
+                ignorar[i] = (uint32_t)i;
+                ordem[i] = (uint32_t)i;
+            }
+            inicio = relogio_ns();
+            buscar_vizinhos_lote(&arvore, pontos, n, 1, ignorar, vizinhos, NULL, threads);
+            double lote = (double)(relogio_ns() - inicio) / 1e9;
+
+            // Seleção dos pares mais próximos (cada par aparece uma vez)
+            size_t exibir = 0;
+            printf("%-10s %-30s %-10s %-30s %10s\n", "Código", "Cidade", "Código", "Cidade",
+                   "Distância");
+            for (size_t p = 0; p < n && exibir < 10; p++) {
+                size_t melhor = p;
+                for (size_t q = p + 1; q < n; q++) {
+                    if (vizinhos[ordem[q]].distancia < vizinhos[ordem[melhor]].distancia) {
+                        melhor = q;
+                    }
+                }
+                uint32_t t = ordem[p];
+                ordem[p] = ordem[melhor];
+                ordem[melhor] = t;
+                uint32_t i = ordem[p];
+                uint32_t j = vizinhos[i].carta;
+                if (vizinhos[j].carta == i && j < i) {
+                    continue;  // Par já exibido pelo outro lado
+                }
+                printf("%-10s %-30s %-10s %-30s %10.4f\n", baralho.cartas[i].codigo,
+                       baralho.cartas[i].nome, baralho.cartas[j].codigo, baralho.cartas[j].nome,
+                       vizinhos[i].distancia);
+                exibir++;
+            }
+            printf("Vizinho mais próximo das %zu cartas: %.3f s (%.2f us por consulta)\n", n, lote,
+                   lote * 1e6 / (double)n);
+        }
+        free(pontos);
+        free(ignorar);
+        free(vizinhos);
+        free(ordem);
+    }
+
+    liberar_arvore_vizinhos(&arvore);
+    fechar_baralho(&baralho);
+    return status;
+}
+
+// Modo raridade: agrupa as cartas em classes de raridade e grava o baralho
+// com a classe de cada carta
+static int executar_raridade(int argc, char *argv[], int threads) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    const char *saida = argv[3];
+    OpcoesRaridade opcoes;
+    iniciar_opcoes_raridade(&opcoes);
+    if (argc > 4) {
+        opcoes.classes = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        opcoes.semente = strtoull(argv[5], NULL, 10);
+    }
+    opcoes.threads = threads;
+    if (opcoes.classes < 2 || opcoes.classes > MAXIMO_RARIDADES) {
+        fprintf(stderr, "Erro: o número de classes deve estar entre 2 e %d.\n", MAXIMO_RARIDADES);
+        return 1;
+    }
+
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    if (abrir_baralho(&baralho, caminho) < 0 || baralho.quantidade < (size_t)opcoes.classes) {
+        fprintf(stderr, "Erro: é preciso um baralho com pelo menos %d cartas em '%s'.\n",
+                opcoes.classes, caminho);
+        fechar_baralho(&baralho);
+        return 1;
+    }
+    uint8_t *raridades = malloc(baralho.quantidade);
+    ResultadoRaridade r;
+    uint64_t inicio = relogio_ns();
+    int status = raridades != NULL ? classificar_raridade(&baralho, &opcoes, raridades, &r) : -1;
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+    if (status != 0) {
+        fprintf(stderr, "Erro: memória insuficiente para agrupar o baralho.\n");
+    } else if (salvar_baralho_raridade(&baralho, raridades, opcoes.classes, saida) != 0) {
+        fprintf(stderr, "Erro: não foi possível gravar '%s'.\n", saida);
+        status = -1;
+    } else {
+        // Médias de cada classe e uma carta de exemplo
+        double populacao[MAXIMO_RARIDADES] = { 0 };
+        double pib_per_capita[MAXIMO_RARIDADES] = { 0 };
+        size_t exemplo[MAXIMO_RARIDADES];
+        for (int t = 0; t < opcoes.classes; t++) {
+            exemplo[t] = baralho.quantidade;
+        }
+        for (size_t i = 0; i < baralho.quantidade; i++) {
+            const Carta *c = &baralho.cartas[i];
+            int t = raridades[i];
+            populacao[t] += c->populacao;
+            pib_per_capita[t] += c->pib_per_capita;
+            exemplo[t] = exemplo[t] == baralho.quantidade ? i : exemplo[t];
+        }
+
+        printf("=== RARIDADE ===\n");
+        printf("Baralho: %s (%zu cartas) -> %s\n", caminho, baralho.quantidade, saida);
+        printf("%-14s %10s %7s %16s %16s  %s\n", "Classe", "Cartas", "%", "População média",
+               "PIB per capita", "Exemplo");
+        for (int t = 0; t < opcoes.classes; t++) {
+            double tamanho = (double)r.tamanhos[t];
+            printf("%-14s %10zu %6.2f%% %16.0f %16.2f  %s\n", nome_raridade(t, opcoes.classes),
+                   r.tamanhos[t], 100.0 * tamanho / (double)baralho.quantidade,
+                   tamanho > 0 ? populacao[t] / tamanho : 0.0,
+                   tamanho > 0 ? pib_per_capita[t] / tamanho : 0.0,
+                   exemplo[t] < baralho.quantidade ? baralho.cartas[exemplo[t]].nome : "-");
+        }
+        printf("Iterações: %d, inércia: %.1f\n", r.iteracoes, r.inercia);
+        printf("Tempo: %.3f s\n", segundos);
+    }
+
+    free(raridades);
+    fechar_baralho(&baralho);
+    return status == 0 ? 0 : 1;
+}
+
+// Modo distribuir: compara a distribuição aleatória das mãos com a
+// equilibrada, nos mesmos embaralhamentos do simulador
+static int executar_distribuicao(int argc, char *argv[]) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    int maos = argc > 3 ? atoi(argv[3]) : 2;
+    long distribuicoes = argc > 4 ? strtol(argv[4], NULL, 10) : 10000;
+    uint64_t semente = argc > 5 ? strtoull(argv[5], NULL, 10) : 42;
+
+    // Toda saída depois de abrir o baralho passa pela liberação do fim
+    Baralho baralho;
+    iniciar_baralho(&baralho);
+    double *forca = NULL;
+    uint32_t *cartas = NULL;
+    uint32_t *trabalho = NULL;
+    int status = 0;
+    long lidas = abrir_baralho(&baralho, caminho);
+    size_t n = baralho.quantidade;
+    if (lidas < 0) {
+        fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho);
+        status = 1;
+    } else if (maos < 2 || maos > MAXIMO_MAOS || n < (size_t)maos || distribuicoes <= 0) {
+        fprintf(stderr, "Erro: é preciso de 2 a %d mãos, um baralho com ao menos uma carta "
+                        "por mão e distribuições > 0.\n", MAXIMO_MAOS);
+        status = 1;
+    } else {
+        forca = malloc(n * sizeof(double));
+        cartas = malloc(n * sizeof(uint32_t));
+        trabalho = malloc((n + n / (size_t)maos) * sizeof(uint32_t));
+        if (forca == NULL || cartas == NULL || trabalho == NULL) {
+            fprintf(stderr, "Erro: memória insuficiente.\n");
+            status = 1;
+        }
+    }
+    uint64_t inicio = relogio_ns();
+    if (status == 0 && calcular_forca_cartas(&baralho, forca) != 0) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        status = 1;
+    }
+    double calculo = (double)(relogio_ns() - inicio) / 1e6;
+    if (status != 0) {
+        free(forca);
+        free(cartas);
+        free(trabalho);
+        fechar_baralho(&baralho);
+        return status;
+    }
+
+    // Diferença entre a mão mais forte e a mais fraca, nas duas distribuições
+    size_t m = n / (size_t)maos;
+    double soma_aleatoria = 0.0, maior_aleatoria = 0.0;
+    double soma_equilibrada = 0.0, maior_equilibrada = 0.0;
+    double total_maos = 0.0;
+    uint64_t tempo = 0;
+    for (long d = 0; d < distribuicoes; d++) {
+        FluxoAleatorio f;
+        iniciar_fluxo(&f, semente, (uint64_t)d, 0);
+        embaralhar_fluxo(&f, cartas, n);
+        double totais[MAXIMO_MAOS] = { 0 };
+        for (size_t c = 0; c < m * (size_t)maos; c++) {
+            totais[c % (size_t)maos] += forca[cartas[c]];
+        }
+        double maior = totais[0], menor = totais[0];
+        for (int h = 0; h < maos; h++) {
+            maior = totais[h] > maior ? totais[h] : maior;
+            menor = totais[h] < menor ? totais[h] : menor;
+            total_maos += totais[h];
+        }
+        soma_aleatoria += maior - menor;
+        maior_aleatoria = maior - menor > maior_aleatoria ? maior - menor : maior_aleatoria;
+
+        uint64_t antes = relogio_ns();
+        double diferenca = distribuir_equilibrado(forca, cartas, n, maos, trabalho, NULL);
+        tempo += relogio_ns() - antes;
+        soma_equilibrada += diferenca;
+        maior_equilibrada = diferenca > maior_equilibrada ? diferenca : maior_equilibrada;
+    }
+
+    // Diferenças em porcentagem da mão média
+    double media_mao = total_maos / ((double)distribuicoes * maos) / 100.0;
+    printf("=== DISTRIBUIÇÃO DAS MÃOS ===\n");
+    printf("Baralho: %s (%zu cartas), %d mãos de %zu cartas\n", caminho, n, maos, m);
+    printf("Força das cartas: %.3f ms\n", calculo);
+    printf("%-14s %18s %18s\n", "Distribuição", "Diferença média", "Diferença máxima");
+    printf("%-14s %17.3f%% %17.3f%%\n", "aleatória", soma_aleatoria / distribuicoes / media_mao,
+           maior_aleatoria / media_mao);
+    printf("%-14s %17.3f%% %17.3f%%\n", "equilibrada",
+           soma_equilibrada / distribuicoes / media_mao, maior_equilibrada / media_mao);
+    printf("Distribuições: %ld (%.2f us cada)\n", distribuicoes,
+           (double)tempo / 1e3 / (double)distribuicoes);
+
+    free(forca);
+    free(cartas);
+    free(trabalho);
+    fechar_baralho(&baralho);
+    return 0;
+}
+
+// Modo mesas: forma mesas de jogadores com ratings próximos; o arquivo tem
+// uma linha "nome;rating" por jogador
+static int executar_mesas(int argc, char *argv[]) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    int por_mesa = atoi(argv[3]);
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL || por_mesa < 2) {
+        fprintf(stderr, "Erro: não foi possível ler '%s' ou mesas com menos de 2 jogadores.\n",
+                caminho);
+        if (arquivo != NULL) {
+            fclose(arquivo);
+        }
+        return 1;
+    }
+
+    typedef char NomeJogador[50];
+    NomeJogador *nomes = NULL;
+    double *ratings = NULL;
+    size_t jogadores = 0, capacidade = 0;
+    char linha[256];
+    long numero_linha = 0;
+    int status = 0;
+    while (status == 0 && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        if (linha[0] == '#' || linha[0] == '\n' || linha[0] == '\r') {
+            continue;
+        }
+        // Nome de 1 a 49 caracteres e rating numérico, só com espaços depois
+        char *separador = strchr(linha, ';');
+        char *fim = separador;
+        double rating = separador != NULL ? strtod(separador + 1, &fim) : 0.0;
+        int convertido = separador != NULL && fim != separador + 1;
+        while (convertido && isspace((unsigned char)*fim)) {
+            fim++;
+        }
+        if (!convertido || separador == linha || separador - linha >= 50 || *fim != '\0'
+            || !isfinite(rating)) {
+            fprintf(stderr, "%s:%ld: linha de jogador inválida, ignorada\n", caminho, numero_linha);
+            continue;
+        }
+        if (jogadores == capacidade) {
+            capacidade = capacidade ? capacidade * 2 : 64;
+            NomeJogador *novos_nomes = realloc(nomes, capacidade * sizeof(NomeJogador));
+            nomes = novos_nomes != NULL ? novos_nomes : nomes;
+            double *novos_ratings = realloc(ratings, capacidade * sizeof(double));
+            ratings = novos_ratings != NULL ? novos_ratings : ratings;
+            status = novos_nomes != NULL && novos_ratings != NULL ? 0 : -1;
+            if (status != 0) {
+                break;
+            }
+        }
+        memcpy(nomes[jogadores], linha, (size_t)(separador - linha));
+        nomes[jogadores][separador - linha] = '\0';
+        ratings[jogadores] = rating;
+        jogadores++;
+    }
+    fclose(arquivo);
+
+    uint32_t *ordem = malloc((jogadores + 1) * sizeof(uint32_t));
+    size_t *inicios = malloc((jogadores + 1) * sizeof(size_t));
+    if (status != 0 || ordem == NULL || inicios == NULL) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        status = -1;
+    } else {
+        size_t mesas = formar_mesas(ratings, jogadores, por_mesa, ordem, inicios);
+        printf("=== MESAS ===\n");
+        printf("Jogadores: %zu, mesas: %zu (até %d por mesa)\n", jogadores, mesas, por_mesa);
+        double maior_diferenca = 0.0;
+        for (size_t t = 0; t < mesas; t++) {
+            double diferenca = ratings[ordem[inicios[t]]] - ratings[ordem[inicios[t + 1] - 1]];
+            maior_diferenca = diferenca > maior_diferenca ? diferenca : maior_diferenca;
+            printf("Mesa %zu (diferença %.0f):", t + 1, diferenca);
+            for (size_t i = inicios[t]; i < inicios[t + 1]; i++) {
+                printf(" %s (%.0f)%s", nomes[ordem[i]], ratings[ordem[i]],
+                       i + 1 < inicios[t + 1] ? "," : "\n");
+            }
+        }
+
+        // Referência: as mesmas mesas por ordem de chegada
+        double maior_chegada = 0.0;
+        for (size_t t = 0; t < mesas; t++) {
+            double maior = ratings[inicios[t]], menor = ratings[inicios[t]];
+            for (size_t i = inicios[t]; i < inicios[t + 1]; i++) {
+                maior = ratings[i] > maior ? ratings[i] : maior;
+                menor = ratings[i] < menor ? ratings[i] : menor;
+            }
+            maior_chegada = maior - menor > maior_chegada ? maior - menor : maior_chegada;
+        }
+        printf("Maior diferença de rating numa mesa: %.0f (por ordem de chegada: %.0f)\n",
+               maior_diferenca, maior_chegada);
+    }
+
+    free(nomes);
+    free(ratings);
+    free(ordem);
+    free(inicios);
+    return status == 0 ? 0 : 1;
+}
+
+// Modo varrer: resumo de um baralho lido em blocos, sem carregá-lo na
+// memória (agregados, melhores cartas, validação e histogramas)
+static int executar_varredura(int argc, char *argv[]) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *caminho = argv[2];
+    int k = argc > 3 ? atoi(argv[3]) : 5;
+    ResumoVarredura *r = malloc(sizeof(ResumoVarredura));
+    if (r == NULL) {
+        fprintf(stderr, "Erro: memória insuficiente.\n");
+        return 1;
+    }
+    uint64_t inicio = relogio_ns();
+    if (varrer_baralho(caminho, k, r) != 0) {
+        fprintf(stderr, "Erro: não foi possível varrer o baralho '%s'.\n", caminho);
+        free(r);
+        return 1;
+    }
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+
+    printf("=== VARREDURA DO BARALHO ===\n");
+    printf("Arquivo: %s (%.1f MB, %llu linhas)\n", caminho, (double)r->bytes / 1e6,
+           (unsigned long long)r->linhas);
+    printf("Cartas: %llu, tempo: %.3f s (%.1f MB/s), memória: %.1f MB\n",
+           (unsigned long long)r->cartas, segundos,
+           segundos > 0 ? (double)r->bytes / 1e6 / segundos : 0.0, (double)r->memoria / 1e6);
+
+    // Atributos: mínimo, média, máximo e quantis do histograma
+    printf("\n%-22s %14s %14s %14s %14s %14s\n", "Atributo", "Mínimo", "Média", "p50", "p99",
+           "Máximo");
+    for (int a = 1; a <= NUM_ATRIBUTOS; a++) {
+        uint64_t n = r->validos[a - 1];
+        printf("%-22s %14.2f %14.2f %14.2f %14.2f %14.2f\n", nome_atributo(a),
+               r->minimo[a - 1], n > 0 ? r->soma[a - 1] / (double)n : 0.0,
+               quantil_varredura(r, a, 0.5), quantil_varredura(r, a, 0.99), r->maximo[a - 1]);
+    }
+
+    // Melhores cartas de cada atributo
+    for (int a = 1; a <= NUM_ATRIBUTOS && r->k > 0; a++) {
+        printf("\nMelhores em %s:\n", nome_atributo(a));
+        for (int i = 0; i < r->tamanho_topo[a - 1]; i++) {
+            const Carta *c = &r->topo[a - 1][i];
+            printf("  %2d. %-10s %-2s %-30s %16.2f\n", i + 1, c->codigo, c->estado, c->nome,
+                   a == COMPARAR_POPULACAO ? (double)c->populacao
+                   : a == COMPARAR_PONTOS_TURISTICOS ? (double)c->pontos_turisticos
+                   : (double)obter_valor_atributo(c, a));
+        }
+    }
+
+    // Estados em ordem alfabética
+    printf("\n%-6s %10s %18s %18s\n", "Estado", "Cartas", "População", "PIB");
+    for (int u = 0; u < ESTADOS_VARREDURA; u++) {
+        if (r->cartas_estado[u] > 0) {
+            printf("%c%c     %10llu %18llu %18.2f\n", 'A' + u / 26, 'A' + u % 26,
+                   (unsigned long long)r->cartas_estado[u],
+                   (unsigned long long)r->populacao_estado[u], r->pib_estado[u]);
+        }
+    }
+
+    // Validação
+    printf("\nLinhas inválidas: %llu", (unsigned long long)r->invalidas);
+    for (uint64_t i = 0; i < r->invalidas && i < INVALIDAS_EXIBIDAS; i++) {
+        printf("%s%llu", i == 0 ? " (linhas " : ", ",
+               (unsigned long long)r->primeiras_invalidas[i]);
+    }
+    printf("%s\n", r->invalidas == 0 ? "" : r->invalidas > INVALIDAS_EXIBIDAS ? ", ...)" : ")");
+    printf("Códigos repetidos: %llu (estimativa; falsos positivos esperados: %.2e)\n",
+           (unsigned long long)r->codigos_repetidos, r->falsos_positivos);
+
+    free(r);
+    return 0;
+}
+
+// Modo gerar: baralho sintético, reproduzível pela semente, em texto ou
+// binário (foto do acervo, que só os modos do acervo abrem)
+static int executar_gerador(int argc, char *argv[], int threads) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    OpcoesGerador opcoes;
+    iniciar_opcoes_gerador(&opcoes);
+    const char *saida = argv[2];
+    long long cartas = strtoll(argv[3], NULL, 10);
+    opcoes.semente = argc > 4 ? strtoull(argv[4], NULL, 10) : opcoes.semente;
+    opcoes.threads = threads;
+    if (argc > 5 && strcmp(argv[5], "binario") == 0) {
+        opcoes.formato = GERADOR_BINARIO;
+    } else if (argc > 5 && strcmp(argv[5], "texto") != 0) {
+        fprintf(stderr, "Erro: formato deve ser 'texto' ou 'binario'.\n");
+        return 1;
+    }
+    if (cartas <= 0 || (unsigned long long)cartas > MAXIMO_CARTAS_GERADOR) {
+        fprintf(stderr, "Erro: o número de cartas deve ser de 1 a %llu.\n",
+                (unsigned long long)MAXIMO_CARTAS_GERADOR);
+        return 1;
+    }
+    opcoes.cartas = (uint64_t)cartas;
+
+    uint64_t inicio = relogio_ns();
+    long long bytes = gerar_baralho(&opcoes, saida);
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+    if (bytes < 0) {
+        fprintf(stderr, "Erro: não foi possível gerar o baralho em '%s'.\n", saida);
+        return 1;
+    }
+    printf("Baralho gerado: %s (%lld cartas, %s, semente %llu)\n", saida, cartas,
+           opcoes.formato == GERADOR_BINARIO ? "binário" : "texto",
+           (unsigned long long)opcoes.semente);
+    printf("%.1f MB em %.3f s (%.2f GB/s, %.1f milhões de cartas/s)\n", (double)bytes / 1e6,
+           segundos, segundos > 0 ? (double)bytes / 1e9 / segundos : 0.0,
+           segundos > 0 ? (double)cartas / 1e6 / segundos : 0.0);
+    return 0;
+}
+
+// Modo ingerir: carrega os baralhos em paralelo no cadastro concorrente e
+// grava as cartas (na ordem das vagas, que com várias threads depende da
+// ordem de chegada)
+static int executar_ingestao(int argc, char *argv[], int threads) {
+    if (argc < 4) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    const char *saida = argv[2];
+    CadastroCartas cadastro;
+    ResumoIngestao r;
+    uint64_t inicio = relogio_ns();
+    if (ingerir_arquivos(&cadastro, (const char *const *)&argv[3], argc - 3, threads, &r) != 0) {
+        fprintf(stderr, "Erro: não foi possível carregar os baralhos.\n");
+        return 1;
+    }
+    double segundos = (double)(relogio_ns() - inicio) / 1e9;
+
+    Baralho b;
+    iniciar_baralho(&b);
+    int erro = copiar_cadastro(&cadastro, &b) != 0 || salvar_baralho(&b, saida) != 0;
+    liberar_baralho(&b);
+    liberar_cadastro(&cadastro);
+    if (erro) {
+        fprintf(stderr, "Erro: não foi possível gravar o baralho em '%s'.\n", saida);
+        return 1;
+    }
+
+    printf("=== INGESTÃO PARALELA ===\n");
+    printf("Arquivos: %d (%.1f MB, %llu linhas), threads: %d\n", r.arquivos,
+           (double)r.bytes / 1e6, (unsigned long long)r.linhas, r.threads);
+    printf("Cartas: %llu, códigos repetidos: %llu, linhas inválidas: %llu\n",
+           (unsigned long long)r.cartas, (unsigned long long)r.repetidas,
+           (unsigned long long)r.invalidas);
+    printf("Tempo: %.3f s (%.1f MB/s, %.2f milhões de cartas/s)\n", segundos,
+           segundos > 0 ? (double)r.bytes / 1e6 / segundos : 0.0,
+           segundos > 0 ? (double)r.cartas / 1e6 / segundos : 0.0);
+    printf("Baralho gravado em: %s\n", saida);
+    return 0;
+}
+
+// Autoteste de remoções: em acervos descartáveis, insere 40 cartas, remove 20
+// em ordem sorteada (a última carta ocupa o lugar da removida) e confere o
+// índice a cada passo; repete com várias sementes para as sondagens do índice
+// passarem pela vaga da removida; retorna 0 se tudo bate, -1 se não
+static int testar_remocoes_acervo(const char *caminho) {
+    enum { RODADAS = 64, INSERIDAS = 40, REMOVIDAS = 20 };
+    char teste[4096], teste_log[4096];
+    if (snprintf(teste, sizeof(teste), "%s.conferencia", caminho) >= (int)sizeof(teste) - 4) {
+        return -1;
+    }
+    snprintf(teste_log, sizeof(teste_log), "%.4000s.wal", teste);
+
+    int status = 0;
+    for (int rodada = 0; rodada < RODADAS && status == 0; rodada++) {
+        unlink(teste);
+        unlink(teste_log);
+        Acervo a;
+        if (abrir_acervo(&a, teste) != 0) {
+            return -1;
+        }
+        a.sincronizacao_adiada = 1;
+        FluxoAleatorio f;
+        iniciar_fluxo(&f, 34, (uint64_t)rodada, 0);
+        Carta cartas[INSERIDAS];
+        for (int i = 0; i < INSERIDAS && status == 0; i++) {
+            char linha[128];
+            snprintf(linha, sizeof(linha), "SP;%08X;Cidade %d;%d;%d.5;%d.0;%d",
+                     (unsigned)proximo_fluxo(&f), i, 1000 + i, 10 + i, 100 + i, i % 7);
+            if (interpretar_linha_carta(linha, &cartas[i]) != 0
+                || inserir_carta_acervo(&a, &cartas[i]) != 0) {
+                status = -1;
+            }
+        }
+        uint32_t ordem[INSERIDAS];
+        embaralhar_fluxo(&f, ordem, INSERIDAS);
+        for (int r = 0; r < REMOVIDAS && status == 0; r++) {
+            if (remover_carta_acervo(&a, cartas[ordem[r]].codigo) != 0
+                || conferir_acervo(&a) != 0) {
+                status = -1;
+            }
+        }
+        for (int r = 0; r < INSERIDAS && status == 0; r++) {
+            if ((buscar_carta_acervo(&a, cartas[ordem[r]].codigo) != NULL) != (r >= REMOVIDAS)) {
+                status = -1;
+            }
+        }
+        if (fechar_acervo(&a) != 0) {
+            status = -1;
+        }
+    }
+    unlink(teste);
+    unlink(teste_log);
+    return status;
+}
+
+// Modo acervo: lista e altera o acervo persistente de cartas
+static int executar_acervo(int argc, char *argv[]) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+    const char *caminho = argv[2];
+    const char *comando = argc > 3 ? argv[3] : "listar";
+    const char *argumento = argc > 4 ? argv[4] : NULL;
+
+    Acervo a;
+    if (abrir_acervo(&a, caminho) != 0) {
+        fprintf(stderr, "Erro: não foi possível abrir o acervo '%s' "
+                        "(arquivo inválido ou aberto por outro processo).\n", caminho);
+        return 1;
+    }
+
+    int status = 0;
+    Carta carta;
+    if (strcmp(comando, "listar") == 0) {
+        for (size_t i = 0; i < a.quantidade; i++) {
+            imprimir_linha_carta(a.cartas[i]);
+        }
+        fprintf(stderr, "%zu cartas.\n", a.quantidade);
+    } else if ((strcmp(comando, "inserir") == 0 || strcmp(comando, "atualizar") == 0)
+               && argumento != NULL) {
+        int inserir = comando[0] == 'i';
+        if (interpretar_linha_carta(argumento, &carta) != 0) {
+            fprintf(stderr, "Erro: carta inválida (estado;codigo;nome;populacao;area;pib;pontos).\n");
+            status = 1;
+        } else if ((buscar_carta_acervo(&a, carta.codigo) != NULL) == inserir) {
+            fprintf(stderr, "Erro: a carta '%s' %s.\n", carta.codigo,
+                    inserir ? "já existe" : "não existe");
+            status = 1;
+        } else if ((inserir ? inserir_carta_acervo(&a, &carta)
+                            : atualizar_carta_acervo(&a, &carta)) != 0) {
+            fprintf(stderr, "Erro: falha ao gravar o acervo.\n");
+            status = 1;
+        }
+    } else if (strcmp(comando, "remover") == 0 && argumento != NULL) {
+        if (buscar_carta_acervo(&a, argumento) == NULL) {
+            fprintf(stderr, "Erro: a carta '%s' não existe.\n", argumento);
+            status = 1;
+        } else if (remover_carta_acervo(&a, argumento) != 0) {
+            fprintf(stderr, "Erro: falha ao gravar o acervo.\n");
+            status = 1;
+        }
+    } else if (strcmp(comando, "importar") == 0 && argumento != NULL) {
+        // Um fdatasync no fim do lote em vez de um por carta
+        Baralho baralho;
+        iniciar_baralho(&baralho);
+        if (carregar_baralho(&baralho, argumento) < 0) {
+            fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", argumento);
+            status = 1;
+        }
+        a.sincronizacao_adiada = 1;
+        for (size_t i = 0; i < baralho.quantidade && status == 0; i++) {
+            const Carta *c = &baralho.cartas[i];
+            if ((buscar_carta_acervo(&a, c->codigo) != NULL ? atualizar_carta_acervo(&a, c)
+                                                            : inserir_carta_acervo(&a, c)) != 0) {
+                fprintf(stderr, "Erro: falha ao gravar o acervo.\n");
+                status = 1;
+            }
+        }
+        if (status == 0 && compactar_acervo(&a) != 0) {
+            fprintf(stderr, "Erro: falha ao compactar o acervo.\n");
+            status = 1;
+        }
+        if (status == 0) {
+            fprintf(stderr, "%zu cartas importadas; o acervo tem %zu cartas.\n",
+                    baralho.quantidade, a.quantidade);
+        }
+        liberar_baralho(&baralho);
+    } else if (strcmp(comando, "exportar") == 0 && argumento != NULL) {
+        Baralho baralho;
+        iniciar_baralho(&baralho);
+        if (copiar_acervo_para_baralho(&a, &baralho) != 0
+            || salvar_baralho(&baralho, argumento) != 0) {
+            fprintf(stderr, "Erro: não foi possível gravar o baralho '%s'.\n", argumento);
+            status = 1;
+        }
+        liberar_baralho(&baralho);
+    } else if (strcmp(comando, "conferir") == 0) {
+        if (conferir_acervo(&a) != 0) {
+            fprintf(stderr, "Erro: o índice do acervo não confere com as cartas.\n");
+            status = 1;
+        } else if (testar_remocoes_acervo(caminho) != 0) {
+            fprintf(stderr, "Erro: o autoteste de remoções falhou.\n");
+            status = 1;
+        } else {
+            fprintf(stderr, "Acervo consistente: %zu cartas.\n", a.quantidade);
+        }
+    } else if (strcmp(comando, "compactar") == 0) {
+        if (compactar_acervo(&a) != 0) {
+            fprintf(stderr, "Erro: falha ao compactar o acervo.\n");
+            status = 1;
+        }
+    } else {
+        exibir_uso(argv[0]);
+        status = 1;
+    }
+
+    if (fechar_acervo(&a) != 0) {
+        fprintf(stderr, "Erro: falha ao gravar o acervo '%s'.\n", caminho);
+        status = 1;
+    }
+    return status;
+}
+
+// Texto do resultado de um duelo ou rodada
+static const char *texto_resultado(int resultado) {
+    return resultado == 1 ? "carta 1 vence" : resultado == 2 ? "carta 2 vence" : "empate";
+}
+
+// Reproduz as rodadas do jogo 'id_jogo' (primeira ocorrência no log). Os
+// parâmetros vêm do último registro de parâmetros antes do jogo; logs sem
+// ele usam os padrões e a --distribuicao da linha de comando
+static int reproduzir_jogo(LeitorRegistro *l, uint64_t id_jogo, const Baralho *baralho) {
+    EventoRegistro e;
+    int encontrado = 0;
+    uint64_t semente = 0;
+    int rodada = 0;
+    OpcoesSimulacao o;
+    iniciar_opcoes_simulacao(&o);
+    int equilibrada = distribuicao_equilibrada;
+
+    while (proximo_evento(l, &e)) {
+        if (!encontrado && e.tipo == REGISTRO_JOGO && e.atributo == JOGO_PARAMETROS) {
+            o.jogadores = (int)e.valor1;
+            o.max_rodadas = (int)e.valor2;
+            equilibrada = e.resultado == 1;
+        } else if (e.tipo == REGISTRO_JOGO && e.atributo == JOGO_INICIO) {
+            if (encontrado) break;
+            if (e.valor1 == id_jogo) {
+                encontrado = 1;
+                semente = e.valor2;
+                printf("=== JOGO %llu (semente %llu%s) ===\n",
+                       (unsigned long long)id_jogo, (unsigned long long)semente,
+                       equilibrada ? ", mãos equilibradas" : "");
+            }
+        } else if (encontrado && e.tipo == REGISTRO_RODADA) {
+            rodada++;
+            if (baralho != NULL && e.valor1 < baralho->quantidade && e.valor2 < baralho->quantidade) {
+                printf("Rodada %d: %s x %s - %s - %s\n", rodada,
+                       baralho->cartas[e.valor1].nome, baralho->cartas[e.valor2].nome,
+                       nome_atributo(e.atributo), texto_resultado(e.resultado));
+            } else {
+                printf("Rodada %d: carta %llu x carta %llu - %s - %s\n", rodada,
+                       (unsigned long long)e.valor1, (unsigned long long)e.valor2,
+                       nome_atributo(e.atributo), texto_resultado(e.resultado));
+            }
+        } else if (encontrado && e.tipo == REGISTRO_JOGO && e.atributo == JOGO_FIM) {
+            printf("Fim: %s após %llu rodadas\n",
+                   e.resultado == 0 ? "empate" : e.resultado == 1 ? "jogador 1 venceu" : "jogador 2 venceu",
+                   (unsigned long long)e.valor1);
+
+            // Com o baralho, confere se a simulação reproduz o mesmo jogo
+            if (baralho != NULL) {
+                ResultadoJogo r;
+                double *forca = NULL;
+                if (equilibrada) {
+                    forca = malloc(baralho->quantidade * sizeof(double));
+                    if (forca != NULL && calcular_forca_cartas(baralho, forca) == 0) {
+                        o.forca = forca;
+                    }
+                }
+                if (simular_jogo_opcoes(baralho, id_jogo, semente, &o, &r) == 0 &&
+                    r.vencedor == e.resultado && (uint64_t)r.rodadas == e.valor1 && r.rodadas == rodada) {
+                    printf("Reprodução conferida: a simulação gera o mesmo jogo.\n");
+                } else {
+                    printf("ATENÇÃO: a simulação com este baralho gera um jogo diferente.\n");
+                }
+                free(forca);
+            }
+            return 0;
+        }
+    }
+
+    fprintf(stderr, encontrado ? "Jogo %llu incompleto no registro.\n"
+                               : "Jogo %llu não encontrado no registro.\n",
+            (unsigned long long)id_jogo);
+    return 1;
+}
+
+// Modo replay: percorre o log binário e recalcula as estatísticas
+static int executar_replay(int argc, char *argv[], const char *jogo, const char *caminho_baralho) {
+    if (argc < 3) {
+        exibir_uso(argv[0]);
+        return 1;
+    }
+
+    LeitorRegistro leitor;
+    if (abrir_leitor_registro(&leitor, argv[2]) != 0) {
+        fprintf(stderr, "Erro: '%s' não é um registro de partidas válido.\n", argv[2]);
+        return 1;
+    }
+
+    if (jogo != NULL) {
+        Baralho baralho;
+        iniciar_baralho(&baralho);
+        if (caminho_baralho != NULL && carregar_baralho(&baralho, caminho_baralho) < 0) {
+            fprintf(stderr, "Erro: não foi possível carregar o baralho '%s'.\n", caminho_baralho);
+            fechar_leitor_registro(&leitor);
+            return 1;
+        }
+        int status = reproduzir_jogo(&leitor, strtoull(jogo, NULL, 10),
+                                     caminho_baralho != NULL ? &baralho : NULL);
+        liberar_baralho(&baralho);
+        fechar_leitor_registro(&leitor);
+        return status;
+    }
+
+    // Contadores por tipo de evento e por atributo x resultado
+    long sessoes = 0, duelos = 0, rodadas = 0, jogos = 0;
+    long vitorias[3] = { 0, 0, 0 };
+    long por_atributo[16][3];
+    memset(por_atributo, 0, sizeof(por_atributo));
+    uint64_t primeiro_tempo = 0, ultimo_tempo = 0;
+
+    EventoRegistro e;
+    clock_t inicio = clock();
+    RASTREAR_ESCOPO("replay");
+    while (proximo_evento(&leitor, &e)) {
+        switch (e.tipo) {
+            case REGISTRO_SESSAO:
+                sessoes++;
+                if (primeiro_tempo == 0) primeiro_tempo = e.tempo_us;
+                break;
+            case REGISTRO_DUELO:
+                duelos++;
+                por_atributo[e.atributo][e.resultado % 3]++;
+                break;
+            case REGISTRO_RODADA:
+                rodadas++;
+                por_atributo[e.atributo][e.resultado % 3]++;
+                break;
+            case REGISTRO_JOGO:
+                if (e.atributo == JOGO_FIM) {
+                    jogos++;
+                    vitorias[e.resultado % 3]++;
+                }
+                break;
+        }
+        ultimo_tempo = e.tempo_us;
+    }
+    double segundos = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    double megabytes = leitor.bytes_lidos / 1e6;
+    fechar_leitor_registro(&leitor);
+
+    RASTREAR_ESCOPO("formatar_saida");
+    printf("=== REPLAY DO REGISTRO ===\n");
+    printf("Arquivo: %s (%.1f MB)\n", argv[2], megabytes);
+    printf("Sessões: %ld\n", sessoes);
+    printf("Período: %.3f s\n", (ultimo_tempo - primeiro_tempo) / 1e6);
+    printf("Duelos avulsos: %ld\n", duelos);
+    printf("Jogos: %ld (jogador 1: %ld, jogador 2: %ld, empates: %ld)\n",
+           jogos, vitorias[1], vitorias[2], vitorias[0]);
+    printf("Rodadas: %ld", rodadas);
+    if (jogos > 0) printf(" (%.2f por jogo)", (double)rodadas / jogos);
+    printf("\n\nResultados por atributo (carta 1 / carta 2 / empates):\n");
+    for (int a = 1; a < 16; a++) {
+        long total = por_atributo[a][0] + por_atributo[a][1] + por_atributo[a][2];
+        if (total > 0) {
+            const char *nome = a == COMPARAR_AVANCADO ? "Comparação Avançada"
+                             : a == COMPARAR_DOIS_ATRIBUTOS ? "Dois Atributos"
+                             : nome_atributo(a);
+            printf("  %-24s %ld / %ld / %ld\n", nome,
+                   por_atributo[a][1], por_atributo[a][2], por_atributo[a][0]);
+        }
+    }
+    printf("\nLeitura: %.3f s (%.0f MB/s)\n", segundos, segundos > 0 ? megabytes / segundos : 0.0);
+    return 0;
+}
+
+// Remove "--nome valor" dos argumentos e retorna o valor (NULL se ausente)
+static const char *extrair_opcao(int *argc, char *argv[], const char *nome) {
+    for (int i = 1; i + 1 < *argc; i++) {
+        if (strcmp(argv[i], nome) == 0) {
+            const char *valor = argv[i + 1];
+            for (int j = i; j + 2 <= *argc; j++) {
+                argv[j] = argv[j + 2];
+            }
+            *argc -= 2;
+            return valor;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    setlocale(LC_ALL, "Portuguese");  // Configura o programa para português
+
+    const char *caminho_registro = extrair_opcao(&argc, argv, "--registro");
+    const char *jogo = extrair_opcao(&argc, argv, "--jogo");
+    const char *caminho_baralho = extrair_opcao(&argc, argv, "--baralho");
+    const char *caminho_metricas = extrair_opcao(&argc, argv, "--metricas");
+    const char *caminho_rastreio = extrair_opcao(&argc, argv, "--rastreio");
+    const char *threads = extrair_opcao(&argc, argv, "--threads");
+    const char *nome_estrategia = extrair_opcao(&argc, argv, "--estrategia");
+    const char *jogadores = extrair_opcao(&argc, argv, "--jogadores");
+    const char *observar = extrair_opcao(&argc, argv, "--observar");
+    const char *nome_formato = extrair_opcao(&argc, argv, "--formato");
+    const char *caminho_acervo = extrair_opcao(&argc, argv, "--acervo");
+    const char *caminho_regras = extrair_opcao(&argc, argv, "--regras");
+    const char *texto_desempate = extrair_opcao(&argc, argv, "--desempate");
+    const char *nome_distribuicao = extrair_opcao(&argc, argv, "--distribuicao");
+    const char *caminho_retomada = extrair_opcao(&argc, argv, "--retomada");
+    const char *intervalo_retomada = extrair_opcao(&argc, argv, "--intervalo-retomada");
+    ArgumentosMesa mesa = { caminho_baralho, extrair_opcao(&argc, argv, "--escutar"),
+                            extrair_opcao(&argc, argv, "--rodadas"),
+                            extrair_opcao(&argc, argv, "--tempo-limite") };
+    const char *modo = argc > 1 ? argv[1] : "mestre";
+
+    int estrategia = nome_estrategia != NULL ? interpretar_estrategia(nome_estrategia)
+                                             : ESTRATEGIA_ALEATORIA;
+    if (estrategia < 0) {
+        fprintf(stderr, "Erro: estratégia desconhecida '%s'.\n", nome_estrategia);
+        return 1;
+    }
+
+    int formato = nome_formato != NULL ? interpretar_formato(nome_formato)
+                : strcmp(modo, "exportar") == 0 ? FORMATO_JSONL : FORMATO_TEXTO;
+    if (formato < 0) {
+        fprintf(stderr, "Erro: formato desconhecido '%s'.\n", nome_formato);
+        return 1;
+    }
+
+    // Registros vão para a saída padrão original; o texto decorado, para stderr
+    FormatadorSaida formatador;
+    if (formato != FORMATO_TEXTO) {
+        int fd = dup(STDOUT_FILENO);
+        if (fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0
+            || abrir_formatador(&formatador, fd, formato) != 0) {
+            fprintf(stderr, "Erro: não foi possível preparar a saída '%s'.\n", nome_formato);
+            return 1;
+        }
+        definir_formatador_interface(&formatador);
+    }
+
+    if (caminho_rastreio != NULL) {
+        if (iniciar_rastreio(caminho_rastreio) != 0) {
+            fprintf(stderr, "Erro: não foi possível iniciar o rastreio.\n");
+            return 1;
+        }
+        nomear_thread_rastreio("principal");
+    }
+
+    if (caminho_regras != NULL) {
+        if (carregar_regras(&regras_casa, caminho_regras) != 0) {
+            fprintf(stderr, "Erro: não foi possível carregar as regras '%s'.\n", caminho_regras);
+            return 1;
+        }
+        regras = &regras_casa;
+        definir_regras_interface(regras);
+    }
+
+    if (texto_desempate != NULL) {
+        if (interpretar_cascata(&cascata_desempate, texto_desempate) != 0) {
+            fprintf(stderr, "Erro: cascata de desempate inválida '%s'.\n", texto_desempate);
+            return 1;
+        }
+        cascata = &cascata_desempate;
+    }
+
+    if (nome_distribuicao != NULL) {
+        distribuicao_equilibrada = strcmp(nome_distribuicao, "equilibrada") == 0;
+        if (!distribuicao_equilibrada && strcmp(nome_distribuicao, "aleatoria") != 0) {
+            fprintf(stderr, "Erro: distribuição desconhecida '%s'.\n", nome_distribuicao);
+            return 1;
+        }
+    }
+
+    if (strcmp(modo, "replay") == 0) {
+        return executar_replay(argc, argv, jogo, caminho_baralho);
+    }
+
+    // O exportador precisa existir antes das demais threads (máscara de sinais)
+    if (caminho_metricas != NULL && iniciar_exportador_metricas(caminho_metricas) != 0) {
+        fprintf(stderr, "Erro: não foi possível iniciar o exportador de métricas.\n");
+        return 1;
+    }
+
+    if (caminho_registro != NULL) {
+        if (abrir_registro(&registro_partidas, caminho_registro) != 0) {
+            fprintf(stderr, "Erro: não foi possível abrir o registro '%s'.\n", caminho_registro);
+            return 1;
+        }
+        registro = &registro_partidas;
+    }
+
+    if (caminho_retomada != NULL) {
+        double intervalo = intervalo_retomada != NULL ? atof(intervalo_retomada)
+                                                      : INTERVALO_RETOMADA_PADRAO;
+        if (abrir_retomada(&ponto_retomada, caminho_retomada, intervalo) != 0) {
+            fprintf(stderr, "Erro: não foi possível preparar a retomada '%s'.\n",
+                    caminho_retomada);
+            return 1;
+        }
+        retomada = &ponto_retomada;
+    }
+
+    if (caminho_acervo != NULL) {
+        if (abrir_acervo(&acervo_cartas, caminho_acervo) != 0) {
+            fprintf(stderr, "Erro: não foi possível abrir o acervo '%s'.\n", caminho_acervo);
+            return 1;
+        }
+        acervo = &acervo_cartas;
+    }
+
+    int status;
+    if (strcmp(modo, "simular") == 0) {
+        status = executar_simulacao(argc, argv, jogadores != NULL ? atoi(jogadores) : 2,
+                                    threads != NULL ? atoi(threads) : 0, observar);
+    } else if (strcmp(modo, "elo") == 0) {
+        status = executar_elo(argc, argv, threads != NULL ? atoi(threads) : 0, estrategia);
+    } else if (strcmp(modo, "balancear") == 0) {
+        status = executar_balanceamento(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "mesa") == 0) {
+        status = executar_modo_mesa(argc, argv, &mesa);
+    } else if (strcmp(modo, "matriz") == 0) {
+        status = executar_matriz(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "consultar") == 0) {
+        status = executar_consulta(argc, argv, threads != NULL ? atoi(threads) : 0,
+                                   formato != FORMATO_TEXTO ? &formatador : NULL);
+    } else if (strcmp(modo, "esquema") == 0) {
+        status = executar_esquema(argc, argv);
+    } else if (strcmp(modo, "semelhantes") == 0) {
+        status = executar_semelhantes(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "raridade") == 0) {
+        status = executar_raridade(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "distribuir") == 0) {
+        status = executar_distribuicao(argc, argv);
+    } else if (strcmp(modo, "mesas") == 0) {
+        status = executar_mesas(argc, argv);
+    } else if (strcmp(modo, "varrer") == 0) {
+        status = executar_varredura(argc, argv);
+    } else if (strcmp(modo, "gerar") == 0) {
+        status = executar_gerador(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "ingerir") == 0) {
+        status = executar_ingestao(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "classificar") == 0) {
+        status = executar_classificacao(argc, argv);
+    } else if (strcmp(modo, "regras") == 0) {
+        status = executar_regras(argc, argv);
+    } else if (strcmp(modo, "compartilhar") == 0) {
+        status = executar_compartilhamento(argc, argv, threads != NULL ? atoi(threads) : 0);
+    } else if (strcmp(modo, "acervo") == 0) {
+        status = executar_acervo(argc, argv);
+    } else if (strcmp(modo, "exportar") == 0) {
+        if (formato == FORMATO_TEXTO) {
+            fprintf(stderr, "Erro: o modo exportar usa --formato jsonl ou csv.\n");
+            status = 1;
+        } else {
+            status = executar_exportacao(argc, argv, &formatador);
+        }
+    } else {
+        setbuf(stdout, NULL);  // Evita problemas de buffer no Windows
+
+        if (strcmp(modo, "novato") == 0) {
+            status = jogar_novato();
+        } else if (strcmp(modo, "aventureiro") == 0) {
+            status = jogar_menu(NIVEL_AVENTUREIRO);
+        } else if (strcmp(modo, "mestre") == 0) {
+            status = jogar_menu(NIVEL_MESTRE);
+        } else {
+            exibir_uso(argv[0]);
+            status = 1;
+        }
+    }
+
+    if (formato != FORMATO_TEXTO) {
+        definir_formatador_interface(NULL);
+        if (fechar_formatador(&formatador) != 0) {
+            fprintf(stderr, "Erro: falha ao gravar a saída.\n");
+            status = 1;
+        }
+    }
+    if (acervo != NULL && fechar_acervo(acervo) != 0) {
+        fprintf(stderr, "Erro: falha ao gravar o acervo '%s'.\n", caminho_acervo);
+        status = 1;
+    }
+    if (retomada != NULL && fechar_retomada(retomada) != 0) {
+        fprintf(stderr, "Erro: falha ao gravar a retomada '%s'.\n", caminho_retomada);
+        status = 1;
+    }
+    if (registro != NULL && fechar_registro(registro) != 0) {
+        fprintf(stderr, "Erro: falha ao gravar o registro '%s'.\n", caminho_registro);
+        status = 1;
+    }
+    if (caminho_rastreio != NULL && finalizar_rastreio() != 0) {
+        fprintf(stderr, "Erro: falha ao gravar o rastreio '%s'.\n", caminho_rastreio);
+        status = 1;
+    }
+    if (caminho_metricas != NULL && exportar_metricas_prometheus(caminho_metricas) != 0) {
+        fprintf(stderr, "Erro: falha ao exportar métricas para '%s'.\n", caminho_metricas);
+        status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,591 @@
+/*
+ * Super Trunfo - Acervo persistente de cartas
+ *
+ * Foto mapeada em memória + log de escrita antecipada com CRC-32. As cartas
+ * vivas são ponteiros para a foto ou para cópias alocadas ao reaplicar o
+ * log; um índice hash (endereçamento aberto) acha a carta pelo código.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "acervo.h"
+
+// Assinatura da foto (inclui a versão do formato no último byte)
+static const uint8_t ASSINATURA_ACERVO[8] = { 'S', 'T', 'A', 'C', 'V', 0, 0, 1 };
+
+// Operações do log
+#define OPERACAO_DEFINIR 1
+#define OPERACAO_REMOVER 2
+
+// Cartas copiadas por escrita ao gravar a foto
+#define CARTAS_POR_BLOCO 1024
+
+// Cabeçalho da foto (seguido de 'quantidade' cartas)
+typedef struct {
+    uint8_t assinatura[8];
+    uint32_t tamanho_carta;   // sizeof(Carta) do build que gravou
+    uint32_t reservado;
+    uint64_t quantidade;
+    uint64_t reservado2;
+} CabecalhoAcervo;
+
+_Static_assert(sizeof(CabecalhoAcervo) == TAMANHO_CABECALHO_ACERVO,
+               "TAMANHO_CABECALHO_ACERVO difere do cabeçalho");
+
+// Registro do log (o CRC cobre tudo depois dele)
+typedef struct {
+    uint32_t crc;
+    uint32_t operacao;
+    Carta carta;              // Só o código importa em OPERACAO_REMOVER
+} RegistroLog;
+
+static uint32_t tabela_crc[256];
+
+// Tabela do CRC-32 (polinômio refletido 0xEDB88320)
+static void preparar_tabela_crc(void) {
+    if (tabela_crc[1] != 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        tabela_crc[i] = c;
+    }
+}
+
+static uint32_t calcular_crc(const void *dados, size_t tamanho) {
+    const uint8_t *p = dados;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (tamanho--) {
+        crc = tabela_crc[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t crc_registro(const RegistroLog *r) {
+    return calcular_crc((const uint8_t *)r + sizeof(r->crc), sizeof(*r) - sizeof(r->crc));
+}
+
+// Escreve todo o bloco, repetindo em escritas parciais
+static int escrever_tudo(int fd, const void *dados, size_t tamanho) {
+    const uint8_t *p = dados;
+    while (tamanho > 0) {
+        ssize_t escrito = write(fd, p, tamanho);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += escrito;
+        tamanho -= (size_t)escrito;
+    }
+    return 0;
+}
+
+// Campo de texto termina dentro do tamanho declarado
+static int texto_valido(const char *texto, size_t tamanho) {
+    return memchr(texto, '\0', tamanho) != NULL;
+}
+
+static int carta_valida(const Carta *c) {
+    return texto_valido(c->estado, sizeof(c->estado)) && texto_valido(c->codigo, sizeof(c->codigo))
+        && texto_valido(c->nome, sizeof(c->nome)) && c->codigo[0] != '\0';
+}
+
+// A carta está na foto mapeada (e não numa cópia alocada)
+static int carta_mapeada(const Acervo *a, const Carta *c) {
+    const unsigned char *p = (const unsigned char *)c;
+    return a->mapa != NULL && p >= a->mapa && p < a->mapa + a->tamanho_mapa;
+}
+
+// Hash FNV-1a do código
+static size_t hash_codigo(const char *codigo) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)codigo; *p; p++) {
+        h = (h ^ *p) * 1099511628211ULL;
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+// Posição no índice da carta com o código, ou da vaga onde ela entraria
+static size_t posicao_indice(const Acervo *a, const char *codigo) {
+    size_t mascara = a->tamanho_indice - 1;
+    size_t i = hash_codigo(codigo) & mascara;
+    while (a->indice[i] != 0 && strcmp(a->cartas[a->indice[i] - 1]->codigo, codigo) != 0) {
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+// Reconstrói o índice com o tamanho dado
+static int refazer_indice(Acervo *a, size_t tamanho) {
+    uint32_t *novo = calloc(tamanho, sizeof(uint32_t));
+    if (novo == NULL) {
+        return -1;
+    }
+    free(a->indice);
+    a->indice = novo;
+    a->tamanho_indice = tamanho;
+    for (size_t p = 0; p < a->quantidade; p++) {
+        a->indice[posicao_indice(a, a->cartas[p]->codigo)] = (uint32_t)(p + 1);
+    }
+    return 0;
+}
+
+// Coloca a carta no conjunto, substituindo a de mesmo código
+static int definir_carta(Acervo *a, const Carta *c) {
+    if ((a->quantidade + 1) * 2 > a->tamanho_indice
+        && refazer_indice(a, a->tamanho_indice ? a->tamanho_indice * 2 : 64) != 0) {
+        return -1;
+    }
+    size_t i = posicao_indice(a, c->codigo);
+    if (a->indice[i] != 0) {
+        const Carta **atual = &a->cartas[a->indice[i] - 1];
+        if (!carta_mapeada(a, *atual)) {
+            free((void *)*atual);
+        }
+        *atual = c;
+        return 0;
+    }
+    if (a->quantidade == a->capacidade) {
+        size_t nova_capacidade = a->capacidade ? a->capacidade * 2 : 64;
+        const Carta **novas = realloc(a->cartas, nova_capacidade * sizeof(*novas));
+        if (novas == NULL) {
+            return -1;
+        }
+        a->cartas = novas;
+        a->capacidade = nova_capacidade;
+    }
+    a->cartas[a->quantidade++] = c;
+    a->indice[i] = (uint32_t)a->quantidade;
+    return 0;
+}
+
+// Tira a carta do conjunto (a última ocupa o lugar dela); 0 se existia
+static int apagar_carta(Acervo *a, const char *codigo) {
+    if (a->quantidade == 0) {
+        return -1;
+    }
+    size_t mascara = a->tamanho_indice - 1;
+    size_t vaga = posicao_indice(a, codigo);
+    if (a->indice[vaga] == 0) {
+        return -1;
+    }
+    size_t p = a->indice[vaga] - 1;
+    size_t ultima = a->quantidade - 1;
+    const Carta *removida = a->cartas[p];
+    if (p != ultima) {
+        // A sondagem pode passar pela vaga da removida: ela ainda está viva aqui
+        a->indice[posicao_indice(a, a->cartas[ultima]->codigo)] = (uint32_t)(p + 1);
+        a->cartas[p] = a->cartas[ultima];
+    }
+    a->quantidade--;
+    if (!carta_mapeada(a, removida)) {
+        free((void *)removida);
+    }
+
+    // Remoção com deslocamento para trás: mantém as sequências de sondagem
+    size_t j = vaga;
+    for (;;) {
+        j = (j + 1) & mascara;
+        if (a->indice[j] == 0) {
+            break;
+        }
+        size_t k = hash_codigo(a->cartas[a->indice[j] - 1]->codigo) & mascara;
+        int fora = vaga <= j ? (k <= vaga || k > j) : (k <= vaga && k > j);
+        if (fora) {
+            a->indice[vaga] = a->indice[j];
+            vaga = j;
+        }
+    }
+    a->indice[vaga] = 0;
+    return 0;
+}
+
+// Aplica um registro do log na memória
+static int aplicar_registro(Acervo *a, const RegistroLog *r) {
+    if (r->operacao == OPERACAO_REMOVER) {
+        apagar_carta(a, r->carta.codigo);  // Reaplicação: pode já não existir
+        return 0;
+    }
+    Carta *copia = malloc(sizeof(Carta));
+    if (copia == NULL) {
+        return -1;
+    }
+    *copia = r->carta;
+    if (definir_carta(a, copia) != 0) {
+        free(copia);
+        return -1;
+    }
+    return 0;
+}
+
+// Preenche o cabeçalho de uma foto
+void preencher_cabecalho_acervo(unsigned char cabecalho[TAMANHO_CABECALHO_ACERVO],
+                                uint64_t quantidade) {
+    CabecalhoAcervo c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.assinatura, ASSINATURA_ACERVO, sizeof(c.assinatura));
+    c.tamanho_carta = sizeof(Carta);
+    c.quantidade = quantidade;
+    memcpy(cabecalho, &c, sizeof(c));
+}
+
+// Grava a foto com as cartas vivas em 'temporario' e troca pela atual
+static int gravar_foto(const Acervo *a, const char *temporario) {
+    int fd = open(temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    unsigned char cabecalho[TAMANHO_CABECALHO_ACERVO];
+    preencher_cabecalho_acervo(cabecalho, a->quantidade);
+
+    int falhou = escrever_tudo(fd, cabecalho, sizeof(cabecalho)) != 0;
+    Carta *bloco = malloc(CARTAS_POR_BLOCO * sizeof(Carta));
+    falhou |= bloco == NULL;
+    for (size_t i = 0; i < a->quantidade && !falhou; i += CARTAS_POR_BLOCO) {
+        size_t n = a->quantidade - i < CARTAS_POR_BLOCO ? a->quantidade - i : CARTAS_POR_BLOCO;
+        for (size_t k = 0; k < n; k++) {
+            bloco[k] = *a->cartas[i + k];
+        }
+        falhou = escrever_tudo(fd, bloco, n * sizeof(Carta)) != 0;
+    }
+    free(bloco);
+    falhou |= fsync(fd) != 0;
+    falhou |= close(fd) != 0;
+    if (falhou || rename(temporario, a->caminho) != 0) {
+        unlink(temporario);
+        return -1;
+    }
+
+    // Torna o rename durável: sincroniza o diretório da foto
+    const char *barra = strrchr(a->caminho, '/');
+    char *diretorio = barra != NULL ? strndup(a->caminho, (size_t)(barra - a->caminho) + 1)
+                                    : strdup(".");
+    if (diretorio == NULL) {
+        return -1;
+    }
+    int fd_diretorio = open(diretorio, O_RDONLY);
+    free(diretorio);
+    if (fd_diretorio >= 0) {
+        fsync(fd_diretorio);
+        close(fd_diretorio);
+    }
+    return 0;
+}
+
+// Mapeia a foto; retorna o número de cartas ou -1 se inválida
+static long mapear_foto(const char *caminho, const unsigned char **mapa, size_t *tamanho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    CabecalhoAcervo cabecalho;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(cabecalho)
+        || pread(fd, &cabecalho, sizeof(cabecalho), 0) != (ssize_t)sizeof(cabecalho)
+        || memcmp(cabecalho.assinatura, ASSINATURA_ACERVO, sizeof(cabecalho.assinatura)) != 0
+        || cabecalho.tamanho_carta != sizeof(Carta)
+        || cabecalho.quantidade > ((size_t)st.st_size - sizeof(cabecalho)) / sizeof(Carta)
+        || (size_t)st.st_size != sizeof(cabecalho) + cabecalho.quantidade * sizeof(Carta)) {
+        close(fd);
+        return -1;
+    }
+    *mapa = NULL;
+    *tamanho = 0;
+    if (cabecalho.quantidade > 0) {
+        void *m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        *mapa = m;
+        *tamanho = (size_t)st.st_size;
+    }
+    close(fd);
+    return (long)cabecalho.quantidade;
+}
+
+// Reaplica o log e corta um final incompleto ou corrompido
+static int reaplicar_log(Acervo *a) {
+    RegistroLog *bloco = malloc(CARTAS_POR_BLOCO * sizeof(RegistroLog));
+    if (bloco == NULL) {
+        return -1;
+    }
+    off_t validos = 0;
+    int fim = 0;
+    while (!fim) {
+        ssize_t lidos = pread(a->fd_log, bloco, CARTAS_POR_BLOCO * sizeof(RegistroLog), validos);
+        if (lidos < 0) {
+            if (errno == EINTR) continue;
+            free(bloco);
+            return -1;
+        }
+        size_t n = (size_t)lidos / sizeof(RegistroLog);
+        fim = n < CARTAS_POR_BLOCO;
+        for (size_t i = 0; i < n; i++) {
+            const RegistroLog *r = &bloco[i];
+            int valido = r->crc == crc_registro(r) && carta_valida(&r->carta)
+                      && (r->operacao == OPERACAO_DEFINIR || r->operacao == OPERACAO_REMOVER);
+            if (!valido) {
+                fim = 1;
+                break;
+            }
+            if (aplicar_registro(a, r) != 0) {
+                free(bloco);
+                return -1;
+            }
+            validos += (off_t)sizeof(RegistroLog);
+            a->registros_log++;
+        }
+    }
+    free(bloco);
+    if (ftruncate(a->fd_log, validos) != 0 || lseek(a->fd_log, 0, SEEK_END) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Junta o caminho com um sufixo
+static char *com_sufixo(const char *caminho, const char *sufixo) {
+    size_t n = strlen(caminho);
+    char *s = malloc(n + strlen(sufixo) + 1);
+    if (s != NULL) {
+        memcpy(s, caminho, n);
+        strcpy(s + n, sufixo);
+    }
+    return s;
+}
+
+// Libera a memória, o mapa e o log (solta a trava) sem gravar nada
+static void liberar_acervo(Acervo *a) {
+    for (size_t i = 0; i < a->quantidade; i++) {
+        if (!carta_mapeada(a, a->cartas[i])) {
+            free((void *)a->cartas[i]);
+        }
+    }
+    if (a->mapa != NULL) {
+        munmap((void *)a->mapa, a->tamanho_mapa);
+    }
+    if (a->fd_log >= 0) {
+        close(a->fd_log);
+    }
+    free(a->cartas);
+    free(a->indice);
+    free(a->caminho);
+    free(a->caminho_log);
+    memset(a, 0, sizeof(*a));
+    a->fd_log = -1;
+}
+
+// Abre o acervo, criando os arquivos se não existirem
+int abrir_acervo(Acervo *a, const char *caminho) {
+    memset(a, 0, sizeof(*a));
+    a->fd_log = -1;
+    preparar_tabela_crc();
+
+    a->caminho = strdup(caminho);
+    a->caminho_log = com_sufixo(caminho, ".wal");
+    char *temporario = com_sufixo(caminho, ".tmp");
+    if (a->caminho == NULL || a->caminho_log == NULL || temporario == NULL) {
+        free(temporario);
+        liberar_acervo(a);
+        return -1;
+    }
+
+    // A trava no log impede dois processos de alterar o mesmo acervo
+    a->fd_log = open(a->caminho_log, O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct flock trava = { .l_type = F_WRLCK, .l_whence = SEEK_SET };
+    if (a->fd_log < 0 || fcntl(a->fd_log, F_SETLK, &trava) != 0) {
+        free(temporario);
+        liberar_acervo(a);
+        return -1;
+    }
+
+    if (access(caminho, F_OK) != 0 && gravar_foto(a, temporario) != 0) {
+        free(temporario);
+        liberar_acervo(a);
+        return -1;
+    }
+    free(temporario);
+
+    long n = mapear_foto(caminho, &a->mapa, &a->tamanho_mapa);
+    if (n < 0) {
+        liberar_acervo(a);
+        return -1;
+    }
+    const Carta *fotografadas = (const Carta *)(a->mapa + sizeof(CabecalhoAcervo));
+    for (long i = 0; i < n; i++) {
+        if (!carta_valida(&fotografadas[i]) || definir_carta(a, &fotografadas[i]) != 0) {
+            liberar_acervo(a);
+            return -1;
+        }
+    }
+    if (reaplicar_log(a) != 0) {
+        liberar_acervo(a);
+        return -1;
+    }
+    return 0;
+}
+
+// Carta com o código ou NULL
+const Carta *buscar_carta_acervo(const Acervo *a, const char *codigo) {
+    if (a->quantidade == 0) {
+        return NULL;
+    }
+    size_t i = posicao_indice(a, codigo);
+    return a->indice[i] != 0 ? a->cartas[a->indice[i] - 1] : NULL;
+}
+
+// Acrescenta o registro ao log (durável antes de aplicar) e aplica
+static int registrar_alteracao(Acervo *a, int operacao, const Carta *c) {
+    RegistroLog r;
+    memset(&r, 0, sizeof(r));
+    r.operacao = (uint32_t)operacao;
+    if (operacao == OPERACAO_REMOVER) {
+        strcpy(r.carta.codigo, c->codigo);
+    } else {
+        r.carta = *c;
+    }
+    if (!carta_valida(&r.carta)) {
+        return -1;
+    }
+    r.crc = crc_registro(&r);
+
+    off_t tamanho = lseek(a->fd_log, 0, SEEK_END);
+    if (tamanho < 0) {
+        return -1;
+    }
+    if (escrever_tudo(a->fd_log, &r, sizeof(r)) != 0
+        || (!a->sincronizacao_adiada && fdatasync(a->fd_log) != 0)) {
+        // Não deixa meio registro antes dos próximos (se o corte falhar, a
+        // reabertura descarta o final inválido)
+        if (ftruncate(a->fd_log, tamanho) != 0) {
+            a->registros_log++;
+        }
+        return -1;
+    }
+    a->registros_log++;
+    return aplicar_registro(a, &r);
+}
+
+// Insere uma carta nova
+int inserir_carta_acervo(Acervo *a, const Carta *c) {
+    if (buscar_carta_acervo(a, c->codigo) != NULL) {
+        return -1;
+    }
+    return registrar_alteracao(a, OPERACAO_DEFINIR, c);
+}
+
+// Substitui a carta de mesmo código
+int atualizar_carta_acervo(Acervo *a, const Carta *c) {
+    if (buscar_carta_acervo(a, c->codigo) == NULL) {
+        return -1;
+    }
+    return registrar_alteracao(a, OPERACAO_DEFINIR, c);
+}
+
+// Remove a carta
+int remover_carta_acervo(Acervo *a, const char *codigo) {
+    const Carta *c = buscar_carta_acervo(a, codigo);
+    if (c == NULL) {
+        return -1;
+    }
+    return registrar_alteracao(a, OPERACAO_REMOVER, c);
+}
+
+// Sincroniza o log
+int sincronizar_acervo(Acervo *a) {
+    return fdatasync(a->fd_log) == 0 ? 0 : -1;
+}
+
+// Grava uma foto nova com todas as cartas e esvazia o log
+int compactar_acervo(Acervo *a) {
+    char *temporario = com_sufixo(a->caminho, ".tmp");
+    if (temporario == NULL || sincronizar_acervo(a) != 0 || gravar_foto(a, temporario) != 0) {
+        free(temporario);
+        return -1;
+    }
+    free(temporario);
+
+    // A foto nova tem as cartas na mesma ordem: o índice continua válido
+    const unsigned char *mapa = NULL;
+    size_t tamanho = 0;
+    if (mapear_foto(a->caminho, &mapa, &tamanho) != (long)a->quantidade) {
+        if (mapa != NULL) munmap((void *)mapa, tamanho);
+        return -1;
+    }
+    const Carta *fotografadas = (const Carta *)(mapa + sizeof(CabecalhoAcervo));
+    for (size_t i = 0; i < a->quantidade; i++) {
+        if (!carta_mapeada(a, a->cartas[i])) {
+            free((void *)a->cartas[i]);
+        }
+        a->cartas[i] = &fotografadas[i];
+    }
+    if (a->mapa != NULL) {
+        munmap((void *)a->mapa, a->tamanho_mapa);
+    }
+    a->mapa = mapa;
+    a->tamanho_mapa = tamanho;
+
+    // Uma queda antes daqui só faz o log ser reaplicado sobre a foto nova
+    if (ftruncate(a->fd_log, 0) != 0 || fdatasync(a->fd_log) != 0) {
+        return -1;
+    }
+    a->registros_log = 0;
+    return 0;
+}
+
+// Confere o índice contra o vetor de cartas
+int conferir_acervo(const Acervo *a) {
+    size_t ocupadas = 0;
+    for (size_t i = 0; i < a->tamanho_indice; i++) {
+        if (a->indice[i] != 0) {
+            if (a->indice[i] > a->quantidade) {
+                return -1;
+            }
+            ocupadas++;
+        }
+    }
+    if (ocupadas != a->quantidade) {
+        return -1;
+    }
+    for (size_t p = 0; p < a->quantidade; p++) {
+        if (a->indice[posicao_indice(a, a->cartas[p]->codigo)] != p + 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Acrescenta cópias de todas as cartas ao baralho
+int copiar_acervo_para_baralho(const Acervo *a, Baralho *b) {
+    for (size_t i = 0; i < a->quantidade; i++) {
+        if (adicionar_carta(b, a->cartas[i]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Compacta se o log estiver grande e libera tudo
+int fechar_acervo(Acervo *a) {
+    int status = 0;
+    if (a->registros_log > LIMITE_LOG_ACERVO) {
+        status = compactar_acervo(a);
+    } else if (a->sincronizacao_adiada) {
+        status = sincronizar_acervo(a);
+    }
+    liberar_acervo(a);
+    return status;
+}
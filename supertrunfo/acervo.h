@@ -0,0 +1,95 @@
+/*
+ * Super Trunfo - Acervo persistente de cartas
+ *
+ * Guarda as cartas cadastradas entre execuções, com inserção, atualização e
+ * remoção por código. O acervo são dois arquivos:
+ *
+ *   <caminho>      foto (snapshot): cabeçalho + vetor de Carta, mapeado em
+ *                  memória somente leitura ao abrir (nada é copiado)
+ *   <caminho>.wal  log de escrita antecipada: cada alteração é acrescentada
+ *                  como um registro de tamanho fixo com CRC-32 e sincronizada
+ *                  (fdatasync) antes da função retornar
+ *
+ * Ao abrir, o log é reaplicado sobre a foto; um registro incompleto ou com
+ * CRC errado no fim (queda no meio da escrita) é descartado. A compactação
+ * grava uma foto nova em <caminho>.tmp, sincroniza, troca pela antiga com
+ * rename() e só então esvazia o log. Como cada registro do log apenas
+ * define ou apaga a carta de um código, reaplicar o log sobre uma foto que
+ * já o contém dá o mesmo resultado: uma queda em qualquer ponto da
+ * compactação não perde nem duplica cartas.
+ *
+ * O arquivo depende do layout de Carta deste build (tamanho gravado no
+ * cabeçalho e conferido na abertura). Um processo por vez pode abrir o
+ * acervo (trava de escrita no log).
+ */
+
+#ifndef SUPERTRUNFO_ACERVO_H
+#define SUPERTRUNFO_ACERVO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+// Compacta ao fechar quando o log tiver mais registros que isso
+#define LIMITE_LOG_ACERVO 1024
+
+// Bytes do cabeçalho da foto (antes do vetor de Carta)
+#define TAMANHO_CABECALHO_ACERVO 32
+
+// Acervo aberto
+typedef struct {
+    char *caminho;               // Foto
+    char *caminho_log;           // <caminho>.wal
+    int fd_log;
+    const unsigned char *mapa;   // Foto mapeada (NULL se vazia)
+    size_t tamanho_mapa;
+    const Carta **cartas;        // Cartas vivas: na foto ou alocadas pelo log
+    size_t quantidade;
+    size_t capacidade;
+    uint32_t *indice;            // Hash do código -> posição + 1 (0 = livre)
+    size_t tamanho_indice;       // Potência de 2
+    size_t registros_log;
+    int sincronizacao_adiada;    // 1 = não sincroniza a cada alteração (lotes)
+} Acervo;
+
+// Abre o acervo, criando os arquivos se não existirem;
+// retorna 0 em sucesso, -1 em erro (arquivo inválido, travado ou sem memória)
+int abrir_acervo(Acervo *a, const char *caminho);
+
+// Carta com o código ou NULL; o ponteiro vale até a próxima alteração
+const Carta *buscar_carta_acervo(const Acervo *a, const char *codigo);
+
+// Insere uma carta nova; retorna 0 em sucesso, -1 se o código já existe ou em erro
+int inserir_carta_acervo(Acervo *a, const Carta *c);
+
+// Substitui a carta de mesmo código; retorna 0 em sucesso, -1 se não existe ou em erro
+int atualizar_carta_acervo(Acervo *a, const Carta *c);
+
+// Remove a carta; retorna 0 em sucesso, -1 se não existe ou em erro
+int remover_carta_acervo(Acervo *a, const char *codigo);
+
+// Sincroniza o log (após alterações com sincronizacao_adiada);
+// retorna 0 em sucesso, -1 em erro
+int sincronizar_acervo(Acervo *a);
+
+// Grava uma foto nova com todas as cartas e esvazia o log;
+// retorna 0 em sucesso, -1 em erro (o acervo continua válido)
+int compactar_acervo(Acervo *a);
+
+// Preenche o cabeçalho de uma foto com 'quantidade' cartas, para quem grava a
+// foto diretamente (cabeçalho seguido do vetor de Carta, sem log)
+void preencher_cabecalho_acervo(unsigned char cabecalho[TAMANHO_CABECALHO_ACERVO],
+                                uint64_t quantidade);
+
+// Confere se o índice acha cada carta na sua posição e não tem entradas
+// sobrando; retorna 0 se o acervo está consistente, -1 se não
+int conferir_acervo(const Acervo *a);
+
+// Acrescenta cópias de todas as cartas ao baralho; retorna 0 ou -1 sem memória
+int copiar_acervo_para_baralho(const Acervo *a, Baralho *b);
+
+// Compacta se o log estiver grande e libera tudo; retorna 0 em sucesso, -1 em erro
+int fechar_acervo(Acervo *a);
+
+#endif
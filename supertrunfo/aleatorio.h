@@ -0,0 +1,122 @@
+/*
+ * Super Trunfo - Números pseudoaleatórios
+ *
+ * splitmix64: rápido, com boa distribuição e estado de 64 bits, usado
+ * pelos avaliadores em lote.
+ *
+ * Philox4x32-10 (Salmon et al., 2011): gerador baseado em contador, usado
+ * pelo simulador. Cada bloco de 128 bits é uma função pura de (chave,
+ * contador), sem estado compartilhado: a chave é a semente e o contador é
+ * (jogo, rodada, bloco). Assim o jogo N tira sempre os mesmos números,
+ * qualquer que seja o número de threads ou a ordem em que os jogos rodam.
+ */
+
+#ifndef SUPERTRUNFO_ALEATORIO_H
+#define SUPERTRUNFO_ALEATORIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Constantes do Philox4x32
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_RODADAS 10
+
+// Fluxo de números do contador (semente, jogo, rodada)
+typedef struct {
+    uint32_t chave[2];
+    uint32_t contador[4];   // bloco, rodada, jogo (32 bits baixos), jogo (altos)
+    uint32_t bloco[4];      // Último bloco gerado
+    int usados;             // Palavras de 'bloco' já entregues
+} FluxoAleatorio;
+
+// Avança o estado e retorna o próximo número de 64 bits
+static inline uint64_t proximo_aleatorio(uint64_t *estado) {
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Sorteia um inteiro em [0, limite)
+static inline uint32_t sortear(uint64_t *estado, uint32_t limite) {
+    return (uint32_t)(((proximo_aleatorio(estado) >> 32) * limite) >> 32);
+}
+
+// Sorteia um real em [0, 1)
+static inline double sortear_real(uint64_t *estado) {
+    return (double)(proximo_aleatorio(estado) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Bloco Philox4x32-10 do contador 'bloco' com a chave dada (no próprio vetor)
+static inline void philox4x32(uint32_t bloco[4], uint32_t chave0, uint32_t chave1) {
+    for (int r = 0; r < PHILOX_RODADAS; r++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * bloco[0];
+        uint64_t p1 = (uint64_t)PHILOX_M1 * bloco[2];
+        uint32_t x0 = (uint32_t)(p1 >> 32) ^ bloco[1] ^ chave0;
+        uint32_t x2 = (uint32_t)(p0 >> 32) ^ bloco[3] ^ chave1;
+        bloco[0] = x0;
+        bloco[1] = (uint32_t)p1;
+        bloco[2] = x2;
+        bloco[3] = (uint32_t)p0;
+        chave0 += PHILOX_W0;
+        chave1 += PHILOX_W1;
+    }
+}
+
+// Posiciona o fluxo no início do contador (semente, jogo, rodada)
+static inline void iniciar_fluxo(FluxoAleatorio *f, uint64_t semente, uint64_t jogo,
+                                 uint32_t rodada) {
+    f->chave[0] = (uint32_t)semente;
+    f->chave[1] = (uint32_t)(semente >> 32);
+    f->contador[0] = 0;
+    f->contador[1] = rodada;
+    f->contador[2] = (uint32_t)jogo;
+    f->contador[3] = (uint32_t)(jogo >> 32);
+    f->usados = 4;
+}
+
+// Próximo número de 32 bits do fluxo
+static inline uint32_t proximo_fluxo(FluxoAleatorio *f) {
+    if (f->usados == 4) {
+        for (int i = 0; i < 4; i++) {
+            f->bloco[i] = f->contador[i];
+        }
+        philox4x32(f->bloco, f->chave[0], f->chave[1]);
+        f->contador[0]++;
+        f->usados = 0;
+    }
+    return f->bloco[f->usados++];
+}
+
+// Sorteia um inteiro em [0, limite) sem viés (multiplicação com rejeição,
+// Lemire 2019: a divisão só acontece na faixa rara que seria enviesada)
+static inline uint32_t sortear_fluxo(FluxoAleatorio *f, uint32_t limite) {
+    uint64_t m = (uint64_t)proximo_fluxo(f) * limite;
+    uint32_t resto = (uint32_t)m;
+    if (resto < limite) {
+        uint32_t limiar = -limite % limite;
+        while (resto < limiar) {
+            m = (uint64_t)proximo_fluxo(f) * limite;
+            resto = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// Preenche 'indices' com 0..n-1 embaralhados (Fisher-Yates)
+static inline void embaralhar_fluxo(FluxoAleatorio *f, uint32_t *indices, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        indices[i] = (uint32_t)i;
+    }
+    for (size_t i = n; i > 1; i--) {
+        uint32_t j = sortear_fluxo(f, (uint32_t)i);
+        uint32_t t = indices[i - 1];
+        indices[i - 1] = indices[j];
+        indices[j] = t;
+    }
+}
+
+#endif
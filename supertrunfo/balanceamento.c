@@ -0,0 +1,415 @@
+/*
+ * Super Trunfo - Balanceamento de baralho
+ *
+ * Cada cadeia guarda a matriz de pontos entre pares (pontos[i * n + j] é a
+ * pontuação de i contra j somada nos atributos: vitória 2, empate 1) e o
+ * desvio inteiro de cada carta em relação à pontuação média. A energia é a
+ * soma dos quadrados dos desvios, proporcional à variância das taxas de
+ * vitória e exata em inteiros.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "balanceamento.h"
+#include "aleatorio.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Campos ajustáveis de cada carta
+#define CAMPOS_AJUSTAVEIS 4
+#define CAMPO_POPULACAO 0
+#define CAMPO_AREA 1
+#define CAMPO_PIB 2
+#define CAMPO_PONTOS_TURISTICOS 3
+
+// Pontuação máxima de um par (vitória em todos os atributos)
+#define PONTOS_POR_PAR (2 * NUM_ATRIBUTOS)
+
+// Propostas usadas para estimar a temperatura inicial
+#define PROPOSTAS_CALIBRACAO 256
+
+// Temperatura final em relação à inicial
+#define RESFRIAMENTO_TOTAL 1e-3
+
+// Estado de uma cadeia de recozimento
+typedef struct {
+    Carta *cartas;
+    float *ajustes;        // Logaritmo do fator de cada campo (n * CAMPOS_AJUSTAVEIS)
+    uint8_t *pontos;       // n * n
+    int32_t *desvios;      // Pontuação de cada carta menos a média
+    uint8_t *linha_nova;   // Linha candidata da carta alterada
+    int64_t energia;
+    long aceitas;
+    uint64_t estado;
+} Cadeia;
+
+// Estado compartilhado pelas threads
+typedef struct {
+    const Baralho *original;
+    const OpcoesBalanceamento *o;
+    Cadeia *cadeias;
+    size_t n;
+    double temperatura_inicial;
+    double razao_resfriamento;  // Multiplica a temperatura a cada proposta
+    long passos_por_epoca;
+    int melhor;                 // Cadeia com menor energia na última troca
+} ContextoBalanceamento;
+
+// Pontuação de 'a' contra 'b' somada em todos os atributos
+static int pontos_do_par(const Carta *a, const Carta *b) {
+    int pontos = 0;
+    for (int atributo = 1; atributo <= NUM_ATRIBUTOS; atributo++) {
+        int resultado = comparar_cartas(a, b, atributo);
+        pontos += resultado == 1 ? 2 : resultado == 0 ? 1 : 0;
+    }
+    return pontos;
+}
+
+// Multiplica um campo inteiro pelo fator, mantendo positivos os valores positivos
+static int ajustar_inteiro(int valor, float ajuste) {
+    double v = nearbyint((double)valor * exp((double)ajuste));
+    if (valor > 0 && v < 1) {
+        v = 1;
+    }
+    return v > INT_MAX ? INT_MAX : (int)v;
+}
+
+// Aplica os ajustes da carta sobre o original e recalcula os derivados
+static void aplicar_ajustes(const Carta *original, const float *ajuste, Carta *c) {
+    *c = *original;
+    c->populacao = ajustar_inteiro(original->populacao, ajuste[CAMPO_POPULACAO]);
+    c->area = original->area * expf(ajuste[CAMPO_AREA]);
+    c->pib = original->pib * expf(ajuste[CAMPO_PIB]);
+    c->pontos_turisticos = ajustar_inteiro(original->pontos_turisticos,
+                                           ajuste[CAMPO_PONTOS_TURISTICOS]);
+    calcular_atributos(c);
+}
+
+// Contexto da avaliação em lote
+typedef struct {
+    const Baralho *b;
+    int64_t *somas;
+} ContextoAvaliacao;
+
+// Soma os pontos das linhas da parte desta thread
+static void tarefa_avaliacao(void *contexto, int indice, int total) {
+    ContextoAvaliacao *c = contexto;
+    size_t n = c->b->quantidade;
+    size_t fim = inicio_da_parte(n, indice + 1, total);
+    for (size_t i = inicio_da_parte(n, indice, total); i < fim; i++) {
+        int64_t soma = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (j != i) {
+                soma += pontos_do_par(&c->b->cartas[i], &c->b->cartas[j]);
+            }
+        }
+        c->somas[i] = soma;
+    }
+}
+
+// Taxa de vitória de cada carta e variância das taxas
+double variancia_vitorias(const Baralho *b, int threads, double *taxas) {
+    RASTREAR_ESCOPO("avaliar_baralho");
+    size_t n = b->quantidade;
+    if (n < 2) {
+        return -1;
+    }
+    ContextoAvaliacao c = { b, malloc(n * sizeof(int64_t)) };
+    if (c.somas == NULL) {
+        return -1;
+    }
+    executar_em_paralelo(numero_de_threads(threads), tarefa_avaliacao, &c);
+
+    double maximo = (double)PONTOS_POR_PAR * (double)(n - 1);
+    double soma_quadrados = 0;
+    for (size_t i = 0; i < n; i++) {
+        double taxa = (double)c.somas[i] / maximo;
+        if (taxas != NULL) {
+            taxas[i] = taxa;
+        }
+        soma_quadrados += (taxa - 0.5) * (taxa - 0.5);
+    }
+    free(c.somas);
+    return soma_quadrados / (double)n;
+}
+
+// Variância das taxas de vitória correspondente a uma energia
+static double variancia_da_energia(int64_t energia, size_t n) {
+    double maximo = (double)PONTOS_POR_PAR * (double)(n - 1);
+    return (double)energia / (maximo * maximo) / (double)n;
+}
+
+// Semente do gerador da cadeia 'indice'
+static uint64_t semente_da_cadeia(uint64_t semente, uint64_t indice) {
+    uint64_t estado = semente ^ (indice * 0xD1B54A32D192ED03ULL);
+    return proximo_aleatorio(&estado);
+}
+
+// Aloca os vetores de uma cadeia; retorna 0 em sucesso, -1 sem memória
+static int alocar_cadeia(Cadeia *c, size_t n) {
+    c->cartas = malloc(n * sizeof(Carta));
+    c->ajustes = calloc(n * CAMPOS_AJUSTAVEIS, sizeof(float));
+    c->pontos = malloc(n * n);
+    c->desvios = malloc(n * sizeof(int32_t));
+    c->linha_nova = malloc(n);
+    return c->cartas && c->ajustes && c->pontos && c->desvios && c->linha_nova ? 0 : -1;
+}
+
+static void liberar_cadeia(Cadeia *c) {
+    free(c->cartas);
+    free(c->ajustes);
+    free(c->pontos);
+    free(c->desvios);
+    free(c->linha_nova);
+}
+
+// Copia o estado de 'origem' para 'destino' (o gerador e as contagens ficam)
+static void copiar_cadeia(Cadeia *destino, const Cadeia *origem, size_t n) {
+    memcpy(destino->cartas, origem->cartas, n * sizeof(Carta));
+    memcpy(destino->ajustes, origem->ajustes, n * CAMPOS_AJUSTAVEIS * sizeof(float));
+    memcpy(destino->pontos, origem->pontos, n * n);
+    memcpy(destino->desvios, origem->desvios, n * sizeof(int32_t));
+    destino->energia = origem->energia;
+}
+
+// Monta a matriz de pontos, os desvios e a energia do estado atual
+static void avaliar_cadeia(Cadeia *c, size_t n) {
+    int32_t media = (int32_t)(PONTOS_POR_PAR / 2 * (n - 1));
+    c->energia = 0;
+    for (size_t i = 0; i < n; i++) {
+        c->pontos[i * n + i] = 0;
+        for (size_t j = i + 1; j < n; j++) {
+            int p = pontos_do_par(&c->cartas[i], &c->cartas[j]);
+            c->pontos[i * n + j] = (uint8_t)p;
+            c->pontos[j * n + i] = (uint8_t)(PONTOS_POR_PAR - p);
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        int32_t soma = 0;
+        for (size_t j = 0; j < n; j++) {
+            soma += c->pontos[i * n + j];
+        }
+        c->desvios[i] = soma - media;
+        c->energia += (int64_t)c->desvios[i] * c->desvios[i];
+    }
+}
+
+// Proposta de mudança de um campo de uma carta
+typedef struct {
+    uint32_t carta;
+    uint32_t campo;
+    float ajuste;
+    Carta candidata;
+} Proposta;
+
+// Sorteia uma proposta e monta a carta candidata
+static void propor(Cadeia *c, const ContextoBalanceamento *ctx, Proposta *p) {
+    float limite = (float)log(ctx->o->fator_maximo);
+    p->carta = sortear(&c->estado, (uint32_t)ctx->n);
+    p->campo = sortear(&c->estado, CAMPOS_AJUSTAVEIS);
+    float ajuste[CAMPOS_AJUSTAVEIS];
+    memcpy(ajuste, &c->ajustes[(size_t)p->carta * CAMPOS_AJUSTAVEIS], sizeof(ajuste));
+
+    // Passo uniforme de até metade do intervalo permitido
+    float novo = ajuste[p->campo] + limite * (float)(sortear_real(&c->estado) - 0.5);
+    p->ajuste = novo > limite ? limite : novo < -limite ? -limite : novo;
+    ajuste[p->campo] = p->ajuste;
+    aplicar_ajustes(&ctx->original->cartas[p->carta], ajuste, &p->candidata);
+}
+
+// Variação de energia se a proposta for aceita (preenche linha_nova)
+static int64_t variacao_energia(Cadeia *c, size_t n, const Proposta *p) {
+    size_t k = p->carta;
+    const uint8_t *linha = &c->pontos[k * n];
+    int64_t variacao = 0;
+    int64_t soma = 0;
+    for (size_t j = 0; j < n; j++) {
+        if (j == k) {
+            c->linha_nova[j] = 0;
+            continue;
+        }
+        int pontos = pontos_do_par(&p->candidata, &c->cartas[j]);
+        int64_t d = pontos - linha[j];
+        c->linha_nova[j] = (uint8_t)pontos;
+        soma += d;
+        // O desvio de j muda em -d
+        variacao += d * d - 2 * (int64_t)c->desvios[j] * d;
+    }
+    int64_t dk = c->desvios[k];
+    return variacao + (dk + soma) * (dk + soma) - dk * dk;
+}
+
+// Aplica a proposta aceita
+static void aceitar(Cadeia *c, size_t n, const Proposta *p, int64_t variacao) {
+    size_t k = p->carta;
+    uint8_t *linha = &c->pontos[k * n];
+    int32_t soma = 0;
+    for (size_t j = 0; j < n; j++) {
+        if (j == k) {
+            continue;
+        }
+        int32_t d = (int32_t)c->linha_nova[j] - linha[j];
+        c->desvios[j] -= d;
+        soma += d;
+        linha[j] = c->linha_nova[j];
+        c->pontos[j * n + k] = (uint8_t)(PONTOS_POR_PAR - c->linha_nova[j]);
+    }
+    c->desvios[k] += soma;
+    c->energia += variacao;
+    c->cartas[k] = p->candidata;
+    c->ajustes[k * CAMPOS_AJUSTAVEIS + p->campo] = p->ajuste;
+    c->aceitas++;
+}
+
+// Roda 'passos' propostas, resfriando a partir de 'temperatura'
+static void recozer(Cadeia *c, const ContextoBalanceamento *ctx, long passos, double temperatura) {
+    Proposta p;
+    for (long passo = 0; passo < passos; passo++) {
+        propor(c, ctx, &p);
+        int64_t variacao = variacao_energia(c, ctx->n, &p);
+        if (variacao <= 0 || sortear_real(&c->estado) < exp(-(double)variacao / temperatura)) {
+            aceitar(c, ctx->n, &p, variacao);
+        }
+        temperatura *= ctx->razao_resfriamento;
+    }
+}
+
+// Laço de cada thread: recozimento das suas cadeias e troca do melhor estado
+static void tarefa_balanceamento(void *contexto, int indice, int total) {
+    ContextoBalanceamento *ctx = contexto;
+    nomear_thread_rastreio(indice == 0 ? "balanceamento principal" : "balanceamento");
+    int cadeias = ctx->o->cadeias;
+    int primeira = (int)inicio_da_parte((size_t)cadeias, indice, total);
+    int ultima = (int)inicio_da_parte((size_t)cadeias, indice + 1, total);
+
+    for (int epoca = 0; epoca < ctx->o->epocas; epoca++) {
+        // A temperatura depende só do passo global, não de quem roda a cadeia
+        double temperatura = ctx->temperatura_inicial *
+                             pow(ctx->razao_resfriamento, (double)epoca * ctx->passos_por_epoca);
+        {
+            RASTREAR_ESCOPO("epoca_de_recozimento");
+            for (int i = primeira; i < ultima; i++) {
+                recozer(&ctx->cadeias[i], ctx, ctx->passos_por_epoca, temperatura);
+            }
+        }
+        sincronizar_threads();
+
+        // Escolha determinística: menor energia, depois menor índice
+        if (indice == 0) {
+            int melhor = 0;
+            for (int i = 1; i < cadeias; i++) {
+                if (ctx->cadeias[i].energia < ctx->cadeias[melhor].energia) {
+                    melhor = i;
+                }
+            }
+            ctx->melhor = melhor;
+        }
+        sincronizar_threads();
+        for (int i = primeira; i < ultima; i++) {
+            if (i != ctx->melhor) {
+                copiar_cadeia(&ctx->cadeias[i], &ctx->cadeias[ctx->melhor], ctx->n);
+            }
+        }
+        sincronizar_threads();
+    }
+}
+
+// Média das pioras das propostas feitas a partir do estado inicial
+static double estimar_temperatura(Cadeia *c, const ContextoBalanceamento *ctx) {
+    Proposta p;
+    double soma = 0;
+    long pioras = 0;
+    for (int i = 0; i < PROPOSTAS_CALIBRACAO; i++) {
+        propor(c, ctx, &p);
+        int64_t variacao = variacao_energia(c, ctx->n, &p);
+        if (variacao > 0) {
+            soma += (double)variacao;
+            pioras++;
+        }
+    }
+    return pioras > 0 ? soma / (double)pioras : 1.0;
+}
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_balanceamento(OpcoesBalanceamento *o) {
+    o->passos = 200000;
+    o->cadeias = 8;
+    o->epocas = 20;
+    o->threads = 0;
+    o->fator_maximo = 1.5;
+    o->semente = 1;
+}
+
+// Balanceia o baralho 'original' e grava o resultado em 'balanceado'
+int balancear_baralho(const Baralho *original, const OpcoesBalanceamento *o,
+                      Baralho *balanceado, ResultadoBalanceamento *r) {
+    RASTREAR_ESCOPO("balancear_baralho");
+    size_t n = original->quantidade;
+    int cadeias = o->cadeias > 0 ? o->cadeias : 1;
+    int epocas = o->epocas > 0 ? o->epocas : 1;
+    if (n < 2 || o->fator_maximo < 1.0) {
+        return -1;
+    }
+
+    Cadeia *c = calloc((size_t)cadeias, sizeof(Cadeia));
+    if (c == NULL) {
+        return -1;
+    }
+    int status = 0;
+    for (int i = 0; i < cadeias && status == 0; i++) {
+        status = alocar_cadeia(&c[i], n);
+    }
+
+    OpcoesBalanceamento ajustadas = *o;
+    ajustadas.cadeias = cadeias;
+    ajustadas.epocas = epocas;
+    ContextoBalanceamento ctx = {
+        .original = original,
+        .o = &ajustadas,
+        .cadeias = c,
+        .n = n,
+        .passos_por_epoca = o->passos / epocas > 0 ? o->passos / epocas : 1,
+    };
+
+    if (status == 0) {
+        // Todas as cadeias partem do baralho original com geradores distintos
+        memcpy(c[0].cartas, original->cartas, n * sizeof(Carta));
+        avaliar_cadeia(&c[0], n);
+        for (int i = 0; i < cadeias; i++) {
+            if (i > 0) {
+                copiar_cadeia(&c[i], &c[0], n);
+            }
+            c[i].estado = semente_da_cadeia(o->semente, (uint64_t)i);
+        }
+        r->variancia_inicial = variancia_da_energia(c[0].energia, n);
+
+        // A calibração só lê o estado (linha_nova é rascunho) e tem gerador próprio
+        Cadeia calibracao = c[0];
+        calibracao.estado = semente_da_cadeia(o->semente, (uint64_t)cadeias);
+        ctx.temperatura_inicial = estimar_temperatura(&calibracao, &ctx);
+        ctx.razao_resfriamento =
+            pow(RESFRIAMENTO_TOTAL, 1.0 / ((double)ctx.passos_por_epoca * epocas));
+
+        executar_em_paralelo(numero_de_threads(o->threads), tarefa_balanceamento, &ctx);
+
+        const Cadeia *melhor = &c[ctx.melhor];
+        r->variancia_final = variancia_da_energia(melhor->energia, n);
+        r->propostas = ctx.passos_por_epoca * epocas * cadeias;
+        r->aceitas = 0;
+        for (int i = 0; i < cadeias; i++) {
+            r->aceitas += c[i].aceitas;
+        }
+        for (size_t i = 0; i < n && status == 0; i++) {
+            status = adicionar_carta(balanceado, &melhor->cartas[i]);
+        }
+    }
+
+    for (int i = 0; i < cadeias; i++) {
+        liberar_cadeia(&c[i]);
+    }
+    free(c);
+    return status;
+}
@@ -0,0 +1,59 @@
+/*
+ * Super Trunfo - Balanceamento de baralho
+ *
+ * Ajusta populacao, area, pib e pontos_turisticos de cada carta dentro de
+ * limites (um fator multiplicativo máximo sobre o valor original) para que
+ * nenhuma carta seja vitória garantida: o objetivo é a menor variância das
+ * taxas de vitória.
+ *
+ * A taxa de vitória de uma carta é a pontuação esperada num duelo contra
+ * cada outra carta do baralho com atributo sorteado (vitória 1, empate 1/2),
+ * calculada de forma exata sobre todos os pares e os NUM_ATRIBUTOS atributos.
+ *
+ * A busca é um recozimento simulado (simulated annealing) com várias
+ * cadeias em paralelo. Cada proposta muda um campo de uma carta e só
+ * reavalia a linha dessa carta (O(n) comparações). A cada época todas as
+ * cadeias recomeçam do melhor estado encontrado; com a semente e o número
+ * de cadeias fixos, o resultado não depende do número de threads.
+ */
+
+#ifndef SUPERTRUNFO_BALANCEAMENTO_H
+#define SUPERTRUNFO_BALANCEAMENTO_H
+
+#include <stdint.h>
+
+#include "baralho.h"
+
+// Opções do balanceamento
+typedef struct {
+    long passos;              // Propostas por cadeia (somando todas as épocas)
+    int cadeias;              // Cadeias de recozimento independentes
+    int epocas;               // Trocas do melhor estado entre as cadeias
+    int threads;              // 0 = um por núcleo
+    double fator_maximo;      // Cada campo fica entre original / fator e original * fator
+    uint64_t semente;
+} OpcoesBalanceamento;
+
+// Resultado do balanceamento
+typedef struct {
+    double variancia_inicial;
+    double variancia_final;
+    long propostas;           // Total de propostas avaliadas (todas as cadeias)
+    long aceitas;
+} ResultadoBalanceamento;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_balanceamento(OpcoesBalanceamento *o);
+
+// Taxa de vitória de cada carta contra o resto do baralho (avaliação exata
+// em lote, paralela por linhas); retorna a variância das taxas ou -1 em erro.
+// 'taxas' pode ser NULL.
+double variancia_vitorias(const Baralho *b, int threads, double *taxas);
+
+// Balanceia o baralho 'original' e grava o resultado em 'balanceado' (que
+// deve estar vazio); retorna 0 em sucesso, -1 se houver menos de 2 cartas
+// ou faltar memória
+int balancear_baralho(const Baralho *original, const OpcoesBalanceamento *o,
+                      Baralho *balanceado, ResultadoBalanceamento *r);
+
+#endif
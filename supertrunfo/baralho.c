@@ -0,0 +1,188 @@
+/*
+ * Super Trunfo - Baralho de cartas
+ *
+ * Vetor dinâmico de cartas e carga de baralhos a partir de arquivo texto.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "baralho.h"
+#include "metricas.h"
+#include "rastreio.h"
+
+// Número máximo de campos de uma linha de carta
+#define CAMPOS_CARTA 7
+
+// Inicializa um baralho vazio
+void iniciar_baralho(Baralho *b) {
+    b->cartas = NULL;
+    b->quantidade = 0;
+    b->capacidade = 0;
+}
+
+// Adiciona uma cópia da carta ao baralho; retorna 0 em sucesso, -1 sem memória
+int adicionar_carta(Baralho *b, const Carta *c) {
+    if (b->quantidade == b->capacidade) {
+        // Dobra a capacidade para manter a inserção amortizada em O(1)
+        size_t nova_capacidade = b->capacidade ? b->capacidade * 2 : 64;
+        Carta *novas = realloc(b->cartas, nova_capacidade * sizeof(Carta));
+        if (novas == NULL) {
+            return -1;
+        }
+        b->cartas = novas;
+        b->capacidade = nova_capacidade;
+    }
+    b->cartas[b->quantidade++] = *c;
+    return 0;
+}
+
+// Copia um campo de texto para o destino, verificando o tamanho máximo
+static int copiar_campo(char *destino, size_t tamanho, const char *inicio, size_t comprimento) {
+    if (comprimento == 0 || comprimento >= tamanho) {
+        return -1;
+    }
+    memcpy(destino, inicio, comprimento);
+    destino[comprimento] = '\0';
+    return 0;
+}
+
+// Interpreta os campos de uma linha, sem calcular os atributos derivados
+static int interpretar_campos_carta(const char *linha, Carta *c) {
+    const char *campos[CAMPOS_CARTA];
+    size_t comprimentos[CAMPOS_CARTA];
+    const char *p = linha;
+    int n = 0;
+
+    // Separa os campos por ';' sem copiar a linha
+    while (n < CAMPOS_CARTA) {
+        const char *fim = p;
+        while (*fim != ';' && *fim != '\n' && *fim != '\r' && *fim != '\0') {
+            fim++;
+        }
+        campos[n] = p;
+        comprimentos[n] = (size_t)(fim - p);
+        n++;
+        if (*fim != ';') {
+            break;
+        }
+        p = fim + 1;
+    }
+    if (n != CAMPOS_CARTA) {
+        return -1;
+    }
+
+    if (comprimentos[0] != 2 || copiar_campo(c->estado, sizeof(c->estado), campos[0], 2) != 0) {
+        return -1;
+    }
+    // Converte para maiúsculas
+    c->estado[0] = toupper((unsigned char)c->estado[0]);
+    c->estado[1] = toupper((unsigned char)c->estado[1]);
+
+    if (copiar_campo(c->codigo, sizeof(c->codigo), campos[1], comprimentos[1]) != 0 ||
+        copiar_campo(c->nome, sizeof(c->nome), campos[2], comprimentos[2]) != 0) {
+        return -1;
+    }
+
+    // Campos numéricos: mesmas regras de validação do cadastro interativo
+    char *fim;
+    long populacao = strtol(campos[3], &fim, 10);
+    if (fim == campos[3] || populacao < 0 || populacao > 2147483647L) return -1;
+    c->area = strtof(campos[4], &fim);
+    if (fim == campos[4] || !(c->area > 0)) return -1;
+    c->pib = strtof(campos[5], &fim);
+    if (fim == campos[5] || c->pib < 0) return -1;
+    long pontos = strtol(campos[6], &fim, 10);
+    if (fim == campos[6] || pontos < 0 || pontos > 2147483647L) return -1;
+
+    c->populacao = (int)populacao;
+    c->pontos_turisticos = (int)pontos;
+    return 0;
+}
+
+// Interpreta uma linha no formato do arquivo de baralho e calcula os atributos
+int interpretar_linha_carta(const char *linha, Carta *c) {
+    if (interpretar_campos_carta(linha, c) != 0) {
+        return -1;
+    }
+    calcular_atributos(c);
+    return 0;
+}
+
+// Lê o arquivo de baralho linha a linha
+static long ler_arquivo_baralho(Baralho *b, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return -1;
+    }
+
+    char linha[256];
+    long lidas = 0;
+    long numero_linha = 0;
+    size_t primeira = b->quantidade;
+    Carta carta;
+
+    // Primeiro interpreta todas as linhas, depois calcula os atributos em
+    // uma passada só (fases separadas também no rastreio)
+    {
+        RASTREAR_ESCOPO("interpretar_linhas");
+        while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+            numero_linha++;
+            if (linha[0] == '#' || linha[0] == '\n' || linha[0] == '\r') {
+                continue;
+            }
+            if (interpretar_campos_carta(linha, &carta) != 0) {
+                fprintf(stderr, "%s:%ld: linha de carta inválida, ignorada\n", caminho, numero_linha);
+                continue;
+            }
+            if (adicionar_carta(b, &carta) != 0) {
+                fclose(arquivo);
+                return -1;
+            }
+            lidas++;
+        }
+    }
+    fclose(arquivo);
+
+    {
+        RASTREAR_ESCOPO("calcular_atributos");
+        for (size_t i = primeira; i < b->quantidade; i++) {
+            calcular_atributos(&b->cartas[i]);
+        }
+    }
+    return lidas;
+}
+
+// Carrega as cartas do arquivo, acrescentando ao baralho
+long carregar_baralho(Baralho *b, const char *caminho) {
+    RASTREAR_ESCOPO("carregar_baralho");
+    uint64_t inicio = iniciar_medicao(METRICA_CARREGAR_BARALHO, AMOSTRAGEM_TOTAL);
+    long lidas = ler_arquivo_baralho(b, caminho);
+    finalizar_medicao(METRICA_CARREGAR_BARALHO, inicio);
+    return lidas;
+}
+
+// Grava o baralho no formato de arquivo
+int salvar_baralho(const Baralho *b, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    fprintf(arquivo, "# estado;codigo;nome;populacao;area;pib;pontos_turisticos\n");
+    for (size_t i = 0; i < b->quantidade; i++) {
+        const Carta *c = &b->cartas[i];
+        // %.9g preserva o float exatamente na releitura
+        fprintf(arquivo, "%s;%s;%s;%d;%.9g;%.9g;%d\n", c->estado, c->codigo, c->nome,
+                c->populacao, c->area, c->pib, c->pontos_turisticos);
+    }
+    int erro = ferror(arquivo);
+    return fclose(arquivo) == 0 && !erro ? 0 : -1;
+}
+
+// Libera a memória do baralho
+void liberar_baralho(Baralho *b) {
+    free(b->cartas);
+    iniciar_baralho(b);
+}
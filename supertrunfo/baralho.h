@@ -0,0 +1,46 @@
+/*
+ * Super Trunfo - Baralho de cartas
+ *
+ * Vetor dinâmico de cartas e carga de baralhos a partir de arquivo texto.
+ *
+ * Formato do arquivo (uma carta por linha, campos separados por ';'):
+ *   estado;codigo;nome;populacao;area;pib;pontos_turisticos
+ * Linhas vazias ou iniciadas por '#' são ignoradas, assim como campos depois
+ * do sétimo (ex.: a raridade gravada por raridade.h).
+ */
+
+#ifndef SUPERTRUNFO_BARALHO_H
+#define SUPERTRUNFO_BARALHO_H
+
+#include <stddef.h>
+
+#include "carta.h"
+
+// Estrutura para armazenar um baralho (vetor dinâmico de cartas)
+typedef struct {
+    Carta *cartas;
+    size_t quantidade;
+    size_t capacidade;
+} Baralho;
+
+// Inicializa um baralho vazio
+void iniciar_baralho(Baralho *b);
+
+// Adiciona uma cópia da carta ao baralho; retorna 0 em sucesso, -1 sem memória
+int adicionar_carta(Baralho *b, const Carta *c);
+
+// Interpreta uma linha no formato do arquivo de baralho e calcula os atributos;
+// retorna 0 em sucesso, -1 se a linha for inválida
+int interpretar_linha_carta(const char *linha, Carta *c);
+
+// Carrega as cartas do arquivo, acrescentando ao baralho;
+// retorna o número de cartas lidas ou -1 em erro
+long carregar_baralho(Baralho *b, const char *caminho);
+
+// Grava o baralho no formato de arquivo; retorna 0 em sucesso, -1 em erro
+int salvar_baralho(const Baralho *b, const char *caminho);
+
+// Libera a memória do baralho
+void liberar_baralho(Baralho *b);
+
+#endif
@@ -0,0 +1,467 @@
+/*
+ * Super Trunfo - Cadastro concorrente de cartas
+ *
+ * Os estados das vagas e o contador de publicadas usam ordem sequencial:
+ * um carregador marca as suas vagas e depois lê publicadas, e quem avança
+ * publicadas lê as vagas; com ordem mais fraca os dois poderiam não se ver
+ * e o contador pararia antes de uma vaga pronta.
+ */
+
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS e MAP_NORESERVE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "cadastro.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+// Hash FNV-1a do código
+static size_t hash_codigo(const char *codigo) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)codigo; *p; p++) {
+        h = (h ^ *p) * 1099511628211ULL;
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+// Região anônima zerada; as páginas só ocupam memória quando tocadas
+static void *mapear_regiao(size_t bytes) {
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static void desmapear_regiao(void *p, size_t bytes) {
+    if (p != NULL) {
+        munmap(p, bytes);
+    }
+}
+
+// Inicia o cadastro vazio
+int iniciar_cadastro(CadastroCartas *c, size_t capacidade) {
+    memset(c, 0, sizeof(*c));
+    if (capacidade == 0 || capacidade >= UINT32_MAX) {
+        return -1;
+    }
+    c->capacidade = capacidade;
+    c->tamanho_indice = 16;
+    while (c->tamanho_indice < 2 * capacidade) {
+        c->tamanho_indice *= 2;
+    }
+    c->cartas = mapear_regiao(capacidade * sizeof(Carta));
+    c->estados = mapear_regiao(capacidade * sizeof(atomic_uchar));
+    c->indice = mapear_regiao(c->tamanho_indice * sizeof(atomic_uint_least32_t));
+    if (c->cartas == NULL || c->estados == NULL || c->indice == NULL) {
+        liberar_cadastro(c);
+        return -1;
+    }
+    atomic_init(&c->reservadas, 0);
+    atomic_init(&c->publicadas, 0);
+    atomic_init(&c->repetidas, 0);
+    return 0;
+}
+
+// Inicia um lote vazio
+void iniciar_lote_cadastro(LoteCadastro *l, CadastroCartas *c) {
+    l->cadastro = c;
+    l->quantidade = 0;
+    l->inseridas = 0;
+    l->repetidas = 0;
+    l->descartadas = 0;
+}
+
+// Põe a vaga no índice; retorna 1 se entrou, 0 se o código já estava lá.
+// A tabela tem o dobro da capacidade, então sempre há posição livre
+static int indexar_vaga(CadastroCartas *c, size_t vaga) {
+    const char *codigo = c->cartas[vaga].codigo;
+    size_t mascara = c->tamanho_indice - 1;
+    uint_least32_t nova = (uint_least32_t)(vaga + 1);
+    for (size_t k = hash_codigo(codigo) & mascara;; k = (k + 1) & mascara) {
+        uint_least32_t atual = atomic_load_explicit(&c->indice[k], memory_order_acquire);
+        if (atual == 0) {
+            // A carta já está escrita: o release a entrega junto com a posição
+            if (atomic_compare_exchange_strong_explicit(&c->indice[k], &atual, nova,
+                                                        memory_order_release,
+                                                        memory_order_acquire)) {
+                return 1;
+            }
+            // Outra vaga ocupou a posição antes: compara com ela
+        }
+        if (strcmp(c->cartas[atual - 1].codigo, codigo) == 0) {
+            return 0;
+        }
+    }
+}
+
+// Avança publicadas até a primeira vaga ainda não pronta
+static void avancar_publicadas(CadastroCartas *c) {
+    size_t p = atomic_load(&c->publicadas);
+    for (;;) {
+        size_t q = p;
+        while (q < c->capacidade && atomic_load(&c->estados[q]) != VAGA_LIVRE) {
+            q++;
+        }
+        // Se outro carregador avançou no meio, recomeça de onde ele parou
+        if (q == p || atomic_compare_exchange_weak(&c->publicadas, &p, q)) {
+            return;
+        }
+    }
+}
+
+// Reserva as vagas, indexa e publica as cartas do lote
+int publicar_lote(LoteCadastro *l) {
+    CadastroCartas *c = l->cadastro;
+    size_t n = l->quantidade;
+    l->quantidade = 0;
+    if (n == 0) {
+        return 0;
+    }
+
+    // Uma operação atômica reserva o lote inteiro; o que passar da
+    // capacidade fica de fora
+    size_t inicio = atomic_fetch_add_explicit(&c->reservadas, n, memory_order_relaxed);
+    size_t cabem = inicio >= c->capacidade ? 0
+                 : n < c->capacidade - inicio ? n : c->capacidade - inicio;
+    if (cabem > 0) {
+        memcpy(&c->cartas[inicio], l->cartas, cabem * sizeof(Carta));
+    }
+
+    size_t repetidas = 0;
+    for (size_t i = 0; i < cabem; i++) {
+        if (!indexar_vaga(c, inicio + i)) {
+            atomic_store(&c->estados[inicio + i], VAGA_REPETIDA);
+            repetidas++;
+        } else {
+            atomic_store(&c->estados[inicio + i], VAGA_PRONTA);
+        }
+    }
+    if (repetidas > 0) {
+        atomic_fetch_add_explicit(&c->repetidas, repetidas, memory_order_relaxed);
+    }
+    l->inseridas += cabem - repetidas;
+    l->repetidas += repetidas;
+    l->descartadas += n - cabem;
+    if (cabem > 0) {
+        avancar_publicadas(c);
+    }
+    return cabem == n ? 0 : -1;
+}
+
+// Acrescenta a carta ao lote
+int adicionar_ao_lote(LoteCadastro *l, const Carta *carta) {
+    l->cartas[l->quantidade++] = *carta;
+    return l->quantidade == LOTE_CADASTRO ? publicar_lote(l) : 0;
+}
+
+// Vagas publicadas
+size_t cartas_publicadas(const CadastroCartas *c) {
+    return atomic_load_explicit(&c->publicadas, memory_order_acquire);
+}
+
+// Carta publicada da vaga ou NULL
+const Carta *carta_cadastro(const CadastroCartas *c, size_t vaga) {
+    if (vaga >= cartas_publicadas(c) ||
+        atomic_load_explicit(&c->estados[vaga], memory_order_relaxed) != VAGA_PRONTA) {
+        return NULL;
+    }
+    return &c->cartas[vaga];
+}
+
+// Carta publicada com o código ou NULL
+const Carta *buscar_carta_cadastro(const CadastroCartas *c, const char *codigo) {
+    size_t mascara = c->tamanho_indice - 1;
+    for (size_t k = hash_codigo(codigo) & mascara;; k = (k + 1) & mascara) {
+        uint_least32_t vaga = atomic_load_explicit(&c->indice[k], memory_order_acquire);
+        if (vaga == 0) {
+            return NULL;
+        }
+        if (strcmp(c->cartas[vaga - 1].codigo, codigo) == 0) {
+            // Indexada mas ainda fora do trecho publicado: não aparece
+            return vaga - 1 < cartas_publicadas(c) ? &c->cartas[vaga - 1] : NULL;
+        }
+    }
+}
+
+// Acrescenta ao baralho as cartas publicadas
+int copiar_cadastro(const CadastroCartas *c, Baralho *b) {
+    size_t n = cartas_publicadas(c);
+    for (size_t i = 0; i < n; i++) {
+        if (atomic_load_explicit(&c->estados[i], memory_order_relaxed) == VAGA_PRONTA &&
+            adicionar_carta(b, &c->cartas[i]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Libera o cadastro
+void liberar_cadastro(CadastroCartas *c) {
+    desmapear_regiao(c->cartas, c->capacidade * sizeof(Carta));
+    desmapear_regiao((void *)c->estados, c->capacidade * sizeof(atomic_uchar));
+    desmapear_regiao((void *)c->indice, c->tamanho_indice * sizeof(atomic_uint_least32_t));
+    memset(c, 0, sizeof(*c));
+}
+
+// Estado compartilhado de uma ingestão
+typedef struct {
+    CadastroCartas *cadastro;
+    int arquivos;
+    int *fds;
+    uint64_t *tamanhos;
+    uint64_t *primeiro_pedaco;     // Pedaços dos arquivos anteriores (arquivos + 1)
+    atomic_uint_least64_t proximo_contagem;
+    atomic_uint_least64_t proximo_carga;
+    atomic_int erro;
+    ResumoIngestao *parciais;      // Um por thread
+} ContextoIngestao;
+
+// Lê [inicio, inicio + tamanho) do arquivo, menos se o arquivo acabar antes;
+// retorna os bytes lidos ou -1 em erro
+static long ler_trecho(int fd, char *destino, size_t tamanho, uint64_t inicio) {
+    size_t lidos = 0;
+    while (lidos < tamanho) {
+        ssize_t r = pread(fd, destino + lidos, tamanho - lidos, (off_t)(inicio + lidos));
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) {
+            break;
+        }
+        lidos += (size_t)r;
+    }
+    return (long)lidos;
+}
+
+// Arquivo do pedaço global 'pedaco' (busca linear: são poucos arquivos)
+static int arquivo_do_pedaco(const ContextoIngestao *ctx, uint64_t pedaco) {
+    int f = 0;
+    while (ctx->primeiro_pedaco[f + 1] <= pedaco) {
+        f++;
+    }
+    return f;
+}
+
+// Interpreta uma linha completa (terminada em '\0') e põe a carta no lote
+static void ingerir_linha(LoteCadastro *l, ResumoIngestao *r, const char *linha,
+                          size_t comprimento) {
+    r->linhas++;
+    if (comprimento >= LINHA_MAXIMA_INGESTAO) {
+        r->invalidas++;
+        return;
+    }
+    if (linha[0] == '#' || linha[0] == '\0' || linha[0] == '\r') {
+        return;
+    }
+    Carta c;
+    if (interpretar_linha_carta(linha, &c) != 0) {
+        r->invalidas++;
+        return;
+    }
+    adicionar_ao_lote(l, &c);  // A capacidade cobre todas as linhas: não enche
+}
+
+// Interpreta as linhas que começam no pedaço [inicio, fim) do arquivo; o
+// buffer tem o pedaço, o byte anterior e até LINHA_MAXIMA_INGESTAO bytes depois
+static int ingerir_pedaco(ContextoIngestao *ctx, int f, uint64_t inicio, uint64_t fim,
+                          char *buffer, LoteCadastro *l, ResumoIngestao *r) {
+    uint64_t de = inicio > 0 ? inicio - 1 : 0;
+    uint64_t ate = fim + LINHA_MAXIMA_INGESTAO;
+    if (ate > ctx->tamanhos[f]) {
+        ate = ctx->tamanhos[f];
+    }
+    long lidos = ler_trecho(ctx->fds[f], buffer, (size_t)(ate - de), de);
+    if (lidos < 0) {
+        return -1;
+    }
+    char *p = buffer;
+    char *limite = buffer + lidos;
+    int no_fim = de + (uint64_t)lidos == ctx->tamanhos[f];
+
+    // Fora do primeiro pedaço, a primeira linha começa depois do primeiro
+    // '\n' a partir do byte anterior (a linha cortada é do pedaço anterior)
+    if (inicio > 0) {
+        char *quebra = memchr(p, '\n', (size_t)lidos);
+        if (quebra == NULL) {
+            return 0;
+        }
+        p = quebra + 1;
+    }
+
+    char *fim_pedaco = buffer + (fim - de);
+    while (p < fim_pedaco) {
+        char *quebra = memchr(p, '\n', (size_t)(limite - p));
+        if (quebra == NULL) {
+            // Última linha sem '\n' ou linha comprida demais para a janela
+            if (no_fim) {
+                *limite = '\0';
+                ingerir_linha(l, r, p, (size_t)(limite - p));
+            } else {
+                r->linhas++;
+                r->invalidas++;
+            }
+            break;
+        }
+        *quebra = '\0';
+        ingerir_linha(l, r, p, (size_t)(quebra - p));
+        p = quebra + 1;
+    }
+    return 0;
+}
+
+// Cada thread conta as quebras de linha de pedaços e, depois que a thread 0
+// cria o cadastro com essa capacidade, interpreta e insere outros pedaços
+static void tarefa_ingestao(void *contexto, int indice, int total) {
+    ContextoIngestao *ctx = contexto;
+    ResumoIngestao *r = &ctx->parciais[indice];
+    uint64_t pedacos = ctx->primeiro_pedaco[ctx->arquivos];
+    char *buffer = malloc(PEDACO_INGESTAO + LINHA_MAXIMA_INGESTAO + 2);
+    LoteCadastro *l = malloc(sizeof(LoteCadastro));
+    if (buffer == NULL || l == NULL) {
+        atomic_store(&ctx->erro, 1);
+    }
+
+    // Fase 1: contagem de linhas, que limita o número de cartas
+    {
+        RASTREAR_ESCOPO("contar_linhas_ingestao");
+        for (;;) {
+            uint64_t pedaco = atomic_fetch_add(&ctx->proximo_contagem, 1);
+            if (pedaco >= pedacos || atomic_load_explicit(&ctx->erro, memory_order_relaxed)) {
+                break;
+            }
+            int f = arquivo_do_pedaco(ctx, pedaco);
+            uint64_t inicio = (pedaco - ctx->primeiro_pedaco[f]) * PEDACO_INGESTAO;
+            uint64_t fim = inicio + PEDACO_INGESTAO;
+            fim = fim < ctx->tamanhos[f] ? fim : ctx->tamanhos[f];
+            long lidos = ler_trecho(ctx->fds[f], buffer, (size_t)(fim - inicio), inicio);
+            if (lidos != (long)(fim - inicio)) {
+                atomic_store(&ctx->erro, 1);
+                break;
+            }
+            for (const char *p = buffer; (p = memchr(p, '\n', (size_t)(buffer + lidos - p)));
+                 p++) {
+                r->linhas++;
+            }
+        }
+    }
+    sincronizar_threads();
+
+    if (indice == 0 && !atomic_load(&ctx->erro)) {
+        // Mais uma linha por arquivo: a última pode não ter '\n'
+        uint64_t linhas = (uint64_t)ctx->arquivos;
+        for (int t = 0; t < total; t++) {
+            linhas += ctx->parciais[t].linhas;
+        }
+        if (linhas >= UINT32_MAX || iniciar_cadastro(ctx->cadastro, (size_t)linhas) != 0) {
+            atomic_store(&ctx->erro, 1);
+        }
+    }
+    sincronizar_threads();
+    r->linhas = 0;
+
+    // Fase 2: interpretação e inserção
+    if (!atomic_load(&ctx->erro)) {
+        RASTREAR_ESCOPO("ingerir_pedacos");
+        iniciar_lote_cadastro(l, ctx->cadastro);
+        for (;;) {
+            uint64_t pedaco = atomic_fetch_add(&ctx->proximo_carga, 1);
+            if (pedaco >= pedacos || atomic_load_explicit(&ctx->erro, memory_order_relaxed)) {
+                break;
+            }
+            int f = arquivo_do_pedaco(ctx, pedaco);
+            uint64_t inicio = (pedaco - ctx->primeiro_pedaco[f]) * PEDACO_INGESTAO;
+            uint64_t fim = inicio + PEDACO_INGESTAO;
+            fim = fim < ctx->tamanhos[f] ? fim : ctx->tamanhos[f];
+            r->bytes += fim - inicio;
+            if (ingerir_pedaco(ctx, f, inicio, fim, buffer, l, r) != 0) {
+                atomic_store(&ctx->erro, 1);
+                break;
+            }
+        }
+        publicar_lote(l);
+        r->cartas = l->inseridas;
+        r->repetidas = l->repetidas;
+    }
+    free(buffer);
+    free(l);
+}
+
+// Carrega os arquivos em paralelo num cadastro novo
+int ingerir_arquivos(CadastroCartas *c, const char *const *caminhos, int arquivos,
+                     int threads, ResumoIngestao *r) {
+    RASTREAR_ESCOPO("ingerir_arquivos");
+    memset(r, 0, sizeof(*r));
+    memset(c, 0, sizeof(*c));
+    r->arquivos = arquivos;
+    threads = numero_de_threads(threads);
+
+    ContextoIngestao ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cadastro = c;
+    ctx.arquivos = arquivos;
+    ctx.fds = malloc((size_t)arquivos * sizeof(int));
+    ctx.tamanhos = malloc((size_t)arquivos * sizeof(uint64_t));
+    ctx.primeiro_pedaco = malloc(((size_t)arquivos + 1) * sizeof(uint64_t));
+    ctx.parciais = calloc((size_t)threads, sizeof(ResumoIngestao));
+    int abertos = 0;
+    int erro = ctx.fds == NULL || ctx.tamanhos == NULL || ctx.primeiro_pedaco == NULL ||
+               ctx.parciais == NULL;
+
+    // Tamanhos e numeração global dos pedaços
+    for (int f = 0; f < arquivos && !erro; f++) {
+        struct stat st;
+        ctx.fds[f] = open(caminhos[f], O_RDONLY);
+        if (ctx.fds[f] < 0) {
+            erro = 1;
+            break;
+        }
+        abertos++;
+        if (fstat(ctx.fds[f], &st) != 0) {
+            erro = 1;
+            break;
+        }
+        ctx.tamanhos[f] = (uint64_t)st.st_size;
+        r->bytes += ctx.tamanhos[f];
+    }
+    if (!erro) {
+        ctx.primeiro_pedaco[0] = 0;
+        for (int f = 0; f < arquivos; f++) {
+            ctx.primeiro_pedaco[f + 1] = ctx.primeiro_pedaco[f] +
+                (ctx.tamanhos[f] + PEDACO_INGESTAO - 1) / PEDACO_INGESTAO;
+        }
+        atomic_init(&ctx.proximo_contagem, 0);
+        atomic_init(&ctx.proximo_carga, 0);
+        atomic_init(&ctx.erro, 0);
+        r->threads = executar_em_paralelo(threads, tarefa_ingestao, &ctx);
+        erro = atomic_load(&ctx.erro);
+    }
+
+    if (!erro) {
+        for (int t = 0; t < r->threads; t++) {
+            r->linhas += ctx.parciais[t].linhas;
+            r->cartas += ctx.parciais[t].cartas;
+            r->repetidas += ctx.parciais[t].repetidas;
+            r->invalidas += ctx.parciais[t].invalidas;
+        }
+    } else if (c->cartas != NULL) {
+        liberar_cadastro(c);
+    }
+    for (int f = 0; f < abertos; f++) {
+        close(ctx.fds[f]);
+    }
+    free(ctx.fds);
+    free(ctx.tamanhos);
+    free(ctx.primeiro_pedaco);
+    free(ctx.parciais);
+    return erro ? -1 : 0;
+}
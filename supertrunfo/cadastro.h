@@ -0,0 +1,120 @@
+/*
+ * Super Trunfo - Cadastro concorrente de cartas
+ *
+ * Várias threads de carga inserem no mesmo cadastro ao mesmo tempo, sem
+ * trava global, enquanto outras leem:
+ *
+ *   - reserva de vagas: cada carregador junta LOTE_CADASTRO cartas num lote
+ *     local e reserva as vagas do lote inteiro com um único fetch_add no
+ *     contador de reservadas (sem espera, uma operação atômica por lote);
+ *   - índice por código: tabela de endereçamento aberto com vaga + 1 em cada
+ *     posição, preenchida por compare-and-swap. A carta é escrita na vaga
+ *     antes do CAS (release), então quem acha a posição no índice (acquire)
+ *     sempre lê a carta inteira. Um código que já está no índice marca a
+ *     vaga como repetida: vale a primeira carta indexada (com várias threads,
+ *     qual delas entra primeiro depende da ordem de chegada);
+ *   - publicação em lote: depois de indexar o lote, o carregador marca as
+ *     vagas como prontas e avança o contador de publicadas até a primeira
+ *     vaga ainda não pronta. Os leitores só enxergam vagas abaixo de
+ *     publicadas, que estão escritas e com o estado final: nunca uma carta
+ *     pela metade.
+ *
+ * A capacidade é fixa e as regiões são mapeadas sem reserva de memória (só
+ * as páginas usadas ocupam memória). O índice guarda posições de 32 bits,
+ * então a capacidade vai até UINT32_MAX - 1 cartas.
+ *
+ * ingerir_arquivos usa o cadastro para carregar vários arquivos de baralho
+ * em paralelo: os arquivos são divididos em pedaços de PEDACO_INGESTAO
+ * bytes, distribuídos entre as threads por um contador atômico, e cada
+ * linha pertence ao pedaço em que começa.
+ */
+
+#ifndef SUPERTRUNFO_CADASTRO_H
+#define SUPERTRUNFO_CADASTRO_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+#define LOTE_CADASTRO 256
+#define PEDACO_INGESTAO (1 << 20)
+#define LINHA_MAXIMA_INGESTAO 256
+
+// Estado de uma vaga
+#define VAGA_LIVRE 0
+#define VAGA_PRONTA 1
+#define VAGA_REPETIDA 2    // Código já cadastrado: a carta não vale
+
+// Cadastro concorrente (contadores disputados em linhas de cache próprias)
+typedef struct {
+    Carta *cartas;
+    atomic_uchar *estados;
+    atomic_uint_least32_t *indice;          // Código -> vaga + 1 (0 = livre)
+    size_t capacidade;
+    size_t tamanho_indice;                  // Potência de 2, pelo menos 2 * capacidade
+    _Alignas(64) atomic_size_t reservadas;  // Pode passar da capacidade
+    _Alignas(64) atomic_size_t publicadas;
+    _Alignas(64) atomic_size_t repetidas;
+} CadastroCartas;
+
+// Lote local de um carregador (não é compartilhado entre threads)
+typedef struct {
+    CadastroCartas *cadastro;
+    size_t quantidade;
+    uint64_t inseridas;
+    uint64_t repetidas;
+    uint64_t descartadas;                   // Sem vaga: cadastro cheio
+    Carta cartas[LOTE_CADASTRO];
+} LoteCadastro;
+
+// Resumo de uma ingestão
+typedef struct {
+    int arquivos;
+    int threads;
+    uint64_t bytes;
+    uint64_t linhas;
+    uint64_t cartas;
+    uint64_t repetidas;
+    uint64_t invalidas;
+} ResumoIngestao;
+
+// Inicia o cadastro vazio com a capacidade dada; retorna 0 em sucesso, -1
+// se faltar memória ou a capacidade for 0 ou passar de UINT32_MAX - 1
+int iniciar_cadastro(CadastroCartas *c, size_t capacidade);
+
+// Inicia um lote vazio do cadastro
+void iniciar_lote_cadastro(LoteCadastro *l, CadastroCartas *c);
+
+// Acrescenta a carta (com os atributos calculados) ao lote e publica o lote
+// quando ele enche; retorna 0 em sucesso, -1 se o cadastro encheu
+int adicionar_ao_lote(LoteCadastro *l, const Carta *carta);
+
+// Reserva as vagas, indexa e publica as cartas do lote; retorna 0 em
+// sucesso, -1 se o cadastro encheu (as cartas que couberam são publicadas)
+int publicar_lote(LoteCadastro *l);
+
+// Vagas publicadas: as cartas [0, publicadas) podem ser lidas
+size_t cartas_publicadas(const CadastroCartas *c);
+
+// Carta publicada da vaga ou NULL (vaga não publicada ou código repetido)
+const Carta *carta_cadastro(const CadastroCartas *c, size_t vaga);
+
+// Carta publicada com o código ou NULL
+const Carta *buscar_carta_cadastro(const CadastroCartas *c, const char *codigo);
+
+// Acrescenta ao baralho as cartas publicadas, na ordem das vagas, sem as
+// repetidas; retorna 0 em sucesso, -1 sem memória
+int copiar_cadastro(const CadastroCartas *c, Baralho *b);
+
+// Libera o cadastro (sem carregadores nem leitores ativos)
+void liberar_cadastro(CadastroCartas *c);
+
+// Carrega os arquivos em paralelo num cadastro novo, com capacidade para
+// todas as linhas deles; retorna 0 em sucesso, -1 se algum arquivo não abrir
+// ou a leitura falhar, ou faltar memória (o cadastro fica liberado)
+int ingerir_arquivos(CadastroCartas *c, const char *const *caminhos, int arquivos,
+                     int threads, ResumoIngestao *r);
+
+#endif
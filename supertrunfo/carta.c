@@ -0,0 +1,170 @@
+/*
+ * Super Trunfo - Núcleo de regras das cartas
+ *
+ * Implementação única das regras usadas pelos modos Novato, Aventureiro,
+ * Mestre e pelo simulador.
+ */
+
+#include "carta.h"
+#include "metricas.h"
+
+// Calcula densidade populacional e PIB per capita
+void calcular_atributos(Carta *carta) {
+    // Calcula densidade se área > 0
+    if (carta->area > 0) {
+        // População dividida pela área para obter hab/km²
+        carta->densidade = (float)carta->populacao / carta->area;
+    } else {
+        carta->densidade = -1;  // Indica erro: área inválida
+    }
+
+    // Calcula PIB per capita se população > 0
+    if (carta->populacao > 0) {
+        // Converte PIB de milhões para reais antes de dividir pela população
+        // PIB * 1.000.000 (para converter milhões em reais)
+        carta->pib_per_capita = (carta->pib * 1000000.0f) / carta->populacao;
+    } else {
+        carta->pib_per_capita = -1;  // Indica erro: população inválida
+    }
+}
+
+// Regra de comparação de um atributo (sem instrumentação)
+static inline int comparar_atributo(const Carta *carta1, const Carta *carta2, int atributo) {
+    float valor1, valor2;
+    int menor_vence = 0;
+
+    // Define qual atributo será comparado
+    switch (atributo) {
+        case 1:  // População
+            valor1 = carta1->populacao;
+            valor2 = carta2->populacao;
+            break;
+        case 2:  // Área
+            valor1 = carta1->area;
+            valor2 = carta2->area;
+            break;
+        case 3:  // PIB
+            valor1 = carta1->pib;
+            valor2 = carta2->pib;
+            break;
+        case 4:  // Densidade populacional (menor vence)
+            valor1 = carta1->densidade;
+            valor2 = carta2->densidade;
+            menor_vence = 1;
+            break;
+        case 5:  // PIB per capita
+            valor1 = carta1->pib_per_capita;
+            valor2 = carta2->pib_per_capita;
+            break;
+        case 6:  // Pontos turísticos
+            valor1 = carta1->pontos_turisticos;
+            valor2 = carta2->pontos_turisticos;
+            break;
+        default:
+            return 0;  // Atributo inválido = empate
+    }
+
+    // Verifica valores inválidos (negativos indicam erro)
+    if (valor1 < 0 || valor2 < 0) {
+        return 0;  // Empate se algum valor é inválido
+    }
+
+    // Compara os valores
+    if (valor1 == valor2) {
+        return 0;  // Empate
+    }
+
+    if (menor_vence) {
+        return (valor1 < valor2) ? 1 : 2;  // Menor vence
+    } else {
+        return (valor1 > valor2) ? 1 : 2;  // Maior vence
+    }
+}
+
+// Compara duas cartas e retorna 1 se carta1 vence, 2 se carta2 vence, 0 se empate
+int comparar_cartas(const Carta *carta1, const Carta *carta2, int atributo) {
+    uint64_t inicio = iniciar_medicao(METRICA_COMPARAR_CARTAS, AMOSTRAGEM_QUENTE);
+    int resultado = comparar_atributo(carta1, carta2, atributo);
+    finalizar_medicao(METRICA_COMPARAR_CARTAS, inicio);
+    return resultado;
+}
+
+// Regras da comparação avançada (sem instrumentação)
+static inline int aplicar_regras_avancadas(const Carta *c1, const Carta *c2) {
+    // Se uma cidade tem mais que o dobro da população da outra e maior PIB
+    if (c1->populacao > 2 * c2->populacao && c1->pib > c2->pib) {
+        return 1;  // Carta 1 vence
+    }
+    if (c2->populacao > 2 * c1->populacao && c2->pib > c1->pib) {
+        return 2;  // Carta 2 vence
+    }
+
+    // Se uma cidade tem maior PIB per capita e mais pontos turísticos
+    if (c1->pib_per_capita > c2->pib_per_capita && c1->pontos_turisticos > c2->pontos_turisticos) {
+        return 1;  // Carta 1 vence
+    }
+    if (c2->pib_per_capita > c1->pib_per_capita && c2->pontos_turisticos > c1->pontos_turisticos) {
+        return 2;  // Carta 2 vence
+    }
+
+    // Se uma cidade tem menor densidade populacional mas mais pontos turísticos
+    if (c1->densidade < c2->densidade && c1->pontos_turisticos > c2->pontos_turisticos) {
+        return 1;  // Carta 1 vence (melhor qualidade de vida)
+    }
+    if (c2->densidade < c1->densidade && c2->pontos_turisticos > c1->pontos_turisticos) {
+        return 2;  // Carta 2 vence (melhor qualidade de vida)
+    }
+
+    return 0;  // Empate se nenhuma condição for atendida
+}
+
+// Função para realizar comparação avançada
+int comparacao_avancada(const Carta *c1, const Carta *c2) {
+    uint64_t inicio = iniciar_medicao(METRICA_COMPARACAO_AVANCADA, AMOSTRAGEM_QUENTE);
+    int resultado = aplicar_regras_avancadas(c1, c2);
+    finalizar_medicao(METRICA_COMPARACAO_AVANCADA, inicio);
+    return resultado;
+}
+
+// Função para obter o valor de um atributo específico
+float obter_valor_atributo(const Carta *carta, int atributo) {
+    switch (atributo) {
+        case 1: return (float)carta->populacao;
+        case 2: return carta->area;
+        case 3: return carta->pib;
+        case 4: return carta->densidade;
+        case 5: return carta->pib_per_capita;
+        case 6: return (float)carta->pontos_turisticos;
+        default: return 0.0f;
+    }
+}
+
+// Soma normalizada de dois atributos (inverte densidade, onde menor é melhor)
+static float soma_normalizada(const Carta *c, int atrib1, int atrib2) {
+    float valor1 = obter_valor_atributo(c, atrib1);
+    float valor2 = obter_valor_atributo(c, atrib2);
+    return (atrib1 == 4 ? -valor1 : valor1) + (atrib2 == 4 ? -valor2 : valor2);
+}
+
+// Compara a soma normalizada de dois atributos; mesmo retorno de comparar_cartas
+int resultado_dois_atributos(const Carta *c1, const Carta *c2, int atrib1, int atrib2) {
+    uint64_t inicio = iniciar_medicao(METRICA_DOIS_ATRIBUTOS, AMOSTRAGEM_QUENTE);
+    float soma_c1 = soma_normalizada(c1, atrib1, atrib2);
+    float soma_c2 = soma_normalizada(c2, atrib1, atrib2);
+    int resultado = soma_c1 == soma_c2 ? 0 : soma_c1 > soma_c2 ? 1 : 2;
+    finalizar_medicao(METRICA_DOIS_ATRIBUTOS, inicio);
+    return resultado;
+}
+
+// Retorna o nome do atributo sendo comparado
+const char *nome_atributo(int atributo) {
+    switch (atributo) {
+        case 1: return "População";
+        case 2: return "Área";
+        case 3: return "PIB";
+        case 4: return "Densidade Populacional";
+        case 5: return "PIB per capita";
+        case 6: return "Pontos Turísticos";
+        default: return "Atributo desconhecido";
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Super Trunfo - Núcleo de regras das cartas
+ *
+ * Estrutura Carta, cálculo dos atributos derivados e as regras de comparação
+ * compartilhadas por todos os modos do jogo.
+ */
+
+#ifndef SUPERTRUNFO_CARTA_H
+#define SUPERTRUNFO_CARTA_H
+
+// Constantes para o menu / atributos de comparação
+#define COMPARAR_POPULACAO 1
+#define COMPARAR_AREA 2
+#define COMPARAR_PIB 3
+#define COMPARAR_DENSIDADE 4
+#define COMPARAR_PIB_CAPITA 5
+#define COMPARAR_PONTOS_TURISTICOS 6
+#define COMPARAR_TUDO 7
+#define COMPARAR_AVANCADO 8
+#define COMPARAR_DOIS_ATRIBUTOS 9
+#define SAIR 0
+
+// Quantidade de atributos comparáveis (1 a 6)
+#define NUM_ATRIBUTOS 6
+
+// Estrutura para armazenar os dados de uma carta
+typedef struct {
+    char estado[3];      // Sigla do estado (2 caracteres + '\0')
+    char codigo[11];     // Código da carta (10 caracteres + '\0')
+    char nome[50];       // Nome da cidade
+    int populacao;       // Número de habitantes
+    float area;          // Área em km²
+    float pib;           // PIB em milhões de reais
+    int pontos_turisticos;
+    float densidade;     // Calculado: população/área
+    float pib_per_capita; // Calculado: PIB/população
+} Carta;
+
+/*
+ * Atributos disponíveis para comparação:
+ * 1 = População (maior vence)
+ * 2 = Área (maior vence)
+ * 3 = PIB (maior vence)
+ * 4 = Densidade populacional (menor vence)
+ * 5 = PIB per capita (maior vence)
+ * 6 = Pontos turísticos (maior vence)
+ */
+
+// Calcula densidade populacional e PIB per capita
+void calcular_atributos(Carta *carta);
+
+// Compara duas cartas e retorna 1 se carta1 vence, 2 se carta2 vence, 0 se empate
+int comparar_cartas(const Carta *carta1, const Carta *carta2, int atributo);
+
+// Comparação avançada (população x PIB, desenvolvimento, qualidade de vida)
+int comparacao_avancada(const Carta *c1, const Carta *c2);
+
+// Compara a soma normalizada de dois atributos; mesmo retorno de comparar_cartas
+int resultado_dois_atributos(const Carta *c1, const Carta *c2, int atrib1, int atrib2);
+
+// Retorna o valor numérico de um atributo (1 a 6)
+float obter_valor_atributo(const Carta *carta, int atributo);
+
+// Retorna o nome do atributo sendo comparado
+const char *nome_atributo(int atributo);
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Super Trunfo - Baralho em memória compartilhada
+ *
+ * O segmento é montado num único mmap de escrita e fechado; quem anexa
+ * mapeia o mesmo objeto com PROT_READ e confere cabeçalho e limites de
+ * todos os deslocamentos antes de usar qualquer um.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "compartilhado.h"
+#include "rastreio.h"
+
+static const char MAGICA_COMPARTILHADO[8] = { 'S', 'T', 'S', 'H', 'M', 0, 0, 1 };
+
+// Alinhamento de cada região do segmento (linha de cache)
+#define ALINHAMENTO_REGIAO 64
+
+static uint64_t alinhar(uint64_t x) {
+    return (x + ALINHAMENTO_REGIAO - 1) & ~(uint64_t)(ALINHAMENTO_REGIAO - 1);
+}
+
+// Hash FNV-1a do código
+static size_t hash_codigo(const char *codigo) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)codigo; *p; p++) {
+        h = (h ^ *p) * 1099511628211ULL;
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+// Publica o baralho e os índices no segmento
+long publicar_baralho_compartilhado(const char *nome, const Baralho *b, int threads) {
+    RASTREAR_ESCOPO("publicar_compartilhado");
+    IndiceBaralho ind;
+    if (construir_indice_baralho(&ind, b, threads) != 0) {
+        return -1;
+    }
+
+    // Layout: cabeçalho, cartas, hash e índices, cada um alinhado
+    CabecalhoCompartilhado cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_COMPARTILHADO, sizeof(cab.magica));
+    cab.tamanho_carta = sizeof(Carta);
+    cab.quantidade = b->quantidade;
+    cab.tamanho_hash = 16;
+    while (cab.tamanho_hash < 2 * b->quantidade) {
+        cab.tamanho_hash *= 2;
+    }
+    uint64_t fim = alinhar(sizeof(cab));
+    cab.deslocamento_cartas = fim;
+    fim = alinhar(fim + b->quantidade * sizeof(Carta));
+    cab.deslocamento_hash = fim;
+    fim = alinhar(fim + cab.tamanho_hash * sizeof(uint32_t));
+    for (int a = 0; a <= NUM_ATRIBUTOS; a++) {
+        cab.deslocamento_indices[a] = fim;
+        cab.validos[a] = ind.validos[a];
+        fim = alinhar(fim + ind.validos[a] * sizeof(EntradaIndice));
+    }
+    cab.tamanho = fim;
+
+    // Um segmento novo; quem anexou o antigo continua com ele
+    shm_unlink(nome);
+    int fd = shm_open(nome, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        liberar_indice_baralho(&ind);
+        return -1;
+    }
+    unsigned char *base = MAP_FAILED;
+    if (ftruncate(fd, (off_t)cab.tamanho) == 0) {
+        base = mmap(NULL, cab.tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(nome);
+        liberar_indice_baralho(&ind);
+        return -1;
+    }
+
+    memcpy(base + cab.deslocamento_cartas, b->cartas, b->quantidade * sizeof(Carta));
+    uint32_t *hash = (uint32_t *)(base + cab.deslocamento_hash);
+    size_t mascara = cab.tamanho_hash - 1;
+    for (size_t i = 0; i < b->quantidade; i++) {
+        size_t k = hash_codigo(b->cartas[i].codigo) & mascara;
+        while (hash[k] != 0 && strcmp(b->cartas[hash[k] - 1].codigo, b->cartas[i].codigo) != 0) {
+            k = (k + 1) & mascara;
+        }
+        if (hash[k] == 0) {
+            hash[k] = (uint32_t)(i + 1);  // Código repetido: vale a primeira carta
+        }
+    }
+    for (int a = 0; a <= NUM_ATRIBUTOS; a++) {
+        memcpy(base + cab.deslocamento_indices[a], ind.ordenados[a],
+               ind.validos[a] * sizeof(EntradaIndice));
+    }
+    liberar_indice_baralho(&ind);
+
+    // O cabeçalho pronto por último: quem anexar antes vê pronto = 0
+    memcpy(base, &cab, sizeof(cab));
+    __atomic_store_n(&((CabecalhoCompartilhado *)base)->pronto, 1, __ATOMIC_RELEASE);
+    munmap(base, cab.tamanho);
+    return (long)cab.tamanho;
+}
+
+// Confere que a região [deslocamento, deslocamento + bytes) cabe no segmento
+static int regiao_valida(uint64_t deslocamento, uint64_t quantidade, size_t elemento,
+                         size_t tamanho) {
+    return deslocamento <= tamanho && quantidade <= (tamanho - deslocamento) / elemento;
+}
+
+// Anexa o segmento somente leitura
+int anexar_baralho_compartilhado(BaralhoCompartilhado *c, const char *nome) {
+    memset(c, 0, sizeof(*c));
+    int fd = shm_open(nome, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(CabecalhoCompartilhado)) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+
+    const CabecalhoCompartilhado *cab = base;
+    size_t tamanho = (size_t)st.st_size;
+    int valido = __atomic_load_n(&cab->pronto, __ATOMIC_ACQUIRE) == 1
+                 && memcmp(cab->magica, MAGICA_COMPARTILHADO, sizeof(cab->magica)) == 0
+                 && cab->tamanho_carta == sizeof(Carta) && cab->tamanho == tamanho
+                 && cab->quantidade < UINT32_MAX
+                 && regiao_valida(cab->deslocamento_cartas, cab->quantidade, sizeof(Carta), tamanho)
+                 && cab->tamanho_hash > 0 && (cab->tamanho_hash & (cab->tamanho_hash - 1)) == 0
+                 && regiao_valida(cab->deslocamento_hash, cab->tamanho_hash, sizeof(uint32_t),
+                                  tamanho);
+    for (int a = 0; a <= NUM_ATRIBUTOS && valido; a++) {
+        valido = cab->validos[a] <= cab->quantidade
+                 && regiao_valida(cab->deslocamento_indices[a], cab->validos[a],
+                                  sizeof(EntradaIndice), tamanho);
+    }
+    if (!valido) {
+        munmap(base, tamanho);
+        return -1;
+    }
+
+    c->base = base;
+    c->tamanho = tamanho;
+    c->cabecalho = cab;
+    c->cartas = (const Carta *)(c->base + cab->deslocamento_cartas);
+    c->quantidade = cab->quantidade;
+    return 0;
+}
+
+// Carta com o código ou NULL
+const Carta *buscar_carta_compartilhada(const BaralhoCompartilhado *c, const char *codigo) {
+    const uint32_t *hash = (const uint32_t *)(c->base + c->cabecalho->deslocamento_hash);
+    size_t mascara = c->cabecalho->tamanho_hash - 1;
+    for (size_t k = hash_codigo(codigo) & mascara; hash[k] != 0; k = (k + 1) & mascara) {
+        if (hash[k] <= c->quantidade && strcmp(c->cartas[hash[k] - 1].codigo, codigo) == 0) {
+            return &c->cartas[hash[k] - 1];
+        }
+    }
+    return NULL;
+}
+
+// Visão do segmento como Baralho (somente leitura)
+void visao_baralho_compartilhado(const BaralhoCompartilhado *c, Baralho *b) {
+    b->cartas = (Carta *)c->cartas;
+    b->quantidade = c->quantidade;
+    b->capacidade = c->quantidade;
+}
+
+// Visão dos índices do segmento como IndiceBaralho (somente leitura)
+void visao_indice_compartilhado(const BaralhoCompartilhado *c, const Baralho *visao,
+                                IndiceBaralho *ind) {
+    ind->baralho = visao;
+    for (int a = 0; a <= NUM_ATRIBUTOS; a++) {
+        ind->ordenados[a] = (EntradaIndice *)(c->base + c->cabecalho->deslocamento_indices[a]);
+        ind->validos[a] = c->cabecalho->validos[a];
+    }
+}
+
+// Desanexa o segmento
+void desanexar_baralho_compartilhado(BaralhoCompartilhado *c) {
+    if (c->base != NULL) {
+        munmap((void *)c->base, c->tamanho);
+    }
+    memset(c, 0, sizeof(*c));
+}
+
+// Remove o nome do segmento
+int remover_baralho_compartilhado(const char *nome) {
+    return shm_unlink(nome) == 0 ? 0 : -1;
+}
@@ -0,0 +1,85 @@
+/*
+ * Super Trunfo - Baralho em memória compartilhada
+ *
+ * Um processo publica o baralho carregado, com os índices já prontos, num
+ * segmento de memória compartilhada POSIX (shm_open); os demais processos
+ * anexam o segmento somente leitura com um mmap, sem ler nem interpretar
+ * o arquivo. Todos os processos usam as mesmas páginas físicas: a memória
+ * total não cresce com o número de processos.
+ *
+ * Layout do segmento (sem ponteiros: tudo é endereçado por deslocamentos a
+ * partir do início, que valem em qualquer endereço de mapeamento):
+ *
+ *   CabecalhoCompartilhado
+ *   Carta[quantidade]
+ *   uint32_t[tamanho_hash]                       hash do código -> posição + 1
+ *   EntradaIndice[validos[a]] para cada atributo  índices de consulta.h
+ *
+ * A publicação remove o segmento antigo com o mesmo nome (quem já o anexou
+ * continua com a versão antiga até desanexar), cria um novo e só marca o
+ * cabeçalho como pronto depois de escrever tudo. O segmento depende do
+ * layout de Carta deste build (tamanho conferido ao anexar).
+ */
+
+#ifndef SUPERTRUNFO_COMPARTILHADO_H
+#define SUPERTRUNFO_COMPARTILHADO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+#include "consulta.h"
+
+// Nome padrão do segmento
+#define NOME_COMPARTILHADO_PADRAO "/supertrunfo"
+
+// Cabeçalho no início do segmento
+typedef struct {
+    char magica[8];
+    uint32_t tamanho_carta;
+    uint32_t pronto;                  // 1 depois que o conteúdo foi escrito
+    uint64_t tamanho;                 // Bytes do segmento
+    uint64_t quantidade;
+    uint64_t deslocamento_cartas;
+    uint64_t deslocamento_hash;
+    uint64_t tamanho_hash;            // Potência de 2
+    uint64_t deslocamento_indices[NUM_ATRIBUTOS + 1];
+    uint64_t validos[NUM_ATRIBUTOS + 1];
+} CabecalhoCompartilhado;
+
+// Segmento anexado
+typedef struct {
+    const unsigned char *base;
+    size_t tamanho;
+    const CabecalhoCompartilhado *cabecalho;
+    const Carta *cartas;
+    size_t quantidade;
+} BaralhoCompartilhado;
+
+// Publica o baralho e os seus índices (construídos com 'threads' threads)
+// no segmento 'nome' (ex.: "/supertrunfo"); retorna o tamanho em bytes ou
+// -1 em erro
+long publicar_baralho_compartilhado(const char *nome, const Baralho *b, int threads);
+
+// Anexa o segmento somente leitura; retorna 0 em sucesso, -1 se não existe,
+// ainda não está pronto ou é de outro build
+int anexar_baralho_compartilhado(BaralhoCompartilhado *c, const char *nome);
+
+// Carta com o código ou NULL
+const Carta *buscar_carta_compartilhada(const BaralhoCompartilhado *c, const char *codigo);
+
+// Visões do segmento nas estruturas comuns, para usar as funções de
+// baralho e consulta sem copiar nada; são somente leitura e não devem ser
+// liberadas (liberar_baralho / liberar_indice_baralho)
+void visao_baralho_compartilhado(const BaralhoCompartilhado *c, Baralho *b);
+void visao_indice_compartilhado(const BaralhoCompartilhado *c, const Baralho *visao,
+                                IndiceBaralho *ind);
+
+// Desanexa o segmento
+void desanexar_baralho_compartilhado(BaralhoCompartilhado *c);
+
+// Remove o nome do segmento (os processos anexados não são afetados);
+// retorna 0 em sucesso, -1 se não existe
+int remover_baralho_compartilhado(const char *nome);
+
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Super Trunfo - Consultas por faixa e filtro sobre o baralho
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "consulta.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Custo relativo de conferir uma carta fora de ordem contra marcar uma
+// entrada do índice no mapa de bits
+#define CUSTO_CONFERENCIA 4
+
+// Nomes dos atributos nos predicados, na ordem de CONSULTA_ESTADO e COMPARAR_*
+static const char *const NOMES_CONSULTA[NUM_ATRIBUTOS + 1] = {
+    "estado", "populacao", "area", "pib", "densidade", "pib_per_capita", "pontos_turisticos",
+};
+
+// Contexto da construção paralela
+typedef struct {
+    IndiceBaralho *ind;
+    int falhou;
+} ContextoIndice;
+
+// Sigla do estado como número (para o índice)
+static double codigo_estado(const char *estado) {
+    return (double)(toupper((unsigned char)estado[0]) << 8 | toupper((unsigned char)estado[1]));
+}
+
+// Valor da carta no atributo da consulta (negativo = inválido)
+static double valor_consulta(const Carta *c, int atributo) {
+    switch (atributo) {
+        case CONSULTA_ESTADO: return codigo_estado(c->estado);
+        case COMPARAR_POPULACAO: return (double)c->populacao;
+        case COMPARAR_PONTOS_TURISTICOS: return (double)c->pontos_turisticos;
+        default: return (double)obter_valor_atributo(c, atributo);
+    }
+}
+
+static int comparar_entradas(const void *a, const void *b) {
+    const EntradaIndice *x = a;
+    const EntradaIndice *y = b;
+    if (x->valor != y->valor) {
+        return x->valor < y->valor ? -1 : 1;
+    }
+    return (x->carta > y->carta) - (x->carta < y->carta);
+}
+
+// Cada thread ordena os índices de alguns atributos
+static void tarefa_indice(void *contexto, int indice, int total) {
+    ContextoIndice *c = contexto;
+    IndiceBaralho *ind = c->ind;
+    const Baralho *b = ind->baralho;
+    RASTREAR_ESCOPO("indice_consulta");
+
+    for (int a = indice; a <= NUM_ATRIBUTOS; a += total) {
+        EntradaIndice *e = malloc((b->quantidade + 1) * sizeof(EntradaIndice));
+        if (e == NULL) {
+            c->falhou = 1;
+            continue;
+        }
+        size_t n = 0;
+        for (size_t i = 0; i < b->quantidade; i++) {
+            double v = valor_consulta(&b->cartas[i], a);
+            if (v >= 0) {
+                e[n].valor = v;
+                e[n].carta = (uint32_t)i;
+                n++;
+            }
+        }
+        qsort(e, n, sizeof(EntradaIndice), comparar_entradas);
+        ind->ordenados[a] = e;
+        ind->validos[a] = n;
+    }
+}
+
+// Constrói os índices
+int construir_indice_baralho(IndiceBaralho *ind, const Baralho *b, int threads) {
+    memset(ind, 0, sizeof(*ind));
+    ind->baralho = b;
+    ContextoIndice contexto = { ind, 0 };
+    int n = numero_de_threads(threads);
+    executar_em_paralelo(n < NUM_ATRIBUTOS + 1 ? n : NUM_ATRIBUTOS + 1, tarefa_indice, &contexto);
+    if (contexto.falhou) {
+        liberar_indice_baralho(ind);
+        return -1;
+    }
+    return 0;
+}
+
+// Interpreta "atributo<op>valor"
+int interpretar_predicado(const char *texto, Predicado *p) {
+    size_t nome = strcspn(texto, "<>=");
+    const char *op = texto + nome;
+    if (*op == '\0') {
+        return -1;
+    }
+    p->atributo = -1;
+    for (int a = 0; a <= NUM_ATRIBUTOS; a++) {
+        if (strlen(NOMES_CONSULTA[a]) == nome && strncmp(texto, NOMES_CONSULTA[a], nome) == 0) {
+            p->atributo = a;
+        }
+    }
+    if (p->atributo < 0) {
+        return -1;
+    }
+
+    int igual = op[1] == '=';
+    const char *valor = op + (op[0] != '=' && igual ? 2 : 1);
+    if (p->atributo == CONSULTA_ESTADO) {
+        if (op[0] != '=' || strlen(valor) != 2 || !isalpha((unsigned char)valor[0])
+            || !isalpha((unsigned char)valor[1])) {
+            return -1;
+        }
+        p->minimo = p->maximo = codigo_estado(valor);
+        return 0;
+    }
+
+    // Faixa "a..b": o primeiro número termina antes dos dois pontos
+    const char *faixa = op[0] == '=' ? strstr(valor, "..") : NULL;
+    char *fim;
+    double v = strtod(valor, &fim);
+    if (fim == valor || (faixa != NULL && fim < faixa)) {
+        return -1;
+    }
+    if (faixa != NULL) {
+        fim = (char *)faixa;
+    }
+    p->minimo = -INFINITY;
+    p->maximo = INFINITY;
+    switch (op[0]) {
+        case '=':
+            p->minimo = v;
+            p->maximo = v;
+            if (strncmp(fim, "..", 2) == 0) {
+                const char *segundo = fim + 2;
+                p->maximo = strtod(segundo, &fim);
+                if (fim == segundo) {
+                    return -1;
+                }
+            }
+            break;
+        case '>':
+            p->minimo = igual ? v : nextafter(v, INFINITY);
+            break;
+        case '<':
+            p->maximo = igual ? v : nextafter(v, -INFINITY);
+            break;
+    }
+    return *fim == '\0' ? 0 : -1;
+}
+
+// Confere um predicado direto na carta
+int carta_satisfaz(const Carta *c, const Predicado *p) {
+    double v = valor_consulta(c, p->atributo);
+    return v >= 0 && v >= p->minimo && v <= p->maximo;
+}
+
+// Primeira entrada com valor >= v (ou > v com 'depois')
+static size_t buscar_posicao(const EntradaIndice *e, size_t n, double v, int depois) {
+    size_t inicio = 0;
+    while (n > 0) {
+        size_t metade = n / 2;
+        int antes = depois ? e[inicio + metade].valor <= v : e[inicio + metade].valor < v;
+        if (antes) {
+            inicio += metade + 1;
+            n -= metade + 1;
+        } else {
+            n = metade;
+        }
+    }
+    return inicio;
+}
+
+// Marca no mapa de bits as cartas da faixa do índice
+static void marcar_faixa(uint64_t *bits, const EntradaIndice *e, size_t inicio, size_t fim) {
+    for (size_t k = inicio; k < fim; k++) {
+        bits[e[k].carta / 64] |= 1ULL << (e[k].carta % 64);
+    }
+}
+
+// Cartas que satisfazem todos os predicados, em ordem crescente
+long consultar_baralho(const IndiceBaralho *ind, const Predicado *predicados, int quantidade,
+                       uint32_t *resultado) {
+    const Baralho *b = ind->baralho;
+    size_t palavras = (b->quantidade + 63) / 64;
+    size_t inicio[MAXIMO_PREDICADOS];
+    size_t fim[MAXIMO_PREDICADOS];
+    if (quantidade <= 0 || quantidade > MAXIMO_PREDICADOS) {
+        return quantidade == 0 ? 0 : -1;
+    }
+
+    // Faixa de cada predicado no índice do atributo; a menor guia o plano
+    int guia = 0;
+    size_t demais = 0;
+    for (int p = 0; p < quantidade; p++) {
+        const Predicado *pr = &predicados[p];
+        const EntradaIndice *e = ind->ordenados[pr->atributo];
+        size_t n = ind->validos[pr->atributo];
+        inicio[p] = buscar_posicao(e, n, pr->minimo, 0);
+        fim[p] = pr->maximo < pr->minimo ? inicio[p] : buscar_posicao(e, n, pr->maximo, 1);
+        if (fim[p] - inicio[p] < fim[guia] - inicio[guia]) {
+            guia = p;
+        }
+    }
+    size_t candidatas = fim[guia] - inicio[guia];
+    if (candidatas == 0) {
+        return 0;
+    }
+    for (int p = 0; p < quantidade; p++) {
+        if (p != guia) {
+            demais += fim[p] - inicio[p] + palavras;
+        }
+    }
+
+    uint64_t *bits = calloc(palavras, sizeof(uint64_t));
+    uint64_t *faixa = quantidade > 1 ? malloc(palavras * sizeof(uint64_t)) : NULL;
+    if (bits == NULL || (quantidade > 1 && faixa == NULL)) {
+        free(bits);
+        free(faixa);
+        return -1;
+    }
+
+    const EntradaIndice *e = ind->ordenados[predicados[guia].atributo];
+    if (candidatas * (size_t)(quantidade - 1) * CUSTO_CONFERENCIA <= demais) {
+        // Poucas candidatas: confere os outros predicados só nelas
+        for (size_t k = inicio[guia]; k < fim[guia]; k++) {
+            const Carta *c = &b->cartas[e[k].carta];
+            int aceita = 1;
+            for (int p = 0; p < quantidade && aceita; p++) {
+                aceita = p == guia || carta_satisfaz(c, &predicados[p]);
+            }
+            if (aceita) {
+                bits[e[k].carta / 64] |= 1ULL << (e[k].carta % 64);
+            }
+        }
+    } else {
+        // Interseção dos mapas de bits de cada faixa
+        marcar_faixa(bits, e, inicio[guia], fim[guia]);
+        for (int p = 0; p < quantidade; p++) {
+            if (p == guia) {
+                continue;
+            }
+            memset(faixa, 0, palavras * sizeof(uint64_t));
+            marcar_faixa(faixa, ind->ordenados[predicados[p].atributo], inicio[p], fim[p]);
+            for (size_t w = 0; w < palavras; w++) {
+                bits[w] &= faixa[w];
+            }
+        }
+    }
+
+    long total = 0;
+    for (size_t w = 0; w < palavras; w++) {
+        for (uint64_t x = bits[w]; x != 0; x &= x - 1) {
+            resultado[total++] = (uint32_t)(w * 64 + (size_t)__builtin_ctzll(x));
+        }
+    }
+    free(bits);
+    free(faixa);
+    return total;
+}
+
+// Libera os índices
+void liberar_indice_baralho(IndiceBaralho *ind) {
+    for (int a = 0; a <= NUM_ATRIBUTOS; a++) {
+        free(ind->ordenados[a]);
+    }
+    memset(ind, 0, sizeof(*ind));
+}
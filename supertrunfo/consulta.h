@@ -0,0 +1,75 @@
+/*
+ * Super Trunfo - Consultas por faixa e filtro sobre o baralho
+ *
+ * Índice ordenado por atributo (vetor de pares valor/carta em ordem
+ * crescente, mais um para o estado) e consultas com vários predicados:
+ *
+ *   estado=MG  populacao>=100000  populacao<=500000  pib_per_capita>40000
+ *   area=100..2000  pontos_turisticos=10
+ *
+ * Cada predicado vira um intervalo fechado [mínimo, máximo] (os estritos
+ * usam o double seguinte), resolvido por busca binária no índice do
+ * atributo. O plano começa pelo predicado mais seletivo: se ele tem poucas
+ * cartas, os demais são conferidos só nessas cartas; senão, cada faixa
+ * marca um mapa de bits e os mapas são intersectados com AND palavra a
+ * palavra. Em nenhum caso o baralho inteiro é percorrido.
+ *
+ * Valores inválidos (negativos) não entram no índice e nunca satisfazem um
+ * predicado. Os valores são comparados em double (população exata).
+ */
+
+#ifndef SUPERTRUNFO_CONSULTA_H
+#define SUPERTRUNFO_CONSULTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+// Atributo "estado" nos predicados (os numéricos são COMPARAR_*)
+#define CONSULTA_ESTADO 0
+
+// Maior número de predicados numa consulta
+#define MAXIMO_PREDICADOS 16
+
+// Valor de uma carta num índice
+typedef struct {
+    double valor;
+    uint32_t carta;
+} EntradaIndice;
+
+// Índices ordenados de todos os atributos de um baralho
+typedef struct {
+    const Baralho *baralho;
+    EntradaIndice *ordenados[NUM_ATRIBUTOS + 1];  // [CONSULTA_ESTADO] e [COMPARAR_*]
+    size_t validos[NUM_ATRIBUTOS + 1];            // Entradas de cada índice
+} IndiceBaralho;
+
+// Predicado: valor do atributo em [minimo, maximo]
+typedef struct {
+    int atributo;
+    double minimo;
+    double maximo;
+} Predicado;
+
+// Constrói os índices (um atributo por thread); o baralho não pode mudar
+// enquanto o índice existir; retorna 0 em sucesso, -1 sem memória
+int construir_indice_baralho(IndiceBaralho *ind, const Baralho *b, int threads);
+
+// Interpreta "atributo<op>valor" (op: = < <= > >=; "=a..b" para faixa;
+// estado só com "="); retorna 0 em sucesso, -1 se inválido
+int interpretar_predicado(const char *texto, Predicado *p);
+
+// Escreve em 'resultado' (espaço para todas as cartas) os índices das cartas
+// que satisfazem todos os predicados, em ordem crescente; retorna quantas
+// ou -1 sem memória
+long consultar_baralho(const IndiceBaralho *ind, const Predicado *predicados, int quantidade,
+                       uint32_t *resultado);
+
+// Confere um predicado direto na carta (sem índice)
+int carta_satisfaz(const Carta *c, const Predicado *p);
+
+// Libera os índices
+void liberar_indice_baralho(IndiceBaralho *ind);
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Super Trunfo - Corrotinas sem pilha
+ *
+ * Corrotinas no estilo protothreads: a função da corrotina é chamada de
+ * novo a cada evento e retoma do último ponto de espera por um switch sobre
+ * o número da linha. Não há pilha própria: o estado que precisa sobreviver
+ * a uma espera fica na estrutura dona da corrotina, nunca em variáveis
+ * locais. Não use switch próprio entre CORROTINA_INICIAR e CORROTINA_FIM.
+ *
+ *   int executar(Tarefa *t) {
+ *       CORROTINA_INICIAR(&t->co);
+ *       CORROTINA_AGUARDAR(&t->co, dados_prontos(t));
+ *       ...
+ *       CORROTINA_FIM(&t->co);
+ *   }
+ */
+
+#ifndef SUPERTRUNFO_CORROTINA_H
+#define SUPERTRUNFO_CORROTINA_H
+
+// Retorno da função da corrotina
+#define CORROTINA_ESPERANDO 0
+#define CORROTINA_TERMINADA 1
+
+// Ponto de retomada (0 = início)
+typedef struct {
+    int linha;
+} Corrotina;
+
+static inline void iniciar_corrotina(Corrotina *c) {
+    c->linha = 0;
+}
+
+#define CORROTINA_INICIAR(c) switch ((c)->linha) { case 0:
+
+// Suspende até 'condicao' ser verdadeira (avaliada a cada retomada)
+#define CORROTINA_AGUARDAR(c, condicao) \
+    do { \
+        (c)->linha = __LINE__; \
+        /* fall through */ \
+        case __LINE__: \
+        if (!(condicao)) return CORROTINA_ESPERANDO; \
+    } while (0)
+
+#define CORROTINA_FIM(c) \
+    } \
+    (c)->linha = -1; \
+    return CORROTINA_TERMINADA
+
+#endif
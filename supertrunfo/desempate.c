@@ -0,0 +1,201 @@
+/*
+ * Super Trunfo - Cascata de desempate
+ *
+ * Classificação por ordenação radix LSD de 8 bits: um passe lê o baralho,
+ * monta as chaves (complementadas, para a ordem crescente ser a de
+ * "melhor primeiro") e os histogramas de todos os bytes; cada passe
+ * seguinte só distribui as entradas. Bytes iguais em todas as chaves
+ * (níveis com poucos valores distintos, metade alta vazia) não geram
+ * passe.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "desempate.h"
+#include "rastreio.h"
+
+// Dígito da ordenação
+#define BITS_DIGITO 8
+#define BALDES (1 << BITS_DIGITO)
+
+// Nomes aceitos na cascata, na ordem de COMPARAR_*
+static const char *const NOMES_CASCATA[NUM_ATRIBUTOS] = {
+    "populacao", "area", "pib", "densidade", "pib_per_capita", "pontos_turisticos",
+};
+
+// Entradas da ordenação com chave de 64 e de 128 bits
+typedef struct {
+    uint64_t chave;
+    uint32_t indice;
+} Entrada64;
+
+typedef struct {
+    uint64_t chave[2];   // chave[1] é a metade mais significativa
+    uint32_t indice;
+} Entrada128;
+
+// Interpreta a cascata
+int interpretar_cascata(Cascata *k, const char *texto) {
+    k->niveis = 0;
+    const char *p = texto;
+    while (*p) {
+        size_t n = strcspn(p, ",");
+        int atributo = 0;
+        if (n == 1 && p[0] >= '1' && p[0] < '1' + NUM_ATRIBUTOS) {
+            atributo = p[0] - '0';
+        }
+        for (int t = 0; t < NUM_ATRIBUTOS && atributo == 0; t++) {
+            if (strlen(NOMES_CASCATA[t]) == n && strncmp(p, NOMES_CASCATA[t], n) == 0) {
+                atributo = t + 1;
+            }
+        }
+        if (atributo == 0 || k->niveis == MAXIMO_NIVEIS_CASCATA) {
+            return -1;
+        }
+        for (int m = 0; m < k->niveis; m++) {
+            if (k->atributos[m] == atributo) {
+                return -1;
+            }
+        }
+        k->atributos[k->niveis++] = atributo;
+        p += n + (p[n] == ',');
+    }
+    return k->niveis > 0 ? 0 : -1;
+}
+
+// Escreve a cascata por extenso
+void descrever_cascata(const Cascata *k, char *texto, size_t tamanho) {
+    size_t usado = 0;
+    texto[0] = '\0';
+    for (int n = 0; n < k->niveis && usado < tamanho; n++) {
+        int escritos = snprintf(texto + usado, tamanho - usado, "%s%s", n > 0 ? " > " : "",
+                                nome_atributo(k->atributos[n]));
+        if (escritos < 0) {
+            break;
+        }
+        usado += (size_t)escritos;
+    }
+}
+
+// Prefixos dos histogramas; retorna 0 se o byte é igual em todas as
+// chaves (passe dispensável)
+static int preparar_passe(size_t *contagem, size_t n) {
+    size_t soma = 0;
+    for (int d = 0; d < BALDES; d++) {
+        if (contagem[d] == n) {
+            return 0;
+        }
+        size_t c = contagem[d];
+        contagem[d] = soma;
+        soma += c;
+    }
+    return 1;
+}
+
+// Radix LSD sobre chaves de 64 bits; retorna o vetor com o resultado
+static Entrada64 *ordenar_64(Entrada64 *a, Entrada64 *b, size_t n, int bytes,
+                             size_t (*contagem)[BALDES]) {
+    for (int byte = 0; byte < bytes; byte++) {
+        if (!preparar_passe(contagem[byte], n)) {
+            continue;
+        }
+        size_t *destino = contagem[byte];
+        int deslocamento = BITS_DIGITO * byte;
+        for (size_t i = 0; i < n; i++) {
+            b[destino[(a[i].chave >> deslocamento) & (BALDES - 1)]++] = a[i];
+        }
+        Entrada64 *t = a;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Radix LSD sobre chaves de 128 bits; retorna o vetor com o resultado
+static Entrada128 *ordenar_128(Entrada128 *a, Entrada128 *b, size_t n, int bytes,
+                               size_t (*contagem)[BALDES]) {
+    for (int byte = 0; byte < bytes; byte++) {
+        if (!preparar_passe(contagem[byte], n)) {
+            continue;
+        }
+        size_t *destino = contagem[byte];
+        int parte = byte >> 3;
+        int deslocamento = BITS_DIGITO * (byte & 7);
+        for (size_t i = 0; i < n; i++) {
+            b[destino[(a[i].chave[parte] >> deslocamento) & (BALDES - 1)]++] = a[i];
+        }
+        Entrada128 *t = a;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Classifica o baralho na cascata
+int classificar_cascata(const Baralho *b, const Cascata *k, uint32_t *ordem) {
+    RASTREAR_ESCOPO("classificar_cascata");
+    size_t n = b->quantidade;
+    int bytes = 4 * k->niveis;
+    if (n == 0) {
+        return 0;
+    }
+    size_t (*contagem)[BALDES] = calloc((size_t)bytes, sizeof(*contagem));
+    if (contagem == NULL) {
+        return -1;
+    }
+
+    // Chaves complementadas (crescente = melhor primeiro); os bytes acima
+    // de 4 * niveis não entram na ordenação
+    if (k->niveis <= 2) {
+        Entrada64 *a = malloc(n * sizeof(Entrada64));
+        Entrada64 *t = malloc(n * sizeof(Entrada64));
+        if (a == NULL || t == NULL) {
+            free(a);
+            free(t);
+            free(contagem);
+            return -1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint64_t chave = ~chave_cascata(&b->cartas[i], k).parte[0];
+            a[i].chave = chave;
+            a[i].indice = (uint32_t)i;
+            for (int byte = 0; byte < bytes; byte++) {
+                contagem[byte][(chave >> (BITS_DIGITO * byte)) & (BALDES - 1)]++;
+            }
+        }
+        Entrada64 *r = ordenar_64(a, t, n, bytes, contagem);
+        for (size_t i = 0; i < n; i++) {
+            ordem[i] = r[i].indice;
+        }
+        free(a);
+        free(t);
+    } else {
+        Entrada128 *a = malloc(n * sizeof(Entrada128));
+        Entrada128 *t = malloc(n * sizeof(Entrada128));
+        if (a == NULL || t == NULL) {
+            free(a);
+            free(t);
+            free(contagem);
+            return -1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            ChaveCascata chave = chave_cascata(&b->cartas[i], k);
+            a[i].chave[0] = ~chave.parte[0];
+            a[i].chave[1] = ~chave.parte[1];
+            a[i].indice = (uint32_t)i;
+            for (int byte = 0; byte < bytes; byte++) {
+                contagem[byte][(a[i].chave[byte >> 3] >> (BITS_DIGITO * (byte & 7)))
+                               & (BALDES - 1)]++;
+            }
+        }
+        Entrada128 *r = ordenar_128(a, t, n, bytes, contagem);
+        for (size_t i = 0; i < n; i++) {
+            ordem[i] = r[i].indice;
+        }
+        free(a);
+        free(t);
+    }
+    free(contagem);
+    return 0;
+}
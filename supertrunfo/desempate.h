@@ -0,0 +1,107 @@
+/*
+ * Super Trunfo - Cascata de desempate
+ *
+ * comparar_cartas devolve empate quando os valores são iguais. Uma cascata
+ * lista atributos em ordem de prioridade (ex.: PIB, depois população,
+ * depois pontos turísticos): o primeiro em que as cartas diferem decide.
+ *
+ * Cada atributo vira uma chave de 32 bits sem sinal que preserva a ordem
+ * de "melhor": inteiros não negativos somam 1; floats têm os bits
+ * reinterpretados (sinal trocado nos positivos, todos os bits invertidos
+ * nos negativos), o que os ordena como números; a densidade, em que menor
+ * vence, tem a chave invertida. Valor inválido (negativo ou NaN) tem chave
+ * 0, abaixo de todos os válidos. As chaves dos níveis são concatenadas,
+ * da mais para a menos importante, numa chave de 64 bits (até dois
+ * níveis) ou de 128 bits (até quatro): comparar duas cartas na cascata é
+ * comparar dois inteiros, e classificar o baralho é uma única ordenação
+ * radix LSD das chaves, byte a byte, do menos para o mais significativo.
+ * A ordenação é estável: cartas iguais em todos os níveis ficam na ordem
+ * do baralho.
+ */
+
+#ifndef SUPERTRUNFO_DESEMPATE_H
+#define SUPERTRUNFO_DESEMPATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "baralho.h"
+
+// Níveis que cabem numa chave de 128 bits
+#define MAXIMO_NIVEIS_CASCATA 4
+
+// Cascata de atributos (1 a 6), do mais para o menos importante
+typedef struct {
+    int niveis;
+    int atributos[MAXIMO_NIVEIS_CASCATA];
+} Cascata;
+
+// Chave de 128 bits: parte[1] é a metade mais significativa
+typedef struct {
+    uint64_t parte[2];
+} ChaveCascata;
+
+// Interpreta a cascata "3,1,6" ou "pib,populacao,pontos_turisticos";
+// retorna 0 em sucesso, -1 se algum atributo é inválido ou repetido
+int interpretar_cascata(Cascata *k, const char *texto);
+
+// Escreve a cascata por extenso ("PIB > População > ...")
+void descrever_cascata(const Cascata *k, char *texto, size_t tamanho);
+
+// Float como inteiro sem sinal na mesma ordem
+static inline uint32_t float_ordenavel(float v) {
+    uint32_t u;
+    v = v == 0.0f ? 0.0f : v;  // -0 e +0 são o mesmo valor
+    memcpy(&u, &v, sizeof(u));
+    return (u & 0x80000000u) ? ~u : u | 0x80000000u;
+}
+
+// Chave de um atributo: maior = melhor; 0 = valor inválido
+static inline uint32_t chave_atributo(const Carta *c, int atributo) {
+    float v;
+    switch (atributo) {
+        case COMPARAR_POPULACAO:
+            return c->populacao >= 0 ? (uint32_t)c->populacao + 1 : 0;
+        case COMPARAR_PONTOS_TURISTICOS:
+            return c->pontos_turisticos >= 0 ? (uint32_t)c->pontos_turisticos + 1 : 0;
+        case COMPARAR_AREA: v = c->area; break;
+        case COMPARAR_PIB: v = c->pib; break;
+        case COMPARAR_DENSIDADE: v = c->densidade; break;
+        case COMPARAR_PIB_CAPITA: v = c->pib_per_capita; break;
+        default: return 0;
+    }
+    if (!(v >= 0.0f)) {
+        return 0;  // Negativo ou NaN
+    }
+    uint32_t u = float_ordenavel(v);
+    return atributo == COMPARAR_DENSIDADE ? ~u : u;  // u <= bits de +inf, então ~u > 0
+}
+
+// Chave da carta na cascata
+static inline ChaveCascata chave_cascata(const Carta *c, const Cascata *k) {
+    ChaveCascata chave = { { 0, 0 } };
+    for (int n = 0; n < k->niveis; n++) {
+        int deslocamento = 32 * (k->niveis - 1 - n);
+        chave.parte[deslocamento >> 6] |= (uint64_t)chave_atributo(c, k->atributos[n])
+                                          << (deslocamento & 63);
+    }
+    return chave;
+}
+
+// Compara as cartas na cascata: 1 se c1 vence, 2 se c2 vence, 0 se iguais
+// em todos os níveis
+static inline int comparar_cascata(const Carta *c1, const Carta *c2, const Cascata *k) {
+    ChaveCascata a = chave_cascata(c1, k);
+    ChaveCascata b = chave_cascata(c2, k);
+    if (a.parte[1] != b.parte[1]) {
+        return a.parte[1] > b.parte[1] ? 1 : 2;
+    }
+    return a.parte[0] > b.parte[0] ? 1 : a.parte[0] < b.parte[0] ? 2 : 0;
+}
+
+// Classifica o baralho na cascata: ordem[0] é a melhor carta; retorna 0
+// em sucesso, -1 sem memória
+int classificar_cascata(const Baralho *b, const Cascata *k, uint32_t *ordem);
+
+#endif
@@ -0,0 +1,286 @@
+/*
+ * Super Trunfo - Distribuição equilibrada e formação de mesas
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "distribuicao.h"
+#include "desempate.h"
+#include "rastreio.h"
+
+// Chave do atributo na ordem de comparar_cartas (maior = melhor, valores
+// convertidos para float como lá); retorna 0 se o valor é inválido
+static int chave_forca(const Carta *c, int atributo, uint32_t *chave) {
+    float v = obter_valor_atributo(c, atributo);
+    if (!(v >= 0.0f)) {
+        return 0;
+    }
+    uint32_t u = float_ordenavel(v);
+    *chave = atributo == COMPARAR_DENSIDADE ? ~u : u;
+    return 1;
+}
+
+static int comparar_entradas(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Força de cada carta
+int calcular_forca_cartas(const Baralho *b, double *forca) {
+    RASTREAR_ESCOPO("calcular_forca_cartas");
+    size_t n = b->quantidade;
+    for (size_t i = 0; i < n; i++) {
+        forca[i] = 0.0;
+    }
+    if (n < 2) {
+        return 0;
+    }
+    uint64_t *entradas = malloc(n * sizeof(uint64_t));
+    if (entradas == NULL) {
+        return -1;
+    }
+    double escala = 1.0 / ((double)(n - 1) * NUM_ATRIBUTOS);
+    for (int atributo = 1; atributo <= NUM_ATRIBUTOS; atributo++) {
+        // Cartas válidas em ordem crescente de chave; as inválidas empatam com todas
+        size_t validas = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t chave;
+            if (chave_forca(&b->cartas[i], atributo, &chave)) {
+                entradas[validas++] = (uint64_t)chave << 32 | (uint32_t)i;
+            } else {
+                forca[i] += 0.5 * (double)(n - 1) * escala;
+            }
+        }
+        qsort(entradas, validas, sizeof(uint64_t), comparar_entradas);
+
+        // Um grupo de chaves iguais vence as anteriores e empata entre si e com as inválidas
+        double invalidas = (double)(n - validas);
+        for (size_t inicio = 0; inicio < validas;) {
+            size_t fim = inicio + 1;
+            while (fim < validas && entradas[fim] >> 32 == entradas[inicio] >> 32) {
+                fim++;
+            }
+            double pontos = (double)inicio + 0.5 * ((double)(fim - inicio - 1) + invalidas);
+            for (size_t p = inicio; p < fim; p++) {
+                forca[(uint32_t)entradas[p]] += pontos * escala;
+            }
+            inicio = fim;
+        }
+    }
+    free(entradas);
+    return 0;
+}
+
+// Ordem de valor crescente ou decrescente (empates pelo índice)
+static int vem_antes(const double *valor, int decrescente, uint32_t a, uint32_t b) {
+    if (valor[a] != valor[b]) {
+        return decrescente ? valor[a] > valor[b] : valor[a] < valor[b];
+    }
+    return a < b;
+}
+
+// Ordena os índices pelo valor (heapsort, sem memória extra)
+static void ordenar_por_valor(uint32_t *v, size_t n, const double *valor, int decrescente) {
+    for (size_t fim = n, inicio = n / 2; fim > 1;) {
+        if (inicio > 0) {
+            inicio--;  // Montagem do heap
+        } else {
+            fim--;     // Extração do maior
+            uint32_t t = v[0];
+            v[0] = v[fim];
+            v[fim] = t;
+        }
+        size_t pai = inicio;
+        for (;;) {
+            size_t filho = 2 * pai + 1;
+            if (filho >= fim) {
+                break;
+            }
+            if (filho + 1 < fim && vem_antes(valor, decrescente, v[filho], v[filho + 1])) {
+                filho++;
+            }
+            if (!vem_antes(valor, decrescente, v[pai], v[filho])) {
+                break;
+            }
+            uint32_t t = v[pai];
+            v[pai] = v[filho];
+            v[filho] = t;
+            pai = filho;
+        }
+    }
+}
+
+// Melhor troca entre a mão forte e a fraca: a carta i da forte pela carta
+// da fraca que deixa a diferença mais perto de zero. Retorna a posição i
+// (m se nenhuma troca diminui a diferença) e a substituta em *substituta.
+static size_t escolher_troca(const double *forca, const uint32_t *mao_forte,
+                             const uint32_t *mao_fraca, size_t m, double diferenca,
+                             uint32_t *ordenadas, uint32_t *substituta) {
+    double melhor = diferenca;
+    size_t escolhida = m;
+
+    // Mãos pequenas: todos os pares, sem ordenar
+    if (m <= MAO_PEQUENA) {
+        double fracas[MAO_PEQUENA];
+        for (size_t j = 0; j < m; j++) {
+            fracas[j] = forca[mao_fraca[j]];
+        }
+        for (size_t i = 0; i < m; i++) {
+            double valor = forca[mao_forte[i]];
+            for (size_t j = 0; j < m; j++) {
+                double delta = valor - fracas[j];
+                double resto = diferenca - 2 * delta;
+                resto = resto < 0 ? -resto : resto;
+                if (delta > 0.0 && resto < melhor) {
+                    melhor = resto;
+                    escolhida = i;
+                    *substituta = mao_fraca[j];
+                }
+            }
+        }
+        return escolhida;
+    }
+
+    // Para cada carta da mão forte, a da fraca mais perto de forca - diferenca / 2
+    memcpy(ordenadas, mao_fraca, m * sizeof(uint32_t));
+    ordenar_por_valor(ordenadas, m, forca, 0);
+    for (size_t i = 0; i < m; i++) {
+        double alvo = forca[mao_forte[i]] - diferenca / 2;
+        size_t baixo = 0, alto = m;
+        while (baixo < alto) {
+            size_t meio = (baixo + alto) / 2;
+            if (forca[ordenadas[meio]] < alvo) {
+                baixo = meio + 1;
+            } else {
+                alto = meio;
+            }
+        }
+        for (size_t j = baixo > 0 ? baixo - 1 : 0; j <= baixo && j < m; j++) {
+            double delta = forca[mao_forte[i]] - forca[ordenadas[j]];
+            double resto = diferenca - 2 * delta;
+            resto = resto < 0 ? -resto : resto;
+            if (delta > 0.0 && resto < melhor) {
+                melhor = resto;
+                escolhida = i;
+                *substituta = ordenadas[j];
+            }
+        }
+    }
+    return escolhida;
+}
+
+// Troca entre a mão mais forte e a mais fraca; retorna 0 se a diferença já
+// está dentro do limite ou nenhuma troca ajuda
+static int trocar_cartas(const double *forca, uint32_t *maos_cartas, size_t m, int maos,
+                         double *totais, double limite, uint32_t *ordenadas) {
+    int forte = 0, fraca = 0;
+    for (int h = 1; h < maos; h++) {
+        forte = totais[h] > totais[forte] ? h : forte;
+        fraca = totais[h] < totais[fraca] ? h : fraca;
+    }
+    double diferenca = totais[forte] - totais[fraca];
+    if (!(diferenca > limite)) {
+        return 0;
+    }
+    uint32_t *mao_forte = maos_cartas + (size_t)forte * m;
+    uint32_t *mao_fraca = maos_cartas + (size_t)fraca * m;
+    uint32_t substituta = 0;
+    size_t escolhida = escolher_troca(forca, mao_forte, mao_fraca, m, diferenca, ordenadas,
+                                      &substituta);
+    if (escolhida == m) {
+        return 0;
+    }
+    size_t j = 0;
+    while (mao_fraca[j] != substituta) {
+        j++;
+    }
+    double delta = forca[mao_forte[escolhida]] - forca[substituta];
+    mao_fraca[j] = mao_forte[escolhida];
+    mao_forte[escolhida] = substituta;
+    totais[forte] -= delta;
+    totais[fraca] += delta;
+    return 1;
+}
+
+// Reordena as cartas embaralhadas para mãos de força equilibrada
+double distribuir_equilibrado(const double *forca, uint32_t *cartas, size_t n, int maos,
+                              uint32_t *trabalho, double *totais) {
+    double soma[MAXIMO_MAOS] = { 0 };
+    int ordem_maos[MAXIMO_MAOS];
+    uint32_t rodada[MAXIMO_MAOS];
+    size_t m = n / (size_t)maos;
+    for (int h = 0; h < maos; h++) {
+        ordem_maos[h] = h;
+    }
+
+    // Rodadas de K cartas: a mais forte para a mão mais fraca até ali
+    for (size_t r = 0; r < m; r++) {
+        for (int t = 0; t < maos; t++) {
+            uint32_t carta = cartas[r * (size_t)maos + (size_t)t];
+            int p = t;
+            while (p > 0 && forca[rodada[p - 1]] < forca[carta]) {
+                rodada[p] = rodada[p - 1];
+                p--;
+            }
+            rodada[p] = carta;
+        }
+        for (int t = 1; t < maos; t++) {
+            int h = ordem_maos[t];
+            int p = t;
+            while (p > 0 && soma[ordem_maos[p - 1]] > soma[h]) {
+                ordem_maos[p] = ordem_maos[p - 1];
+                p--;
+            }
+            ordem_maos[p] = h;
+        }
+        for (int t = 0; t < maos; t++) {
+            int h = ordem_maos[t];
+            trabalho[(size_t)h * m + r] = rodada[t];
+            soma[h] += forca[rodada[t]];
+        }
+    }
+
+    // Busca local: trocas entre a mão mais forte e a mais fraca
+    double total = 0.0;
+    for (int h = 0; h < maos; h++) {
+        total += soma[h];
+    }
+    double limite = TOLERANCIA_DISTRIBUICAO * total / maos;
+    for (int troca = 0; troca < TROCAS_DISTRIBUICAO && m > 0; troca++) {
+        if (!trocar_cartas(forca, trabalho, m, maos, soma, limite, trabalho + n)) {
+            break;
+        }
+    }
+
+    // Volta para a ordem da distribuição alternada
+    double maior = soma[0], menor = soma[0];
+    for (int h = 0; h < maos; h++) {
+        for (size_t r = 0; r < m; r++) {
+            cartas[r * (size_t)maos + (size_t)h] = trabalho[(size_t)h * m + r];
+        }
+        maior = soma[h] > maior ? soma[h] : maior;
+        menor = soma[h] < menor ? soma[h] : menor;
+        if (totais != NULL) {
+            totais[h] = soma[h];
+        }
+    }
+    return maior - menor;
+}
+
+// Forma mesas de até por_mesa jogadores
+size_t formar_mesas(const double *ratings, size_t jogadores, int por_mesa, uint32_t *ordem,
+                    size_t *inicios) {
+    for (size_t i = 0; i < jogadores; i++) {
+        ordem[i] = (uint32_t)i;
+    }
+    ordenar_por_valor(ordem, jogadores, ratings, 1);
+
+    // Tamanhos iguais a menos de um jogador
+    size_t mesas = por_mesa > 0 ? (jogadores + (size_t)por_mesa - 1) / (size_t)por_mesa : 0;
+    for (size_t t = 0; t <= mesas; t++) {
+        inicios[t] = mesas > 0 ? jogadores * t / mesas : 0;
+    }
+    return mesas;
+}
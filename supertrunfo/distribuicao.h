@@ -0,0 +1,62 @@
+/*
+ * Super Trunfo - Distribuição equilibrada e formação de mesas
+ *
+ * A força de uma carta é a sua pontuação esperada num duelo contra cada
+ * outra carta do baralho, com atributo sorteado, pelas regras de
+ * comparar_cartas (vitória 1, empate 1/2, valor inválido empata): a mesma
+ * taxa de vitória de variancia_vitorias, mas calculada em O(n log n) pela
+ * posição da carta em cada atributo ordenado.
+ *
+ * A distribuição parte do baralho já embaralhado e o divide em rodadas de
+ * K cartas: em cada rodada a carta mais forte vai para a mão mais fraca até
+ * ali, a segunda para a segunda mais fraca e assim por diante. Depois uma
+ * busca local troca uma carta entre a mão mais forte e a mais fraca,
+ * escolhendo o par que deixa as duas mais perto da média, até a diferença
+ * entre elas ficar abaixo de TOLERANCIA_DISTRIBUICAO da mão média, não
+ * haver troca que ajude ou TROCAS_DISTRIBUICAO trocas. Em baralhos grandes
+ * as rodadas já deixam as mãos dentro da tolerância. Quais cartas ficam juntas
+ * continua dependendo do embaralhamento, e a ordem das cartas em cada mão
+ * é a do baralho embaralhado.
+ *
+ * As mesas são formadas pela ordem dos ratings: os jogadores de maior
+ * rating na primeira mesa, os seguintes na segunda, e assim por diante, o
+ * que minimiza a soma das diferenças de rating dentro das mesas. São
+ * ceil(jogadores / por_mesa) mesas, com tamanhos que diferem em no máximo
+ * um jogador (nenhuma mesa fica com um jogador sozinho por sobra).
+ */
+
+#ifndef SUPERTRUNFO_DISTRIBUICAO_H
+#define SUPERTRUNFO_DISTRIBUICAO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+#define MAXIMO_MAOS 64
+#define TROCAS_DISTRIBUICAO 16
+#define TOLERANCIA_DISTRIBUICAO 1e-3
+
+// Mãos em que a troca testa todos os pares em vez de ordenar a mão fraca
+#define MAO_PEQUENA 64
+
+// Força de cada carta (0 a 1); retorna 0 em sucesso, -1 sem memória
+int calcular_forca_cartas(const Baralho *b, double *forca);
+
+// Reordena as n cartas embaralhadas para a distribuição alternada (carta c
+// para a mão c % maos) dar mãos de força equilibrada; as n % maos últimas
+// cartas ficam de fora. 'trabalho' deve ter n + n / maos posições contíguas
+// (as mãos e a mão fraca ordenada da busca local) e 'totais' (pode ser NULL)
+// recebe a força de cada mão. Retorna a diferença entre a mão mais forte e a
+// mais fraca.
+double distribuir_equilibrado(const double *forca, uint32_t *cartas, size_t n, int maos,
+                              uint32_t *trabalho, double *totais);
+
+// Forma mesas de até por_mesa jogadores: 'ordem' recebe os jogadores do
+// maior ao menor rating (empates pelo índice) e a mesa t tem ordem[inicios[t]]
+// a ordem[inicios[t + 1] - 1]. 'inicios' deve ter jogadores + 1 posições.
+// Retorna o número de mesas.
+size_t formar_mesas(const double *ratings, size_t jogadores, int por_mesa, uint32_t *ordem,
+                    size_t *inicios);
+
+#endif
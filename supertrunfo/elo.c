@@ -0,0 +1,244 @@
+/*
+ * Super Trunfo - Rating Elo das cartas
+ *
+ * Cada thread tem um fragmento com a variação de rating e os resultados do
+ * lote corrente para todas as cartas; a redução percorre as cartas por
+ * faixas, então nenhuma posição é escrita por duas threads.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "elo.h"
+#include "estrategia.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Duelos por lote: pelo menos DUELOS_POR_CARTA_LOTE / 2 duelos por carta
+#define DUELOS_POR_LOTE_MINIMO 4096
+#define DUELOS_POR_CARTA_LOTE 8
+
+// Escala do ponto fixo das variações de rating (soma associativa)
+#define ESCALA_VARIACAO 1048576.0
+
+// ln(10) / 400: converte a diferença de rating no expoente da curva logística
+#define LN10_SOBRE_400 (2.302585092994046 / 400.0)
+
+// Resultados de uma carta num lote, no fragmento de uma thread
+typedef struct {
+    int64_t variacao;
+    uint32_t vitorias;
+    uint32_t derrotas;
+    uint32_t empates;
+} ParcialCarta;
+
+// Estado compartilhado pelas threads
+typedef struct {
+    const Baralho *b;
+    const OpcoesElo *o;
+    const uint8_t *melhor;
+    AvaliacaoCarta *avaliacoes;
+    ParcialCarta *fragmentos;    // total_threads fragmentos de n posições
+    long duelos_por_lote;
+    long primeiro_lote;          // Início do primeiro lote (> 0 ao retomar)
+    uint64_t identificacao;      // Da execução, nos pontos de retomada
+} ContextoElo;
+
+// Joga os duelos [inicio, fim) contra os ratings congelados do lote
+static void jogar_duelos(const ContextoElo *c, long inicio, long fim, ParcialCarta *fragmento) {
+    const Carta *cartas = c->b->cartas;
+    const AvaliacaoCarta *av = c->avaliacoes;
+    uint32_t n = (uint32_t)c->b->quantidade;
+    double k = c->o->fator_k;
+
+    for (long d = inicio; d < fim; d++) {
+        // Cada duelo tem a própria sequência: não depende de quem o joga
+        uint64_t estado = c->o->semente ^ ((uint64_t)d * 0xD1B54A32D192ED03ULL);
+        uint32_t i = sortear(&estado, n);
+        uint32_t j = sortear(&estado, n - 1);
+        if (j >= i) {
+            j++;
+        }
+        int atributo = escolher_atributo(c->o->estrategia, c->melhor, i, &estado);
+        int resultado = c->o->matriz != NULL ? resultado_matriz(c->o->matriz, atributo, i, j)
+                                             : comparar_cartas(&cartas[i], &cartas[j], atributo);
+
+        double pontos = resultado == 1 ? 1.0 : resultado == 2 ? 0.0 : 0.5;
+        double esperado = 1.0 / (1.0 + exp((av[j].rating - av[i].rating) * LN10_SOBRE_400));
+        int64_t variacao = (int64_t)llrint(k * (pontos - esperado) * ESCALA_VARIACAO);
+        fragmento[i].variacao += variacao;
+        fragmento[j].variacao -= variacao;
+
+        if (resultado == 1) {
+            fragmento[i].vitorias++;
+            fragmento[j].derrotas++;
+        } else if (resultado == 2) {
+            fragmento[i].derrotas++;
+            fragmento[j].vitorias++;
+        } else {
+            fragmento[i].empates++;
+            fragmento[j].empates++;
+        }
+    }
+}
+
+// Soma os fragmentos das cartas [inicio, fim) e aplica as variações
+static void reduzir_fragmentos(const ContextoElo *c, size_t inicio, size_t fim, int total) {
+    size_t n = c->b->quantidade;
+    for (size_t carta = inicio; carta < fim; carta++) {
+        int64_t variacao = 0;
+        long vitorias = 0, derrotas = 0, empates = 0;
+        for (int t = 0; t < total; t++) {
+            ParcialCarta *p = &c->fragmentos[(size_t)t * n + carta];
+            variacao += p->variacao;
+            vitorias += p->vitorias;
+            derrotas += p->derrotas;
+            empates += p->empates;
+            memset(p, 0, sizeof(*p));
+        }
+        AvaliacaoCarta *a = &c->avaliacoes[carta];
+        a->rating += (double)variacao / ESCALA_VARIACAO;
+        a->vitorias += vitorias;
+        a->derrotas += derrotas;
+        a->empates += empates;
+        a->jogos += vitorias + derrotas + empates;
+    }
+}
+
+// Laço de cada thread: duelos do lote, barreira, redução da faixa, barreira
+static void tarefa_elo(void *contexto, int indice, int total) {
+    ContextoElo *c = contexto;
+    nomear_thread_rastreio(indice == 0 ? "elo principal" : "elo");
+    ParcialCarta *fragmento = &c->fragmentos[(size_t)indice * c->b->quantidade];
+    size_t faixa_inicio = inicio_da_parte(c->b->quantidade, indice, total);
+    size_t faixa_fim = inicio_da_parte(c->b->quantidade, indice + 1, total);
+
+    for (long lote = c->primeiro_lote; lote < c->o->duelos; lote += c->duelos_por_lote) {
+        long tamanho = c->o->duelos - lote < c->duelos_por_lote ? c->o->duelos - lote
+                                                                : c->duelos_por_lote;
+        {
+            RASTREAR_ESCOPO("lote_de_duelos");
+            jogar_duelos(c, lote + (long)inicio_da_parte((size_t)tamanho, indice, total),
+                         lote + (long)inicio_da_parte((size_t)tamanho, indice + 1, total), fragmento);
+        }
+        sincronizar_threads();
+        reduzir_fragmentos(c, faixa_inicio, faixa_fim, total);
+        sincronizar_threads();
+
+        // Ratings do fim do lote: a thread 0 copia enquanto as outras só os
+        // leem no lote seguinte (a próxima redução espera por ela na barreira)
+        PontoRetomada *p = c->o->retomada;
+        if (indice == 0 && p != NULL && lote + tamanho < c->o->duelos && retomada_vencida(p)) {
+            salvar_retomada(p, RETOMADA_ELO, c->identificacao, (uint64_t)(lote + tamanho),
+                            c->avaliacoes, c->b->quantidade * sizeof(AvaliacaoCarta));
+        }
+    }
+}
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_elo(OpcoesElo *o) {
+    o->duelos = 1000000;
+    o->semente = 1;
+    o->threads = 0;
+    o->estrategia = ESTRATEGIA_ALEATORIA;
+    o->fator_k = FATOR_K_PADRAO;
+    o->rating_inicial = RATING_INICIAL_PADRAO;
+    o->matriz = NULL;
+    o->retomada = NULL;
+}
+
+// Calcula os ratings das cartas do baralho
+int calcular_elo(const Baralho *b, const OpcoesElo *o, AvaliacaoCarta *avaliacoes) {
+    RASTREAR_ESCOPO("calcular_elo");
+    size_t n = b->quantidade;
+    if (n < 2) {
+        return -1;
+    }
+    int threads = numero_de_threads(o->threads);
+
+    uint8_t *melhor = NULL;
+    if (o->estrategia == ESTRATEGIA_MELHOR_ATRIBUTO) {
+        melhor = malloc(n);
+        if (melhor == NULL || calcular_melhores_atributos(b, melhor) != 0) {
+            free(melhor);
+            return -1;
+        }
+    }
+    ParcialCarta *fragmentos = calloc((size_t)threads * n, sizeof(ParcialCarta));
+    if (fragmentos == NULL) {
+        free(melhor);
+        return -1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        avaliacoes[i] = (AvaliacaoCarta){ .rating = o->rating_inicial };
+    }
+
+    // O tamanho do lote depende só do baralho, nunca do número de threads
+    long por_lote = (long)n * DUELOS_POR_CARTA_LOTE / 2;
+    ContextoElo c = {
+        .b = b,
+        .o = o,
+        .melhor = melhor,
+        .avaliacoes = avaliacoes,
+        .fragmentos = fragmentos,
+        .duelos_por_lote = por_lote > DUELOS_POR_LOTE_MINIMO ? por_lote : DUELOS_POR_LOTE_MINIMO,
+    };
+
+    // Com pontos de retomada, continua do último lote gravado desta execução
+    size_t tamanho_ratings = n * sizeof(AvaliacaoCarta);
+    if (o->retomada != NULL) {
+        uint64_t id = identificar_valor(RETOMADA_ELO, o->semente);
+        id = identificar_valor(id, (uint64_t)o->duelos);
+        id = identificar_valor(id, (uint64_t)o->estrategia);
+        id = identificar_valor(id, (uint64_t)llrint(o->fator_k * ESCALA_VARIACAO));
+        id = identificar_valor(id, (uint64_t)llrint(o->rating_inicial * ESCALA_VARIACAO));
+        c.identificacao = identificar_baralho(id, b);
+        uint64_t lote = 0;
+        if (carregar_retomada(o->retomada, RETOMADA_ELO, c.identificacao, &lote, avaliacoes,
+                              tamanho_ratings) == 0
+            && lote <= (uint64_t)o->duelos && lote % (uint64_t)c.duelos_por_lote == 0) {
+            c.primeiro_lote = (long)lote;
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                avaliacoes[i] = (AvaliacaoCarta){ .rating = o->rating_inicial };
+            }
+        }
+    }
+    executar_em_paralelo(threads, tarefa_elo, &c);
+
+    if (o->retomada != NULL) {
+        esperar_retomada(o->retomada);
+        salvar_retomada(o->retomada, RETOMADA_ELO, c.identificacao, (uint64_t)o->duelos,
+                        avaliacoes, tamanho_ratings);
+    }
+
+    free(fragmentos);
+    free(melhor);
+    return 0;
+}
+
+// Avaliações usadas pelo comparador de ordenar_por_rating
+static const AvaliacaoCarta *avaliacoes_ordenacao;
+
+static int comparar_ratings(const void *a, const void *b) {
+    uint32_t i = *(const uint32_t *)a;
+    uint32_t j = *(const uint32_t *)b;
+    double ri = avaliacoes_ordenacao[i].rating;
+    double rj = avaliacoes_ordenacao[j].rating;
+    if (ri != rj) {
+        return ri > rj ? -1 : 1;
+    }
+    return (i > j) - (i < j);
+}
+
+// Preenche 'ordem' com os índices das cartas do maior para o menor rating
+void ordenar_por_rating(const AvaliacaoCarta *avaliacoes, size_t n, uint32_t *ordem) {
+    for (size_t i = 0; i < n; i++) {
+        ordem[i] = (uint32_t)i;
+    }
+    avaliacoes_ordenacao = avaliacoes;
+    qsort(ordem, n, sizeof(uint32_t), comparar_ratings);
+    avaliacoes_ordenacao = NULL;
+}
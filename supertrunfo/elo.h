@@ -0,0 +1,65 @@
+/*
+ * Super Trunfo - Rating Elo das cartas
+ *
+ * Sorteia milhões de duelos entre pares de cartas (o desafiante escolhe o
+ * atributo por uma estratégia) e atualiza o rating Elo de cada carta.
+ *
+ * Os duelos são processados em lotes: dentro de um lote todos usam os
+ * ratings do fim do lote anterior, cada thread acumula as variações num
+ * fragmento próprio em ponto fixo e, depois de uma barreira, cada thread
+ * soma os fragmentos de uma faixa de cartas. Como a soma é inteira e cada
+ * duelo depende só de (semente, índice do duelo), o resultado é idêntico
+ * com qualquer número de threads.
+ *
+ * Com um ponto de retomada nas opções, os ratings do fim de um lote (e o
+ * início do lote seguinte) vão para o arquivo de pontos quando o intervalo
+ * vence; uma execução interrompida recomeça desse lote, com os mesmos
+ * ratings e, portanto, o mesmo resultado final.
+ */
+
+#ifndef SUPERTRUNFO_ELO_H
+#define SUPERTRUNFO_ELO_H
+
+#include <stdint.h>
+
+#include "baralho.h"
+#include "matriz.h"
+#include "retomada.h"
+
+#define RATING_INICIAL_PADRAO 1500.0
+#define FATOR_K_PADRAO 16.0
+
+// Rating e resultados de uma carta
+typedef struct {
+    double rating;
+    long jogos;
+    long vitorias;
+    long derrotas;
+    long empates;
+} AvaliacaoCarta;
+
+// Opções do cálculo de ratings
+typedef struct {
+    long duelos;
+    uint64_t semente;
+    int threads;          // 0 = um por núcleo
+    int estrategia;       // ESTRATEGIA_* de estrategia.h
+    double fator_k;
+    double rating_inicial;
+    const MatrizResultados *matriz;  // Opcional: resultados pré-calculados de
+                                     // todos os atributos (mesmo baralho)
+    PontoRetomada *retomada;         // Opcional: grava pontos de retomada no fim
+                                     // dos lotes e continua do último (retomada.h)
+} OpcoesElo;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_elo(OpcoesElo *o);
+
+// Calcula os ratings das cartas do baralho em 'avaliacoes' (uma por carta);
+// retorna 0 em sucesso, -1 se o baralho tiver menos de 2 cartas ou faltar memória
+int calcular_elo(const Baralho *b, const OpcoesElo *o, AvaliacaoCarta *avaliacoes);
+
+// Preenche 'ordem' com os índices das cartas do maior para o menor rating
+void ordenar_por_rating(const AvaliacaoCarta *avaliacoes, size_t n, uint32_t *ordem);
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ * Super Trunfo - Esquema de atributos em tempo de execução
+ *
+ * Leitura do esquema (fórmulas compiladas para notação pós-fixa pelo
+ * algoritmo shunting-yard) e carga do baralho em colunas.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "esquema.h"
+#include "rastreio.h"
+
+// Campos por linha de esquema ou de baralho
+#define MAXIMO_CAMPOS (MAXIMO_ATRIBUTOS_ESQUEMA + MAXIMO_TEXTOS_ESQUEMA)
+
+// Tamanho máximo de uma linha
+#define TAMANHO_LINHA 1024
+
+// Remove espaços e quebra de linha das pontas (no próprio texto)
+static char *aparar(char *s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    size_t n = strlen(s);
+    while (n > 0 && isspace((unsigned char)s[n - 1])) {
+        s[--n] = '\0';
+    }
+    return s;
+}
+
+// Separa a linha em campos por ';' (no próprio texto); retorna quantos
+static int separar_campos(char *linha, char **campos, int maximo) {
+    int n = 0;
+    for (;;) {
+        char *fim = strchr(linha, ';');
+        if (n == maximo) {
+            return -1;
+        }
+        if (fim != NULL) {
+            *fim = '\0';
+        }
+        campos[n++] = aparar(linha);
+        if (fim == NULL) {
+            return n;
+        }
+        linha = fim + 1;
+    }
+}
+
+// Copia um nome, verificando o tamanho
+static int copiar_nome(char *destino, const char *nome, int vazio_permitido) {
+    size_t n = strlen(nome);
+    if (n >= TAMANHO_NOME_ESQUEMA || (n == 0 && !vazio_permitido)) {
+        return -1;
+    }
+    memcpy(destino, nome, n + 1);
+    return 0;
+}
+
+static int interpretar_direcao(const char *texto) {
+    if (strcmp(texto, "maior") == 0) return 0;
+    if (strcmp(texto, "menor") == 0) return 1;
+    return -1;
+}
+
+// Precedência dos operadores (0 = não é operador)
+static int precedencia(char op) {
+    return op == '+' || op == '-' ? 1 : op == '*' || op == '/' ? 2 : 0;
+}
+
+// Compila a fórmula para notação pós-fixa; só atributos já declarados
+static int compilar_formula(const Esquema *e, const char *texto, AtributoEsquema *a) {
+    char pilha[MAXIMO_TERMOS_FORMULA];
+    int topo = 0;
+    int profundidade = 0;   // Valores na pilha de avaliação
+    int espera_valor = 1;
+    a->termos = 0;
+
+    const char *p = texto;
+    while (*p) {
+        if (isspace((unsigned char)*p)) {
+            p++;
+            continue;
+        }
+        if (a->termos >= MAXIMO_TERMOS_FORMULA) {
+            return -1;
+        }
+        TermoFormula *t = &a->formula[a->termos];
+        if (isdigit((unsigned char)*p) || *p == '.') {
+            char *fim;
+            if (!espera_valor) return -1;
+            t->operacao = 'n';
+            t->numero = strtod(p, &fim);
+            p = fim;
+            a->termos++;
+            profundidade++;
+            espera_valor = 0;
+        } else if (isalpha((unsigned char)*p) || *p == '_') {
+            char nome[TAMANHO_NOME_ESQUEMA];
+            size_t n = 0;
+            while ((isalnum((unsigned char)*p) || *p == '_') && n + 1 < sizeof(nome)) {
+                nome[n++] = *p++;
+            }
+            nome[n] = '\0';
+            int atributo = buscar_atributo_esquema(e, nome);
+            if (!espera_valor || atributo == 0) return -1;
+            t->operacao = 'a';
+            t->atributo = atributo - 1;
+            a->termos++;
+            profundidade++;
+            espera_valor = 0;
+        } else if (*p == '(') {
+            if (!espera_valor || topo == MAXIMO_TERMOS_FORMULA) return -1;
+            pilha[topo++] = *p++;
+        } else if (*p == ')') {
+            if (espera_valor) return -1;
+            while (topo > 0 && pilha[topo - 1] != '(') {
+                if (a->termos >= MAXIMO_TERMOS_FORMULA) return -1;
+                a->formula[a->termos++].operacao = pilha[--topo];
+                profundidade--;
+            }
+            if (topo == 0) return -1;
+            topo--;
+            p++;
+        } else if (precedencia(*p) > 0) {
+            if (espera_valor) return -1;
+            while (topo > 0 && precedencia(pilha[topo - 1]) >= precedencia(*p)) {
+                if (a->termos >= MAXIMO_TERMOS_FORMULA) return -1;
+                a->formula[a->termos++].operacao = pilha[--topo];
+                profundidade--;
+            }
+            if (topo == MAXIMO_TERMOS_FORMULA) return -1;
+            pilha[topo++] = *p++;
+            espera_valor = 1;
+        } else {
+            return -1;
+        }
+    }
+    if (espera_valor) {
+        return -1;
+    }
+    while (topo > 0) {
+        if (pilha[topo - 1] == '(' || a->termos >= MAXIMO_TERMOS_FORMULA) return -1;
+        a->formula[a->termos++].operacao = pilha[--topo];
+        profundidade--;
+    }
+    return profundidade == 1 ? 0 : -1;
+}
+
+// Atributo (1 em diante) com o nome, ou 0 se não existe
+int buscar_atributo_esquema(const Esquema *e, const char *nome) {
+    for (int a = 0; a < e->quantidade_atributos; a++) {
+        if (strcmp(e->atributos[a].nome, nome) == 0) {
+            return a + 1;
+        }
+    }
+    return 0;
+}
+
+// Interpreta uma declaração do esquema
+static int interpretar_declaracao(Esquema *e, char **campos, int n) {
+    if (strcmp(campos[0], "esquema") == 0 && n == 2) {
+        return copiar_nome(e->nome, campos[1], 0);
+    }
+    if (strcmp(campos[0], "texto") == 0 && n == 2) {
+        if (e->quantidade_textos == MAXIMO_TEXTOS_ESQUEMA
+            || copiar_nome(e->textos[e->quantidade_textos], campos[1], 0) != 0) {
+            return -1;
+        }
+        e->colunas_texto[e->quantidade_textos++] = e->colunas++;
+        return 0;
+    }
+
+    int derivado = strcmp(campos[0], "derivado") == 0;
+    if (!derivado && !(strcmp(campos[0], "atributo") == 0 && n == 5)) {
+        return -1;
+    }
+    if ((derivado && n != 5) || e->quantidade_atributos == MAXIMO_ATRIBUTOS_ESQUEMA
+        || buscar_atributo_esquema(e, campos[1]) != 0) {
+        return -1;
+    }
+    AtributoEsquema *a = &e->atributos[e->quantidade_atributos];
+    memset(a, 0, sizeof(*a));
+    a->derivado = derivado;
+    a->coluna = -1;
+    a->tipo = TIPO_REAL;
+    if (copiar_nome(a->nome, campos[1], 0) != 0) {
+        return -1;
+    }
+    if (derivado) {
+        a->menor_vence = interpretar_direcao(campos[3]);
+        if (copiar_nome(a->unidade, campos[2], 1) != 0 || a->menor_vence < 0
+            || compilar_formula(e, campos[4], a) != 0) {
+            return -1;
+        }
+    } else {
+        if (strcmp(campos[2], "inteiro") == 0) {
+            a->tipo = TIPO_INTEIRO;
+        } else if (strcmp(campos[2], "real") != 0) {
+            return -1;
+        }
+        a->menor_vence = interpretar_direcao(campos[4]);
+        if (copiar_nome(a->unidade, campos[3], 1) != 0 || a->menor_vence < 0) {
+            return -1;
+        }
+        a->coluna = e->colunas++;
+    }
+    e->quantidade_atributos++;
+    return 0;
+}
+
+// Carrega o esquema
+int carregar_esquema(Esquema *e, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    memset(e, 0, sizeof(*e));
+    e->texto_nome = -1;
+    e->texto_codigo = -1;
+
+    char linha[TAMANHO_LINHA];
+    char *campos[MAXIMO_CAMPOS];
+    long numero_linha = 0;
+    int status = 0;
+    while (status == 0 && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        char *texto = aparar(linha);
+        if (texto[0] == '#' || texto[0] == '\0') {
+            continue;
+        }
+        int n = separar_campos(texto, campos, MAXIMO_CAMPOS);
+        if (n < 2 || interpretar_declaracao(e, campos, n) != 0) {
+            fprintf(stderr, "%s:%ld: declaração de esquema inválida\n", caminho, numero_linha);
+            status = -1;
+        }
+    }
+    fclose(arquivo);
+    if (status == 0 && (e->quantidade_textos == 0 || e->quantidade_atributos == 0)) {
+        fprintf(stderr, "%s: o esquema precisa de um texto e de um atributo\n", caminho);
+        status = -1;
+    }
+
+    for (int t = 0; t < e->quantidade_textos; t++) {
+        if (strcmp(e->textos[t], "nome") == 0 && e->texto_nome < 0) {
+            e->texto_nome = t;
+        }
+        if (strcmp(e->textos[t], "codigo") == 0 && e->texto_codigo < 0) {
+            e->texto_codigo = t;
+        }
+    }
+    if (e->texto_codigo < 0) {
+        e->texto_codigo = 0;
+    }
+    return status;
+}
+
+// Inicializa um baralho colunar vazio
+void iniciar_baralho_colunar(BaralhoColunar *b, const Esquema *e) {
+    memset(b, 0, sizeof(*b));
+    b->esquema = e;
+}
+
+// Garante espaço para mais uma carta em todas as colunas
+static int reservar_carta(BaralhoColunar *b) {
+    if (b->quantidade < b->capacidade) {
+        return 0;
+    }
+    const Esquema *e = b->esquema;
+    size_t nova = b->capacidade ? b->capacidade * 2 : 64;
+    for (int a = 0; a < e->quantidade_atributos; a++) {
+        double *v = realloc(b->valores[a], nova * sizeof(double));
+        if (v == NULL) return -1;
+        b->valores[a] = v;
+        double *c = realloc(b->chaves[a], nova * sizeof(double));
+        if (c == NULL) return -1;
+        b->chaves[a] = c;
+    }
+    for (int t = 0; t < e->quantidade_textos; t++) {
+        uint32_t *o = realloc(b->textos[t], nova * sizeof(uint32_t));
+        if (o == NULL) return -1;
+        b->textos[t] = o;
+    }
+    b->capacidade = nova;
+    return 0;
+}
+
+// Acrescenta um texto à memória de textos; retorna o início ou -1
+static long guardar_texto(BaralhoColunar *b, const char *texto) {
+    size_t n = strlen(texto) + 1;
+    if (b->tamanho_textos + n > b->capacidade_textos) {
+        size_t nova = b->capacidade_textos ? b->capacidade_textos * 2 : 4096;
+        while (nova < b->tamanho_textos + n) {
+            nova *= 2;
+        }
+        if (nova > UINT32_MAX) {
+            return -1;
+        }
+        char *m = realloc(b->memoria_textos, nova);
+        if (m == NULL) {
+            return -1;
+        }
+        b->memoria_textos = m;
+        b->capacidade_textos = nova;
+    }
+    memcpy(b->memoria_textos + b->tamanho_textos, texto, n);
+    b->tamanho_textos += n;
+    return (long)(b->tamanho_textos - n);
+}
+
+// Interpreta o valor de um atributo básico (campo vazio = inválido)
+static int interpretar_valor(const AtributoEsquema *a, const char *campo, double *valor) {
+    char *fim;
+    if (campo[0] == '\0') {
+        *valor = NAN;
+        return 0;
+    }
+    if (a->tipo == TIPO_INTEIRO) {
+        long long v = strtoll(campo, &fim, 10);
+        *valor = (double)v;
+    } else {
+        *valor = strtod(campo, &fim);
+    }
+    return fim != campo && *fim == '\0' ? 0 : -1;
+}
+
+// Valor de um derivado para a carta i (NaN se não finito)
+static double avaliar_formula(const BaralhoColunar *b, const AtributoEsquema *a, size_t i) {
+    double pilha[MAXIMO_TERMOS_FORMULA];
+    int topo = 0;
+    for (int k = 0; k < a->termos; k++) {
+        const TermoFormula *t = &a->formula[k];
+        switch (t->operacao) {
+            case 'n': pilha[topo++] = t->numero; break;
+            case 'a': pilha[topo++] = b->valores[t->atributo][i]; break;
+            case '+': topo--; pilha[topo - 1] += pilha[topo]; break;
+            case '-': topo--; pilha[topo - 1] -= pilha[topo]; break;
+            case '*': topo--; pilha[topo - 1] *= pilha[topo]; break;
+            case '/': topo--; pilha[topo - 1] /= pilha[topo]; break;
+        }
+    }
+    return isfinite(pilha[0]) ? pilha[0] : NAN;
+}
+
+// Carrega as cartas do arquivo, acrescentando ao baralho
+long carregar_baralho_colunar(BaralhoColunar *b, const char *caminho) {
+    RASTREAR_ESCOPO("carregar_baralho_colunar");
+    const Esquema *e = b->esquema;
+    FILE *arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        return -1;
+    }
+
+    char linha[TAMANHO_LINHA];
+    char *campos[MAXIMO_CAMPOS];
+    long numero_linha = 0;
+    long lidas = 0;
+    size_t primeira = b->quantidade;
+    while (fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numero_linha++;
+        if (linha[0] == '#' || linha[0] == '\n' || linha[0] == '\r') {
+            continue;
+        }
+        int valida = separar_campos(linha, campos, MAXIMO_CAMPOS) == e->colunas;
+        if (valida && reservar_carta(b) != 0) {
+            fclose(arquivo);
+            return -1;
+        }
+        size_t i = b->quantidade;
+        for (int a = 0; a < e->quantidade_atributos && valida; a++) {
+            const AtributoEsquema *at = &e->atributos[a];
+            if (!at->derivado) {
+                valida = interpretar_valor(at, campos[at->coluna], &b->valores[a][i]) == 0;
+            }
+        }
+        if (!valida) {
+            fprintf(stderr, "%s:%ld: linha de carta inválida, ignorada\n", caminho, numero_linha);
+            continue;
+        }
+        for (int t = 0; t < e->quantidade_textos; t++) {
+            long inicio = guardar_texto(b, campos[e->colunas_texto[t]]);
+            if (inicio < 0) {
+                fclose(arquivo);
+                return -1;
+            }
+            b->textos[t][i] = (uint32_t)inicio;
+        }
+        b->quantidade++;
+        lidas++;
+    }
+    fclose(arquivo);
+
+    // Derivados e chaves, coluna por coluna
+    for (int a = 0; a < e->quantidade_atributos; a++) {
+        const AtributoEsquema *at = &e->atributos[a];
+        double *valores = b->valores[a];
+        double *chaves = b->chaves[a];
+        if (at->derivado) {
+            for (size_t i = primeira; i < b->quantidade; i++) {
+                valores[i] = avaliar_formula(b, at, i);
+            }
+        }
+        double sinal = at->menor_vence ? -1.0 : 1.0;
+        for (size_t i = primeira; i < b->quantidade; i++) {
+            chaves[i] = sinal * valores[i];
+        }
+    }
+    return lidas;
+}
+
+// Libera a memória do baralho
+void liberar_baralho_colunar(BaralhoColunar *b) {
+    for (int a = 0; a < MAXIMO_ATRIBUTOS_ESQUEMA; a++) {
+        free(b->valores[a]);
+        free(b->chaves[a]);
+    }
+    for (int t = 0; t < MAXIMO_TEXTOS_ESQUEMA; t++) {
+        free(b->textos[t]);
+    }
+    free(b->memoria_textos);
+    iniciar_baralho_colunar(b, b->esquema);
+}
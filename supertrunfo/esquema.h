@@ -0,0 +1,123 @@
+/*
+ * Super Trunfo - Esquema de atributos em tempo de execução
+ *
+ * Baralhos de outros temas (carros, animais, clubes) declaram os próprios
+ * atributos num arquivo de esquema, uma declaração por linha, campos
+ * separados por ';' (linhas vazias ou iniciadas por '#' são ignoradas):
+ *
+ *   esquema;<nome do baralho>
+ *   texto;<nome>                                   coluna de texto (a primeira
+ *                                                  chamada "codigo" identifica)
+ *   atributo;<nome>;<inteiro|real>;<unidade>;<maior|menor>
+ *   derivado;<nome>;<unidade>;<maior|menor>;<fórmula>
+ *
+ * As linhas do baralho trazem as colunas de texto e os atributos na ordem
+ * em que foram declarados; os derivados são calculados na carga. A fórmula
+ * usa + - * /, parênteses, números e atributos declarados antes, ex.:
+ *
+ *   derivado;densidade;hab/km²;menor;populacao / area
+ *
+ * Os atributos (básicos e derivados) são numerados de 1 em diante na ordem
+ * de declaração, como os COMPARAR_* do baralho de cidades.
+ *
+ * Armazenamento colunar: um vetor por atributo. Na carga, cada coluna
+ * também é convertida numa coluna de chaves já orientada para "maior
+ * vence" (negada quando menor vence; NaN quando o valor é inválido: campo
+ * vazio ou fórmula sem resultado finito, como divisão por zero). Assim o
+ * comparador de qualquer atributo é o mesmo par de leituras e comparações,
+ * sem switch nem direção por chamada, e NaN empata com tudo, como os
+ * valores inválidos em comparar_cartas.
+ */
+
+#ifndef SUPERTRUNFO_ESQUEMA_H
+#define SUPERTRUNFO_ESQUEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAXIMO_ATRIBUTOS_ESQUEMA 32
+#define MAXIMO_TEXTOS_ESQUEMA 8
+#define MAXIMO_TERMOS_FORMULA 64
+#define TAMANHO_NOME_ESQUEMA 32
+
+// Tipos de atributo básico
+#define TIPO_INTEIRO 1
+#define TIPO_REAL 2
+
+// Termo de uma fórmula em notação pós-fixa
+typedef struct {
+    char operacao;   // 'n' número, 'a' atributo, ou + - * /
+    int atributo;    // Índice (base 0) do atributo, para 'a'
+    double numero;
+} TermoFormula;
+
+// Atributo declarado
+typedef struct {
+    char nome[TAMANHO_NOME_ESQUEMA];
+    char unidade[TAMANHO_NOME_ESQUEMA];
+    int tipo;                // TIPO_INTEIRO ou TIPO_REAL (derivados são reais)
+    int menor_vence;
+    int derivado;
+    int coluna;              // Posição no arquivo do baralho (-1 se derivado)
+    int termos;
+    TermoFormula formula[MAXIMO_TERMOS_FORMULA];
+} AtributoEsquema;
+
+// Esquema carregado
+typedef struct {
+    char nome[TAMANHO_NOME_ESQUEMA];
+    int quantidade_textos;
+    char textos[MAXIMO_TEXTOS_ESQUEMA][TAMANHO_NOME_ESQUEMA];
+    int colunas_texto[MAXIMO_TEXTOS_ESQUEMA];  // Posição de cada texto no arquivo
+    int quantidade_atributos;
+    AtributoEsquema atributos[MAXIMO_ATRIBUTOS_ESQUEMA];
+    int colunas;             // Campos por linha do baralho
+    int texto_codigo;        // Texto que identifica a carta
+    int texto_nome;          // Texto exibido como nome (-1 se não houver)
+} Esquema;
+
+// Baralho em colunas
+typedef struct {
+    const Esquema *esquema;
+    size_t quantidade;
+    size_t capacidade;
+    double *valores[MAXIMO_ATRIBUTOS_ESQUEMA];  // Valores (NaN = inválido)
+    double *chaves[MAXIMO_ATRIBUTOS_ESQUEMA];   // Orientadas para "maior vence"
+    uint32_t *textos[MAXIMO_TEXTOS_ESQUEMA];    // Início de cada texto em memoria_textos
+    char *memoria_textos;
+    size_t tamanho_textos;
+    size_t capacidade_textos;
+} BaralhoColunar;
+
+// Carrega o esquema; retorna 0 em sucesso, -1 em erro (a linha inválida é
+// informada na saída de erro)
+int carregar_esquema(Esquema *e, const char *caminho);
+
+// Atributo (1 em diante) com o nome, ou 0 se não existe
+int buscar_atributo_esquema(const Esquema *e, const char *nome);
+
+// Inicializa um baralho colunar vazio
+void iniciar_baralho_colunar(BaralhoColunar *b, const Esquema *e);
+
+// Carrega as cartas do arquivo, acrescentando ao baralho (linhas inválidas
+// são informadas e ignoradas); retorna o número de cartas lidas ou -1 em erro
+long carregar_baralho_colunar(BaralhoColunar *b, const char *caminho);
+
+// Compara as cartas i e j no atributo (1 em diante): 1 se i vence, 2 se j
+// vence, 0 se empate ou valor inválido
+static inline int comparar_colunar(const BaralhoColunar *b, size_t i, size_t j, int atributo) {
+    const double *chaves = b->chaves[atributo - 1];
+    double x = chaves[i];
+    double y = chaves[j];
+    return x > y ? 1 : x < y ? 2 : 0;
+}
+
+// Texto da coluna 'texto' (0 em diante) da carta i
+static inline const char *texto_colunar(const BaralhoColunar *b, int texto, size_t i) {
+    return b->memoria_textos + b->textos[texto][i];
+}
+
+// Libera a memória do baralho
+void liberar_baralho_colunar(BaralhoColunar *b);
+
+#endif
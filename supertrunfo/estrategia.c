@@ -0,0 +1,78 @@
+/*
+ * Super Trunfo - Estratégias de escolha de atributo
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "estrategia.h"
+
+// Valor de um atributo já orientado para "maior vence", com o índice da carta
+typedef struct {
+    float chave;
+    uint32_t indice;
+} ChaveCarta;
+
+static int comparar_chaves(const void *a, const void *b) {
+    float x = ((const ChaveCarta *)a)->chave;
+    float y = ((const ChaveCarta *)b)->chave;
+    return (x > y) - (x < y);
+}
+
+// Preenche melhor[i] com o atributo em que a carta i vence mais cartas do baralho
+int calcular_melhores_atributos(const Baralho *b, uint8_t *melhor) {
+    size_t n = b->quantidade;
+    ChaveCarta *chaves = malloc(n * sizeof(ChaveCarta));
+    uint32_t *melhor_contagem = calloc(n, sizeof(uint32_t));
+    if ((chaves == NULL || melhor_contagem == NULL) && n > 0) {
+        free(chaves);
+        free(melhor_contagem);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        melhor[i] = 1;
+    }
+
+    for (int atributo = 1; atributo <= NUM_ATRIBUTOS; atributo++) {
+        // Valores inválidos (negativos) empatam com tudo: não vencem ninguém
+        // e não contam como vencidos
+        size_t validas = 0;
+        for (size_t i = 0; i < n; i++) {
+            float v = obter_valor_atributo(&b->cartas[i], atributo);
+            if (v >= 0) {
+                chaves[validas].chave = atributo == COMPARAR_DENSIDADE ? -v : v;
+                chaves[validas].indice = (uint32_t)i;
+                validas++;
+            }
+        }
+        qsort(chaves, validas, sizeof(ChaveCarta), comparar_chaves);
+
+        // Cada carta vence exatamente as que ficam antes do seu grupo de empate
+        size_t inicio_grupo = 0;
+        for (size_t i = 0; i < validas; i++) {
+            if (chaves[i].chave != chaves[inicio_grupo].chave) {
+                inicio_grupo = i;
+            }
+            uint32_t c = chaves[i].indice;
+            if (inicio_grupo > melhor_contagem[c]) {
+                melhor_contagem[c] = (uint32_t)inicio_grupo;
+                melhor[c] = (uint8_t)atributo;
+            }
+        }
+    }
+
+    free(chaves);
+    free(melhor_contagem);
+    return 0;
+}
+
+// Converte "aleatoria"/"melhor" na constante; -1 se desconhecida
+int interpretar_estrategia(const char *nome) {
+    if (strcmp(nome, "aleatoria") == 0) {
+        return ESTRATEGIA_ALEATORIA;
+    }
+    if (strcmp(nome, "melhor") == 0) {
+        return ESTRATEGIA_MELHOR_ATRIBUTO;
+    }
+    return -1;
+}
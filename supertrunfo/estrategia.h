@@ -0,0 +1,37 @@
+/*
+ * Super Trunfo - Estratégias de escolha de atributo
+ *
+ * Como um jogador automático escolhe o atributo da rodada: ao acaso, ou pelo
+ * atributo em que a sua carta supera a maior fração do baralho (a escolha
+ * "inteligente" de quem conhece o baralho mas não a carta do adversário).
+ */
+
+#ifndef SUPERTRUNFO_ESTRATEGIA_H
+#define SUPERTRUNFO_ESTRATEGIA_H
+
+#include <stdint.h>
+
+#include "baralho.h"
+#include "aleatorio.h"
+
+#define ESTRATEGIA_ALEATORIA 0
+#define ESTRATEGIA_MELHOR_ATRIBUTO 1
+
+// Preenche melhor[i] com o atributo (1 a NUM_ATRIBUTOS) em que a carta i vence
+// mais cartas do baralho; retorna 0 em sucesso, -1 sem memória
+int calcular_melhores_atributos(const Baralho *b, uint8_t *melhor);
+
+// Converte "aleatoria"/"melhor" na constante; -1 se desconhecida
+int interpretar_estrategia(const char *nome);
+
+// Atributo escolhido para a carta 'carta' ('melhor' só é lido na estratégia
+// ESTRATEGIA_MELHOR_ATRIBUTO)
+static inline int escolher_atributo(int estrategia, const uint8_t *melhor,
+                                    uint32_t carta, uint64_t *estado) {
+    if (estrategia == ESTRATEGIA_MELHOR_ATRIBUTO) {
+        return melhor[carta];
+    }
+    return 1 + (int)sortear(estado, NUM_ATRIBUTOS);
+}
+
+#endif
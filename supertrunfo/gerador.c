@@ -0,0 +1,335 @@
+/*
+ * Super Trunfo - Gerador de baralhos sintéticos
+ *
+ * Cartas geradas por índice (fluxo Philox próprio de cada carta) e gravadas
+ * por blocos em paralelo, com pwrite na faixa de cada bloco.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "gerador.h"
+#include "acervo.h"
+#include "aleatorio.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Maior linha de texto de uma carta gerada (com folga)
+#define LINHA_MAXIMA_GERADOR 128
+
+// Municípios por UF (IBGE), na ordem das siglas
+static const char SIGLAS_GERADOR[][3] = {
+    "AC", "AL", "AM", "AP", "BA", "CE", "DF", "ES", "GO", "MA", "MG", "MS", "MT", "PA",
+    "PB", "PE", "PI", "PR", "RJ", "RN", "RO", "RR", "RS", "SC", "SE", "SP", "TO"
+};
+static const uint16_t MUNICIPIOS_GERADOR[] = {
+    22, 102, 62, 16, 417, 184, 1, 78, 246, 217, 853, 79, 141, 144,
+    223, 185, 224, 399, 92, 167, 52, 15, 497, 295, 75, 645, 139
+};
+#define TOTAL_MUNICIPIOS 5570
+
+// Sílabas e prefixos dos nomes
+static const char *const SILABAS_GERADOR[] = {
+    "ba", "be", "bi", "ca", "co", "cu", "da", "do", "fa", "fe", "ga", "go", "ja", "ju",
+    "la", "li", "lo", "ma", "mi", "mo", "na", "no", "pa", "pi", "ra", "ri", "ro", "sa",
+    "ta", "te", "tu", "va"
+};
+static const char *const PREFIXOS_GERADOR[] = { "São ", "Santa ", "Nova ", "Porto " };
+
+// Cartas geradas: os valores com duas casas também em centavos, para o texto
+typedef struct {
+    Carta carta;
+    int64_t area_centavos;
+    int64_t pib_centavos;
+} CartaGerada;
+
+// Contexto compartilhado pelas threads
+typedef struct {
+    const OpcoesGerador *o;
+    int fd;
+    uint64_t blocos;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    uint64_t proximo_bloco;   // Próximo bloco a reservar a sua faixa (texto)
+    long long posicao;        // Fim da última faixa reservada
+    int erro;                 // Só com __atomic enquanto os blocos rodam
+} ContextoGerador;
+
+// Real em (0, 1), nunca 0 nem 1 (seguro para log e potências negativas)
+static double uniforme_aberto(FluxoAleatorio *f) {
+    return ((double)proximo_fluxo(f) + 0.5) * (1.0 / 4294967296.0);
+}
+
+// Par de normais padrão independentes (Box-Muller)
+static void normais_padrao(FluxoAleatorio *f, double z[2]) {
+    double raio = sqrt(-2.0 * log(uniforme_aberto(f)));
+    double angulo = 6.283185307179586 * uniforme_aberto(f);
+    z[0] = raio * cos(angulo);
+    z[1] = raio * sin(angulo);
+}
+
+// Arredonda para centavos dentro de [minimo, maximo]
+static int64_t centavos(double v, double minimo, double maximo) {
+    v = v < minimo ? minimo : v > maximo ? maximo : v;
+    return (int64_t)llround(v * 100.0);
+}
+
+// Gera a carta e os valores em centavos
+static void gerar_carta_completa(uint64_t semente, uint64_t indice, CartaGerada *g) {
+    Carta *c = &g->carta;
+    FluxoAleatorio f;
+    memset(c, 0, sizeof(*c));
+    iniciar_fluxo(&f, semente, indice, RODADA_GERADOR);
+
+    // Estado pela proporção de municípios
+    uint32_t municipio = sortear_fluxo(&f, TOTAL_MUNICIPIOS);
+    int uf = 0;
+    while (municipio >= MUNICIPIOS_GERADOR[uf]) {
+        municipio -= MUNICIPIOS_GERADOR[uf++];
+    }
+    memcpy(c->estado, SIGLAS_GERADOR[uf], 3);
+
+    // Código: UF + índice em base 36
+    memcpy(c->codigo, c->estado, 2);
+    uint64_t resto = indice;
+    for (int d = 9; d >= 2; d--) {
+        c->codigo[d] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[resto % 36];
+        resto /= 36;
+    }
+
+    // Nome: prefixo opcional e 2 a 4 sílabas, a primeira maiúscula (todos os
+    // sorteios do nome saem de uma palavra: 4 bits do prefixo, 5 por sílaba
+    // e os 8 últimos para a quantidade)
+    uint32_t bits = proximo_fluxo(&f);
+    size_t n = 0;
+    if ((bits & 15) < 4) {
+        size_t t = strlen(PREFIXOS_GERADOR[bits & 15]);
+        memcpy(c->nome, PREFIXOS_GERADOR[bits & 15], t);
+        n = t;
+    }
+    size_t inicio_nome = n;
+    int silabas = 2 + (int)(((bits >> 24) * 3) >> 8);
+    for (int s = 0; s < silabas; s++) {
+        const char *silaba = SILABAS_GERADOR[(bits >> (4 + 5 * s)) & 31];
+        c->nome[n++] = silaba[0];
+        c->nome[n++] = silaba[1];
+    }
+    c->nome[inicio_nome] = (char)(c->nome[inicio_nome] - 'a' + 'A');
+
+    // População: corpo log-normal abaixo de 100 mil e cauda de Pareto acima
+    double populacao, z[2];
+    if (uniforme_aberto(&f) < POPULACAO_CAUDA_GERADOR) {
+        // Inversa da Pareto truncada em POPULACAO_MAXIMA_GERADOR
+        double u = uniforme_aberto(&f);
+        populacao = 100000.0 / (1.0 - u * (1.0 - 100000.0 / POPULACAO_MAXIMA_GERADOR));
+    } else {
+        int usadas = 2;
+        do {
+            if (usadas == 2) {
+                normais_padrao(&f, z);
+                usadas = 0;
+            }
+            populacao = 10500.0 * exp(0.95 * z[usadas++]);
+        } while (populacao >= 100000.0);
+        populacao = populacao < 800.0 ? 800.0 : populacao;
+    }
+    populacao = floor(populacao);
+    c->populacao = (int)populacao;
+
+    // Área log-normal; PIB (milhões) = população x PIB per capita log-normal
+    normais_padrao(&f, z);
+    g->area_centavos = centavos(420.0 * exp(1.2 * z[0]), 3.0, 160000.0);
+    double per_capita = 20000.0 * exp(0.55 * z[1]);
+    g->pib_centavos = centavos(populacao * per_capita / 1e6, 0.01, 1e12);
+    c->area = (float)((double)g->area_centavos / 100.0);
+    c->pib = (float)((double)g->pib_centavos / 100.0);
+
+    // Pontos turísticos: Pareto discreta (alfa 1,5) crescendo com a população
+    double pontos = (pow(uniforme_aberto(&f), -1.0 / 1.5) - 1.0) * 2.0 *
+                    pow(populacao / 1e4, 0.35);
+    c->pontos_turisticos = pontos > 1e6 ? 1000000 : (int)pontos;
+
+    calcular_atributos(c);
+}
+
+// Gera a carta 'indice' da semente
+void gerar_carta(uint64_t semente, uint64_t indice, Carta *c) {
+    CartaGerada g;
+    gerar_carta_completa(semente, indice, &g);
+    *c = g.carta;
+}
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_gerador(OpcoesGerador *o) {
+    o->cartas = 1000000;
+    o->semente = 42;
+    o->formato = GERADOR_TEXTO;
+    o->threads = 0;
+}
+
+// Escreve o inteiro em decimal e retorna o fim
+static char *escrever_inteiro(char *p, uint64_t v) {
+    char digitos[20];
+    int n = 0;
+    do {
+        digitos[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    while (n > 0) {
+        *p++ = digitos[--n];
+    }
+    return p;
+}
+
+// Escreve centavos como valor com duas casas e retorna o fim
+static char *escrever_centavos(char *p, int64_t v) {
+    p = escrever_inteiro(p, (uint64_t)v / 100);
+    *p++ = '.';
+    *p++ = (char)('0' + v / 10 % 10);
+    *p++ = (char)('0' + v % 10);
+    return p;
+}
+
+// Escreve a linha da carta no formato do arquivo de baralho
+static char *escrever_linha(char *p, const CartaGerada *g) {
+    const Carta *c = &g->carta;
+    size_t t;
+    *p++ = c->estado[0];
+    *p++ = c->estado[1];
+    *p++ = ';';
+    memcpy(p, c->codigo, 10);
+    p += 10;
+    *p++ = ';';
+    t = strlen(c->nome);
+    memcpy(p, c->nome, t);
+    p += t;
+    *p++ = ';';
+    p = escrever_inteiro(p, (uint64_t)c->populacao);
+    *p++ = ';';
+    p = escrever_centavos(p, g->area_centavos);
+    *p++ = ';';
+    p = escrever_centavos(p, g->pib_centavos);
+    *p++ = ';';
+    p = escrever_inteiro(p, (uint64_t)c->pontos_turisticos);
+    *p++ = '\n';
+    return p;
+}
+
+// Grava todo o bloco na posição, repetindo em escritas parciais
+static int gravar_na_posicao(int fd, const char *dados, size_t tamanho, long long posicao) {
+    while (tamanho > 0) {
+        ssize_t escrito = pwrite(fd, dados, tamanho, (off_t)posicao);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += escrito;
+        tamanho -= (size_t)escrito;
+        posicao += escrito;
+    }
+    return 0;
+}
+
+// Reserva a faixa do bloco de texto, na ordem dos blocos
+static long long reservar_faixa(ContextoGerador *ctx, uint64_t bloco, size_t tamanho) {
+    pthread_mutex_lock(&ctx->trava);
+    while (ctx->proximo_bloco != bloco) {
+        pthread_cond_wait(&ctx->sinal, &ctx->trava);
+    }
+    long long posicao = ctx->posicao;
+    ctx->posicao += (long long)tamanho;
+    ctx->proximo_bloco++;
+    pthread_cond_broadcast(&ctx->sinal);
+    pthread_mutex_unlock(&ctx->trava);
+    return posicao;
+}
+
+// Marca erro sem interromper a ordem das reservas (atômico: os blocos leem
+// o erro fora da trava)
+static void marcar_erro(ContextoGerador *ctx) {
+    __atomic_store_n(&ctx->erro, 1, __ATOMIC_RELAXED);
+}
+
+// Tarefa de cada thread: blocos indice, indice + total, ...
+static void tarefa_gerador(void *contexto, int indice, int total) {
+    ContextoGerador *ctx = contexto;
+    const OpcoesGerador *o = ctx->o;
+    RASTREAR_ESCOPO("gerar_blocos");
+
+    int texto = o->formato == GERADOR_TEXTO;
+    size_t capacidade = CARTAS_BLOCO_GERADOR * (texto ? LINHA_MAXIMA_GERADOR : sizeof(Carta));
+    char *buffer = malloc(capacidade);
+    if (buffer == NULL) {
+        marcar_erro(ctx);
+    }
+
+    for (uint64_t b = (uint64_t)indice; b < ctx->blocos; b += (uint64_t)total) {
+        uint64_t primeira = b * CARTAS_BLOCO_GERADOR;
+        uint64_t n = o->cartas - primeira < CARTAS_BLOCO_GERADOR ? o->cartas - primeira
+                                                                   : CARTAS_BLOCO_GERADOR;
+        // Depois de um erro os blocos só reservam faixas vazias, para não travar os outros
+        int parar = buffer == NULL || __atomic_load_n(&ctx->erro, __ATOMIC_RELAXED);
+        size_t tamanho = 0;
+        CartaGerada g;
+        for (uint64_t i = 0; i < n && !parar; i++) {
+            gerar_carta_completa(o->semente, primeira + i, &g);
+            if (texto) {
+                tamanho = (size_t)(escrever_linha(buffer + tamanho, &g) - buffer);
+            } else {
+                memcpy(buffer + tamanho, &g.carta, sizeof(Carta));
+                tamanho += sizeof(Carta);
+            }
+        }
+
+        long long posicao = texto ? reservar_faixa(ctx, b, tamanho)
+                                  : TAMANHO_CABECALHO_ACERVO + (long long)(primeira * sizeof(Carta));
+        if (!parar && gravar_na_posicao(ctx->fd, buffer, tamanho, posicao) != 0) {
+            marcar_erro(ctx);
+        }
+    }
+    free(buffer);
+}
+
+// Gera o baralho no arquivo
+long long gerar_baralho(const OpcoesGerador *o, const char *caminho) {
+    RASTREAR_ESCOPO("gerar_baralho");
+    if (o->cartas > MAXIMO_CARTAS_GERADOR) {
+        return -1;
+    }
+    ContextoGerador ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.o = o;
+    ctx.blocos = (o->cartas + CARTAS_BLOCO_GERADOR - 1) / CARTAS_BLOCO_GERADOR;
+    ctx.fd = open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (ctx.fd < 0) {
+        return -1;
+    }
+
+    // Binário: cabeçalho da foto do acervo, seguido das cartas
+    if (o->formato == GERADOR_BINARIO) {
+        unsigned char cabecalho[TAMANHO_CABECALHO_ACERVO];
+        preencher_cabecalho_acervo(cabecalho, o->cartas);
+        ctx.erro = gravar_na_posicao(ctx.fd, (const char *)cabecalho, sizeof(cabecalho), 0) != 0;
+        ctx.posicao = TAMANHO_CABECALHO_ACERVO + (long long)(o->cartas * sizeof(Carta));
+    }
+
+    pthread_mutex_init(&ctx.trava, NULL);
+    pthread_cond_init(&ctx.sinal, NULL);
+    if (!ctx.erro) {
+        executar_em_paralelo(numero_de_threads(o->threads), tarefa_gerador, &ctx);
+    }
+    pthread_mutex_destroy(&ctx.trava);
+    pthread_cond_destroy(&ctx.sinal);
+
+    if (close(ctx.fd) != 0) {
+        ctx.erro = 1;
+    }
+    return ctx.erro ? -1 : ctx.posicao;
+}
@@ -0,0 +1,67 @@
+/*
+ * Super Trunfo - Gerador de baralhos sintéticos
+ *
+ * Gera baralhos de qualquer tamanho para medir desempenho sem usar baralhos
+ * reais. A carta i é uma função pura de (semente, i): cada uma tira seus
+ * números do fluxo Philox (semente, i, RODADA_GERADOR) de aleatorio.h, então
+ * o arquivo é o mesmo byte a byte com qualquer número de threads.
+ *
+ * As distribuições imitam os municípios brasileiros:
+ * - estado: a proporção real de municípios por UF (IBGE, 5570 municípios);
+ * - população: corpo log-normal (mediana perto de 11 mil habitantes) e,
+ *   em POPULACAO_CAUDA_GERADOR das cartas, cauda de Pareto (alfa 1, lei de
+ *   Zipf das cidades) de 100 mil a POPULACAO_MAXIMA_GERADOR habitantes;
+ * - área: log-normal com mediana perto de 420 km²;
+ * - PIB: população vezes um PIB per capita log-normal, então herda a cauda
+ *   da população;
+ * - pontos turísticos: cauda de Pareto discreta, crescendo com a população.
+ * Área e PIB têm duas casas decimais. O código é a UF seguida do índice da
+ * carta em base 36 (8 dígitos), então é único até 36^8 cartas.
+ *
+ * O arquivo sai em texto (formato de carregar_baralho) ou em binário, como
+ * uma foto do acervo (cabeçalho e vetor de Carta), que abrir_acervo mapeia
+ * sem interpretar nada. O binário só serve para o acervo (modo acervo ou
+ * --acervo): os modos que carregam baralhos leem apenas o texto. As threads geram blocos de CARTAS_BLOCO_GERADOR
+ * cartas e gravam com pwrite na posição de cada bloco: no binário a posição
+ * é fixa; no texto cada bloco reserva a sua faixa do arquivo na ordem dos
+ * blocos, assim que o anterior sabe o próprio tamanho, e a gravação em si
+ * corre em paralelo.
+ */
+
+#ifndef SUPERTRUNFO_GERADOR_H
+#define SUPERTRUNFO_GERADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "carta.h"
+
+#define CARTAS_BLOCO_GERADOR 16384
+#define RODADA_GERADOR 0x47455200u  // "GER" no contador, longe das rodadas dos jogos
+#define POPULACAO_CAUDA_GERADOR 0.06
+#define POPULACAO_MAXIMA_GERADOR 20000000.0
+#define MAXIMO_CARTAS_GERADOR 2821109907456ULL  // 36^8
+
+// Formato do arquivo gerado
+#define GERADOR_TEXTO 0
+#define GERADOR_BINARIO 1
+
+// Opções do gerador
+typedef struct {
+    uint64_t cartas;
+    uint64_t semente;
+    int formato;              // GERADOR_TEXTO ou GERADOR_BINARIO
+    int threads;              // 0 = um por núcleo
+} OpcoesGerador;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_gerador(OpcoesGerador *o);
+
+// Gera a carta 'indice' da semente (com os atributos derivados)
+void gerar_carta(uint64_t semente, uint64_t indice, Carta *c);
+
+// Gera o baralho no arquivo e retorna os bytes gravados, ou -1 em erro
+// (arquivo, memória ou mais de MAXIMO_CARTAS_GERADOR cartas)
+long long gerar_baralho(const OpcoesGerador *o, const char *caminho);
+
+#endif
@@ -0,0 +1,345 @@
+/*
+ * Super Trunfo - Interface de terminal
+ *
+ * Cadastro interativo de cartas e exibição dos resultados das comparações.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+#include "interface.h"
+
+// Formatador da saída legível por máquina (NULL = texto decorado)
+static FormatadorSaida *formatador = NULL;
+
+// Direciona as funções de exibição para o formatador
+void definir_formatador_interface(FormatadorSaida *f) {
+    formatador = f;
+}
+
+// Regras da casa da comparação avançada (NULL = regras fixas)
+static const ProgramaRegras *regras = NULL;
+
+// Usa as regras da casa na comparação avançada
+void definir_regras_interface(const ProgramaRegras *p) {
+    regras = p;
+}
+
+// Resultado da comparação avançada com as regras em uso
+static int resultado_avancado(const Carta *c1, const Carta *c2) {
+    return regras != NULL ? aplicar_regras(regras, c1, c2) : comparacao_avancada(c1, c2);
+}
+
+// Função para limpar o buffer do teclado
+void limpar_buffer(void) {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+}
+
+// Função para ler os dados de uma carta do usuário
+void ler_carta(Carta *c) {
+    int ret;
+    printf("\n=== CADASTRO DE CARTA ===\n");
+
+    do {
+        printf("\nEstado (sigla com 2 letras, ex: SP): ");
+        ret = scanf("%2s", c->estado);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro na leitura. Tente novamente.\n");
+            continue;
+        }
+        // Converte para maiúsculas
+        c->estado[0] = toupper(c->estado[0]);
+        c->estado[1] = toupper(c->estado[1]);
+
+        if (strlen(c->estado) != 2) {
+            printf("A sigla do estado deve ter exatamente 2 letras!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nCódigo da carta (max 10 caracteres): ");
+        ret = scanf("%10s", c->codigo);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro na leitura. Tente novamente.\n");
+            continue;
+        }
+        if (strlen(c->codigo) == 0) {
+            printf("O código não pode estar vazio!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nNome da cidade (max 49 caracteres): ");
+        ret = scanf(" %49[^\n]", c->nome);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro na leitura. Tente novamente.\n");
+            continue;
+        }
+        if (strlen(c->nome) == 0) {
+            printf("O nome da cidade não pode estar vazio!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nPopulação (número inteiro >= 0): ");
+        ret = scanf("%d", &c->populacao);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro: digite um número inteiro válido!\n");
+            continue;
+        }
+        if (c->populacao < 0) {
+            printf("A população não pode ser negativa!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nÁrea em km² (número > 0): ");
+        ret = scanf("%f", &c->area);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro: digite um número válido!\n");
+            continue;
+        }
+        if (c->area <= 0) {
+            printf("A área deve ser maior que zero!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nPIB em milhões de R$ (>= 0): ");
+        ret = scanf("%f", &c->pib);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro: digite um número válido!\n");
+            continue;
+        }
+        if (c->pib < 0) {
+            printf("O PIB não pode ser negativo!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+
+    do {
+        printf("\nNúmero de pontos turísticos (>= 0): ");
+        ret = scanf("%d", &c->pontos_turisticos);
+        limpar_buffer();
+        if (ret != 1) {
+            printf("Erro: digite um número inteiro válido!\n");
+            continue;
+        }
+        if (c->pontos_turisticos < 0) {
+            printf("O número de pontos turísticos não pode ser negativo!\n");
+            ret = 0;
+        }
+    } while (ret != 1);
+}
+
+// Função para exibir menu de seleção de atributo
+int selecionar_atributo(const char *ordem, int atributo_indisponivel) {
+    int opcao;
+    do {
+        printf("\n=== SELEÇÃO DO %s ATRIBUTO ===\n", ordem);
+        printf("Escolha um atributo para comparação:\n\n");
+
+        // Mostra apenas os atributos disponíveis
+        if (atributo_indisponivel != 1) printf("1. População\n");
+        if (atributo_indisponivel != 2) printf("2. Área\n");
+        if (atributo_indisponivel != 3) printf("3. PIB\n");
+        if (atributo_indisponivel != 4) printf("4. Densidade Populacional\n");
+        if (atributo_indisponivel != 5) printf("5. PIB per capita\n");
+        if (atributo_indisponivel != 6) printf("6. Pontos Turísticos\n");
+
+        printf("\nSua escolha: ");
+        scanf("%d", &opcao);
+        limpar_buffer();
+
+        // Verifica se a opção é válida e diferente do atributo indisponível
+        if (opcao < 1 || opcao > 6 || opcao == atributo_indisponivel) {
+            printf("\nOpção inválida! Por favor, escolha um atributo disponível.\n");
+            continue;
+        }
+        break;
+    } while (1);
+
+    return opcao;
+}
+
+// Função para comparar dois atributos e determinar o vencedor
+void comparar_dois_atributos(const Carta *c1, const Carta *c2, int atrib1, int atrib2) {
+    system("cls");
+    printf("\n=== COMPARAÇÃO COM DOIS ATRIBUTOS ===\n\n");
+
+    // Obtém os valores dos atributos
+    float valor1_c1 = obter_valor_atributo(c1, atrib1);
+    float valor1_c2 = obter_valor_atributo(c2, atrib1);
+    float valor2_c1 = obter_valor_atributo(c1, atrib2);
+    float valor2_c2 = obter_valor_atributo(c2, atrib2);
+
+    // Normaliza os valores para a soma (inverte para densidade onde menor é melhor)
+    float soma_c1 = (atrib1 == 4 ? -valor1_c1 : valor1_c1) +
+                    (atrib2 == 4 ? -valor2_c1 : valor2_c1);
+    float soma_c2 = (atrib1 == 4 ? -valor1_c2 : valor1_c2) +
+                    (atrib2 == 4 ? -valor2_c2 : valor2_c2);
+
+    // Exibe os valores comparados
+    printf("=== %s ===\n", c1->nome);
+    printf("%s: %.2f\n", nome_atributo(atrib1), valor1_c1);
+    printf("%s: %.2f\n", nome_atributo(atrib2), valor2_c1);
+    printf("Soma normalizada: %.2f\n\n", soma_c1);
+
+    printf("=== %s ===\n", c2->nome);
+    printf("%s: %.2f\n", nome_atributo(atrib1), valor1_c2);
+    printf("%s: %.2f\n", nome_atributo(atrib2), valor2_c2);
+    printf("Soma normalizada: %.2f\n\n", soma_c2);
+
+    // Determina o vencedor usando a regra do núcleo e operador ternário
+    int resultado = resultado_dois_atributos(c1, c2, atrib1, atrib2);
+    printf("RESULTADO: ");
+    printf("%s\n", resultado == 0 ? "🤝 EMPATE!" :
+           resultado == 1 ?
+           "🏆 " : "🥈 ");
+
+    if (resultado != 0) {
+        printf("%s venceu com uma soma de %.2f contra %.2f!\n",
+               resultado == 1 ? c1->nome : c2->nome,
+               resultado == 1 ? soma_c1 : soma_c2,
+               resultado == 1 ? soma_c2 : soma_c1);
+    }
+}
+
+// Exibe os dados de uma carta
+void exibir_carta(const Carta *carta) {
+    if (formatador != NULL) {
+        formatar_carta(formatador, carta);
+        descarregar_formatador(formatador);
+        return;
+    }
+    printf("\n===================================\n");
+    printf("Carta: %s\n", carta->nome);
+    printf("-----------------------------------\n");
+    printf("Estado: %s\n", carta->estado);
+    printf("Codigo: %s\n", carta->codigo);
+    // Dados básicos
+    printf("Populacao: %d habitantes\n", carta->populacao);
+    printf("Area: %.2f km²\n", carta->area);
+    printf("PIB: R$ %.2f milhoes\n", carta->pib);
+    printf("Pontos Turisticos: %d\n", carta->pontos_turisticos);
+
+    // Dados calculados
+    printf("\nDados Calculados:\n");
+    printf("-----------------------------------\n");
+
+    if (carta->densidade >= 0) {
+        printf("Densidade Populacional: %.2f hab/km²\n", carta->densidade);
+        printf("(%.2f habitantes por quilômetro quadrado)\n", carta->densidade);
+    } else {
+        printf("Densidade Populacional: Não calculável (área = 0)\n");
+    }
+
+    if (carta->pib_per_capita >= 0) {
+        printf("PIB per capita: R$ %.2f\n", carta->pib_per_capita);
+        printf("(R$ %.2f reais por habitante)\n", carta->pib_per_capita);
+    } else {
+        printf("PIB per capita: Não calculável (população = 0)\n");
+    }
+    printf("===================================\n");
+}
+
+// Exibe o resultado da comparação avançada
+void exibir_resultado_avancado(const Carta *c1, const Carta *c2) {
+    if (formatador != NULL) {
+        formatar_resultado_avancado(formatador, c1, c2, resultado_avancado(c1, c2));
+        descarregar_formatador(formatador);
+        return;
+    }
+    printf("\n=== ANÁLISE AVANÇADA ===\n");
+
+    printf("\nPopulação vs PIB:\n");
+    printf("%s: %d habitantes, PIB: R$ %.2f milhões\n", c1->nome, c1->populacao, c1->pib);
+    printf("%s: %d habitantes, PIB: R$ %.2f milhões\n", c2->nome, c2->populacao, c2->pib);
+
+    printf("\nQualidade de Vida:\n");
+    printf("%s: %.2f hab/km², %d pontos turísticos\n", c1->nome, c1->densidade, c1->pontos_turisticos);
+    printf("%s: %.2f hab/km², %d pontos turísticos\n", c2->nome, c2->densidade, c2->pontos_turisticos);
+
+    printf("\nDesenvolvimento:\n");
+    printf("%s: R$ %.2f PIB per capita, %d pontos turísticos\n", c1->nome, c1->pib_per_capita, c1->pontos_turisticos);
+    printf("%s: R$ %.2f PIB per capita, %d pontos turísticos\n", c2->nome, c2->pib_per_capita, c2->pontos_turisticos);
+
+    int resultado = resultado_avancado(c1, c2);
+    printf("\nRESULTADO DA ANÁLISE AVANÇADA%s:\n", regras != NULL ? " (REGRAS DA CASA)" : "");
+    if (resultado == 1) {
+        printf("🌟 %s demonstra melhor desenvolvimento geral!\n", c1->nome);
+    } else if (resultado == 2) {
+        printf("🌟 %s demonstra melhor desenvolvimento geral!\n", c2->nome);
+    } else {
+        printf("🤝 As cidades estão em níveis similares de desenvolvimento.\n");
+    }
+}
+
+// Exibe o resultado da comparação entre duas cartas
+void exibir_comparacao(const Carta *c1, const Carta *c2, int atributo) {
+    if (formatador != NULL) {
+        formatar_comparacao(formatador, c1, c2, atributo, comparar_cartas(c1, c2, atributo));
+        descarregar_formatador(formatador);
+        return;
+    }
+    printf("\n=== COMPARAÇÃO DE CARTAS ===\n");
+    printf("Atributo: %s\n\n", nome_atributo(atributo));
+
+    switch (atributo) {
+        case 1:  // População
+            printf("Carta 1 - %s (%s): %d habitantes\n", c1->nome, c1->estado, c1->populacao);
+            printf("Carta 2 - %s (%s): %d habitantes\n", c2->nome, c2->estado, c2->populacao);
+            break;
+        case 2:  // Área
+            printf("Carta 1 - %s (%s): %.2f km²\n", c1->nome, c1->estado, c1->area);
+            printf("Carta 2 - %s (%s): %.2f km²\n", c2->nome, c2->estado, c2->area);
+            break;
+        case 3:  // PIB
+            printf("Carta 1 - %s (%s): R$ %.2f milhões\n", c1->nome, c1->estado, c1->pib);
+            printf("Carta 2 - %s (%s): R$ %.2f milhões\n", c2->nome, c2->estado, c2->pib);
+            break;
+        case 4:  // Densidade
+            if (c1->densidade >= 0) {
+                printf("Carta 1 - %s (%s): %.2f hab/km²\n", c1->nome, c1->estado, c1->densidade);
+            } else {
+                printf("Carta 1 - %s (%s): Densidade não calculável\n", c1->nome, c1->estado);
+            }
+            if (c2->densidade >= 0) {
+                printf("Carta 2 - %s (%s): %.2f hab/km²\n", c2->nome, c2->estado, c2->densidade);
+            } else {
+                printf("Carta 2 - %s (%s): Densidade não calculável\n", c2->nome, c2->estado);
+            }
+            break;
+        case 5:  // PIB per capita
+            if (c1->pib_per_capita >= 0) {
+                printf("Carta 1 - %s (%s): R$ %.2f\n", c1->nome, c1->estado, c1->pib_per_capita);
+            } else {
+                printf("Carta 1 - %s (%s): PIB per capita não calculável\n", c1->nome, c1->estado);
+            }
+            if (c2->pib_per_capita >= 0) {
+                printf("Carta 2 - %s (%s): R$ %.2f\n", c2->nome, c2->estado, c2->pib_per_capita);
+            } else {
+                printf("Carta 2 - %s (%s): PIB per capita não calculável\n", c2->nome, c2->estado);
+            }
+            break;
+        case 6:  // Pontos turísticos
+            printf("Carta 1 - %s (%s): %d pontos turísticos\n", c1->nome, c1->estado, c1->pontos_turisticos);
+            printf("Carta 2 - %s (%s): %d pontos turísticos\n", c2->nome, c2->estado, c2->pontos_turisticos);
+            break;
+    }
+    printf("\n");
+}
@@ -0,0 +1,44 @@
+/*
+ * Super Trunfo - Interface de terminal
+ *
+ * Cadastro interativo de cartas e exibição dos resultados das comparações.
+ * Com um formatador definido, exibir_carta, exibir_comparacao e
+ * exibir_resultado_avancado emitem registros JSON Lines/CSV (saida.h) em vez
+ * do texto decorado.
+ */
+
+#ifndef SUPERTRUNFO_INTERFACE_H
+#define SUPERTRUNFO_INTERFACE_H
+
+#include "carta.h"
+#include "saida.h"
+#include "regras.h"
+
+// Função para limpar o buffer do teclado
+void limpar_buffer(void);
+
+// Função para ler os dados de uma carta do usuário
+void ler_carta(Carta *c);
+
+// Função para exibir menu de seleção de atributo
+int selecionar_atributo(const char *ordem, int atributo_indisponivel);
+
+// Direciona as funções de exibição para o formatador (NULL volta ao texto)
+void definir_formatador_interface(FormatadorSaida *f);
+
+// Usa as regras da casa na comparação avançada (NULL volta às regras fixas)
+void definir_regras_interface(const ProgramaRegras *p);
+
+// Exibe os dados de uma carta
+void exibir_carta(const Carta *carta);
+
+// Exibe o resultado da comparação entre duas cartas
+void exibir_comparacao(const Carta *c1, const Carta *c2, int atributo);
+
+// Exibe o resultado da comparação avançada
+void exibir_resultado_avancado(const Carta *c1, const Carta *c2);
+
+// Função para comparar dois atributos e exibir o vencedor
+void comparar_dois_atributos(const Carta *c1, const Carta *c2, int atrib1, int atrib2);
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * Super Trunfo - Matriz de resultados pré-calculada
+ *
+ * As chaves de cada atributo ficam num vetor com folga até múltiplo de 32
+ * (folga = NaN, que empata com tudo); assim cada palavra da linha sai de um
+ * laço fixo de 32 comparações sem desvios, que o compilador vetoriza.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "matriz.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Colunas por palavra de 64 bits
+#define COLUNAS_POR_PALAVRA 32
+
+// Código de 2 bits do par (chave da linha, chave da coluna)
+static inline uint64_t codigo_par(float linha, float coluna) {
+    return (uint64_t)(linha > coluna) | (uint64_t)(linha < coluna) << 1;
+}
+
+// Preenche a linha i a partir das chaves do atributo
+static void calcular_linha(const MatrizResultados *m, int a, size_t i) {
+    const float *chaves = m->chaves[a];
+    uint64_t *linha = m->bits[a] + i * m->palavras_por_linha;
+    float chave = chaves[i];
+    for (size_t w = 0; w < m->palavras_por_linha; w++) {
+        const float *colunas = chaves + w * COLUNAS_POR_PALAVRA;
+        uint64_t palavra = 0;
+        for (int t = 0; t < COLUNAS_POR_PALAVRA; t++) {
+            palavra |= codigo_par(chave, colunas[t]) << (2 * t);
+        }
+        linha[w] = palavra;
+    }
+}
+
+// Cada thread calcula uma faixa de linhas de todos os atributos
+static void tarefa_matriz(void *contexto, int indice, int total) {
+    MatrizResultados *m = contexto;
+    RASTREAR_ESCOPO("matriz_linhas");
+    size_t inicio = inicio_da_parte(m->quantidade, indice, total);
+    size_t fim = inicio_da_parte(m->quantidade, indice + 1, total);
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        if (m->bits[a] == NULL) {
+            continue;
+        }
+        for (size_t i = inicio; i < fim; i++) {
+            calcular_linha(m, a, i);
+        }
+    }
+}
+
+// Valor do atributo orientado para "maior vence" (NaN se inválido)
+static float chave_atributo(const Carta *c, int atributo) {
+    float v = obter_valor_atributo(c, atributo);
+    if (v < 0) {
+        return NAN;
+    }
+    return atributo == COMPARAR_DENSIDADE ? -v : v;
+}
+
+// Recalcula a chave da carta i em todos os atributos construídos
+static void preencher_chaves(MatrizResultados *m, const Baralho *b, size_t i) {
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        if (m->chaves[a] != NULL) {
+            m->chaves[a][i] = chave_atributo(&b->cartas[i], a + 1);
+        }
+    }
+}
+
+// Constrói a matriz dos atributos pedidos para o baralho
+int construir_matriz_resultados(MatrizResultados *m, const Baralho *b, unsigned atributos,
+                                int threads) {
+    memset(m, 0, sizeof(*m));
+    m->quantidade = b->quantidade;
+    m->palavras_por_linha = (b->quantidade + COLUNAS_POR_PALAVRA - 1) / COLUNAS_POR_PALAVRA;
+    m->atributos = atributos & TODOS_ATRIBUTOS;
+    m->threads = threads;
+
+    size_t colunas = m->palavras_por_linha * COLUNAS_POR_PALAVRA;
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        if (!(m->atributos & (1u << a))) {
+            continue;
+        }
+        m->chaves[a] = malloc((colunas > 0 ? colunas : 1) * sizeof(float));
+        m->bits[a] = malloc((m->quantidade * m->palavras_por_linha + 1) * sizeof(uint64_t));
+        if (m->chaves[a] == NULL || m->bits[a] == NULL) {
+            liberar_matriz_resultados(m);
+            return -1;
+        }
+        for (size_t i = b->quantidade; i < colunas; i++) {
+            m->chaves[a][i] = NAN;
+        }
+    }
+    for (size_t i = 0; i < b->quantidade; i++) {
+        preencher_chaves(m, b, i);
+    }
+
+    executar_em_paralelo(numero_de_threads(threads), tarefa_matriz, m);
+    return 0;
+}
+
+// Conta os bits de 'mascara' na linha i
+static size_t contar_linha(const MatrizResultados *m, int atributo, size_t i, uint64_t mascara) {
+    const uint64_t *linha = m->bits[atributo - 1] + i * m->palavras_por_linha;
+    size_t total = 0;
+    for (size_t w = 0; w < m->palavras_por_linha; w++) {
+        total += (size_t)__builtin_popcountll(linha[w] & mascara);
+    }
+    return total;
+}
+
+// Quantas cartas a carta i vence no atributo
+size_t vitorias_matriz(const MatrizResultados *m, int atributo, size_t i) {
+    return contar_linha(m, atributo, i, BITS_VITORIA);
+}
+
+// Quantas cartas vencem a carta i no atributo
+size_t derrotas_matriz(const MatrizResultados *m, int atributo, size_t i) {
+    return contar_linha(m, atributo, i, BITS_VITORIA << 1);
+}
+
+// Recalcula linha e coluna da carta i depois de ela mudar
+int atualizar_carta_matriz(MatrizResultados *m, const Baralho *b, size_t i) {
+    if (b->quantidade != m->quantidade) {
+        unsigned atributos = m->atributos;
+        int threads = m->threads;
+        liberar_matriz_resultados(m);
+        return construir_matriz_resultados(m, b, atributos, threads);
+    }
+    preencher_chaves(m, b, i);
+
+    size_t palavra = i / COLUNAS_POR_PALAVRA;
+    unsigned deslocamento = 2 * (unsigned)(i % COLUNAS_POR_PALAVRA);
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        if (m->bits[a] == NULL) {
+            continue;
+        }
+        calcular_linha(m, a, i);
+
+        // Coluna i: o par (j, i) de cada linha j
+        const float *chaves = m->chaves[a];
+        for (size_t j = 0; j < m->quantidade; j++) {
+            uint64_t *p = m->bits[a] + j * m->palavras_por_linha + palavra;
+            *p = (*p & ~(3ULL << deslocamento)) | codigo_par(chaves[j], chaves[i]) << deslocamento;
+        }
+    }
+    return 0;
+}
+
+// Bytes ocupados pelos bits da matriz
+size_t memoria_matriz(const MatrizResultados *m) {
+    size_t construidos = (size_t)__builtin_popcount(m->atributos);
+    return construidos * m->quantidade * m->palavras_por_linha * sizeof(uint64_t);
+}
+
+// Libera a matriz
+void liberar_matriz_resultados(MatrizResultados *m) {
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        free(m->bits[a]);
+        free(m->chaves[a]);
+    }
+    memset(m, 0, sizeof(*m));
+}
@@ -0,0 +1,75 @@
+/*
+ * Super Trunfo - Matriz de resultados pré-calculada
+ *
+ * Para cada atributo, o resultado de comparar_cartas(i, j) de todos os pares
+ * do baralho num código de 2 bits (0 = empate, 1 = i vence, 2 = j vence: o
+ * próprio retorno de comparar_cartas). Cada linha ocupa um número inteiro
+ * de palavras de 64 bits (32 colunas por palavra), então:
+ *
+ *   - o resultado de um par é uma leitura e um deslocamento;
+ *   - "quantas cartas i vence" é a soma de popcount(linha & 0x5555...).
+ *
+ * Memória: n²/4 bytes por atributo (50 mil cartas = ~625 MB por atributo),
+ * por isso é possível construir só alguns atributos. As linhas são
+ * calculadas em paralelo a partir do valor de cada carta já orientado para
+ * "maior vence"; valores inválidos viram NaN, que empata com tudo, como na
+ * regra de comparar_cartas.
+ *
+ * Quando uma carta muda, atualizar_carta_matriz recalcula só a sua linha e
+ * a sua coluna (O(n) por atributo); se o baralho mudar de tamanho, a matriz
+ * inteira é reconstruída.
+ */
+
+#ifndef SUPERTRUNFO_MATRIZ_H
+#define SUPERTRUNFO_MATRIZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+// Todos os atributos (bit atributo - 1)
+#define TODOS_ATRIBUTOS ((1u << NUM_ATRIBUTOS) - 1)
+
+// Máscara dos bits "linha vence" de uma palavra
+#define BITS_VITORIA 0x5555555555555555ULL
+
+// Resultados de todos os pares, por atributo
+typedef struct {
+    size_t quantidade;            // Cartas (linhas e colunas)
+    size_t palavras_por_linha;
+    unsigned atributos;           // Atributos construídos (bit atributo - 1)
+    int threads;                  // 0 = um por núcleo
+    uint64_t *bits[NUM_ATRIBUTOS];
+    float *chaves[NUM_ATRIBUTOS]; // Valores orientados ("maior vence"; NaN = inválido)
+} MatrizResultados;
+
+// Constrói a matriz dos atributos pedidos (máscara) para o baralho;
+// retorna 0 em sucesso, -1 sem memória
+int construir_matriz_resultados(MatrizResultados *m, const Baralho *b, unsigned atributos,
+                                int threads);
+
+// Resultado de comparar_cartas(cartas[i], cartas[j], atributo); o atributo precisa
+// ter sido construído
+static inline int resultado_matriz(const MatrizResultados *m, int atributo, size_t i, size_t j) {
+    const uint64_t *linha = m->bits[atributo - 1] + i * m->palavras_por_linha;
+    return (int)(linha[j / 32] >> (2 * (j % 32))) & 3;
+}
+
+// Quantas cartas a carta i vence no atributo
+size_t vitorias_matriz(const MatrizResultados *m, int atributo, size_t i);
+
+// Quantas cartas vencem a carta i no atributo
+size_t derrotas_matriz(const MatrizResultados *m, int atributo, size_t i);
+
+// Recalcula linha e coluna da carta i depois de ela mudar (ou reconstrói
+// tudo se o baralho mudou de tamanho); retorna 0 em sucesso, -1 sem memória
+int atualizar_carta_matriz(MatrizResultados *m, const Baralho *b, size_t i);
+
+// Bytes ocupados pelos bits da matriz
+size_t memoria_matriz(const MatrizResultados *m);
+
+// Libera a matriz
+void liberar_matriz_resultados(MatrizResultados *m);
+
+#endif
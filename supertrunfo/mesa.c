@@ -0,0 +1,741 @@
+/*
+ * Super Trunfo - Mesa de jogo com vários jogadores
+ *
+ * Laço de eventos com poll() sobre os descritores dos jogadores; cada
+ * partida é uma corrotina (corrotina.h) que guarda todo o seu estado na
+ * estrutura Partida. Nenhuma operação de E/S bloqueia: a leitura acumula
+ * bytes até formar uma linha e a escrita esvazia o buffer de saída quando
+ * o descritor aceita mais dados.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "mesa.h"
+#include "corrotina.h"
+#include "estrategia.h"
+#include "metricas.h"
+
+// Maior linha aceita de um jogador (linhas maiores são cortadas)
+#define TAMANHO_ENTRADA 512
+
+// Saída pendente máxima: acima disso o jogador não está lendo e é desconectado
+#define LIMITE_SAIDA 65536
+
+// Conexões pendentes no socket de escuta
+#define FILA_ESCUTA 64
+
+typedef struct Partida Partida;
+
+// Um jogador: descritores, buffers e a partida em que está
+typedef struct {
+    int fd_entrada;
+    int fd_saida;
+    int proprios;            // 1 se os descritores foram abertos pela mesa
+    int bot;
+    char nome[48];
+    char entrada[TAMANHO_ENTRADA];
+    size_t tamanho_entrada;
+    char *saida;
+    size_t tamanho_saida;
+    size_t capacidade_saida;
+    int fim_entrada;         // Fim de arquivo na entrada (a saída continua)
+    int fechado;             // Erro ou saída estourada: jogador desconectado
+    int encerrando;          // Partida acabou: esvazia a saída e fecha
+    Partida *partida;
+} Jogador;
+
+// Uma partida entre dois jogadores (estado da corrotina)
+struct Partida {
+    Corrotina co;
+    int numero;
+    Jogador *jogadores[2];
+    Carta cartas[2];
+    uint32_t indices_bot[2];  // Carta do baralho sorteada pelo bot
+    int cadastrada[2];
+    int rodada;
+    int escolhedor;
+    int atributo;             // -1 enquanto não escolhido; 0 = desistência
+    int placar[2];
+    int perdedor;             // -1; 0 ou 1 se perdeu por W.O./desistência; 2 se os dois
+    uint64_t prazo_ns;
+    int acordar;
+};
+
+// Estado do laço de eventos
+typedef struct {
+    const OpcoesMesa *o;
+    uint8_t *melhor;          // Melhor atributo de cada carta do baralho (bots)
+    Jogador **jogadores;
+    size_t quantidade_jogadores;
+    size_t capacidade_jogadores;
+    Partida **partidas;
+    size_t quantidade_partidas;
+    size_t capacidade_partidas;
+    Jogador *esperando;       // Jogador sem adversário ainda
+    int fd_escuta;
+    int proximo_numero;
+    int conexoes;
+    int bots;
+    uint64_t estado;
+} Mesa;
+
+// ---------------------------------------------------------------------------
+// Jogadores e E/S
+// ---------------------------------------------------------------------------
+
+// Acrescenta texto formatado à saída do jogador (descartado para bots)
+static void enviar(Jogador *j, const char *formato, ...) {
+    if (j->bot || j->fechado) {
+        return;
+    }
+    char texto[1024];
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(texto, sizeof(texto), formato, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    size_t tamanho = (size_t)n < sizeof(texto) ? (size_t)n : sizeof(texto) - 1;
+
+    if (j->tamanho_saida + tamanho > LIMITE_SAIDA) {
+        // Jogador parado há muito tempo: desconecta em vez de acumular
+        j->fechado = 1;
+        j->tamanho_saida = 0;
+        return;
+    }
+    if (j->tamanho_saida + tamanho > j->capacidade_saida) {
+        size_t nova = j->capacidade_saida ? j->capacidade_saida : 1024;
+        while (nova < j->tamanho_saida + tamanho) {
+            nova *= 2;
+        }
+        char *saida = realloc(j->saida, nova);
+        if (saida == NULL) {
+            j->fechado = 1;
+            return;
+        }
+        j->saida = saida;
+        j->capacidade_saida = nova;
+    }
+    memcpy(j->saida + j->tamanho_saida, texto, tamanho);
+    j->tamanho_saida += tamanho;
+}
+
+// Retira uma linha completa da entrada; retorna 1 se havia uma
+static int retirar_linha(Jogador *j, char *linha, size_t tamanho) {
+    char *fim = memchr(j->entrada, '\n', j->tamanho_entrada);
+    size_t comprimento;
+    if (fim != NULL) {
+        comprimento = (size_t)(fim - j->entrada);
+    } else if (j->tamanho_entrada == sizeof(j->entrada) ||
+               (j->fim_entrada && j->tamanho_entrada > 0)) {
+        comprimento = j->tamanho_entrada;  // Linha longa demais ou última sem '\n'
+    } else {
+        return 0;
+    }
+    size_t copiar = comprimento < tamanho - 1 ? comprimento : tamanho - 1;
+    memcpy(linha, j->entrada, copiar);
+    linha[copiar] = '\0';
+    if (copiar > 0 && linha[copiar - 1] == '\r') {
+        linha[copiar - 1] = '\0';
+    }
+
+    size_t consumidos = fim != NULL ? comprimento + 1 : comprimento;
+    memmove(j->entrada, j->entrada + consumidos, j->tamanho_entrada - consumidos);
+    j->tamanho_entrada -= consumidos;
+    return 1;
+}
+
+// Lê o que estiver disponível na entrada do jogador
+static void ler_jogador(Jogador *j) {
+    if (j->tamanho_entrada == sizeof(j->entrada)) {
+        return;  // Buffer cheio: a partida consome antes de ler mais
+    }
+    ssize_t n = read(j->fd_entrada, j->entrada + j->tamanho_entrada,
+                     sizeof(j->entrada) - j->tamanho_entrada);
+    if (n > 0) {
+        j->tamanho_entrada += (size_t)n;
+    } else if (n == 0) {
+        j->fim_entrada = 1;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        j->fechado = 1;
+    }
+}
+
+// Escreve o quanto o descritor aceitar da saída pendente
+static void escrever_jogador(Jogador *j) {
+    // Até PIPE_BUF bytes: num descritor bloqueante (entrada padrão) com
+    // POLLOUT sinalizado, a escrita não bloqueia
+    size_t tamanho = j->tamanho_saida < PIPE_BUF ? j->tamanho_saida : PIPE_BUF;
+    ssize_t n = write(j->fd_saida, j->saida, tamanho);
+    if (n > 0) {
+        memmove(j->saida, j->saida + n, j->tamanho_saida - (size_t)n);
+        j->tamanho_saida -= (size_t)n;
+    } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        j->fechado = 1;
+        j->tamanho_saida = 0;
+    }
+}
+
+// Cria um jogador e o acrescenta à mesa; NULL sem memória
+static Jogador *novo_jogador(Mesa *m, int fd_entrada, int fd_saida, int proprios, const char *nome) {
+    if (m->quantidade_jogadores == m->capacidade_jogadores) {
+        size_t nova = m->capacidade_jogadores ? m->capacidade_jogadores * 2 : 16;
+        Jogador **jogadores = realloc(m->jogadores, nova * sizeof(Jogador *));
+        if (jogadores == NULL) {
+            return NULL;
+        }
+        m->jogadores = jogadores;
+        m->capacidade_jogadores = nova;
+    }
+    Jogador *j = calloc(1, sizeof(Jogador));
+    if (j == NULL) {
+        return NULL;
+    }
+    j->fd_entrada = fd_entrada;
+    j->fd_saida = fd_saida;
+    j->proprios = proprios;
+    j->bot = fd_entrada < 0;
+    // Nomes longos (caminhos) são cortados
+    size_t comprimento = strlen(nome);
+    if (comprimento >= sizeof(j->nome)) {
+        comprimento = sizeof(j->nome) - 1;
+    }
+    memcpy(j->nome, nome, comprimento);
+    m->jogadores[m->quantidade_jogadores++] = j;
+    return j;
+}
+
+// Fecha os descritores e libera o jogador 'indice'
+static void remover_jogador(Mesa *m, size_t indice) {
+    Jogador *j = m->jogadores[indice];
+    if (j->proprios) {
+        close(j->fd_entrada);
+        if (j->fd_saida != j->fd_entrada) {
+            close(j->fd_saida);
+        }
+    }
+    if (m->esperando == j) {
+        m->esperando = NULL;
+    }
+    free(j->saida);
+    free(j);
+    m->jogadores[indice] = m->jogadores[--m->quantidade_jogadores];
+}
+
+// Abre um jogador a partir da descrição da linha de comando
+static Jogador *abrir_jogador(Mesa *m, const char *descricao) {
+    char nome[48];
+    if (strcmp(descricao, "bot") == 0) {
+        snprintf(nome, sizeof(nome), "bot %d", ++m->bots);
+        return novo_jogador(m, -1, -1, 0, nome);
+    }
+    if (strcmp(descricao, "-") == 0) {
+        return novo_jogador(m, STDIN_FILENO, STDOUT_FILENO, 0, "terminal");
+    }
+
+    // "entrada:saida" ou um único arquivo para as duas direções
+    char caminho[PATH_MAX];
+    snprintf(caminho, sizeof(caminho), "%s", descricao);
+    char *separador = strchr(caminho, ':');
+    int fd_entrada, fd_saida;
+    if (separador != NULL) {
+        *separador = '\0';
+        fd_entrada = open(caminho, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        fd_saida = open(separador + 1, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    } else {
+        fd_entrada = open(caminho, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        fd_saida = fd_entrada;
+    }
+    if (fd_entrada < 0 || fd_saida < 0) {
+        if (fd_entrada >= 0) close(fd_entrada);
+        if (fd_saida >= 0 && fd_saida != fd_entrada) close(fd_saida);
+        return NULL;
+    }
+    Jogador *j = novo_jogador(m, fd_entrada, fd_saida, 1, caminho);
+    if (j == NULL) {
+        close(fd_entrada);
+        if (fd_saida != fd_entrada) close(fd_saida);
+    }
+    return j;
+}
+
+// Cria o socket Unix de escuta; retorna o descritor ou -1
+static int abrir_escuta(const char *caminho) {
+    struct sockaddr_un endereco;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    unlink(caminho);
+    if (bind(fd, (struct sockaddr *)&endereco, sizeof(endereco)) != 0 ||
+        listen(fd, FILA_ESCUTA) != 0 ||
+        fcntl(fd, F_SETFL, O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ---------------------------------------------------------------------------
+// Partidas
+// ---------------------------------------------------------------------------
+
+// Envia o mesmo texto aos dois jogadores
+static void anunciar(Partida *p, const char *formato, const char *texto) {
+    enviar(p->jogadores[0], formato, texto);
+    enviar(p->jogadores[1], formato, texto);
+}
+
+// Prazo estourado?
+static int prazo_vencido(const Mesa *m, const Partida *p) {
+    (void)m;
+    return relogio_ns() >= p->prazo_ns;
+}
+
+static void renovar_prazo(const Mesa *m, Partida *p) {
+    p->prazo_ns = relogio_ns() + (uint64_t)m->o->tempo_limite_ms * 1000000u;
+}
+
+// O jogador não pode mais responder (desconectado ou sem entrada pendente)
+static int ausente(const Jogador *j) {
+    return !j->bot && (j->fechado || (j->fim_entrada && j->tamanho_entrada == 0));
+}
+
+// Pede a carta da rodada (o bot sorteia uma do baralho na hora)
+static void pedir_cadastros(Mesa *m, Partida *p) {
+    for (int i = 0; i < 2; i++) {
+        Jogador *j = p->jogadores[i];
+        p->cadastrada[i] = 0;
+        if (j->bot) {
+            p->indices_bot[i] = sortear(&m->estado, (uint32_t)m->o->baralho->quantidade);
+            p->cartas[i] = m->o->baralho->cartas[p->indices_bot[i]];
+            p->cadastrada[i] = 1;
+        } else {
+            enviar(j, "\nRodada %d - cadastre sua carta:\n"
+                      "estado;codigo;nome;populacao;area;pib;pontos_turisticos\n> ", p->rodada);
+        }
+    }
+}
+
+// Consome as linhas de cadastro recebidas; 1 quando não há mais o que esperar
+static int coletar_cadastros(Partida *p) {
+    char linha[TAMANHO_ENTRADA];
+    for (int i = 0; i < 2; i++) {
+        Jogador *j = p->jogadores[i];
+        while (!p->cadastrada[i] && retirar_linha(j, linha, sizeof(linha))) {
+            if (linha[0] == '\0') {
+                enviar(j, "> ");
+            } else if (interpretar_linha_carta(linha, &p->cartas[i]) == 0) {
+                p->cadastrada[i] = 1;
+                enviar(j, "Carta cadastrada: %s (%s).\n", p->cartas[i].nome, p->cartas[i].estado);
+                if (!p->cadastrada[1 - i]) {
+                    enviar(j, "Aguardando %s...\n", p->jogadores[1 - i]->nome);
+                }
+            } else {
+                enviar(j, "Linha inválida. Use estado;codigo;nome;populacao;area;pib;pontos_turisticos\n> ");
+            }
+        }
+    }
+    return (p->cadastrada[0] || ausente(p->jogadores[0])) &&
+           (p->cadastrada[1] || ausente(p->jogadores[1]));
+}
+
+// Pede o atributo ao jogador da vez (o bot escolhe o seu melhor atributo)
+static void pedir_atributo(Mesa *m, Partida *p) {
+    Jogador *j = p->jogadores[p->escolhedor];
+    p->atributo = -1;
+    if (j->bot) {
+        p->atributo = escolher_atributo(ESTRATEGIA_MELHOR_ATRIBUTO, m->melhor,
+                                        p->indices_bot[p->escolhedor], &m->estado);
+        return;
+    }
+    enviar(p->jogadores[1 - p->escolhedor], "Aguardando %s escolher o atributo...\n", j->nome);
+    enviar(j, "Sua carta: %s (%s). Escolha o atributo:\n", p->cartas[p->escolhedor].nome,
+           p->cartas[p->escolhedor].estado);
+    for (int a = 1; a <= NUM_ATRIBUTOS; a++) {
+        enviar(j, "%d. %s\n", a, nome_atributo(a));
+    }
+    enviar(j, "0. Desistir da partida\n> ");
+}
+
+// Consome a resposta do jogador da vez; 1 quando não há mais o que esperar
+static int coletar_atributo(Partida *p) {
+    Jogador *j = p->jogadores[p->escolhedor];
+    char linha[TAMANHO_ENTRADA];
+    while (p->atributo < 0 && retirar_linha(j, linha, sizeof(linha))) {
+        char *fim;
+        long atributo = strtol(linha, &fim, 10);
+        if (fim != linha && *fim == '\0' && atributo >= 0 && atributo <= NUM_ATRIBUTOS) {
+            p->atributo = (int)atributo;
+        } else {
+            enviar(j, "Opção inválida. Escolha de 0 a %d.\n> ", NUM_ATRIBUTOS);
+        }
+    }
+    return p->atributo >= 0 || ausente(j);
+}
+
+// Compara as cartas e mostra o resultado aos dois jogadores
+static void resolver_rodada(Mesa *m, Partida *p) {
+    int resultado = comparar_cartas(&p->cartas[0], &p->cartas[1], p->atributo);
+    if (m->o->registro != NULL) {
+        registrar_duelo(m->o->registro, 0, 1, p->atributo, resultado);
+    }
+    if (resultado != 0) {
+        p->placar[resultado - 1]++;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        const Carta *minha = &p->cartas[i];
+        const Carta *outra = &p->cartas[1 - i];
+        enviar(p->jogadores[i], "\n%s: %s (%s) %.2f x %.2f %s (%s)\n", nome_atributo(p->atributo),
+               minha->nome, minha->estado, obter_valor_atributo(minha, p->atributo),
+               obter_valor_atributo(outra, p->atributo), outra->nome, outra->estado);
+        enviar(p->jogadores[i], "%s Placar: você %d x %d %s\n",
+               resultado == 0 ? "Empate!" : resultado == i + 1 ? "Você venceu a rodada!"
+                                                              : "Você perdeu a rodada.",
+               p->placar[i], p->placar[1 - i], p->jogadores[1 - i]->nome);
+    }
+}
+
+// Fluxo de uma partida; retorna CORROTINA_TERMINADA ao fim
+static int executar_partida(Mesa *m, Partida *p) {
+    CORROTINA_INICIAR(&p->co);
+    enviar(p->jogadores[0], "\nPartida %d: você contra %s (%d rodadas).\n", p->numero,
+           p->jogadores[1]->nome, m->o->rodadas);
+    enviar(p->jogadores[1], "\nPartida %d: você contra %s (%d rodadas).\n", p->numero,
+           p->jogadores[0]->nome, m->o->rodadas);
+
+    for (p->rodada = 1; p->rodada <= m->o->rodadas; p->rodada++) {
+        pedir_cadastros(m, p);
+        renovar_prazo(m, p);
+        CORROTINA_AGUARDAR(&p->co, coletar_cadastros(p) || prazo_vencido(m, p));
+        if (!p->cadastrada[0] || !p->cadastrada[1]) {
+            // Quem sumiu ou não cadastrou a tempo perde; se os dois, ninguém vence
+            p->perdedor = p->cadastrada[0] == p->cadastrada[1] ? 2 : p->cadastrada[0] ? 1 : 0;
+            anunciar(p, "\n%s\n", "Tempo esgotado ou jogador desconectado: partida encerrada.");
+            break;
+        }
+
+        p->escolhedor = (p->rodada - 1) % 2;
+        pedir_atributo(m, p);
+        renovar_prazo(m, p);
+        CORROTINA_AGUARDAR(&p->co, coletar_atributo(p) || prazo_vencido(m, p));
+        if (p->atributo < 0) {
+            p->perdedor = p->escolhedor;
+            anunciar(p, "\n%s\n", "Tempo esgotado ou jogador desconectado: partida encerrada.");
+            break;
+        }
+        if (p->atributo == 0) {
+            p->perdedor = p->escolhedor;
+            anunciar(p, "\n%s desistiu da partida.\n", p->jogadores[p->escolhedor]->nome);
+            break;
+        }
+        resolver_rodada(m, p);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        int venceu = p->perdedor >= 0 && p->perdedor < 2 ? p->perdedor != i
+                                                         : p->placar[i] > p->placar[1 - i];
+        int empatou = p->perdedor == 2 || (p->perdedor < 0 && p->placar[0] == p->placar[1]);
+        enviar(p->jogadores[i], "\nFim da partida %d: %s (%d x %d).\n", p->numero,
+               empatou ? "empate" : venceu ? "você venceu" : "você perdeu",
+               p->placar[i], p->placar[1 - i]);
+    }
+    CORROTINA_FIM(&p->co);
+}
+
+// Emparelha o jogador com quem estiver esperando
+static void chegou_jogador(Mesa *m, Jogador *j) {
+    if (m->esperando == NULL) {
+        m->esperando = j;
+        enviar(j, "Aguardando adversário...\n");
+        return;
+    }
+    if (m->quantidade_partidas == m->capacidade_partidas) {
+        size_t nova = m->capacidade_partidas ? m->capacidade_partidas * 2 : 16;
+        Partida **partidas = realloc(m->partidas, nova * sizeof(Partida *));
+        if (partidas == NULL) {
+            j->fechado = 1;
+            return;
+        }
+        m->partidas = partidas;
+        m->capacidade_partidas = nova;
+    }
+    Partida *p = calloc(1, sizeof(Partida));
+    if (p == NULL) {
+        j->fechado = 1;
+        return;
+    }
+    iniciar_corrotina(&p->co);
+    p->numero = ++m->proximo_numero;
+    p->jogadores[0] = m->esperando;
+    p->jogadores[1] = j;
+    p->perdedor = -1;
+    p->acordar = 1;
+    m->esperando->partida = p;
+    j->partida = p;
+    m->esperando = NULL;
+    m->partidas[m->quantidade_partidas++] = p;
+}
+
+// Retoma as partidas com novidades; as terminadas liberam seus jogadores
+static void retomar_partidas(Mesa *m) {
+    for (size_t i = 0; i < m->quantidade_partidas;) {
+        Partida *p = m->partidas[i];
+        if (!p->acordar && !prazo_vencido(m, p)) {
+            i++;
+            continue;
+        }
+        p->acordar = 0;
+        if (executar_partida(m, p) != CORROTINA_TERMINADA) {
+            i++;
+            continue;
+        }
+        for (int k = 0; k < 2; k++) {
+            p->jogadores[k]->partida = NULL;
+            p->jogadores[k]->encerrando = 1;
+        }
+        free(p);
+        m->partidas[i] = m->partidas[--m->quantidade_partidas];
+    }
+}
+
+// Milissegundos até o prazo mais próximo (-1 = sem prazo)
+static int espera_poll(const Mesa *m) {
+    if (m->quantidade_partidas == 0) {
+        return -1;
+    }
+    uint64_t agora = relogio_ns();
+    uint64_t menor = UINT64_MAX;
+    for (size_t i = 0; i < m->quantidade_partidas; i++) {
+        if (m->partidas[i]->acordar) {
+            return 0;
+        }
+        if (m->partidas[i]->prazo_ns < menor) {
+            menor = m->partidas[i]->prazo_ns;
+        }
+    }
+    if (menor <= agora) {
+        return 0;
+    }
+    uint64_t ms = (menor - agora + 999999) / 1000000;
+    return ms > INT_MAX ? INT_MAX : (int)ms;
+}
+
+// Aceita as conexões pendentes no socket de escuta
+static void aceitar_conexoes(Mesa *m) {
+    int fd;
+    while ((fd = accept(m->fd_escuta, NULL, NULL)) >= 0) {
+        char nome[48];
+        snprintf(nome, sizeof(nome), "conexão %d", ++m->conexoes);
+        Jogador *j = fcntl(fd, F_SETFL, O_NONBLOCK) == 0 ? novo_jogador(m, fd, fd, 1, nome) : NULL;
+        if (j == NULL) {
+            close(fd);
+            continue;
+        }
+        chegou_jogador(m, j);
+    }
+}
+
+// Laço de eventos: roda até não haver partidas nem jogadores (sem escuta)
+static int laco_eventos(Mesa *m) {
+    struct pollfd *fds = NULL;
+    Jogador **donos = NULL;
+    size_t capacidade = 0;
+
+    for (;;) {
+        retomar_partidas(m);
+
+        // Sai da mesa quem terminou e já esvaziou a saída, ou desconectou esperando
+        for (size_t i = 0; i < m->quantidade_jogadores;) {
+            Jogador *j = m->jogadores[i];
+            int sair = j->encerrando ? j->fechado || j->bot || j->tamanho_saida == 0
+                                     : j->partida == NULL && (j->fechado || j->fim_entrada);
+            if (sair) {
+                remover_jogador(m, i);
+            } else {
+                i++;
+            }
+        }
+        if (m->fd_escuta < 0 && m->quantidade_partidas == 0) {
+            if (m->esperando != NULL && !m->esperando->encerrando) {
+                enviar(m->esperando, "Nenhum adversário disponível.\n");
+                m->esperando->encerrando = 1;
+            }
+            if (m->quantidade_jogadores == 0) {
+                break;
+            }
+        }
+
+        // Monta o conjunto de descritores
+        size_t necessario = m->quantidade_jogadores * 2 + 1;
+        if (necessario > capacidade) {
+            struct pollfd *novos_fds = realloc(fds, necessario * sizeof(struct pollfd));
+            Jogador **novos_donos = realloc(donos, necessario * sizeof(Jogador *));
+            if (novos_fds != NULL) fds = novos_fds;
+            if (novos_donos != NULL) donos = novos_donos;
+            if (novos_fds == NULL || novos_donos == NULL) {
+                free(fds);
+                free(donos);
+                return -1;
+            }
+            capacidade = necessario;
+        }
+        nfds_t n = 0;
+        if (m->fd_escuta >= 0) {
+            fds[n] = (struct pollfd){ m->fd_escuta, POLLIN, 0 };
+            donos[n++] = NULL;
+        }
+        for (size_t i = 0; i < m->quantidade_jogadores; i++) {
+            Jogador *j = m->jogadores[i];
+            if (j->bot || j->fechado) {
+                continue;
+            }
+            short leitura = j->encerrando || j->fim_entrada ? 0 : POLLIN;
+            short escrita = j->tamanho_saida > 0 ? POLLOUT : 0;
+            if (j->fd_entrada == j->fd_saida) {
+                fds[n] = (struct pollfd){ j->fd_entrada, (short)(leitura | escrita), 0 };
+                donos[n++] = j;
+                continue;
+            }
+            if (leitura != 0) {
+                fds[n] = (struct pollfd){ j->fd_entrada, leitura, 0 };
+                donos[n++] = j;
+            }
+            if (escrita != 0) {
+                fds[n] = (struct pollfd){ j->fd_saida, escrita, 0 };
+                donos[n++] = j;
+            }
+        }
+
+        int prontos = poll(fds, n, espera_poll(m));
+        if (prontos < 0 && errno != EINTR) {
+            free(fds);
+            free(donos);
+            return -1;
+        }
+
+        for (nfds_t i = 0; prontos > 0 && i < n; i++) {
+            short eventos = fds[i].revents;
+            if (eventos == 0) {
+                continue;
+            }
+            Jogador *j = donos[i];
+            if (j == NULL) {
+                aceitar_conexoes(m);
+                continue;
+            }
+            if (fds[i].fd == j->fd_entrada && (eventos & (POLLIN | POLLHUP | POLLERR)) &&
+                (fds[i].events & POLLIN)) {
+                ler_jogador(j);
+            }
+            if (fds[i].fd == j->fd_saida && (eventos & POLLOUT) && !j->fechado) {
+                escrever_jogador(j);
+            }
+            // Erro na saída, ou desconexão sem leitura pendente que a detecte
+            if (fds[i].fd == j->fd_saida &&
+                ((eventos & (POLLERR | POLLNVAL)) ||
+                 ((eventos & POLLHUP) && !(fds[i].events & POLLIN)))) {
+                j->fechado = 1;
+            }
+            if (j->partida != NULL) {
+                j->partida->acordar = 1;
+            }
+        }
+    }
+
+    free(fds);
+    free(donos);
+    return 0;
+}
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_mesa(OpcoesMesa *o) {
+    o->baralho = NULL;
+    o->rodadas = RODADAS_PADRAO_MESA;
+    o->tempo_limite_ms = TEMPO_LIMITE_PADRAO_MS;
+    o->escutar = NULL;
+    o->registro = NULL;
+    o->semente = 42;
+}
+
+// Abre os jogadores e roda as partidas
+int executar_mesa(const char *const *jogadores, int quantidade, const OpcoesMesa *o) {
+    Mesa m;
+    memset(&m, 0, sizeof(m));
+    m.o = o;
+    m.fd_escuta = -1;
+    m.estado = o->semente;
+
+    int tem_bot = 0;
+    for (int i = 0; i < quantidade; i++) {
+        tem_bot |= strcmp(jogadores[i], "bot") == 0;
+    }
+    if (tem_bot) {
+        if (o->baralho == NULL || o->baralho->quantidade == 0) {
+            return -1;
+        }
+        m.melhor = malloc(o->baralho->quantidade);
+        if (m.melhor == NULL || calcular_melhores_atributos(o->baralho, m.melhor) != 0) {
+            free(m.melhor);
+            return -1;
+        }
+    }
+
+    // Escrever num jogador desconectado não pode derrubar a mesa
+    struct sigaction ignorar = { .sa_handler = SIG_IGN }, anterior;
+    sigemptyset(&ignorar.sa_mask);
+    sigaction(SIGPIPE, &ignorar, &anterior);
+
+    int status = 0;
+    if (o->escutar != NULL && (m.fd_escuta = abrir_escuta(o->escutar)) < 0) {
+        status = -1;
+    }
+    for (int i = 0; i < quantidade && status == 0; i++) {
+        Jogador *j = abrir_jogador(&m, jogadores[i]);
+        if (j == NULL) {
+            status = -1;
+        } else {
+            chegou_jogador(&m, j);
+        }
+    }
+    if (status == 0) {
+        status = laco_eventos(&m);
+    }
+
+    while (m.quantidade_jogadores > 0) {
+        remover_jogador(&m, m.quantidade_jogadores - 1);
+    }
+    for (size_t i = 0; i < m.quantidade_partidas; i++) {
+        free(m.partidas[i]);
+    }
+    if (m.fd_escuta >= 0) {
+        close(m.fd_escuta);
+        unlink(o->escutar);
+    }
+    sigaction(SIGPIPE, &anterior, NULL);
+    free(m.jogadores);
+    free(m.partidas);
+    free(m.melhor);
+    return status;
+}
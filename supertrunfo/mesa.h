@@ -0,0 +1,48 @@
+/*
+ * Super Trunfo - Mesa de jogo com vários jogadores
+ *
+ * Um laço de eventos (poll) atende todos os jogadores numa única thread.
+ * Cada partida é uma corrotina com o fluxo do jogo (cadastro das cartas,
+ * escolha do atributo, comparação, resultado) que só é retomada quando um
+ * dos seus jogadores manda uma linha, desconecta ou estoura o prazo. A E/S
+ * é não bloqueante e a saída de cada jogador tem buffer próprio: um
+ * jogador parado não atrasa as outras partidas, só perde a sua por W.O.
+ *
+ * Jogadores:
+ *   "-"                  entrada e saída padrão
+ *   "bot"                jogador automático (cartas do baralho da mesa)
+ *   "arquivo"            terminal ou FIFO aberto para leitura e escrita
+ *   "entrada:saida"      par de arquivos (ex.: dois FIFOs)
+ * Com 'escutar', conexões num socket Unix entram como novos jogadores.
+ * Os jogadores são emparelhados por ordem de chegada.
+ */
+
+#ifndef SUPERTRUNFO_MESA_H
+#define SUPERTRUNFO_MESA_H
+
+#include <stdint.h>
+
+#include "baralho.h"
+#include "registro.h"
+
+#define RODADAS_PADRAO_MESA 3
+#define TEMPO_LIMITE_PADRAO_MS 60000
+
+// Opções da mesa
+typedef struct {
+    const Baralho *baralho;      // Cartas dos bots (obrigatório se houver bots)
+    int rodadas;                 // Rodadas por partida
+    int tempo_limite_ms;         // Prazo de cada resposta; estourado = W.O.
+    const char *escutar;         // Socket Unix para novos jogadores (opcional)
+    RegistroPartidas *registro;  // Grava os duelos no log binário (opcional)
+    uint64_t semente;
+} OpcoesMesa;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_mesa(OpcoesMesa *o);
+
+// Abre os jogadores e roda as partidas até todas terminarem (para sempre
+// com 'escutar'); retorna 0 em sucesso, -1 se algum jogador não abrir
+int executar_mesa(const char *const *jogadores, int quantidade, const OpcoesMesa *o);
+
+#endif
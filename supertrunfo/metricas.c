@@ -0,0 +1,248 @@
+/*
+ * Super Trunfo - Métricas do motor
+ *
+ * Blocos por thread publicados numa lista sem trava e reaproveitados quando
+ * a thread termina; a consolidação e a exportação Prometheus somam os
+ * blocos de todas as threads sob demanda.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "metricas.h"
+
+// Lista global dos blocos de todas as threads
+static _Atomic(MetricasThread *) lista_metricas = NULL;
+
+#ifndef SUPERTRUNFO_SEM_METRICAS
+
+_Thread_local MetricasThread *metricas_local = NULL;
+
+// Chave cujo destrutor libera o bloco quando a thread termina
+static pthread_key_t chave_metricas;
+static pthread_once_t chave_metricas_criada = PTHREAD_ONCE_INIT;
+
+// Thread terminando: o bloco fica para a próxima (as contagens continuam nele)
+static void liberar_bloco_metricas(void *bloco) {
+    MetricasThread *m = bloco;
+    atomic_store_explicit(&m->livre, 1, memory_order_release);
+}
+
+static void criar_chave_metricas(void) {
+    pthread_key_create(&chave_metricas, liberar_bloco_metricas);
+}
+
+// Reaproveita um bloco livre ou cria e publica um novo para a thread atual
+MetricasThread *registrar_thread_metricas(void) {
+    pthread_once(&chave_metricas_criada, criar_chave_metricas);
+
+    // Um bloco de thread já terminada: o acquire vê as últimas contagens dela
+    MetricasThread *m = NULL;
+    for (MetricasThread *b = atomic_load_explicit(&lista_metricas, memory_order_acquire);
+         b != NULL && m == NULL; b = b->proxima) {
+        int livre = 1;
+        if (atomic_load_explicit(&b->livre, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&b->livre, &livre, 0,
+                                                    memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            m = b;
+        }
+    }
+
+    if (m == NULL) {
+        m = aligned_alloc(TAMANHO_LINHA_CACHE, sizeof(MetricasThread));
+        if (m == NULL) {
+            // Sem memória não há como instrumentar; aborta em vez de perder contagens
+            abort();
+        }
+        memset(m, 0, sizeof(*m));
+
+        // Empilha o bloco na lista global (CAS sem trava)
+        MetricasThread *topo = atomic_load_explicit(&lista_metricas, memory_order_relaxed);
+        do {
+            m->proxima = topo;
+        } while (!atomic_compare_exchange_weak_explicit(&lista_metricas, &topo, m,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+    pthread_setspecific(chave_metricas, m);
+    metricas_local = m;
+    return m;
+}
+
+// Relógio monotônico em nanossegundos
+uint64_t relogio_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Índice do balde de um valor: lineares até 8, depois 8 sub-baldes por potência de 2
+static int indice_balde(uint64_t ns) {
+    if (ns < SUBBALDES_HISTOGRAMA) {
+        return (int)ns;
+    }
+    int expoente = 63 - __builtin_clzll(ns);
+    int sub = (int)((ns >> (expoente - 3)) & (SUBBALDES_HISTOGRAMA - 1));
+    return (expoente - 2) * SUBBALDES_HISTOGRAMA + sub;
+}
+
+// Registra uma latência no histograma da thread
+void registrar_latencia(MetricasThread *m, int metrica, uint64_t ns) {
+    incrementar_local(&m->amostras[metrica], 1);
+    incrementar_local(&m->soma_ns[metrica], ns);
+    incrementar_local(&m->histograma[metrica][indice_balde(ns)], 1);
+}
+
+#endif
+
+// Limite inferior, em ns, do balde 'indice' do histograma
+uint64_t limite_balde(int indice) {
+    if (indice < SUBBALDES_HISTOGRAMA) {
+        return (uint64_t)indice;
+    }
+    int expoente = indice / SUBBALDES_HISTOGRAMA + 2;
+    uint64_t sub = (uint64_t)(indice % SUBBALDES_HISTOGRAMA);
+    return (SUBBALDES_HISTOGRAMA + sub) << (expoente - 3);
+}
+
+// Nome da operação usado no rótulo Prometheus
+const char *nome_metrica(int metrica) {
+    switch (metrica) {
+        case METRICA_COMPARAR_CARTAS: return "comparar_cartas";
+        case METRICA_COMPARACAO_AVANCADA: return "comparacao_avancada";
+        case METRICA_DOIS_ATRIBUTOS: return "comparar_dois_atributos";
+        case METRICA_CARREGAR_BARALHO: return "carregar_baralho";
+        case METRICA_RODADA: return "rodada";
+        case METRICA_JOGO: return "jogo";
+        default: return "desconhecida";
+    }
+}
+
+// Soma os blocos de todas as threads
+void consolidar_metricas(ResumoMetricas *resumo) {
+    memset(resumo, 0, sizeof(*resumo));
+    for (MetricasThread *m = atomic_load_explicit(&lista_metricas, memory_order_acquire);
+         m != NULL; m = m->proxima) {
+        for (int i = 0; i < NUM_METRICAS; i++) {
+            resumo->chamadas[i] += atomic_load_explicit(&m->chamadas[i], memory_order_relaxed);
+            resumo->amostras[i] += atomic_load_explicit(&m->amostras[i], memory_order_relaxed);
+            resumo->soma_ns[i] += atomic_load_explicit(&m->soma_ns[i], memory_order_relaxed);
+            for (int b = 0; b < BALDES_HISTOGRAMA; b++) {
+                resumo->histograma[i][b] += atomic_load_explicit(&m->histograma[i][b],
+                                                                 memory_order_relaxed);
+            }
+        }
+    }
+}
+
+// Limites (em segundos) exportados para o Prometheus
+static const double LIMITES_EXPORTADOS[] = {
+    1e-8, 2.5e-8, 5e-8, 1e-7, 2.5e-7, 5e-7, 1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5,
+    1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+};
+
+// Exportações em série: a thread de SIGUSR1 e a da saída usam o mesmo
+// arquivo temporário
+static pthread_mutex_t trava_exportacao = PTHREAD_MUTEX_INITIALIZER;
+
+// Escreve as métricas no arquivo temporário e troca pelo destino
+static int escrever_metricas_prometheus(const char *caminho) {
+    // O resumo tem ~24 KB; fica no heap para não pesar na pilha de threads
+    ResumoMetricas *resumo = malloc(sizeof(ResumoMetricas));
+    if (resumo == NULL) {
+        return -1;
+    }
+    consolidar_metricas(resumo);
+
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", caminho);
+    FILE *f = fopen(temporario, "w");
+    if (f == NULL) {
+        free(resumo);
+        return -1;
+    }
+
+    fprintf(f, "# HELP supertrunfo_chamadas_total Chamadas por operação do motor.\n");
+    fprintf(f, "# TYPE supertrunfo_chamadas_total counter\n");
+    for (int i = 0; i < NUM_METRICAS; i++) {
+        fprintf(f, "supertrunfo_chamadas_total{operacao=\"%s\"} %llu\n",
+                nome_metrica(i), (unsigned long long)resumo->chamadas[i]);
+    }
+
+    fprintf(f, "# HELP supertrunfo_latencia_segundos Latência das chamadas amostradas.\n");
+    fprintf(f, "# TYPE supertrunfo_latencia_segundos histogram\n");
+    int num_limites = (int)(sizeof(LIMITES_EXPORTADOS) / sizeof(LIMITES_EXPORTADOS[0]));
+    for (int i = 0; i < NUM_METRICAS; i++) {
+        // Acumula os baldes HDR até cada limite exportado
+        uint64_t acumulado = 0;
+        int balde = 0;
+        for (int l = 0; l < num_limites; l++) {
+            uint64_t limite_ns = (uint64_t)(LIMITES_EXPORTADOS[l] * 1e9 + 0.5);
+            while (balde < BALDES_HISTOGRAMA && limite_balde(balde) <= limite_ns) {
+                acumulado += resumo->histograma[i][balde++];
+            }
+            fprintf(f, "supertrunfo_latencia_segundos_bucket{operacao=\"%s\",le=\"%g\"} %llu\n",
+                    nome_metrica(i), LIMITES_EXPORTADOS[l], (unsigned long long)acumulado);
+        }
+        fprintf(f, "supertrunfo_latencia_segundos_bucket{operacao=\"%s\",le=\"+Inf\"} %llu\n",
+                nome_metrica(i), (unsigned long long)resumo->amostras[i]);
+        fprintf(f, "supertrunfo_latencia_segundos_sum{operacao=\"%s\"} %.9f\n",
+                nome_metrica(i), resumo->soma_ns[i] / 1e9);
+        fprintf(f, "supertrunfo_latencia_segundos_count{operacao=\"%s\"} %llu\n",
+                nome_metrica(i), (unsigned long long)resumo->amostras[i]);
+    }
+    free(resumo);
+
+    if (fclose(f) != 0) {
+        remove(temporario);
+        return -1;
+    }
+    return rename(temporario, caminho) == 0 ? 0 : -1;
+}
+
+// Escreve as métricas no formato texto do Prometheus
+int exportar_metricas_prometheus(const char *caminho) {
+    pthread_mutex_lock(&trava_exportacao);
+    int resultado = escrever_metricas_prometheus(caminho);
+    pthread_mutex_unlock(&trava_exportacao);
+    return resultado;
+}
+
+// Caminho de exportação usado pela thread de SIGUSR1
+static const char *caminho_exportacao = NULL;
+
+// Espera SIGUSR1 e exporta as métricas a cada sinal
+static void *exportar_sob_demanda(void *arg) {
+    sigset_t *sinais = arg;
+    int sinal;
+    while (sigwait(sinais, &sinal) == 0) {
+        if (exportar_metricas_prometheus(caminho_exportacao) != 0) {
+            fprintf(stderr, "Erro: falha ao exportar métricas para '%s'.\n", caminho_exportacao);
+        }
+    }
+    return NULL;
+}
+
+// Inicia uma thread que exporta as métricas a cada SIGUSR1
+int iniciar_exportador_metricas(const char *caminho) {
+    static sigset_t sinais;
+    pthread_t thread;
+
+    caminho_exportacao = caminho;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGUSR1);
+    // Bloqueado nesta thread e nas criadas depois; só o exportador o recebe
+    if (pthread_sigmask(SIG_BLOCK, &sinais, NULL) != 0 ||
+        pthread_create(&thread, NULL, exportar_sob_demanda, &sinais) != 0) {
+        return -1;
+    }
+    pthread_detach(thread);
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Super Trunfo - Métricas do motor
+ *
+ * Contadores de chamadas e histogramas de latência por operação, mantidos
+ * por thread em blocos alinhados à linha de cache (sem compartilhamento
+ * falso nem operações atômicas de leitura-modificação-escrita no caminho
+ * quente). A leitura soma os blocos de todas as threads. Quando uma thread
+ * termina, o seu bloco fica livre e a próxima thread criada o reaproveita,
+ * somando por cima das contagens dele: a lista cresce só até o máximo de
+ * threads vivas ao mesmo tempo, não com o número de threads já criadas.
+ *
+ * Os contadores são exatos. A latência das operações mais quentes é
+ * amostrada (1 a cada AMOSTRAGEM_QUENTE chamadas) para o custo do relógio
+ * não pesar; operações longas (carga de baralho, jogo) são sempre medidas.
+ *
+ * Histogramas no estilo HDR: 8 sub-baldes por potência de 2 de nanossegundos
+ * (erro relativo de até 12,5%), de 1 ns a 2^63 ns.
+ *
+ * Compile com -DSUPERTRUNFO_SEM_METRICAS para remover toda a instrumentação.
+ */
+
+#ifndef SUPERTRUNFO_METRICAS_H
+#define SUPERTRUNFO_METRICAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Operações instrumentadas
+#define METRICA_COMPARAR_CARTAS 0
+#define METRICA_COMPARACAO_AVANCADA 1
+#define METRICA_DOIS_ATRIBUTOS 2
+#define METRICA_CARREGAR_BARALHO 3
+#define METRICA_RODADA 4
+#define METRICA_JOGO 5
+#define NUM_METRICAS 6
+
+// Amostragem de latência: toda chamada ou 1 a cada 1024
+#define AMOSTRAGEM_TOTAL 1
+#define AMOSTRAGEM_QUENTE 1024
+
+// Baldes do histograma: 8 lineares + 8 por potência de 2 até 2^63
+#define SUBBALDES_HISTOGRAMA 8
+#define BALDES_HISTOGRAMA 496
+
+#define TAMANHO_LINHA_CACHE 64
+
+// Bloco de métricas de uma thread (só a própria thread escreve)
+typedef struct MetricasThread {
+    _Alignas(TAMANHO_LINHA_CACHE) atomic_uint_least64_t chamadas[NUM_METRICAS];
+    atomic_uint_least64_t amostras[NUM_METRICAS];
+    atomic_uint_least64_t soma_ns[NUM_METRICAS];
+    atomic_uint_least64_t histograma[NUM_METRICAS][BALDES_HISTOGRAMA];
+    struct MetricasThread *proxima;  // Lista global de blocos (nunca liberados)
+    atomic_int livre;                // 1 depois que a thread dona terminou
+} MetricasThread;
+
+// Visão consolidada (soma de todas as threads)
+typedef struct {
+    uint64_t chamadas[NUM_METRICAS];
+    uint64_t amostras[NUM_METRICAS];
+    uint64_t soma_ns[NUM_METRICAS];
+    uint64_t histograma[NUM_METRICAS][BALDES_HISTOGRAMA];
+} ResumoMetricas;
+
+#ifndef SUPERTRUNFO_SEM_METRICAS
+
+extern _Thread_local MetricasThread *metricas_local;
+
+// Reaproveita um bloco livre ou cria e publica um novo para a thread atual
+// (primeiro uso)
+MetricasThread *registrar_thread_metricas(void);
+
+// Relógio monotônico em nanossegundos
+uint64_t relogio_ns(void);
+
+// Registra uma latência no histograma da thread
+void registrar_latencia(MetricasThread *m, int metrica, uint64_t ns);
+
+// Incremento feito apenas pela thread dona: carga e escrita relaxadas, sem lock
+static inline void incrementar_local(atomic_uint_least64_t *contador, uint64_t valor) {
+    atomic_store_explicit(contador,
+                          atomic_load_explicit(contador, memory_order_relaxed) + valor,
+                          memory_order_relaxed);
+}
+
+static inline MetricasThread *metricas_da_thread(void) {
+    MetricasThread *m = metricas_local;
+    return m != NULL ? m : registrar_thread_metricas();
+}
+
+// Conta a chamada e, se ela for amostrada, retorna o instante inicial (0 se não)
+static inline uint64_t iniciar_medicao(int metrica, uint64_t amostragem) {
+    MetricasThread *m = metricas_da_thread();
+    uint64_t n = atomic_load_explicit(&m->chamadas[metrica], memory_order_relaxed);
+    atomic_store_explicit(&m->chamadas[metrica], n + 1, memory_order_relaxed);
+    return (n % amostragem) == 0 ? relogio_ns() : 0;
+}
+
+// Encerra uma medição iniciada com iniciar_medicao
+static inline void finalizar_medicao(int metrica, uint64_t inicio) {
+    if (inicio != 0) {
+        registrar_latencia(metricas_local, metrica, relogio_ns() - inicio);
+    }
+}
+
+#else
+
+static inline uint64_t iniciar_medicao(int metrica, uint64_t amostragem) {
+    (void)metrica;
+    (void)amostragem;
+    return 0;
+}
+
+static inline void finalizar_medicao(int metrica, uint64_t inicio) {
+    (void)metrica;
+    (void)inicio;
+}
+
+#endif
+
+// Nome da operação usado no rótulo Prometheus
+const char *nome_metrica(int metrica);
+
+// Soma os blocos de todas as threads
+void consolidar_metricas(ResumoMetricas *resumo);
+
+// Limite inferior, em ns, do balde 'indice' do histograma
+uint64_t limite_balde(int indice);
+
+// Escreve as métricas no formato texto do Prometheus; a escrita é atômica
+// (arquivo temporário + rename). Retorna 0 em sucesso, -1 em erro.
+int exportar_metricas_prometheus(const char *caminho);
+
+// Inicia uma thread que exporta as métricas para 'caminho' a cada SIGUSR1.
+// Deve ser chamada antes de criar outras threads (o sinal fica bloqueado nelas).
+int iniciar_exportador_metricas(const char *caminho);
+
+#endif
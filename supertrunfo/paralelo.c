@@ -0,0 +1,112 @@
+/*
+ * Super Trunfo - Execução paralela
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "paralelo.h"
+
+// Grupo de threads de uma execução
+typedef struct {
+    TarefaParalela tarefa;
+    void *contexto;
+    int total;                   // Threads efetivamente criadas (definido antes da largada)
+    int largada;                 // 1 quando todas podem começar
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    pthread_barrier_t barreira;
+} GrupoThreads;
+
+// Argumentos de cada thread criada
+typedef struct {
+    GrupoThreads *grupo;
+    int indice;
+} ArgumentoThread;
+
+static _Thread_local GrupoThreads *grupo_atual = NULL;
+
+static void *executar_tarefa(void *arg) {
+    ArgumentoThread *a = arg;
+    GrupoThreads *g = a->grupo;
+
+    // Espera a largada: só então 'total' e a barreira estão definidos
+    pthread_mutex_lock(&g->trava);
+    while (!g->largada) {
+        pthread_cond_wait(&g->sinal, &g->trava);
+    }
+    pthread_mutex_unlock(&g->trava);
+
+    grupo_atual = g;
+    g->tarefa(g->contexto, a->indice, g->total);
+    grupo_atual = NULL;
+    return NULL;
+}
+
+// Número de threads a usar: 'pedido' se > 0, senão o número de núcleos online
+int numero_de_threads(int pedido) {
+    if (pedido > 0) {
+        return pedido;
+    }
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    return nucleos > 0 ? (int)nucleos : 1;
+}
+
+// Espera todas as threads do grupo chegarem a este ponto
+void sincronizar_threads(void) {
+    if (grupo_atual != NULL) {
+        pthread_barrier_wait(&grupo_atual->barreira);
+    }
+}
+
+// Executa a tarefa em até 'threads' threads
+int executar_em_paralelo(int threads, TarefaParalela tarefa, void *contexto) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    GrupoThreads g = { .tarefa = tarefa, .contexto = contexto, .total = 1, .largada = 0 };
+    pthread_t *ids = malloc((size_t)threads * sizeof(pthread_t));
+    ArgumentoThread *args = malloc((size_t)threads * sizeof(ArgumentoThread));
+    if (ids == NULL || args == NULL) {
+        free(ids);
+        free(args);
+        threads = 1;
+    }
+    pthread_mutex_init(&g.trava, NULL);
+    pthread_cond_init(&g.sinal, NULL);
+
+    // Se alguma thread não puder ser criada, o grupo roda com as que já
+    // existem: as tarefas dividem o trabalho pelo 'total' recebido
+    int criadas = 1;
+    while (criadas < threads) {
+        args[criadas] = (ArgumentoThread){ &g, criadas };
+        if (pthread_create(&ids[criadas], NULL, executar_tarefa, &args[criadas]) != 0) {
+            break;
+        }
+        criadas++;
+    }
+
+    g.total = criadas;
+    pthread_barrier_init(&g.barreira, NULL, (unsigned)criadas);
+    pthread_mutex_lock(&g.trava);
+    g.largada = 1;
+    pthread_cond_broadcast(&g.sinal);
+    pthread_mutex_unlock(&g.trava);
+
+    grupo_atual = &g;
+    tarefa(contexto, 0, criadas);
+    grupo_atual = NULL;
+    for (int i = 1; i < criadas; i++) {
+        pthread_join(ids[i], NULL);
+    }
+
+    pthread_barrier_destroy(&g.barreira);
+    pthread_cond_destroy(&g.sinal);
+    pthread_mutex_destroy(&g.trava);
+    free(ids);
+    free(args);
+    return criadas;
+}
@@ -0,0 +1,33 @@
+/*
+ * Super Trunfo - Execução paralela
+ *
+ * Roda a mesma tarefa em N threads (a thread chamadora é a de índice 0) e
+ * espera todas terminarem. As tarefas dividem o trabalho pelo próprio
+ * índice e separam fases com sincronizar_threads().
+ */
+
+#ifndef SUPERTRUNFO_PARALELO_H
+#define SUPERTRUNFO_PARALELO_H
+
+#include <stddef.h>
+
+// Tarefa executada por cada thread: contexto, índice da thread e total de threads
+typedef void (*TarefaParalela)(void *contexto, int indice, int total);
+
+// Número de threads a usar: 'pedido' se > 0, senão o número de núcleos online
+int numero_de_threads(int pedido);
+
+// Executa a tarefa em até 'threads' threads e retorna quantas rodaram (se o
+// sistema recusar criar alguma, o grupo roda com menos; o 'total' recebido
+// pela tarefa é sempre o número real)
+int executar_em_paralelo(int threads, TarefaParalela tarefa, void *contexto);
+
+// Barreira entre todas as threads do grupo atual (sem efeito fora de um grupo)
+void sincronizar_threads(void);
+
+// Início do intervalo [inicio, fim) da parte 'indice' de 'total' partes de 'n' itens
+static inline size_t inicio_da_parte(size_t n, int indice, int total) {
+    return n * (size_t)indice / (size_t)total;
+}
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ * Super Trunfo - Raridade das cartas (agrupamento k-means)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "raridade.h"
+#include "aleatorio.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Nomes das classes abaixo da "Super Trunfo", da mais comum à mais rara
+static const char *const NOMES_RARIDADE[MAXIMO_RARIDADES - 1] = {
+    "Comum", "Incomum", "Rara", "Épica", "Lendária",
+};
+
+// Contexto do agrupamento, compartilhado pelas threads
+typedef struct {
+    const Baralho *b;
+    const OpcoesRaridade *o;
+    size_t n;
+    size_t blocos;
+    int k;
+    EspacoAtributos espaco;
+    float *colunas[DIMENSOES_VIZINHOS];  // colunas[d][i]: dimensão d da carta i
+    float centros[MAXIMO_RARIDADES][DIMENSOES_VIZINHOS];
+    uint8_t *grupos;                     // Centro de cada carta
+    double *somas;                       // Por bloco: k * DIMENSOES_VIZINHOS somas
+    uint32_t *contagens;                 // Por bloco: k contagens
+    size_t *mudancas;                    // Por bloco: cartas que trocaram de centro
+    double *inercias;                    // Por bloco
+    int iteracoes;
+    int continuar;
+} ContextoRaridade;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_raridade(OpcoesRaridade *o) {
+    o->classes = 5;
+    o->iteracoes_maximas = 100;
+    o->threads = 0;
+    o->semente = 1;
+}
+
+// Nome da classe
+const char *nome_raridade(int raridade, int classes) {
+    if (raridade < 0 || raridade >= classes) {
+        return "?";
+    }
+    return raridade == classes - 1 ? "Super Trunfo" : NOMES_RARIDADE[raridade];
+}
+
+// Projeta as cartas do intervalo nas colunas
+static void projetar_intervalo(ContextoRaridade *c, size_t inicio, size_t fim) {
+    float ponto[DIMENSOES_VIZINHOS];
+    for (size_t i = inicio; i < fim; i++) {
+        projetar_carta(&c->espaco, &c->b->cartas[i], ponto);
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            c->colunas[d][i] = ponto[d];
+        }
+    }
+}
+
+// Distância ao quadrado da carta i ao ponto p (em colunas)
+static float distancia2_coluna(float *const *colunas, size_t i, const float *p) {
+    float soma = 0.0f;
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        float diferenca = colunas[d][i] - p[d];
+        soma += diferenca * diferenca;
+    }
+    return soma;
+}
+
+// Centros iniciais pelo k-means++
+static void semear_centros(ContextoRaridade *c, float *distancias) {
+    uint64_t estado = c->o->semente;
+    size_t escolhida = sortear(&estado, (uint32_t)c->n);
+    for (int g = 0; g < c->k; g++) {
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            c->centros[g][d] = c->colunas[d][escolhida];
+        }
+        if (g == c->k - 1) {
+            break;
+        }
+
+        // Distância de cada carta ao centro mais próximo até agora
+        double total = 0.0;
+        for (size_t i = 0; i < c->n; i++) {
+            float d2 = distancia2_coluna(c->colunas, i, c->centros[g]);
+            distancias[i] = g == 0 || d2 < distancias[i] ? d2 : distancias[i];
+            total += distancias[i];
+        }
+        if (!(total > 0.0)) {
+            escolhida = sortear(&estado, (uint32_t)c->n);  // Todas as cartas coincidem
+            continue;
+        }
+        double alvo = sortear_real(&estado) * total;
+        double acumulado = 0.0;
+        escolhida = c->n - 1;
+        for (size_t i = 0; i < c->n; i++) {
+            acumulado += distancias[i];
+            if (acumulado > alvo && distancias[i] > 0.0f) {
+                escolhida = i;
+                break;
+            }
+        }
+    }
+}
+
+// Atribuição de um bloco ao centro mais próximo, com as somas parciais
+static void atribuir_bloco(ContextoRaridade *c, size_t bloco) {
+    size_t inicio = bloco * BLOCO_RARIDADE;
+    size_t tamanho = c->n - inicio < BLOCO_RARIDADE ? c->n - inicio : BLOCO_RARIDADE;
+    const float *x[DIMENSOES_VIZINHOS];
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        x[d] = c->colunas[d] + inicio;
+    }
+    float melhor[BLOCO_RARIDADE];
+    int32_t grupo[BLOCO_RARIDADE];
+    for (size_t j = 0; j < tamanho; j++) {
+        melhor[j] = INFINITY;
+        grupo[j] = 0;
+    }
+
+    // Um laço vetorizável por centro; a escolha é por seleção, sem desvio
+    for (int g = 0; g < c->k; g++) {
+        const float *m = c->centros[g];
+        for (size_t j = 0; j < tamanho; j++) {
+            float soma = 0.0f;
+            for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+                float diferenca = x[d][j] - m[d];
+                soma += diferenca * diferenca;
+            }
+            int menor = soma < melhor[j];
+            melhor[j] = menor ? soma : melhor[j];
+            grupo[j] = menor ? g : grupo[j];
+        }
+    }
+
+    // Somas parciais do bloco
+    double *somas = c->somas + bloco * (size_t)c->k * DIMENSOES_VIZINHOS;
+    uint32_t *contagens = c->contagens + bloco * (size_t)c->k;
+    memset(somas, 0, (size_t)c->k * DIMENSOES_VIZINHOS * sizeof(double));
+    memset(contagens, 0, (size_t)c->k * sizeof(uint32_t));
+    size_t mudancas = 0;
+    double inercia = 0.0;
+    for (size_t j = 0; j < tamanho; j++) {
+        int g = grupo[j];
+        contagens[g]++;
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            somas[g * DIMENSOES_VIZINHOS + d] += x[d][j];
+        }
+        mudancas += c->grupos[inicio + j] != g;
+        c->grupos[inicio + j] = (uint8_t)g;
+        inercia += melhor[j];
+    }
+    c->mudancas[bloco] = mudancas;
+    c->inercias[bloco] = inercia;
+}
+
+// Novo centro g: média das suas cartas, somando as parciais na ordem dos blocos
+static void reduzir_centro(ContextoRaridade *c, int g) {
+    double soma[DIMENSOES_VIZINHOS] = { 0 };
+    size_t contagem = 0;
+    for (size_t bloco = 0; bloco < c->blocos; bloco++) {
+        const double *parcial = c->somas + (bloco * (size_t)c->k + (size_t)g) * DIMENSOES_VIZINHOS;
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            soma[d] += parcial[d];
+        }
+        contagem += c->contagens[bloco * (size_t)c->k + (size_t)g];
+    }
+    if (contagem == 0) {
+        return;  // Centro vazio fica onde estava
+    }
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        c->centros[g][d] = (float)(soma[d] / (double)contagem);
+    }
+}
+
+static void tarefa_raridade(void *contexto, int indice, int total) {
+    ContextoRaridade *c = contexto;
+    size_t primeiro = inicio_da_parte(c->blocos, indice, total);
+    size_t ultimo = inicio_da_parte(c->blocos, indice + 1, total);
+
+    // Projeção das cartas dos blocos desta thread
+    {
+        RASTREAR_ESCOPO("projetar_cartas");
+        size_t fim = ultimo * BLOCO_RARIDADE < c->n ? ultimo * BLOCO_RARIDADE : c->n;
+        projetar_intervalo(c, primeiro * BLOCO_RARIDADE, fim);
+    }
+    sincronizar_threads();
+    if (indice == 0) {
+        RASTREAR_ESCOPO("semear_centros");
+        semear_centros(c, c->colunas[DIMENSOES_VIZINHOS - 1] + c->n);
+    }
+    sincronizar_threads();
+
+    for (;;) {
+        {
+            RASTREAR_ESCOPO("atribuir");
+            for (size_t bloco = primeiro; bloco < ultimo; bloco++) {
+                atribuir_bloco(c, bloco);
+            }
+        }
+        sincronizar_threads();
+        for (int g = indice; g < c->k; g += total) {
+            reduzir_centro(c, g);
+        }
+        if (indice == 0) {
+            size_t mudancas = 0;
+            for (size_t bloco = 0; bloco < c->blocos; bloco++) {
+                mudancas += c->mudancas[bloco];
+            }
+            c->iteracoes++;
+            c->continuar = mudancas > 0 && c->iteracoes < c->o->iteracoes_maximas;
+        }
+        sincronizar_threads();
+        if (!c->continuar) {
+            break;
+        }
+    }
+}
+
+// Agrupa as cartas
+int classificar_raridade(const Baralho *b, const OpcoesRaridade *o, uint8_t *raridades,
+                         ResultadoRaridade *r) {
+    RASTREAR_ESCOPO("classificar_raridade");
+    ContextoRaridade *c = calloc(1, sizeof(ContextoRaridade));
+    if (c == NULL || o->classes < 2 || o->classes > MAXIMO_RARIDADES ||
+        b->quantidade < (size_t)o->classes || b->quantidade > UINT32_MAX) {
+        free(c);
+        return -1;
+    }
+    c->b = b;
+    c->o = o;
+    c->n = b->quantidade;
+    c->k = o->classes;
+    c->blocos = (c->n + BLOCO_RARIDADE - 1) / BLOCO_RARIDADE;
+    c->grupos = raridades;
+    preparar_espaco_atributos(&c->espaco, b);
+
+    // Uma coluna a mais no fim guarda as distâncias do k-means++
+    float *colunas = malloc((DIMENSOES_VIZINHOS + 1) * c->n * sizeof(float));
+    c->somas = malloc(c->blocos * (size_t)c->k * DIMENSOES_VIZINHOS * sizeof(double));
+    c->contagens = malloc(c->blocos * (size_t)c->k * sizeof(uint32_t));
+    c->mudancas = malloc(c->blocos * sizeof(size_t));
+    c->inercias = malloc(c->blocos * sizeof(double));
+    int status = -1;
+    if (colunas != NULL && c->somas != NULL && c->contagens != NULL && c->mudancas != NULL &&
+        c->inercias != NULL) {
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            c->colunas[d] = colunas + (size_t)d * c->n;
+        }
+        memset(raridades, 0xFF, c->n);
+        executar_em_paralelo(numero_de_threads(o->threads), tarefa_raridade, c);
+
+        // Classes em ordem crescente de força do centro
+        double forca[MAXIMO_RARIDADES];
+        int ordem[MAXIMO_RARIDADES];
+        for (int g = 0; g < c->k; g++) {
+            forca[g] = 0.0;
+            for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+                forca[g] += d == COMPARAR_DENSIDADE - 1 ? -c->centros[g][d] : c->centros[g][d];
+            }
+            int p = g;
+            while (p > 0 && forca[ordem[p - 1]] > forca[g]) {
+                ordem[p] = ordem[p - 1];
+                p--;
+            }
+            ordem[p] = g;
+        }
+        uint8_t classe[MAXIMO_RARIDADES];
+        memset(r, 0, sizeof(*r));
+        for (int t = 0; t < c->k; t++) {
+            classe[ordem[t]] = (uint8_t)t;
+            memcpy(r->centros[t], c->centros[ordem[t]], sizeof(r->centros[t]));
+        }
+        for (size_t i = 0; i < c->n; i++) {
+            raridades[i] = classe[raridades[i]];
+            r->tamanhos[raridades[i]]++;
+        }
+        r->iteracoes = c->iteracoes;
+        for (size_t bloco = 0; bloco < c->blocos; bloco++) {
+            r->inercia += c->inercias[bloco];
+        }
+        status = 0;
+    }
+    free(colunas);
+    free(c->somas);
+    free(c->contagens);
+    free(c->mudancas);
+    free(c->inercias);
+    free(c);
+    return status;
+}
+
+// Grava o baralho com a raridade como oitavo campo
+int salvar_baralho_raridade(const Baralho *b, const uint8_t *raridades, int classes,
+                            const char *caminho) {
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    fprintf(arquivo, "# estado;codigo;nome;populacao;area;pib;pontos_turisticos;raridade\n");
+    for (size_t i = 0; i < b->quantidade; i++) {
+        const Carta *c = &b->cartas[i];
+        fprintf(arquivo, "%s;%s;%s;%d;%.9g;%.9g;%d;%s\n", c->estado, c->codigo, c->nome,
+                c->populacao, c->area, c->pib, c->pontos_turisticos,
+                nome_raridade(raridades[i], classes));
+    }
+    int erro = ferror(arquivo);
+    return fclose(arquivo) == 0 && !erro ? 0 : -1;
+}
@@ -0,0 +1,70 @@
+/*
+ * Super Trunfo - Raridade das cartas (agrupamento k-means)
+ *
+ * As cartas são agrupadas em k classes de raridade por k-means no espaço
+ * normalizado de vizinhos.h (seis atributos, incluindo densidade e PIB per
+ * capita). Os centros iniciais vêm do k-means++: o primeiro é uma carta
+ * sorteada e cada seguinte é sorteado com probabilidade proporcional ao
+ * quadrado da distância ao centro mais próximo. Depois o algoritmo alterna
+ * atribuição (cada carta vai para o centro mais próximo) e atualização
+ * (cada centro vai para a média das suas cartas) até nenhuma carta mudar
+ * de classe ou o limite de iterações. Um centro que fica sem cartas
+ * permanece onde estava.
+ *
+ * Os pontos ficam em colunas (uma por dimensão), e a atribuição é feita em
+ * blocos de BLOCO_RARIDADE cartas: para cada centro, um laço sobre o bloco
+ * que o compilador vetoriza, com a escolha do menor sem desvio. Cada bloco
+ * guarda as somas parciais das suas cartas; depois cada thread soma, na
+ * ordem dos blocos, as parciais dos centros que lhe cabem. Com a semente
+ * fixa, o resultado não depende do número de threads.
+ *
+ * As classes são ordenadas pela força do centro (soma das coordenadas, com
+ * a densidade negativa, porque nela menor vence): a classe 0 é a comum e a
+ * k - 1 é a "Super Trunfo".
+ */
+
+#ifndef SUPERTRUNFO_RARIDADE_H
+#define SUPERTRUNFO_RARIDADE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+#include "vizinhos.h"
+
+#define MAXIMO_RARIDADES 6
+#define BLOCO_RARIDADE 1024
+
+// Opções do agrupamento
+typedef struct {
+    int classes;              // k, de 2 a MAXIMO_RARIDADES
+    int iteracoes_maximas;
+    int threads;              // 0 = um por núcleo
+    uint64_t semente;
+} OpcoesRaridade;
+
+// Resultado do agrupamento
+typedef struct {
+    int iteracoes;
+    double inercia;           // Soma das distâncias ao quadrado aos centros
+    size_t tamanhos[MAXIMO_RARIDADES];
+    float centros[MAXIMO_RARIDADES][DIMENSOES_VIZINHOS];  // Na ordem das classes
+} ResultadoRaridade;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_raridade(OpcoesRaridade *o);
+
+// Nome da classe (0 a classes - 1): "Comum", "Incomum", ..., "Super Trunfo"
+const char *nome_raridade(int raridade, int classes);
+
+// Agrupa as cartas; raridades[i] recebe a classe da carta i. Retorna 0 em
+// sucesso, -1 se houver menos cartas que classes, k inválido ou faltar memória
+int classificar_raridade(const Baralho *b, const OpcoesRaridade *o, uint8_t *raridades,
+                         ResultadoRaridade *r);
+
+// Grava o baralho com a raridade como oitavo campo (ignorado na carga);
+// retorna 0 em sucesso, -1 em erro
+int salvar_baralho_raridade(const Baralho *b, const uint8_t *raridades, int classes,
+                            const char *caminho);
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Super Trunfo - Rastreio de fases (Chrome trace-event / Perfetto)
+ *
+ * Buffers por thread publicados numa lista sem trava, reaproveitados quando
+ * a thread termina e gravados como JSON ao finalizar. Quem grava marca o
+ * buffer e depois relê rastreio_ativo; a finalização desliga o rastreio e
+ * depois lê as marcas. Em ordem sequencial, ou a thread vê o rastreio
+ * desligado e não grava, ou a finalização vê a marca e espera.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "rastreio.h"
+
+atomic_int rastreio_ativo = 0;
+
+static _Atomic(BufferRastreio *) lista_buffers = NULL;
+static atomic_uint proximo_tid = 1;
+static _Thread_local BufferRastreio *buffer_local = NULL;
+static char *caminho_rastreio = NULL;
+static uint64_t origem_ns = 0;
+
+// Relógio monotônico em nanossegundos
+static uint64_t agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Chave cujo destrutor libera o buffer quando a thread termina
+static pthread_key_t chave_rastreio;
+static pthread_once_t chave_rastreio_criada = PTHREAD_ONCE_INIT;
+
+// Thread terminando: o buffer, com os eventos, fica para a próxima
+static void liberar_buffer_rastreio(void *buffer) {
+    BufferRastreio *b = buffer;
+    atomic_store_explicit(&b->livre, 1, memory_order_release);
+}
+
+static void criar_chave_rastreio(void) {
+    pthread_key_create(&chave_rastreio, liberar_buffer_rastreio);
+}
+
+// Reaproveita um buffer livre ou cria e publica um novo para a thread atual
+// (primeiro uso); NULL sem memória
+static BufferRastreio *buffer_da_thread(void) {
+    if (buffer_local != NULL) {
+        return buffer_local;
+    }
+    pthread_once(&chave_rastreio_criada, criar_chave_rastreio);
+
+    // Buffer de uma thread já terminada: continua depois dos eventos dela
+    for (BufferRastreio *b = atomic_load_explicit(&lista_buffers, memory_order_acquire);
+         b != NULL; b = b->proximo) {
+        int livre = 1;
+        if (atomic_load_explicit(&b->livre, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&b->livre, &livre, 0,
+                                                    memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            pthread_setspecific(chave_rastreio, b);
+            buffer_local = b;
+            return b;
+        }
+    }
+
+    BufferRastreio *b = calloc(1, sizeof(BufferRastreio));
+    if (b == NULL) {
+        return NULL;
+    }
+    b->eventos = malloc(CAPACIDADE_RASTREIO * sizeof(EventoRastreio));
+    if (b->eventos == NULL) {
+        free(b);
+        return NULL;
+    }
+    b->tid = atomic_fetch_add(&proximo_tid, 1);
+    snprintf(b->nome_thread, sizeof(b->nome_thread), "thread %u", b->tid);
+
+    // Empilha o buffer na lista global (CAS sem trava)
+    BufferRastreio *topo = atomic_load_explicit(&lista_buffers, memory_order_relaxed);
+    do {
+        b->proximo = topo;
+    } while (!atomic_compare_exchange_weak_explicit(&lista_buffers, &topo, b,
+                                                    memory_order_release, memory_order_relaxed));
+    pthread_setspecific(chave_rastreio, b);
+    buffer_local = b;
+    return b;
+}
+
+// Marca o buffer antes de gravar; retorna 0 (sem marca) se o rastreio já
+// foi desligado
+static int entrar_no_buffer(BufferRastreio *b) {
+    atomic_store(&b->gravando, 1);
+    if (!atomic_load(&rastreio_ativo)) {
+        atomic_store_explicit(&b->gravando, 0, memory_order_release);
+        return 0;
+    }
+    return 1;
+}
+
+static void sair_do_buffer(BufferRastreio *b) {
+    atomic_store_explicit(&b->gravando, 0, memory_order_release);
+}
+
+// Finalização automática na saída do processo
+static void finalizar_na_saida(void) {
+    finalizar_rastreio();
+}
+
+// Liga o rastreio
+int iniciar_rastreio(const char *caminho) {
+    free(caminho_rastreio);
+    caminho_rastreio = malloc(strlen(caminho) + 1);
+    if (caminho_rastreio == NULL) {
+        return -1;
+    }
+    strcpy(caminho_rastreio, caminho);
+
+    static int registrado = 0;
+    if (!registrado) {
+        atexit(finalizar_na_saida);
+        registrado = 1;
+    }
+    origem_ns = agora_ns();
+    atomic_store(&rastreio_ativo, 1);
+    return 0;
+}
+
+// Dá nome à trilha da thread atual (só tem efeito com o rastreio ligado)
+void nomear_thread_rastreio(const char *nome) {
+    // Desligado: não aloca buffer para threads que nunca vão rastrear
+    if (!atomic_load_explicit(&rastreio_ativo, memory_order_relaxed)) {
+        return;
+    }
+    BufferRastreio *b = buffer_da_thread();
+    if (b != NULL && entrar_no_buffer(b)) {
+        snprintf(b->nome_thread, sizeof(b->nome_thread), "%s", nome);
+        sair_do_buffer(b);
+    }
+}
+
+// Instante atual em ns, ou 0 se o rastreio estiver desligado
+uint64_t abrir_evento_rastreio(void) {
+    return agora_ns();
+}
+
+// Grava um evento iniciado em 'inicio_ns' no buffer da thread
+void fechar_evento_rastreio(const char *nome, uint64_t inicio_ns) {
+    BufferRastreio *b = buffer_da_thread();
+    if (b == NULL || !entrar_no_buffer(b)) {
+        return;
+    }
+    uint64_t n = atomic_load_explicit(&b->escritos, memory_order_relaxed);
+    EventoRastreio *e = &b->eventos[n & (CAPACIDADE_RASTREIO - 1)];
+    e->nome = nome;
+    e->inicio_ns = inicio_ns;
+    e->duracao_ns = agora_ns() - inicio_ns;
+    // Publica o evento depois de escrito
+    atomic_store_explicit(&b->escritos, n + 1, memory_order_release);
+    sair_do_buffer(b);
+}
+
+// Escreve um nome como string JSON (os nomes são literais do código)
+static void escrever_string_json(FILE *f, const char *texto) {
+    fputc('"', f);
+    for (const char *p = texto; *p; p++) {
+        if (*p == '"' || *p == '\\') fputc('\\', f);
+        fputc(*p, f);
+    }
+    fputc('"', f);
+}
+
+// Grava o JSON e desliga o rastreio
+int finalizar_rastreio(void) {
+    if (!atomic_exchange(&rastreio_ativo, 0) || caminho_rastreio == NULL) {
+        return 0;
+    }
+
+    FILE *f = fopen(caminho_rastreio, "w");
+    if (f == NULL) {
+        return -1;
+    }
+
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+               "\"args\":{\"name\":\"super trunfo\"}}");
+
+    for (BufferRastreio *b = atomic_load_explicit(&lista_buffers, memory_order_acquire);
+         b != NULL; b = b->proximo) {
+        // Espera a gravação em curso; as seguintes veem o rastreio desligado
+        while (atomic_load(&b->gravando)) {
+            sched_yield();
+        }
+        uint64_t escritos = atomic_load_explicit(&b->escritos, memory_order_acquire);
+        uint64_t primeiro = escritos > CAPACIDADE_RASTREIO ? escritos - CAPACIDADE_RASTREIO : 0;
+
+        fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                b->tid);
+        escrever_string_json(f, b->nome_thread);
+        fprintf(f, ",\"eventos_descartados\":%llu}}", (unsigned long long)primeiro);
+
+        for (uint64_t i = primeiro; i < escritos; i++) {
+            const EventoRastreio *e = &b->eventos[i & (CAPACIDADE_RASTREIO - 1)];
+            uint64_t inicio = e->inicio_ns > origem_ns ? e->inicio_ns - origem_ns : 0;
+            fprintf(f, ",\n{\"name\":");
+            escrever_string_json(f, e->nome);
+            // Tempos em µs com precisão de ns
+            fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu}",
+                    b->tid,
+                    (unsigned long long)(inicio / 1000), (unsigned long long)(inicio % 1000),
+                    (unsigned long long)(e->duracao_ns / 1000),
+                    (unsigned long long)(e->duracao_ns % 1000));
+        }
+    }
+    fprintf(f, "\n]}\n");
+
+    return fclose(f) == 0 ? 0 : -1;
+}
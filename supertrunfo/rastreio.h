@@ -0,0 +1,98 @@
+/*
+ * Super Trunfo - Rastreio de fases (Chrome trace-event / Perfetto)
+ *
+ * Escopos rastreados viram eventos completos ("ph":"X") com uma trilha por
+ * thread. Cada thread grava num buffer circular próprio, sem trava; quando
+ * o buffer enche, os eventos mais antigos são sobrescritos (e contados como
+ * descartados). Ao finalizar, os buffers são gravados como JSON que abre em
+ * chrome://tracing ou ui.perfetto.dev.
+ *
+ * O buffer de uma thread que terminou é reaproveitado pela próxima thread
+ * criada, com os eventos e a trilha: threads que se sucedem (como as de
+ * cada executar_em_paralelo) dividem uma trilha, e a memória cresce só até
+ * o máximo de threads vivas ao mesmo tempo. A finalização desliga o
+ * rastreio e espera a gravação em curso em cada buffer antes de lê-lo.
+ *
+ * Uso:
+ *   {
+ *       RASTREAR_ESCOPO("carregar_baralho");
+ *       ...  // O evento termina ao sair do bloco
+ *   }
+ *
+ * Desligado (sem iniciar_rastreio), cada escopo custa uma leitura de flag.
+ * Compile com -DSUPERTRUNFO_SEM_RASTREIO para remover os escopos.
+ */
+
+#ifndef SUPERTRUNFO_RASTREIO_H
+#define SUPERTRUNFO_RASTREIO_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Eventos guardados por thread (potência de 2)
+#define CAPACIDADE_RASTREIO 65536
+
+// Evento completo: nome estático, início e duração em ns
+typedef struct {
+    const char *nome;
+    uint64_t inicio_ns;
+    uint64_t duracao_ns;
+} EventoRastreio;
+
+// Buffer circular de uma thread (só a própria thread escreve)
+typedef struct BufferRastreio {
+    EventoRastreio *eventos;
+    atomic_uint_least64_t escritos;  // Total já gravado (índice = escritos % capacidade)
+    atomic_int gravando;             // 1 enquanto a thread dona grava no buffer
+    atomic_int livre;                // 1 depois que a thread dona terminou
+    uint32_t tid;
+    char nome_thread[32];
+    struct BufferRastreio *proximo;
+} BufferRastreio;
+
+// Escopo aberto por RASTREAR_ESCOPO
+typedef struct {
+    const char *nome;
+    uint64_t inicio_ns;  // 0 se o rastreio estava desligado na abertura
+} EscopoRastreio;
+
+extern atomic_int rastreio_ativo;
+
+// Liga o rastreio; o JSON é gravado em 'caminho' por finalizar_rastreio
+// (chamada também automaticamente na saída do processo)
+int iniciar_rastreio(const char *caminho);
+
+// Dá nome à trilha da thread atual (só tem efeito com o rastreio ligado)
+void nomear_thread_rastreio(const char *nome);
+
+// Grava o JSON e desliga o rastreio; retorna 0 em sucesso, -1 em erro
+int finalizar_rastreio(void);
+
+// Instante atual em ns, ou 0 se o rastreio estiver desligado
+uint64_t abrir_evento_rastreio(void);
+
+// Grava um evento iniciado em 'inicio_ns' no buffer da thread
+void fechar_evento_rastreio(const char *nome, uint64_t inicio_ns);
+
+static inline void encerrar_escopo_rastreio(EscopoRastreio *escopo) {
+    if (escopo->inicio_ns != 0) {
+        fechar_evento_rastreio(escopo->nome, escopo->inicio_ns);
+    }
+}
+
+static inline uint64_t iniciar_escopo_rastreio(void) {
+    return atomic_load_explicit(&rastreio_ativo, memory_order_relaxed) ? abrir_evento_rastreio() : 0;
+}
+
+#define RASTREIO_CONCATENAR_(a, b) a##b
+#define RASTREIO_CONCATENAR(a, b) RASTREIO_CONCATENAR_(a, b)
+
+#ifndef SUPERTRUNFO_SEM_RASTREIO
+#define RASTREAR_ESCOPO(nome) \
+    EscopoRastreio RASTREIO_CONCATENAR(escopo_rastreio_, __LINE__) \
+        __attribute__((cleanup(encerrar_escopo_rastreio))) = { (nome), iniciar_escopo_rastreio() }
+#else
+#define RASTREAR_ESCOPO(nome) ((void)0)
+#endif
+
+#endif
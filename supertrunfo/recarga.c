@@ -0,0 +1,216 @@
+/*
+ * Super Trunfo - Recarga do baralho sem parar os jogos
+ *
+ * Quem publica (a thread observadora ou uma chamada direta) segura o mutex
+ * 'escrita'; os leitores nunca o tocam. Uma versão aposentada é liberada
+ * quando nenhuma vaga aponta para ela: como a vaga é escrita antes da
+ * releitura do ponteiro atual e a troca acontece antes da varredura das
+ * vagas (ordem sequencial), um leitor que fixou a versão antiga sempre
+ * aparece na varredura.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "recarga.h"
+#include "rastreio.h"
+
+// Fatia de espera da thread observadora (para encerrar rápido)
+#define FATIA_ESPERA_MS 50
+
+// Confere se o arquivo mudou desde a última carga (e guarda o estado novo)
+static int arquivo_mudou(RecargaBaralho *r) {
+    struct stat st;
+    if (stat(r->caminho, &st) != 0) {
+        return 0;  // Ausente no meio de uma troca: confere de novo depois
+    }
+    int mudou = st.st_dev != r->dispositivo || st.st_ino != r->inode || st.st_size != r->tamanho
+                || st.st_mtim.tv_sec != r->modificacao.tv_sec
+                || st.st_mtim.tv_nsec != r->modificacao.tv_nsec;
+    r->dispositivo = st.st_dev;
+    r->inode = st.st_ino;
+    r->tamanho = st.st_size;
+    r->modificacao = st.st_mtim;
+    return mudou;
+}
+
+// Carrega uma versão nova do arquivo; NULL se inválido
+static VersaoBaralho *carregar_versao(const char *caminho, uint64_t numero) {
+    VersaoBaralho *v = malloc(sizeof(VersaoBaralho));
+    if (v == NULL) {
+        return NULL;
+    }
+    iniciar_baralho(&v->baralho);
+    if (carregar_baralho(&v->baralho, caminho) < 0 || v->baralho.quantidade < 2) {
+        liberar_baralho(&v->baralho);
+        free(v);
+        return NULL;
+    }
+    v->numero = numero;
+    v->proxima = NULL;
+    return v;
+}
+
+// Libera as aposentadas que nenhuma vaga tem fixadas (com 'escrita')
+static void liberar_aposentadas(RecargaBaralho *r) {
+    VersaoBaralho **p = &r->aposentadas;
+    while (*p != NULL) {
+        VersaoBaralho *v = *p;
+        int fixada = 0;
+        for (int i = 0; i < MAXIMO_LEITORES_RECARGA && !fixada; i++) {
+            fixada = atomic_load(&r->vagas[i].versao) == v;
+        }
+        if (fixada) {
+            p = &v->proxima;
+        } else {
+            *p = v->proxima;
+            liberar_baralho(&v->baralho);
+            free(v);
+        }
+    }
+}
+
+// Carrega a primeira versão
+int iniciar_recarga(RecargaBaralho *r, const char *caminho) {
+    memset(r, 0, sizeof(*r));
+    r->caminho = strdup(caminho);
+    if (r->caminho == NULL) {
+        return -1;
+    }
+    arquivo_mudou(r);
+    VersaoBaralho *v = carregar_versao(caminho, 1);
+    if (v == NULL) {
+        free(r->caminho);
+        return -1;
+    }
+    for (int i = 0; i < MAXIMO_LEITORES_RECARGA; i++) {
+        atomic_init(&r->vagas[i].ocupada, 0);
+        atomic_init(&r->vagas[i].versao, NULL);
+    }
+    atomic_init(&r->atual, v);
+    atomic_init(&r->parar, 0);
+    atomic_init(&r->recargas, 0);
+    atomic_init(&r->falhas, 0);
+    pthread_mutex_init(&r->escrita, NULL);
+    return 0;
+}
+
+// Confere o arquivo e publica a versão nova se ele mudou
+int recarregar_se_mudou(RecargaBaralho *r) {
+    RASTREAR_ESCOPO("recarregar_baralho");
+    pthread_mutex_lock(&r->escrita);
+    int status = 0;
+    if (arquivo_mudou(r)) {
+        VersaoBaralho *antiga = atomic_load(&r->atual);
+        VersaoBaralho *nova = carregar_versao(r->caminho, antiga->numero + 1);
+        if (nova == NULL) {
+            atomic_fetch_add(&r->falhas, 1);
+            status = -1;
+        } else {
+            // A troca: jogos novos passam a fixar 'nova'
+            antiga = atomic_exchange(&r->atual, nova);
+            antiga->proxima = r->aposentadas;
+            r->aposentadas = antiga;
+            atomic_fetch_add(&r->recargas, 1);
+            status = 1;
+        }
+    }
+    liberar_aposentadas(r);
+    pthread_mutex_unlock(&r->escrita);
+    return status;
+}
+
+// Laço da thread observadora
+static void *observar(void *arg) {
+    RecargaBaralho *r = arg;
+    nomear_thread_rastreio("recarga");
+    while (!atomic_load_explicit(&r->parar, memory_order_relaxed)) {
+        for (int esperado = 0; esperado < r->intervalo_ms
+                               && !atomic_load_explicit(&r->parar, memory_order_relaxed);
+             esperado += FATIA_ESPERA_MS) {
+            int fatia = r->intervalo_ms - esperado < FATIA_ESPERA_MS ? r->intervalo_ms - esperado
+                                                                      : FATIA_ESPERA_MS;
+            struct timespec t = { fatia / 1000, (long)(fatia % 1000) * 1000000L };
+            nanosleep(&t, NULL);
+        }
+        recarregar_se_mudou(r);
+    }
+    return NULL;
+}
+
+// Inicia a thread que observa o arquivo
+int observar_recarga(RecargaBaralho *r, int intervalo_ms) {
+    r->intervalo_ms = intervalo_ms > 0 ? intervalo_ms : INTERVALO_PADRAO_RECARGA_MS;
+    if (pthread_create(&r->observador, NULL, observar, r) != 0) {
+        return -1;
+    }
+    r->observando = 1;
+    return 0;
+}
+
+// Reserva uma vaga de leitor
+int ocupar_vaga_recarga(RecargaBaralho *r) {
+    for (int i = 0; i < MAXIMO_LEITORES_RECARGA; i++) {
+        int livre = 0;
+        if (atomic_compare_exchange_strong(&r->vagas[i].ocupada, &livre, 1)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Devolve a vaga
+void liberar_vaga_recarga(RecargaBaralho *r, int vaga) {
+    atomic_store(&r->vagas[vaga].versao, NULL);
+    atomic_store_explicit(&r->vagas[vaga].ocupada, 0, memory_order_release);
+}
+
+// Fixa a versão atual na vaga
+const VersaoBaralho *fixar_versao(RecargaBaralho *r, int vaga) {
+    VersaoBaralho *v = atomic_load(&r->atual);
+    for (;;) {
+        atomic_store(&r->vagas[vaga].versao, v);
+        VersaoBaralho *agora = atomic_load(&r->atual);
+        if (agora == v) {
+            return v;
+        }
+        v = agora;
+    }
+}
+
+// Solta a versão fixada na vaga
+void soltar_versao(RecargaBaralho *r, int vaga) {
+    atomic_store_explicit(&r->vagas[vaga].versao, NULL, memory_order_release);
+}
+
+// Número da versão atual (o ponteiro atual nunca é liberado enquanto é o atual)
+uint64_t versao_atual_recarga(RecargaBaralho *r) {
+    pthread_mutex_lock(&r->escrita);
+    uint64_t numero = atomic_load(&r->atual)->numero;
+    pthread_mutex_unlock(&r->escrita);
+    return numero;
+}
+
+// Para a observação e libera todas as versões
+void encerrar_recarga(RecargaBaralho *r) {
+    if (r->observando) {
+        atomic_store(&r->parar, 1);
+        pthread_join(r->observador, NULL);
+        r->observando = 0;
+    }
+    VersaoBaralho *v = atomic_load(&r->atual);
+    v->proxima = r->aposentadas;
+    while (v != NULL) {
+        VersaoBaralho *proxima = v->proxima;
+        liberar_baralho(&v->baralho);
+        free(v);
+        v = proxima;
+    }
+    pthread_mutex_destroy(&r->escrita);
+    free(r->caminho);
+    memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,100 @@
+/*
+ * Super Trunfo - Recarga do baralho sem parar os jogos
+ *
+ * Uma thread observadora confere o arquivo do baralho a cada intervalo
+ * (data de modificação, tamanho e inode, o que cobre edição no lugar e
+ * troca por rename) e, quando ele muda, carrega a versão nova e a publica
+ * trocando um ponteiro atômico, no estilo RCU:
+ *
+ *   - cada jogo fixa a versão atual ao começar (fixar_versao) e a usa até
+ *     terminar (soltar_versao); as comparações leem o Baralho fixado
+ *     direto, sem lock nem atômico;
+ *   - fixar é uma escrita atômica do ponteiro na vaga do leitor e uma
+ *     releitura do ponteiro atual (repetida só se uma troca aconteceu no
+ *     meio); só depois disso a versão é acessada;
+ *   - a versão trocada vai para a lista de aposentadas e só é liberada
+ *     quando nenhuma vaga a tem fixada.
+ *
+ * Um arquivo que não abre ou tem menos de duas cartas válidas não é
+ * publicado: os jogos seguem na versão anterior.
+ */
+
+#ifndef SUPERTRUNFO_RECARGA_H
+#define SUPERTRUNFO_RECARGA_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include "baralho.h"
+
+// Leitores (threads ou jogos) que podem fixar versões ao mesmo tempo
+#define MAXIMO_LEITORES_RECARGA 256
+
+// Intervalo padrão entre verificações do arquivo
+#define INTERVALO_PADRAO_RECARGA_MS 500
+
+// Uma versão publicada do baralho
+typedef struct VersaoBaralho {
+    Baralho baralho;
+    uint64_t numero;                        // 1 em diante
+    struct VersaoBaralho *proxima;          // Lista de aposentadas
+} VersaoBaralho;
+
+// Vaga de um leitor, numa linha de cache própria
+typedef struct {
+    _Alignas(64) atomic_int ocupada;
+    _Atomic(const struct VersaoBaralho *) versao;  // Versão fixada (NULL = nenhuma)
+} VagaLeitor;
+
+// Baralho recarregável
+typedef struct {
+    _Atomic(VersaoBaralho *) atual;
+    VagaLeitor vagas[MAXIMO_LEITORES_RECARGA];
+    VersaoBaralho *aposentadas;             // Protegida por 'escrita'
+    pthread_mutex_t escrita;                // Só entre quem publica
+    char *caminho;
+    dev_t dispositivo;                      // Arquivo da última carga
+    ino_t inode;
+    off_t tamanho;
+    struct timespec modificacao;
+    int intervalo_ms;
+    int observando;
+    atomic_int parar;
+    pthread_t observador;
+    atomic_uint_least64_t recargas;         // Versões publicadas depois da primeira
+    atomic_uint_least64_t falhas;           // Mudanças não publicadas (arquivo inválido)
+} RecargaBaralho;
+
+// Carrega a primeira versão; retorna 0 em sucesso, -1 se o arquivo não
+// abre ou tem menos de duas cartas
+int iniciar_recarga(RecargaBaralho *r, const char *caminho);
+
+// Inicia a thread que observa o arquivo; retorna 0 em sucesso, -1 em erro
+int observar_recarga(RecargaBaralho *r, int intervalo_ms);
+
+// Confere o arquivo agora e publica a versão nova se ele mudou; retorna 1
+// se publicou, 0 se não mudou, -1 se mudou mas é inválido
+int recarregar_se_mudou(RecargaBaralho *r);
+
+// Reserva uma vaga de leitor; retorna o índice ou -1 se todas estão ocupadas
+int ocupar_vaga_recarga(RecargaBaralho *r);
+
+// Devolve a vaga (sem versão fixada)
+void liberar_vaga_recarga(RecargaBaralho *r, int vaga);
+
+// Fixa a versão atual na vaga; ela não é liberada até soltar_versao
+const VersaoBaralho *fixar_versao(RecargaBaralho *r, int vaga);
+
+// Solta a versão fixada na vaga
+void soltar_versao(RecargaBaralho *r, int vaga);
+
+// Número da versão atual
+uint64_t versao_atual_recarga(RecargaBaralho *r);
+
+// Para a observação e libera todas as versões (nenhuma pode estar fixada)
+void encerrar_recarga(RecargaBaralho *r);
+
+#endif
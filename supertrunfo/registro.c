@@ -0,0 +1,348 @@
+/*
+ * Super Trunfo - Registro binário de partidas
+ *
+ * Escrita com buffer duplo e thread de escrita com O_APPEND; leitura
+ * sequencial em blocos grandes, para que o replay percorra logs de vários GB
+ * na velocidade do disco.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "registro.h"
+#include "rastreio.h"
+
+// Assinatura do arquivo (inclui a versão do formato no último byte)
+static const uint8_t ASSINATURA_REGISTRO[8] = { 'S', 'T', 'L', 'O', 'G', 0, 0, 1 };
+
+// Tamanho do bloco de leitura do replay
+#define TAMANHO_BLOCO_LEITURA (4 << 20)
+
+// Tempo atual em microssegundos desde a época Unix
+static uint64_t tempo_atual_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Escreve todo o bloco, repetindo em escritas parciais
+static int escrever_tudo(int fd, const uint8_t *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escrito = write(fd, dados, tamanho);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += escrito;
+        tamanho -= (size_t)escrito;
+    }
+    return 0;
+}
+
+// Delta de tempo desde o último evento com tempo (nunca negativo)
+static uint64_t delta_tempo(RegistroPartidas *r) {
+    uint64_t agora = tempo_atual_us();
+    uint64_t delta = agora > r->ultimo_tempo_us ? agora - r->ultimo_tempo_us : 0;
+    r->ultimo_tempo_us += delta;
+    return delta;
+}
+
+// Garante espaço no buffer para mais um evento
+static uint8_t *reservar_evento(RegistroPartidas *r) {
+    reservar_registro(r, TAMANHO_MAXIMO_EVENTO);
+    return r->buffer + r->usado;
+}
+
+// Thread de escrita: grava cada buffer entregue por descarregar_registro
+static void *escrever_em_segundo_plano(void *arg) {
+    RegistroPartidas *r = arg;
+
+    nomear_thread_rastreio("escritor do registro");
+    pthread_mutex_lock(&r->trava);
+    for (;;) {
+        while (r->tamanho_pendente == 0 && !r->encerrar) {
+            pthread_cond_wait(&r->sinal, &r->trava);
+        }
+        if (r->tamanho_pendente == 0) {
+            break;  // Encerrado e sem nada pendente
+        }
+        size_t tamanho = r->tamanho_pendente;
+        pthread_mutex_unlock(&r->trava);
+
+        int falhou;
+        {
+            RASTREAR_ESCOPO("gravar_registro");
+            falhou = escrever_tudo(r->fd, r->pendente, tamanho) != 0;
+        }
+
+        pthread_mutex_lock(&r->trava);
+        if (falhou) r->erro = 1;
+        r->tamanho_pendente = 0;
+        pthread_cond_broadcast(&r->sinal);
+    }
+    pthread_mutex_unlock(&r->trava);
+    return NULL;
+}
+
+// Abre (ou cria) o registro para acréscimo
+int abrir_registro(RegistroPartidas *r, const char *caminho) {
+    memset(r, 0, sizeof(*r));
+    r->fd = open(caminho, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (r->fd < 0) {
+        return -1;
+    }
+    // Uma sessão por vez no arquivo; a trava sai com o close
+    struct flock trava = { .l_type = F_WRLCK, .l_whence = SEEK_SET, .l_start = 0, .l_len = 0 };
+    int travado;
+    while ((travado = fcntl(r->fd, F_SETLKW, &trava)) != 0 && errno == EINTR) {
+    }
+    if (travado != 0) {
+        close(r->fd);
+        return -1;
+    }
+    r->buffer = malloc(TAMANHO_BUFFER_REGISTRO);
+    r->pendente = malloc(TAMANHO_BUFFER_REGISTRO);
+    if (r->buffer == NULL || r->pendente == NULL) {
+        free(r->buffer);
+        free(r->pendente);
+        close(r->fd);
+        return -1;
+    }
+    r->capacidade = TAMANHO_BUFFER_REGISTRO;
+
+    pthread_mutex_init(&r->trava, NULL);
+    pthread_cond_init(&r->sinal, NULL);
+    if (pthread_create(&r->escritor, NULL, escrever_em_segundo_plano, r) != 0) {
+        pthread_mutex_destroy(&r->trava);
+        pthread_cond_destroy(&r->sinal);
+        free(r->buffer);
+        free(r->pendente);
+        close(r->fd);
+        return -1;
+    }
+
+    // Arquivo novo recebe a assinatura
+    struct stat st;
+    if (fstat(r->fd, &st) == 0 && st.st_size == 0) {
+        memcpy(r->buffer, ASSINATURA_REGISTRO, sizeof(ASSINATURA_REGISTRO));
+        r->usado = sizeof(ASSINATURA_REGISTRO);
+    }
+
+    // Cada sessão começa com o tempo absoluto, base dos deltas seguintes
+    r->ultimo_tempo_us = tempo_atual_us();
+    uint8_t *p = r->buffer + r->usado;
+    p[0] = REGISTRO_SESSAO;
+    r->usado += 1 + escrever_varint(p + 1, r->ultimo_tempo_us);
+    return 0;
+}
+
+// Entrega o buffer atual à thread de escrita e passa a preencher o outro
+int descarregar_registro(RegistroPartidas *r) {
+    pthread_mutex_lock(&r->trava);
+    // Espera a escrita anterior terminar (buffer duplo)
+    while (r->tamanho_pendente != 0) {
+        pthread_cond_wait(&r->sinal, &r->trava);
+    }
+    if (r->usado > 0 && !r->erro) {
+        uint8_t *cheio = r->buffer;
+        r->buffer = r->pendente;
+        r->pendente = cheio;
+        r->tamanho_pendente = r->usado;
+        pthread_cond_broadcast(&r->sinal);
+    }
+    // Em caso de erro os eventos são descartados para não crescer sem limite
+    r->usado = 0;
+    int erro = r->erro;
+    pthread_mutex_unlock(&r->trava);
+    return erro ? -1 : 0;
+}
+
+// Descarrega e fecha o registro
+int fechar_registro(RegistroPartidas *r) {
+    descarregar_registro(r);
+
+    pthread_mutex_lock(&r->trava);
+    r->encerrar = 1;
+    pthread_cond_broadcast(&r->sinal);
+    pthread_mutex_unlock(&r->trava);
+    pthread_join(r->escritor, NULL);
+
+    pthread_mutex_destroy(&r->trava);
+    pthread_cond_destroy(&r->sinal);
+    if (close(r->fd) != 0) {
+        r->erro = 1;
+    }
+    free(r->buffer);
+    free(r->pendente);
+    r->buffer = NULL;
+    r->pendente = NULL;
+    r->fd = -1;
+    return r->erro ? -1 : 0;
+}
+
+// Registra um duelo avulso
+void registrar_duelo(RegistroPartidas *r, uint32_t carta1, uint32_t carta2, int atributo, int resultado) {
+    uint8_t *p = reservar_evento(r);
+    size_t n = 1;
+    p[0] = (uint8_t)(REGISTRO_DUELO | ((atributo & 0xF) << 2) | ((resultado & 0x3) << 6));
+    n += escrever_varint(p + n, delta_tempo(r));
+    n += escrever_varint(p + n, carta1);
+    n += escrever_varint(p + n, carta2);
+    r->usado += n;
+}
+
+// Registra o início de uma partida simulada
+void registrar_inicio_jogo(RegistroPartidas *r, uint64_t id_jogo, uint64_t semente) {
+    uint8_t *p = reservar_evento(r);
+    size_t n = 1;
+    p[0] = (uint8_t)(REGISTRO_JOGO | (JOGO_INICIO << 2));
+    n += escrever_varint(p + n, delta_tempo(r));
+    n += escrever_varint(p + n, id_jogo);
+    n += escrever_varint(p + n, semente);
+    r->usado += n;
+}
+
+// Registra o fim de uma partida simulada. O tempo é o do início do jogo:
+// consultar o relógio em todo jogo curto custaria mais que o próprio jogo.
+void registrar_fim_jogo(RegistroPartidas *r, int vencedor, uint32_t rodadas) {
+    uint8_t *p = reservar_evento(r);
+    size_t n = 1;
+    p[0] = (uint8_t)(REGISTRO_JOGO | (JOGO_FIM << 2) | ((vencedor & 0x3) << 6));
+    p[n++] = 0;  // Delta de tempo zero
+    n += escrever_varint(p + n, rodadas);
+    r->usado += n;
+}
+
+// Registra os parâmetros dos jogos seguintes. Vão num só varint, então um
+// leitor que não conhece o subtipo o pula como um fim de jogo
+void registrar_parametros_jogo(RegistroPartidas *r, int jogadores, int max_rodadas,
+                               int equilibrada) {
+    uint8_t *p = reservar_evento(r);
+    size_t n = 1;
+    p[0] = (uint8_t)(REGISTRO_JOGO | (JOGO_PARAMETROS << 2) | ((equilibrada ? 1 : 0) << 6));
+    p[n++] = 0;  // Delta de tempo zero
+    n += escrever_varint(p + n, (uint64_t)(jogadores & 0xFF) | (uint64_t)max_rodadas << 8);
+    r->usado += n;
+}
+
+// Completa o buffer de leitura, preservando os bytes ainda não consumidos
+static void reabastecer(LeitorRegistro *l) {
+    size_t restante = l->fim - l->inicio;
+    memmove(l->buffer, l->buffer + l->inicio, restante);
+    l->inicio = 0;
+    l->fim = restante;
+
+    while (!l->fim_arquivo && l->fim < l->capacidade) {
+        ssize_t lido = read(l->fd, l->buffer + l->fim, l->capacidade - l->fim);
+        if (lido < 0 && errno == EINTR) continue;
+        if (lido <= 0) {
+            l->fim_arquivo = 1;
+            break;
+        }
+        l->fim += (size_t)lido;
+        l->bytes_lidos += (uint64_t)lido;
+    }
+}
+
+// Lê um varint; retorna 0 se o buffer terminou no meio dele
+static int ler_varint(LeitorRegistro *l, uint64_t *valor) {
+    uint64_t v = 0;
+    int deslocamento = 0;
+    while (l->inicio < l->fim && deslocamento < 64) {
+        uint8_t byte = l->buffer[l->inicio++];
+        v |= (uint64_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80)) {
+            *valor = v;
+            return 1;
+        }
+        deslocamento += 7;
+    }
+    return 0;
+}
+
+// Abre o registro para leitura
+int abrir_leitor_registro(LeitorRegistro *l, const char *caminho) {
+    memset(l, 0, sizeof(*l));
+    l->fd = open(caminho, O_RDONLY);
+    if (l->fd < 0) {
+        return -1;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(l->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    l->buffer = malloc(TAMANHO_BLOCO_LEITURA);
+    if (l->buffer == NULL) {
+        close(l->fd);
+        return -1;
+    }
+    l->capacidade = TAMANHO_BLOCO_LEITURA;
+    reabastecer(l);
+
+    if (l->fim < sizeof(ASSINATURA_REGISTRO) ||
+        memcmp(l->buffer, ASSINATURA_REGISTRO, sizeof(ASSINATURA_REGISTRO)) != 0) {
+        fechar_leitor_registro(l);
+        return -1;
+    }
+    l->inicio = sizeof(ASSINATURA_REGISTRO);
+    return 0;
+}
+
+// Lê o próximo evento
+int proximo_evento(LeitorRegistro *l, EventoRegistro *e) {
+    if (l->fim - l->inicio < TAMANHO_MAXIMO_EVENTO && !l->fim_arquivo) {
+        reabastecer(l);
+    }
+    if (l->inicio >= l->fim) {
+        return 0;
+    }
+
+    uint8_t cabecalho = l->buffer[l->inicio++];
+    uint64_t delta = 0;
+    e->tipo = cabecalho & 0x3;
+    e->atributo = (cabecalho >> 2) & 0xF;
+    e->resultado = cabecalho >> 6;
+    e->valor1 = 0;
+    e->valor2 = 0;
+
+    // Registro truncado no fim do arquivo é descartado
+    switch (e->tipo) {
+        case REGISTRO_SESSAO:
+            if (!ler_varint(l, &l->tempo_us)) return 0;
+            break;
+        case REGISTRO_DUELO:
+            if (!ler_varint(l, &delta) || !ler_varint(l, &e->valor1) ||
+                !ler_varint(l, &e->valor2)) return 0;
+            break;
+        case REGISTRO_RODADA:
+            if (!ler_varint(l, &e->valor1) || !ler_varint(l, &e->valor2)) return 0;
+            break;
+        case REGISTRO_JOGO:
+            if (!ler_varint(l, &delta) || !ler_varint(l, &e->valor1)) return 0;
+            if (e->atributo == JOGO_INICIO && !ler_varint(l, &e->valor2)) return 0;
+            if (e->atributo == JOGO_PARAMETROS) {
+                e->valor2 = e->valor1 >> 8;
+                e->valor1 &= 0xFF;
+            }
+            break;
+    }
+    l->tempo_us += delta;
+    e->tempo_us = l->tempo_us;
+    return 1;
+}
+
+// Fecha o leitor
+void fechar_leitor_registro(LeitorRegistro *l) {
+    free(l->buffer);
+    l->buffer = NULL;
+    if (l->fd >= 0) {
+        close(l->fd);
+    }
+    l->fd = -1;
+}
@@ -0,0 +1,172 @@
+/*
+ * Super Trunfo - Registro binário de partidas
+ *
+ * Log binário só de acréscimo (append-only) com cada duelo e cada rodada
+ * das partidas simuladas. Os eventos são codificados num buffer grande; um
+ * buffer cheio é entregue a uma thread de escrita (buffer duplo) que o grava
+ * com O_APPEND, então o simulador não espera pelo disco. Várias sessões
+ * podem acrescentar ao mesmo arquivo, uma depois da outra: cada sessão
+ * mantém uma trava de escrita (fcntl) no arquivo do início ao fim, e uma
+ * sessão aberta ao mesmo tempo espera a anterior fechar, já que buffers de
+ * duas sessões intercalados misturariam jogos e a base dos tempos.
+ *
+ * Formato do arquivo:
+ *   cabeçalho: "STLOG\0\0\1" (8 bytes), escrito só quando o arquivo é criado
+ *   registros: 1 byte de cabeçalho + campos em varint (LEB128 sem sinal)
+ *
+ *   byte de cabeçalho = tipo (bits 0-1) | atributo (bits 2-5) | resultado (bits 6-7)
+ *
+ *   REGISTRO_SESSAO  tempo absoluto em µs desde a época Unix
+ *   REGISTRO_DUELO   delta de tempo em µs, carta1, carta2
+ *   REGISTRO_JOGO    atributo = JOGO_INICIO: delta de tempo, id do jogo, semente
+ *                    atributo = JOGO_FIM:    delta de tempo, rodadas (resultado = vencedor)
+ *                    atributo = JOGO_PARAMETROS: delta de tempo, jogadores | máximo de
+ *                                            rodadas << 8 (resultado = 1 se as mãos
+ *                                            são equilibradas); vale para os jogos
+ *                                            seguintes, até o próximo
+ *   REGISTRO_RODADA  carta1, carta2 (sem tempo: herda o do início do jogo)
+ *
+ * Um registro truncado no fim do arquivo (queda no meio da escrita) é
+ * ignorado pela leitura.
+ */
+
+#ifndef SUPERTRUNFO_REGISTRO_H
+#define SUPERTRUNFO_REGISTRO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+// Tipos de registro (2 bits)
+#define REGISTRO_DUELO 0
+#define REGISTRO_RODADA 1
+#define REGISTRO_JOGO 2
+#define REGISTRO_SESSAO 3
+
+// Subtipos de REGISTRO_JOGO (campo atributo)
+#define JOGO_INICIO 0
+#define JOGO_FIM 1
+#define JOGO_PARAMETROS 2
+
+// Tamanho padrão do buffer de escrita
+#define TAMANHO_BUFFER_REGISTRO (1 << 20)
+
+// Maior registro possível: cabeçalho + três varints de 64 bits
+#define TAMANHO_MAXIMO_EVENTO 31
+
+// Maior registro de rodada: cabeçalho + dois varints de 32 bits
+#define TAMANHO_MAXIMO_RODADA 11
+
+// Registro aberto para escrita
+typedef struct {
+    int fd;
+    uint8_t *buffer;           // Buffer sendo preenchido
+    size_t usado;
+    size_t capacidade;
+    uint64_t ultimo_tempo_us;  // Base dos deltas de tempo
+    int erro;                  // Diferente de 0 após falha de escrita
+
+    // Thread de escrita: grava 'pendente' enquanto 'buffer' é preenchido
+    pthread_t escritor;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    uint8_t *pendente;
+    size_t tamanho_pendente;
+    int encerrar;
+} RegistroPartidas;
+
+// Evento lido do registro
+typedef struct {
+    int tipo;
+    int atributo;
+    int resultado;
+    uint64_t tempo_us;  // Tempo absoluto (µs desde a época Unix)
+    uint64_t valor1;    // carta1 / id do jogo / rodadas / jogadores
+    uint64_t valor2;    // carta2 / semente / máximo de rodadas
+} EventoRegistro;
+
+// Registro aberto para leitura sequencial
+typedef struct {
+    int fd;
+    uint8_t *buffer;
+    size_t inicio;
+    size_t fim;
+    size_t capacidade;
+    uint64_t tempo_us;
+    uint64_t bytes_lidos;
+    int fim_arquivo;
+} LeitorRegistro;
+
+// Abre (ou cria) o registro para acréscimo, esperando outra sessão no mesmo
+// arquivo fechar; retorna 0 em sucesso, -1 em erro
+int abrir_registro(RegistroPartidas *r, const char *caminho);
+
+// Entrega o buffer atual à thread de escrita; retorna 0 em sucesso, -1 em erro
+int descarregar_registro(RegistroPartidas *r);
+
+// Garante 'bytes' livres no buffer (usado antes de uma sequência de rodadas)
+static inline void reservar_registro(RegistroPartidas *r, size_t bytes) {
+    if (r->capacidade - r->usado < bytes) {
+        descarregar_registro(r);
+    }
+}
+
+// Descarrega e fecha o registro; retorna 0 em sucesso, -1 se houve erro de escrita
+int fechar_registro(RegistroPartidas *r);
+
+// Registra um duelo avulso (modos interativos, avaliadores)
+void registrar_duelo(RegistroPartidas *r, uint32_t carta1, uint32_t carta2, int atributo, int resultado);
+
+// Registra o início e o fim de uma partida simulada
+void registrar_inicio_jogo(RegistroPartidas *r, uint64_t id_jogo, uint64_t semente);
+void registrar_fim_jogo(RegistroPartidas *r, int vencedor, uint32_t rodadas);
+
+// Registra os parâmetros dos jogos seguintes (o replay os usa para conferir
+// um jogo sem depender das opções da linha de comando)
+void registrar_parametros_jogo(RegistroPartidas *r, int jogadores, int max_rodadas,
+                               int equilibrada);
+
+// Escreve um varint no destino e retorna o número de bytes usados
+static inline size_t escrever_varint(uint8_t *destino, uint64_t valor) {
+    size_t n = 0;
+    while (valor >= 0x80) {
+        destino[n++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[n++] = (uint8_t)valor;
+    return n;
+}
+
+// Registra uma rodada de partida simulada. Caminho quente: só escreve no
+// buffer, sem verificar espaço; o chamador reserva TAMANHO_MAXIMO_RODADA
+// bytes por rodada com reservar_registro antes de começar o jogo.
+static inline void registrar_rodada(RegistroPartidas *r, uint32_t carta1, uint32_t carta2,
+                                    int atributo, int resultado) {
+    uint8_t *p = r->buffer + r->usado;
+    uint32_t cabecalho = (uint32_t)(REGISTRO_RODADA | (atributo << 2) | (resultado << 6));
+    // Caminho rápido para baralhos de até 128 cartas: cada carta cabe num byte
+    if ((carta1 | carta2) < 0x80) {
+        p[0] = (uint8_t)cabecalho;
+        p[1] = (uint8_t)carta1;
+        p[2] = (uint8_t)carta2;
+        r->usado += 3;
+    } else {
+        size_t n = 1;
+        p[0] = (uint8_t)cabecalho;
+        n += escrever_varint(p + n, carta1);
+        n += escrever_varint(p + n, carta2);
+        r->usado += n;
+    }
+}
+
+// Abre o registro para leitura; retorna 0 em sucesso, -1 se não for um registro válido
+int abrir_leitor_registro(LeitorRegistro *l, const char *caminho);
+
+// Lê o próximo evento; retorna 1 se leu, 0 no fim do arquivo
+int proximo_evento(LeitorRegistro *l, EventoRegistro *e);
+
+// Fecha o leitor
+void fechar_leitor_registro(LeitorRegistro *l);
+
+#endif
@@ -0,0 +1,467 @@
+/*
+ * Super Trunfo - Regras da casa para a comparação avançada
+ *
+ * Compilador de descida recursiva direto para código de registradores (os
+ * temporários são alocados em pilha: o resultado de uma operação ocupa o
+ * primeiro temporário dos operandos) e máquina que executa o código sobre
+ * lotes de pares.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "regras.h"
+#include "rastreio.h"
+
+// Tamanho máximo de uma linha do arquivo de regras
+#define TAMANHO_LINHA 1024
+
+// Primeiro registrador de constantes e de temporários
+#define PRIMEIRA_CONSTANTE (2 * NUM_ATRIBUTOS)
+#define PRIMEIRO_TEMPORARIO (PRIMEIRA_CONSTANTE + MAXIMO_CONSTANTES_REGRAS)
+
+static const char *const NOMES_ATRIBUTOS[NUM_ATRIBUTOS] = {
+    "populacao", "area", "pib", "densidade", "pib_per_capita", "pontos_turisticos",
+};
+
+// Estado da compilação de uma condição
+typedef struct {
+    ProgramaRegras *p;
+    const char *s;
+    int trocar;          // 1 = a e b trocados
+    int temporarios;     // Próximo temporário livre
+    int erro;
+} Compilador;
+
+static int compilar_ou(Compilador *c);
+
+// Pula espaços
+static void pular_espacos(Compilador *c) {
+    while (isspace((unsigned char)*c->s)) {
+        c->s++;
+    }
+}
+
+// Consome o símbolo, se for o próximo
+static int simbolo(Compilador *c, const char *s) {
+    pular_espacos(c);
+    size_t n = strlen(s);
+    if (strncmp(c->s, s, n) != 0) {
+        return 0;
+    }
+    c->s += n;
+    return 1;
+}
+
+// Consome a palavra inteira, se for a próxima
+static int palavra(Compilador *c, const char *p) {
+    pular_espacos(c);
+    size_t n = strlen(p);
+    if (strncmp(c->s, p, n) != 0 || isalnum((unsigned char)c->s[n]) || c->s[n] == '_') {
+        return 0;
+    }
+    c->s += n;
+    return 1;
+}
+
+// Reserva um temporário
+static int novo_temporario(Compilador *c) {
+    if (c->temporarios >= MAXIMO_REGISTROS_REGRAS) {
+        c->erro = 1;
+        return -1;
+    }
+    int r = c->temporarios++;
+    if (c->temporarios > c->p->registros) {
+        c->p->registros = c->temporarios;
+    }
+    return r;
+}
+
+// Emite destino = x <operação> y, liberando os temporários dos operandos
+static int emitir(Compilador *c, int operacao, int x, int y) {
+    if (c->erro || x < 0 || y < 0 || c->p->instrucoes >= MAXIMO_INSTRUCOES_REGRAS) {
+        c->erro = 1;
+        return -1;
+    }
+    if (y >= PRIMEIRO_TEMPORARIO && y < c->temporarios) {
+        c->temporarios = y;
+    }
+    if (x >= PRIMEIRO_TEMPORARIO && x < c->temporarios) {
+        c->temporarios = x;
+    }
+    int destino = novo_temporario(c);
+    if (destino < 0) {
+        return -1;
+    }
+    InstrucaoRegra *in = &c->p->codigo[c->p->instrucoes++];
+    in->operacao = (uint8_t)operacao;
+    in->destino = (uint8_t)destino;
+    in->x = (uint8_t)x;
+    in->y = (uint8_t)y;
+    return destino;
+}
+
+// Registrador da constante (iguais compartilham o registrador)
+static int constante(Compilador *c, double valor) {
+    ProgramaRegras *p = c->p;
+    for (int k = 0; k < p->constantes; k++) {
+        if (p->valores_constantes[k] == valor) {
+            return PRIMEIRA_CONSTANTE + k;
+        }
+    }
+    if (p->constantes == MAXIMO_CONSTANTES_REGRAS) {
+        c->erro = 1;
+        return -1;
+    }
+    p->valores_constantes[p->constantes] = valor;
+    return PRIMEIRA_CONSTANTE + p->constantes++;
+}
+
+// Número, a.<atributo>, b.<atributo> ou expressão entre parênteses
+static int compilar_primario(Compilador *c) {
+    pular_espacos(c);
+    if (isdigit((unsigned char)*c->s) || *c->s == '.') {
+        char *fim;
+        double valor = strtod(c->s, &fim);
+        if (fim == c->s) {
+            c->erro = 1;
+            return -1;
+        }
+        c->s = fim;
+        return constante(c, valor);
+    }
+    if (simbolo(c, "(")) {
+        int r = compilar_ou(c);
+        if (!simbolo(c, ")")) {
+            c->erro = 1;
+            return -1;
+        }
+        return r;
+    }
+    int lado = (c->s[0] == 'a' ? 0 : c->s[0] == 'b' ? 1 : -1);
+    if (lado < 0 || c->s[1] != '.') {
+        c->erro = 1;
+        return -1;
+    }
+    c->s += 2;
+    for (int t = 0; t < NUM_ATRIBUTOS; t++) {
+        if (palavra(c, NOMES_ATRIBUTOS[t])) {
+            int r = REGISTRO_ATRIBUTO(lado ^ c->trocar, t + 1);
+            c->p->usados |= 1u << r;
+            return r;
+        }
+    }
+    c->erro = 1;
+    return -1;
+}
+
+// Menos unário
+static int compilar_unario(Compilador *c) {
+    if (simbolo(c, "-")) {
+        int x = compilar_unario(c);
+        return emitir(c, REGRA_NEGAR, x, x);
+    }
+    return compilar_primario(c);
+}
+
+static int compilar_produto(Compilador *c) {
+    int x = compilar_unario(c);
+    for (;;) {
+        int operacao = simbolo(c, "*") ? REGRA_MULTIPLICAR : simbolo(c, "/") ? REGRA_DIVIDIR : -1;
+        if (operacao < 0) {
+            return x;
+        }
+        x = emitir(c, operacao, x, compilar_unario(c));
+    }
+}
+
+static int compilar_soma(Compilador *c) {
+    int x = compilar_produto(c);
+    for (;;) {
+        int operacao = simbolo(c, "+") ? REGRA_SOMAR : simbolo(c, "-") ? REGRA_SUBTRAIR : -1;
+        if (operacao < 0) {
+            return x;
+        }
+        x = emitir(c, operacao, x, compilar_produto(c));
+    }
+}
+
+// Uma comparação (não associativa) ou uma soma
+static int compilar_comparacao(Compilador *c) {
+    int x = compilar_soma(c);
+    int operacao = simbolo(c, "<=") ? REGRA_MENOR_IGUAL
+                   : simbolo(c, ">=") ? REGRA_MAIOR_IGUAL
+                   : simbolo(c, "==") ? REGRA_IGUAL
+                   : simbolo(c, "!=") ? REGRA_DIFERENTE
+                   : simbolo(c, "<") ? REGRA_MENOR
+                   : simbolo(c, ">") ? REGRA_MAIOR
+                   : -1;
+    if (operacao < 0) {
+        return x;
+    }
+    return emitir(c, operacao, x, compilar_soma(c));
+}
+
+static int compilar_nao(Compilador *c) {
+    pular_espacos(c);
+    if (palavra(c, "nao") || (c->s[0] == '!' && c->s[1] != '=' && simbolo(c, "!"))) {
+        int x = compilar_nao(c);
+        return emitir(c, REGRA_NAO, x, x);
+    }
+    return compilar_comparacao(c);
+}
+
+static int compilar_e(Compilador *c) {
+    int x = compilar_nao(c);
+    while (palavra(c, "e") || simbolo(c, "&&")) {
+        x = emitir(c, REGRA_E, x, compilar_nao(c));
+    }
+    return x;
+}
+
+static int compilar_ou(Compilador *c) {
+    int x = compilar_e(c);
+    while (palavra(c, "ou") || simbolo(c, "||")) {
+        x = emitir(c, REGRA_OU, x, compilar_e(c));
+    }
+    return x;
+}
+
+// Compila a condição para uma orientação e a decisão correspondente
+static int compilar_condicao(ProgramaRegras *p, const char *texto, int trocar) {
+    Compilador c = { p, texto, trocar, PRIMEIRO_TEMPORARIO, 0 };
+    int r = compilar_ou(&c);
+    pular_espacos(&c);
+    if (c.erro || r < 0 || *c.s != '\0' || p->instrucoes >= MAXIMO_INSTRUCOES_REGRAS) {
+        return -1;
+    }
+    InstrucaoRegra *in = &p->codigo[p->instrucoes++];
+    in->operacao = REGRA_DECIDIR;
+    in->destino = (uint8_t)(trocar ? 2 : 1);
+    in->x = (uint8_t)r;
+    in->y = (uint8_t)r;
+    return 0;
+}
+
+// Remove espaços e quebra de linha das pontas (no próprio texto)
+static char *aparar(char *s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    size_t n = strlen(s);
+    while (n > 0 && isspace((unsigned char)s[n - 1])) {
+        s[--n] = '\0';
+    }
+    return s;
+}
+
+// Interpreta uma linha "regra;<nome>;<condição>"
+static int interpretar_regra(ProgramaRegras *p, char *linha) {
+    char *nome = strchr(linha, ';');
+    char *condicao = nome != NULL ? strchr(nome + 1, ';') : NULL;
+    if (condicao == NULL || p->quantidade_regras == MAXIMO_REGRAS) {
+        return -1;
+    }
+    *nome++ = '\0';
+    *condicao++ = '\0';
+    nome = aparar(nome);
+    size_t n = strlen(nome);
+    if (strcmp(aparar(linha), "regra") != 0 || n >= TAMANHO_NOME_REGRA) {
+        return -1;
+    }
+    if (compilar_condicao(p, condicao, 0) != 0 || compilar_condicao(p, condicao, 1) != 0) {
+        return -1;
+    }
+    memcpy(p->nomes[p->quantidade_regras++], nome, n + 1);
+    return 0;
+}
+
+// Compila as regras do texto
+int compilar_regras(ProgramaRegras *p, const char *texto, const char *origem) {
+    memset(p, 0, sizeof(*p));
+    p->registros = PRIMEIRO_TEMPORARIO;
+    char linha[TAMANHO_LINHA];
+    long numero_linha = 0;
+    while (*texto) {
+        size_t n = strcspn(texto, "\n");
+        numero_linha++;
+        if (n >= sizeof(linha)) {
+            fprintf(stderr, "%s:%ld: linha longa demais\n", origem, numero_linha);
+            return -1;
+        }
+        memcpy(linha, texto, n);
+        linha[n] = '\0';
+        texto += n + (texto[n] == '\n');
+        char *s = aparar(linha);
+        if (s[0] == '#' || s[0] == '\0') {
+            continue;
+        }
+        if (interpretar_regra(p, s) != 0) {
+            fprintf(stderr, "%s:%ld: regra inválida\n", origem, numero_linha);
+            return -1;
+        }
+    }
+    if (p->quantidade_regras == 0) {
+        fprintf(stderr, "%s: nenhuma regra\n", origem);
+        return -1;
+    }
+    return 0;
+}
+
+// Lê e compila o arquivo de regras
+int carregar_regras(ProgramaRegras *p, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        return -1;
+    }
+    size_t capacidade = 4096;
+    size_t tamanho = 0;
+    char *texto = malloc(capacidade);
+    size_t lidos;
+    while (texto != NULL && (lidos = fread(texto + tamanho, 1, capacidade - tamanho - 1, arquivo)) > 0) {
+        tamanho += lidos;
+        if (tamanho + 1 == capacidade) {
+            char *maior = realloc(texto, capacidade * 2);
+            if (maior == NULL) {
+                free(texto);
+            }
+            texto = maior;
+            capacidade *= 2;
+        }
+    }
+    fclose(arquivo);
+    if (texto == NULL) {
+        return -1;
+    }
+    texto[tamanho] = '\0';
+    int status = compilar_regras(p, texto, caminho);
+    free(texto);
+    return status;
+}
+
+// Lê o atributo das m cartas para o registrador
+#define LER_ATRIBUTO(campo)                          \
+    for (int i = 0; i < m; i++) {                    \
+        r[i] = (double)cartas[i]->campo;             \
+    }                                                \
+    break
+
+// Laço de uma operação sobre o lote inteiro (os lugares além de m só
+// carregam lixo inofensivo); o resultado passa por um vetor local porque o
+// destino costuma ser um dos operandos, e o compilador só vetoriza o laço
+// sem sobreposição
+#define OPERAR(expressao)                            \
+    for (int i = 0; i < LOTE_REGRAS; i++) {          \
+        v[i] = (expressao);                          \
+    }                                                \
+    memcpy(d, v, sizeof(v));                         \
+    break
+
+// Valor lógico de um registrador: diferente de zero (NaN é falso)
+#define VERDADE(v) (((v) < 0) | ((v) > 0))
+
+// Executa o programa sobre m pares (m <= LOTE_REGRAS)
+static void executar_lote(const ProgramaRegras *p, const Carta *const *lados[2], int m,
+                          uint8_t *resultados, double (*registros)[LOTE_REGRAS]) {
+    for (int lado = 0; lado < 2; lado++) {
+        const Carta *const *cartas = lados[lado];
+        for (int t = 1; t <= NUM_ATRIBUTOS; t++) {
+            if (!(p->usados & (1u << REGISTRO_ATRIBUTO(lado, t)))) {
+                continue;
+            }
+            double *r = registros[REGISTRO_ATRIBUTO(lado, t)];
+            switch (t) {
+                case COMPARAR_POPULACAO: LER_ATRIBUTO(populacao);
+                case COMPARAR_AREA: LER_ATRIBUTO(area);
+                case COMPARAR_PIB: LER_ATRIBUTO(pib);
+                case COMPARAR_DENSIDADE: LER_ATRIBUTO(densidade);
+                case COMPARAR_PIB_CAPITA: LER_ATRIBUTO(pib_per_capita);
+                case COMPARAR_PONTOS_TURISTICOS: LER_ATRIBUTO(pontos_turisticos);
+            }
+        }
+    }
+
+    // Decisões em double, como os registradores, e sem desvios: o laço
+    // vetoriza
+    double decisoes[LOTE_REGRAS];
+    double pendentes[LOTE_REGRAS];
+    for (int i = 0; i < LOTE_REGRAS; i++) {
+        decisoes[i] = 0.0;
+        pendentes[i] = 1.0;
+    }
+    for (int k = 0; k < p->instrucoes; k++) {
+        const InstrucaoRegra *in = &p->codigo[k];
+        double *d = registros[in->destino];
+        const double *x = registros[in->x];
+        const double *y = registros[in->y];
+        double v[LOTE_REGRAS];
+        switch (in->operacao) {
+            case REGRA_SOMAR: OPERAR(x[i] + y[i]);
+            case REGRA_SUBTRAIR: OPERAR(x[i] - y[i]);
+            case REGRA_MULTIPLICAR: OPERAR(x[i] * y[i]);
+            case REGRA_DIVIDIR: OPERAR(x[i] / y[i]);
+            case REGRA_NEGAR: OPERAR(-x[i]);
+            case REGRA_MENOR: OPERAR(x[i] < y[i]);
+            case REGRA_MENOR_IGUAL: OPERAR(x[i] <= y[i]);
+            case REGRA_MAIOR: OPERAR(x[i] > y[i]);
+            case REGRA_MAIOR_IGUAL: OPERAR(x[i] >= y[i]);
+            case REGRA_IGUAL: OPERAR(x[i] == y[i]);
+            case REGRA_DIFERENTE: OPERAR(x[i] != y[i]);
+            case REGRA_E: OPERAR(VERDADE(x[i]) & VERDADE(y[i]));
+            case REGRA_OU: OPERAR(VERDADE(x[i]) | VERDADE(y[i]));
+            case REGRA_NAO: OPERAR(!VERDADE(x[i]));
+            case REGRA_DECIDIR: {
+                double vencedor = in->destino;
+                for (int i = 0; i < LOTE_REGRAS; i++) {
+                    double decide = (double)VERDADE(x[i]) * pendentes[i];
+                    decisoes[i] += decide * vencedor;
+                    pendentes[i] -= decide;
+                }
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < m; i++) {
+        resultados[i] = (uint8_t)decisoes[i];
+    }
+}
+
+// Preenche os registradores de constantes
+static void preencher_constantes(const ProgramaRegras *p, double (*registros)[LOTE_REGRAS]) {
+    for (int k = 0; k < p->constantes; k++) {
+        for (int i = 0; i < LOTE_REGRAS; i++) {
+            registros[PRIMEIRA_CONSTANTE + k][i] = p->valores_constantes[k];
+        }
+    }
+}
+
+// Aplica as regras às cartas
+int aplicar_regras(const ProgramaRegras *p, const Carta *c1, const Carta *c2) {
+    double registros[MAXIMO_REGISTROS_REGRAS][LOTE_REGRAS] = { { 0 } };
+    const Carta *const *lados[2] = { &c1, &c2 };
+    uint8_t resultado;
+    preencher_constantes(p, registros);
+    executar_lote(p, lados, 1, &resultado, registros);
+    return resultado;
+}
+
+// Aplica as regras aos pares em lotes
+void aplicar_regras_lote(const ProgramaRegras *p, const Baralho *b, const uint32_t *pares,
+                         size_t quantidade, uint8_t *resultados) {
+    RASTREAR_ESCOPO("aplicar_regras_lote");
+    double registros[MAXIMO_REGISTROS_REGRAS][LOTE_REGRAS] = { { 0 } };
+    const Carta *primeiras[LOTE_REGRAS];
+    const Carta *segundas[LOTE_REGRAS];
+    const Carta *const *lados[2] = { primeiras, segundas };
+    preencher_constantes(p, registros);
+    for (size_t inicio = 0; inicio < quantidade; inicio += LOTE_REGRAS) {
+        int m = quantidade - inicio < LOTE_REGRAS ? (int)(quantidade - inicio) : LOTE_REGRAS;
+        for (int i = 0; i < m; i++) {
+            primeiras[i] = &b->cartas[pares[2 * (inicio + i)]];
+            segundas[i] = &b->cartas[pares[2 * (inicio + i) + 1]];
+        }
+        executar_lote(p, lados, m, resultados + inicio, registros);
+    }
+}
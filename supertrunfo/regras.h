@@ -0,0 +1,117 @@
+/*
+ * Super Trunfo - Regras da casa para a comparação avançada
+ *
+ * comparacao_avancada aplica três regras fixas; aqui as regras vêm de um
+ * arquivo, uma por linha (linhas vazias ou iniciadas por '#' são
+ * ignoradas):
+ *
+ *   regra;<nome>;<condição>
+ *
+ * A condição é uma expressão sobre os atributos das duas cartas: a.<atributo>
+ * é a carta que pode vencer e b.<atributo> a adversária. Atributos:
+ * populacao, area, pib, densidade, pib_per_capita e pontos_turisticos.
+ * Operadores, do menos ao mais forte: ou (||), e (&&), nao (!),
+ * comparações (< <= > >= == !=), + -, * /, menos unário; parênteses e
+ * números. Ex.: a primeira regra de comparacao_avancada é
+ *
+ *   regra;populacao e pib;a.populacao > 2 * b.populacao e a.pib > b.pib
+ *
+ * As regras são tentadas na ordem: a primeira cuja condição vale com a =
+ * carta 1 dá a vitória à carta 1; se vale com a = carta 2, à carta 2. Se
+ * nenhuma vale, empate. As contas são em double (uma divisão por zero dá
+ * infinito ou NaN, e NaN falha em qualquer comparação); um valor é
+ * verdadeiro quando é diferente de zero, e NaN é falso.
+ *
+ * Compilação: cada regra vira duas sequências de instruções de
+ * registradores (uma com a e b trocados) mais uma instrução que decide o
+ * resultado. A execução é em lotes: cada registrador guarda o valor de
+ * LOTE_REGRAS pares, os atributos usados são lidos uma vez por lote, e
+ * cada instrução é um laço curto sobre o lote que o compilador vetoriza.
+ * O custo do despacho (um switch por instrução) fica dividido pelos pares
+ * do lote.
+ */
+
+#ifndef SUPERTRUNFO_REGRAS_H
+#define SUPERTRUNFO_REGRAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+#define MAXIMO_REGRAS 32
+#define MAXIMO_INSTRUCOES_REGRAS 512
+#define MAXIMO_REGISTROS_REGRAS 64
+#define MAXIMO_CONSTANTES_REGRAS 32
+#define TAMANHO_NOME_REGRA 32
+
+// Pares avaliados juntos por instrução
+#define LOTE_REGRAS 64
+
+// Registradores fixos: atributo t (1 a 6) da carta a em t - 1, da carta b
+// em NUM_ATRIBUTOS + t - 1; depois as constantes e os temporários
+#define REGISTRO_ATRIBUTO(lado, atributo) ((lado) * NUM_ATRIBUTOS + (atributo) - 1)
+
+// Regras que reproduzem comparacao_avancada
+#define REGRAS_AVANCADAS_PADRAO                                                           \
+    "regra;populacao e pib;a.populacao > 2 * b.populacao e a.pib > b.pib\n"               \
+    "regra;desenvolvimento;a.pib_per_capita > b.pib_per_capita "                          \
+    "e a.pontos_turisticos > b.pontos_turisticos\n"                                       \
+    "regra;qualidade de vida;a.densidade < b.densidade "                                  \
+    "e a.pontos_turisticos > b.pontos_turisticos\n"
+
+// Operações da máquina
+enum {
+    REGRA_SOMAR,
+    REGRA_SUBTRAIR,
+    REGRA_MULTIPLICAR,
+    REGRA_DIVIDIR,
+    REGRA_NEGAR,
+    REGRA_MENOR,
+    REGRA_MENOR_IGUAL,
+    REGRA_MAIOR,
+    REGRA_MAIOR_IGUAL,
+    REGRA_IGUAL,
+    REGRA_DIFERENTE,
+    REGRA_E,
+    REGRA_OU,
+    REGRA_NAO,
+    REGRA_DECIDIR,     // Lugares ainda empatados com x verdadeiro recebem 'destino'
+};
+
+// Instrução: destino = x <operação> y
+typedef struct {
+    uint8_t operacao;
+    uint8_t destino;
+    uint8_t x;
+    uint8_t y;
+} InstrucaoRegra;
+
+// Regras compiladas
+typedef struct {
+    int quantidade_regras;
+    char nomes[MAXIMO_REGRAS][TAMANHO_NOME_REGRA];
+    int instrucoes;
+    InstrucaoRegra codigo[MAXIMO_INSTRUCOES_REGRAS];
+    int constantes;
+    double valores_constantes[MAXIMO_CONSTANTES_REGRAS];  // Registradores 2 * NUM_ATRIBUTOS em diante
+    int registros;                                        // Registradores usados
+    unsigned usados;                                      // Bit REGISTRO_ATRIBUTO = atributo lido
+} ProgramaRegras;
+
+// Compila as regras do texto; retorna 0 em sucesso, -1 em erro (a linha
+// inválida é informada na saída de erro, com 'origem' como nome)
+int compilar_regras(ProgramaRegras *p, const char *texto, const char *origem);
+
+// Lê e compila o arquivo de regras; retorna 0 em sucesso, -1 em erro
+int carregar_regras(ProgramaRegras *p, const char *caminho);
+
+// Aplica as regras às cartas: 1 se c1 vence, 2 se c2 vence, 0 se empate
+int aplicar_regras(const ProgramaRegras *p, const Carta *c1, const Carta *c2);
+
+// Aplica as regras aos pares (b->cartas[pares[2k]], b->cartas[pares[2k + 1]]),
+// em lotes de LOTE_REGRAS; resultados[k] recebe 0, 1 ou 2
+void aplicar_regras_lote(const ProgramaRegras *p, const Baralho *b, const uint32_t *pares,
+                         size_t quantidade, uint8_t *resultados);
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * Super Trunfo - Pontos de retomada de execuções longas
+ *
+ * Thread de escrita com um buffer pendente; cada ponto vai para um arquivo
+ * temporário sincronizado e substitui o anterior com rename().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "retomada.h"
+#include "metricas.h"
+#include "rastreio.h"
+
+// Assinatura do arquivo (inclui a versão do formato no último byte)
+static const uint8_t ASSINATURA_RETOMADA[8] = { 'S', 'T', 'R', 'E', 'T', 0, 0, 1 };
+
+// Cabeçalho do arquivo
+typedef struct {
+    uint8_t assinatura[8];
+    uint32_t tipo;
+    uint32_t reservado;
+    uint64_t identificacao;
+    uint64_t progresso;
+    uint64_t tamanho;
+    uint64_t soma;              // FNV-1a dos dados
+} CabecalhoRetomada;
+
+// FNV-1a de 64 bits, continuando de 'h'
+static uint64_t fnv1a(uint64_t h, const void *dados, size_t tamanho) {
+    const unsigned char *p = dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        h = (h ^ p[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Escreve todo o bloco, repetindo em escritas parciais
+static int escrever_tudo(int fd, const unsigned char *dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escrito = write(fd, dados, tamanho);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += escrito;
+        tamanho -= (size_t)escrito;
+    }
+    return 0;
+}
+
+// Grava o ponto no temporário, sincroniza e troca pelo arquivo
+static int gravar_ponto(const PontoRetomada *p, const unsigned char *dados, size_t tamanho) {
+    int fd = open(p->temporario, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    int falhou = escrever_tudo(fd, dados, tamanho) != 0;
+    falhou |= fsync(fd) != 0;
+    falhou |= close(fd) != 0;
+    if (falhou || rename(p->temporario, p->caminho) != 0) {
+        unlink(p->temporario);
+        return -1;
+    }
+
+    // Torna o rename durável: sincroniza o diretório do arquivo de pontos
+    const char *barra = strrchr(p->caminho, '/');
+    char *diretorio = barra != NULL ? strndup(p->caminho, (size_t)(barra - p->caminho) + 1)
+                                    : strdup(".");
+    if (diretorio == NULL) {
+        return -1;
+    }
+    int fd_diretorio = open(diretorio, O_RDONLY);
+    free(diretorio);
+    if (fd_diretorio >= 0) {
+        fsync(fd_diretorio);
+        close(fd_diretorio);
+    }
+    return 0;
+}
+
+// Thread de escrita: grava cada ponto entregue por salvar_retomada
+static void *gravar_em_segundo_plano(void *arg) {
+    PontoRetomada *p = arg;
+
+    nomear_thread_rastreio("escritor da retomada");
+    pthread_mutex_lock(&p->trava);
+    for (;;) {
+        while (p->tamanho_pendente == 0 && !p->encerrar) {
+            pthread_cond_wait(&p->sinal, &p->trava);
+        }
+        if (p->tamanho_pendente == 0) {
+            break;  // Encerrado e sem nada pendente
+        }
+        size_t tamanho = p->tamanho_pendente;
+        pthread_mutex_unlock(&p->trava);
+
+        int falhou;
+        {
+            RASTREAR_ESCOPO("gravar_retomada");
+            falhou = gravar_ponto(p, p->pendente, tamanho) != 0;
+        }
+
+        pthread_mutex_lock(&p->trava);
+        if (falhou) p->erro = 1;
+        else p->gravados++;
+        p->tamanho_pendente = 0;
+        pthread_cond_broadcast(&p->sinal);
+    }
+    pthread_mutex_unlock(&p->trava);
+    return NULL;
+}
+
+// Abre o arquivo de pontos
+int abrir_retomada(PontoRetomada *p, const char *caminho, double intervalo_segundos) {
+    memset(p, 0, sizeof(*p));
+    size_t t = strlen(caminho);
+    p->caminho = strdup(caminho);
+    p->temporario = malloc(t + 5);
+    if (p->caminho == NULL || p->temporario == NULL) {
+        free(p->caminho);
+        free(p->temporario);
+        return -1;
+    }
+    memcpy(p->temporario, caminho, t);
+    memcpy(p->temporario + t, ".tmp", 5);
+    p->intervalo_ns = intervalo_segundos > 0 ? (uint64_t)(intervalo_segundos * 1e9) : 0;
+    p->ultimo_ns = relogio_ns();
+
+    pthread_mutex_init(&p->trava, NULL);
+    pthread_cond_init(&p->sinal, NULL);
+    if (pthread_create(&p->escritor, NULL, gravar_em_segundo_plano, p) != 0) {
+        pthread_mutex_destroy(&p->trava);
+        pthread_cond_destroy(&p->sinal);
+        free(p->caminho);
+        free(p->temporario);
+        return -1;
+    }
+    return 0;
+}
+
+// Mistura mais um parâmetro à identificação
+uint64_t identificar_valor(uint64_t base, uint64_t valor) {
+    return fnv1a(base, &valor, sizeof(valor));
+}
+
+// Hash de identificação com o conteúdo do baralho (campos, não os bytes da
+// estrutura, que podem ter lixo depois do '\0' dos textos)
+uint64_t identificar_baralho(uint64_t base, const Baralho *b) {
+    uint64_t h = identificar_valor(base, b->quantidade);
+    for (size_t i = 0; i < b->quantidade; i++) {
+        const Carta *c = &b->cartas[i];
+        h = fnv1a(h, c->estado, strlen(c->estado) + 1);
+        h = fnv1a(h, c->codigo, strlen(c->codigo) + 1);
+        h = fnv1a(h, c->nome, strlen(c->nome) + 1);
+        h = fnv1a(h, &c->populacao, sizeof(c->populacao));
+        h = fnv1a(h, &c->area, sizeof(c->area));
+        h = fnv1a(h, &c->pib, sizeof(c->pib));
+        h = fnv1a(h, &c->pontos_turisticos, sizeof(c->pontos_turisticos));
+    }
+    return h;
+}
+
+// Lê o último ponto
+int carregar_retomada(PontoRetomada *p, uint32_t tipo, uint64_t identificacao,
+                      uint64_t *progresso, void *dados, size_t tamanho) {
+    FILE *f = fopen(p->caminho, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+    CabecalhoRetomada c;
+    int valido = fread(&c, sizeof(c), 1, f) == 1
+              && memcmp(c.assinatura, ASSINATURA_RETOMADA, sizeof(c.assinatura)) == 0
+              && c.tipo == tipo && c.identificacao == identificacao && c.tamanho == tamanho
+              && fread(dados, 1, tamanho, f) == tamanho
+              && fnv1a(1469598103934665603ULL, dados, tamanho) == c.soma;
+    fclose(f);
+    if (!valido) {
+        return -1;
+    }
+    *progresso = c.progresso;
+    p->retomado = c.progresso;
+    return 0;
+}
+
+// Já passou o intervalo desde o último ponto
+int retomada_vencida(const PontoRetomada *p) {
+    return relogio_ns() - p->ultimo_ns >= p->intervalo_ns;
+}
+
+// Entrega o estado à thread de escrita
+int salvar_retomada(PontoRetomada *p, uint32_t tipo, uint64_t identificacao,
+                    uint64_t progresso, const void *dados, size_t tamanho) {
+    pthread_mutex_lock(&p->trava);
+    int ocupado = p->tamanho_pendente != 0;
+    int erro = p->erro;
+    pthread_mutex_unlock(&p->trava);
+    if (erro) {
+        return -1;
+    }
+    if (ocupado) {
+        return 1;
+    }
+
+    // A thread de escrita só mexe no buffer com tamanho_pendente != 0
+    size_t total = sizeof(CabecalhoRetomada) + tamanho;
+    if (total > p->capacidade) {
+        unsigned char *maior = realloc(p->pendente, total);
+        if (maior == NULL) {
+            return -1;
+        }
+        p->pendente = maior;
+        p->capacidade = total;
+    }
+    CabecalhoRetomada c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.assinatura, ASSINATURA_RETOMADA, sizeof(c.assinatura));
+    c.tipo = tipo;
+    c.identificacao = identificacao;
+    c.progresso = progresso;
+    c.tamanho = tamanho;
+    c.soma = fnv1a(1469598103934665603ULL, dados, tamanho);
+    memcpy(p->pendente, &c, sizeof(c));
+    memcpy(p->pendente + sizeof(c), dados, tamanho);
+    p->ultimo_ns = relogio_ns();
+
+    pthread_mutex_lock(&p->trava);
+    p->tamanho_pendente = total;
+    pthread_cond_broadcast(&p->sinal);
+    pthread_mutex_unlock(&p->trava);
+    return 0;
+}
+
+// Espera a gravação pendente terminar
+void esperar_retomada(PontoRetomada *p) {
+    pthread_mutex_lock(&p->trava);
+    while (p->tamanho_pendente != 0) {
+        pthread_cond_wait(&p->sinal, &p->trava);
+    }
+    pthread_mutex_unlock(&p->trava);
+}
+
+// Espera a gravação pendente e fecha
+int fechar_retomada(PontoRetomada *p) {
+    pthread_mutex_lock(&p->trava);
+    p->encerrar = 1;
+    pthread_cond_broadcast(&p->sinal);
+    pthread_mutex_unlock(&p->trava);
+    pthread_join(p->escritor, NULL);
+
+    pthread_mutex_destroy(&p->trava);
+    pthread_cond_destroy(&p->sinal);
+    free(p->pendente);
+    free(p->caminho);
+    free(p->temporario);
+    p->pendente = NULL;
+    p->caminho = NULL;
+    p->temporario = NULL;
+    return p->erro ? -1 : 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Super Trunfo - Pontos de retomada de execuções longas
+ *
+ * Uma simulação ou um cálculo de Elo longo grava periodicamente o estado
+ * completo da execução: o progresso (próximo jogo ou próximo duelo, que é
+ * também a posição dos contadores do gerador, já que cada jogo e cada duelo
+ * tira seus números só de (semente, índice)) e os agregados parciais. Ao
+ * começar de novo com o mesmo arquivo e os mesmos parâmetros, a execução
+ * continua do último ponto, e o resultado final é idêntico bit a bit ao de
+ * uma execução sem interrupção: os agregados são somas inteiras, ou ratings
+ * gravados exatamente no fim de um lote.
+ *
+ * A gravação é assíncrona, como no registro de partidas: salvar_retomada só
+ * copia o estado para um buffer e o entrega a uma thread de escrita. Se a
+ * gravação anterior ainda não terminou, o ponto é pulado (e o próximo
+ * chega no fim da etapa seguinte), então quem calcula nunca espera pelo disco.
+ * A thread grava em <caminho>.tmp, sincroniza e troca pelo arquivo com
+ * rename(), então o arquivo é sempre o ponto anterior ou o novo, inteiro;
+ * depois sincroniza o diretório, para a troca também sobreviver a uma queda.
+ *
+ * Formato: cabeçalho (assinatura "STRET\0\0\1", tipo, identificação dos
+ * parâmetros, progresso, tamanho e soma FNV-1a dos dados) seguido dos
+ * dados. A identificação é um hash dos parâmetros que definem o resultado
+ * (semente, tamanho da execução, opções e conteúdo do baralho): um ponto de
+ * outra execução é ignorado.
+ */
+
+#ifndef SUPERTRUNFO_RETOMADA_H
+#define SUPERTRUNFO_RETOMADA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "baralho.h"
+
+// Tipos de execução
+#define RETOMADA_SIMULACAO 1
+#define RETOMADA_ELO 2
+
+// Intervalo padrão entre pontos, em segundos
+#define INTERVALO_RETOMADA_PADRAO 60.0
+
+// Arquivo de pontos de retomada aberto
+typedef struct {
+    char *caminho;
+    char *temporario;           // <caminho>.tmp
+    uint64_t intervalo_ns;
+    uint64_t ultimo_ns;         // Momento do último ponto entregue
+    uint64_t gravados;          // Pontos gravados com sucesso
+    uint64_t retomado;          // Progresso do ponto carregado (0 = do início)
+    int erro;                   // Diferente de 0 após falha de gravação
+
+    // Thread de escrita: grava 'pendente' enquanto a execução continua
+    pthread_t escritor;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    unsigned char *pendente;
+    size_t capacidade;
+    size_t tamanho_pendente;    // 0 = livre
+    int encerrar;
+} PontoRetomada;
+
+// Abre o arquivo de pontos (não lê nada); retorna 0 em sucesso, -1 em erro
+int abrir_retomada(PontoRetomada *p, const char *caminho, double intervalo_segundos);
+
+// Hash de identificação: parte de 'base' e mistura o conteúdo do baralho
+uint64_t identificar_baralho(uint64_t base, const Baralho *b);
+
+// Mistura mais um parâmetro à identificação
+uint64_t identificar_valor(uint64_t base, uint64_t valor);
+
+// Lê o último ponto: retorna 0 e preenche progresso e dados se o arquivo
+// existe, é íntegro e é do mesmo tipo, identificação e tamanho; -1 se não
+int carregar_retomada(PontoRetomada *p, uint32_t tipo, uint64_t identificacao,
+                      uint64_t *progresso, void *dados, size_t tamanho);
+
+// Já passou o intervalo desde o último ponto
+int retomada_vencida(const PontoRetomada *p);
+
+// Entrega o estado à thread de escrita; retorna 0 se foi entregue, 1 se a
+// gravação anterior ainda corre (ponto pulado) e -1 em erro
+int salvar_retomada(PontoRetomada *p, uint32_t tipo, uint64_t identificacao,
+                    uint64_t progresso, const void *dados, size_t tamanho);
+
+// Espera a gravação pendente terminar (antes do ponto final, que não
+// pode ser pulado)
+void esperar_retomada(PontoRetomada *p);
+
+// Espera a gravação pendente e fecha; retorna 0 em sucesso, -1 se alguma
+// gravação falhou
+int fechar_retomada(PontoRetomada *p);
+
+#endif
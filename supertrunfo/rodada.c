@@ -0,0 +1,94 @@
+/*
+ * Super Trunfo - Rodada com vários jogadores
+ */
+
+#include <math.h>
+
+#include "rodada.h"
+
+// Largura dos laços de máximo (float em registradores de 256 bits)
+#define LARGURA_VETOR 8
+
+// Copia o campo dos k lugares para as chaves; o switch fica fora do laço
+#define COLETAR_CAMPO(campo, sinal)                                        \
+    for (int t = 0; t < k; t++) {                                          \
+        float v = cartas[t] != NULL ? (float)cartas[t]->campo : 0.0f;      \
+        invalidas |= (uint64_t)(v < 0) << t;                               \
+        chaves[t] = cartas[t] != NULL ? (sinal) * v : -INFINITY;           \
+    }                                                                      \
+    break
+
+// Resolve uma rodada de k cartas no atributo
+int resolver_rodada(const Carta *const *cartas, int k, int atributo, ResultadoRodada *r) {
+    float chaves[MAXIMO_CARTAS_RODADA];
+    uint64_t ocupados = 0;
+    uint64_t invalidas = 0;
+    if (k > MAXIMO_CARTAS_RODADA) {
+        k = MAXIMO_CARTAS_RODADA;
+    }
+    for (int t = 0; t < k; t++) {
+        ocupados |= (uint64_t)(cartas[t] != NULL) << t;
+    }
+
+    switch (atributo) {
+        case COMPARAR_POPULACAO: COLETAR_CAMPO(populacao, 1.0f);
+        case COMPARAR_AREA: COLETAR_CAMPO(area, 1.0f);
+        case COMPARAR_PIB: COLETAR_CAMPO(pib, 1.0f);
+        case COMPARAR_DENSIDADE: COLETAR_CAMPO(densidade, -1.0f);
+        case COMPARAR_PIB_CAPITA: COLETAR_CAMPO(pib_per_capita, 1.0f);
+        case COMPARAR_PONTOS_TURISTICOS: COLETAR_CAMPO(pontos_turisticos, 1.0f);
+        default:
+            invalidas = ocupados;  // Atributo inválido = empate
+            break;
+    }
+    if ((invalidas & ocupados) != 0) {
+        r->vencedor = -1;
+        r->empatadas = ocupados;
+        return -1;
+    }
+
+    // Máximo em LARGURA_VETOR faixas independentes, depois entre as faixas
+    int preenchidas = (k + LARGURA_VETOR - 1) / LARGURA_VETOR * LARGURA_VETOR;
+    for (int t = k; t < preenchidas; t++) {
+        chaves[t] = -INFINITY;
+    }
+    float parcial[LARGURA_VETOR];
+    for (int l = 0; l < LARGURA_VETOR; l++) {
+        parcial[l] = -INFINITY;
+    }
+    for (int t = 0; t < preenchidas; t += LARGURA_VETOR) {
+        for (int l = 0; l < LARGURA_VETOR; l++) {
+            parcial[l] = chaves[t + l] > parcial[l] ? chaves[t + l] : parcial[l];
+        }
+    }
+    float maximo = parcial[0];
+    for (int l = 1; l < LARGURA_VETOR; l++) {
+        maximo = parcial[l] > maximo ? parcial[l] : maximo;
+    }
+
+    uint64_t empatadas = 0;
+    for (int t = 0; t < k; t++) {
+        empatadas |= (uint64_t)(chaves[t] == maximo) << t;
+    }
+    empatadas &= ocupados;
+
+    r->empatadas = empatadas;
+    r->vencedor = __builtin_popcountll(empatadas) == 1 ? __builtin_ctzll(empatadas) : -1;
+    return r->vencedor;
+}
+
+// Resolve várias rodadas de k lugares
+void resolver_rodadas(const Baralho *b, const uint32_t *cartas, int k, const uint8_t *atributos,
+                      size_t rodadas, ResultadoRodada *resultados) {
+    const Carta *lugares[MAXIMO_CARTAS_RODADA];
+    if (k > MAXIMO_CARTAS_RODADA) {
+        k = MAXIMO_CARTAS_RODADA;
+    }
+    for (size_t q = 0; q < rodadas; q++) {
+        const uint32_t *indices = cartas + q * (size_t)k;
+        for (int t = 0; t < k; t++) {
+            lugares[t] = indices[t] != SEM_CARTA ? &b->cartas[indices[t]] : NULL;
+        }
+        resolver_rodada(lugares, k, atributos[q], &resultados[q]);
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Super Trunfo - Rodada com vários jogadores
+ *
+ * Resolve de uma vez uma rodada de K cartas (K até 64) num atributo: vence
+ * a carta de maior valor (menor, na densidade); se o melhor valor aparece
+ * em mais de uma carta, elas formam o conjunto empatado. As regras são as
+ * de comparar_cartas: se alguma carta tem valor inválido (negativo) ou o
+ * atributo é inválido, a rodada empata entre todas as cartas. Com K = 2 o
+ * resultado é sempre o mesmo de comparar_cartas.
+ *
+ * Os valores dos K lugares são copiados para um vetor de chaves orientadas
+ * para "maior vence"; o máximo e a máscara dos lugares que o alcançam saem
+ * de laços de largura fixa, sem desvios, que o compilador vetoriza.
+ * Lugares vazios (jogador eliminado) não vencem nem empatam.
+ */
+
+#ifndef SUPERTRUNFO_RODADA_H
+#define SUPERTRUNFO_RODADA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+// Maior número de cartas (lugares) numa rodada
+#define MAXIMO_CARTAS_RODADA 64
+
+// Lugar vazio no lote de rodadas
+#define SEM_CARTA UINT32_MAX
+
+// Resultado de uma rodada
+typedef struct {
+    int vencedor;         // Lugar (0 em diante) da carta vencedora; -1 se empate
+    uint64_t empatadas;   // Bit t = lugar t tem o melhor valor (só o vencedor, se houver)
+} ResultadoRodada;
+
+// Resolve uma rodada de k cartas (NULL = lugar vazio) no atributo (1 a 6);
+// retorna r->vencedor
+int resolver_rodada(const Carta *const *cartas, int k, int atributo, ResultadoRodada *r);
+
+// Resolve 'rodadas' rodadas de k lugares de uma vez: a carta do lugar t na
+// rodada q é b->cartas[cartas[q * k + t]] (SEM_CARTA = lugar vazio) e o
+// atributo é atributos[q]
+void resolver_rodadas(const Baralho *b, const uint32_t *cartas, int k, const uint8_t *atributos,
+                      size_t rodadas, ResultadoRodada *resultados);
+
+#endif
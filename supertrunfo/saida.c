@@ -0,0 +1,281 @@
+/*
+ * Super Trunfo - Saída legível por máquina (JSON Lines e CSV)
+ *
+ * Cada registro é montado direto no buffer: antes de começar, o formatador
+ * garante ESPACO_REGISTRO bytes livres (o maior registro possível cabe com
+ * folga), então as funções de escrita não verificam limites.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "saida.h"
+
+// Espaço reservado por registro (campos de texto escapados + números)
+#define ESPACO_REGISTRO 4096
+
+// Tipos de registro (bit em 'cabecalhos')
+#define REGISTRO_CARTA 0
+#define REGISTRO_COMPARACAO 1
+#define REGISTRO_AVANCADO 2
+
+// Acima disso o ponto fixo com duas casas não cabe em 64 bits
+#define MAXIMO_PONTO_FIXO 9.0e15
+
+static const char DIGITOS_PARES[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char *const CABECALHOS_CSV[] = {
+    "tipo,estado,codigo,nome,populacao,area,pib,pontos_turisticos,densidade,pib_per_capita\n",
+    "tipo,atributo,codigo1,nome1,codigo2,nome2,valor1,valor2,resultado\n",
+    "tipo,codigo1,nome1,codigo2,nome2,resultado\n",
+};
+
+// Converte "texto"/"jsonl"/"csv" na constante; -1 se desconhecido
+int interpretar_formato(const char *nome) {
+    if (strcmp(nome, "texto") == 0) return FORMATO_TEXTO;
+    if (strcmp(nome, "jsonl") == 0 || strcmp(nome, "json") == 0) return FORMATO_JSONL;
+    if (strcmp(nome, "csv") == 0) return FORMATO_CSV;
+    return -1;
+}
+
+// Prepara o formatador
+int abrir_formatador(FormatadorSaida *f, int fd, int formato) {
+    f->formato = formato;
+    f->fd = fd;
+    f->tamanho = 0;
+    f->cabecalhos = 0;
+    f->erro = 0;
+    f->gravados = 0;
+    f->buffer = malloc(TAMANHO_BUFFER_SAIDA);
+    return f->buffer != NULL ? 0 : -1;
+}
+
+// Grava o buffer no descritor
+int descarregar_formatador(FormatadorSaida *f) {
+    size_t escritos = 0;
+    while (escritos < f->tamanho && !f->erro) {
+        ssize_t n = write(f->fd, f->buffer + escritos, f->tamanho - escritos);
+        if (n > 0) {
+            escritos += (size_t)n;
+        } else if (n < 0 && errno != EINTR) {
+            f->erro = 1;
+        }
+    }
+    f->gravados += escritos;
+    f->tamanho = 0;
+    return f->erro ? -1 : 0;
+}
+
+// Descarrega e libera o buffer
+int fechar_formatador(FormatadorSaida *f) {
+    int status = descarregar_formatador(f);
+    free(f->buffer);
+    f->buffer = NULL;
+    return status;
+}
+
+// Garante espaço para um registro e retorna onde escrever
+static char *iniciar_registro(FormatadorSaida *f) {
+    if (TAMANHO_BUFFER_SAIDA - f->tamanho < ESPACO_REGISTRO) {
+        descarregar_formatador(f);
+    }
+    return f->buffer + f->tamanho;
+}
+
+static void concluir_registro(FormatadorSaida *f, char *fim) {
+    f->tamanho = (size_t)(fim - f->buffer);
+}
+
+static char *escrever_texto(char *p, const char *texto) {
+    size_t n = strlen(texto);
+    memcpy(p, texto, n);
+    return p + n;
+}
+
+// Inteiro sem sinal em decimal, dois dígitos por vez
+static char *escrever_natural(char *p, unsigned long long v) {
+    char temporario[20];
+    char *t = temporario + sizeof(temporario);
+    while (v >= 100) {
+        unsigned d = (unsigned)(v % 100) * 2;
+        v /= 100;
+        *--t = DIGITOS_PARES[d + 1];
+        *--t = DIGITOS_PARES[d];
+    }
+    if (v >= 10) {
+        *--t = DIGITOS_PARES[v * 2 + 1];
+        *--t = DIGITOS_PARES[v * 2];
+    } else {
+        *--t = (char)('0' + v);
+    }
+    size_t n = (size_t)(temporario + sizeof(temporario) - t);
+    memcpy(p, t, n);
+    return p + n;
+}
+
+static char *escrever_inteiro(char *p, long long v) {
+    if (v < 0) {
+        *p++ = '-';
+        return escrever_natural(p, 0ULL - (unsigned long long)v);
+    }
+    return escrever_natural(p, (unsigned long long)v);
+}
+
+// Real com duas casas decimais em ponto fixo (valores enormes usam snprintf)
+static char *escrever_real(char *p, double v) {
+    if (!(fabs(v) < MAXIMO_PONTO_FIXO)) {
+        return p + snprintf(p, 64, "%.2f", v);
+    }
+    long long centesimos = llround(v * 100.0);
+    if (centesimos < 0) {
+        *p++ = '-';
+        centesimos = -centesimos;
+    }
+    p = escrever_natural(p, (unsigned long long)(centesimos / 100));
+    unsigned d = (unsigned)(centesimos % 100) * 2;
+    *p++ = '.';
+    *p++ = DIGITOS_PARES[d];
+    *p++ = DIGITOS_PARES[d + 1];
+    return p;
+}
+
+// Atributo derivado: negativo indica valor não calculável
+static char *escrever_opcional(const FormatadorSaida *f, char *p, double v) {
+    if (v < 0) {
+        return f->formato == FORMATO_JSONL ? escrever_texto(p, "null") : p;
+    }
+    return escrever_real(p, v);
+}
+
+// Valor de um atributo no tipo dele (inteiro ou real)
+static char *escrever_atributo(const FormatadorSaida *f, char *p, const Carta *c, int atributo) {
+    switch (atributo) {
+        case COMPARAR_POPULACAO: return escrever_inteiro(p, c->populacao);
+        case COMPARAR_PONTOS_TURISTICOS: return escrever_inteiro(p, c->pontos_turisticos);
+        default: return escrever_opcional(f, p, obter_valor_atributo(c, atributo));
+    }
+}
+
+// String JSON com aspas (escapa aspas, barra e controles; UTF-8 passa direto)
+static char *escrever_string_json(char *p, const char *texto) {
+    *p++ = '"';
+    for (const unsigned char *s = (const unsigned char *)texto; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            *p++ = '\\';
+            *p++ = (char)*s;
+        } else if (*s < 0x20) {
+            p += snprintf(p, 7, "\\u%04x", *s);
+        } else {
+            *p++ = (char)*s;
+        }
+    }
+    *p++ = '"';
+    return p;
+}
+
+// Campo CSV (entre aspas só quando contém separador, aspas ou quebra de linha)
+static char *escrever_campo_csv(char *p, const char *texto) {
+    if (strpbrk(texto, ",\"\r\n") == NULL) {
+        return escrever_texto(p, texto);
+    }
+    *p++ = '"';
+    for (const char *s = texto; *s; s++) {
+        if (*s == '"') {
+            *p++ = '"';
+        }
+        *p++ = *s;
+    }
+    *p++ = '"';
+    return p;
+}
+
+// Início de um registro: cabeçalho CSV na primeira vez, abertura do objeto
+static char *abrir_registro(FormatadorSaida *f, int tipo, const char *nome_tipo) {
+    char *p = iniciar_registro(f);
+    if (f->formato == FORMATO_CSV) {
+        if (!(f->cabecalhos & (1u << tipo))) {
+            f->cabecalhos |= 1u << tipo;
+            p = escrever_texto(p, CABECALHOS_CSV[tipo]);
+        }
+        return escrever_texto(p, nome_tipo);
+    }
+    p = escrever_texto(p, "{\"tipo\":\"");
+    p = escrever_texto(p, nome_tipo);
+    return escrever_texto(p, "\"");
+}
+
+// Separador e nome do campo (JSON) ou só a vírgula (CSV)
+static char *abrir_campo(const FormatadorSaida *f, char *p, const char *nome) {
+    *p++ = ',';
+    if (f->formato == FORMATO_JSONL) {
+        *p++ = '"';
+        p = escrever_texto(p, nome);
+        *p++ = '"';
+        *p++ = ':';
+    }
+    return p;
+}
+
+static char *campo_texto(const FormatadorSaida *f, char *p, const char *nome, const char *valor) {
+    p = abrir_campo(f, p, nome);
+    return f->formato == FORMATO_JSONL ? escrever_string_json(p, valor) : escrever_campo_csv(p, valor);
+}
+
+static char *fechar_registro(const FormatadorSaida *f, char *p) {
+    if (f->formato == FORMATO_JSONL) {
+        *p++ = '}';
+    }
+    *p++ = '\n';
+    return p;
+}
+
+// Acrescenta um registro de carta
+void formatar_carta(FormatadorSaida *f, const Carta *c) {
+    char *p = abrir_registro(f, REGISTRO_CARTA, "carta");
+    p = campo_texto(f, p, "estado", c->estado);
+    p = campo_texto(f, p, "codigo", c->codigo);
+    p = campo_texto(f, p, "nome", c->nome);
+    p = escrever_inteiro(abrir_campo(f, p, "populacao"), c->populacao);
+    p = escrever_real(abrir_campo(f, p, "area"), c->area);
+    p = escrever_real(abrir_campo(f, p, "pib"), c->pib);
+    p = escrever_inteiro(abrir_campo(f, p, "pontos_turisticos"), c->pontos_turisticos);
+    p = escrever_opcional(f, abrir_campo(f, p, "densidade"), c->densidade);
+    p = escrever_opcional(f, abrir_campo(f, p, "pib_per_capita"), c->pib_per_capita);
+    concluir_registro(f, fechar_registro(f, p));
+}
+
+// Acrescenta um registro de comparação
+void formatar_comparacao(FormatadorSaida *f, const Carta *c1, const Carta *c2,
+                         int atributo, int resultado) {
+    char *p = abrir_registro(f, REGISTRO_COMPARACAO, "comparacao");
+    p = escrever_inteiro(abrir_campo(f, p, "atributo"), atributo);
+    p = campo_texto(f, p, "codigo1", c1->codigo);
+    p = campo_texto(f, p, "nome1", c1->nome);
+    p = campo_texto(f, p, "codigo2", c2->codigo);
+    p = campo_texto(f, p, "nome2", c2->nome);
+    p = escrever_atributo(f, abrir_campo(f, p, "valor1"), c1, atributo);
+    p = escrever_atributo(f, abrir_campo(f, p, "valor2"), c2, atributo);
+    p = escrever_inteiro(abrir_campo(f, p, "resultado"), resultado);
+    concluir_registro(f, fechar_registro(f, p));
+}
+
+// Acrescenta um registro de análise avançada
+void formatar_resultado_avancado(FormatadorSaida *f, const Carta *c1, const Carta *c2,
+                                 int resultado) {
+    char *p = abrir_registro(f, REGISTRO_AVANCADO, "avancado");
+    p = campo_texto(f, p, "codigo1", c1->codigo);
+    p = campo_texto(f, p, "nome1", c1->nome);
+    p = campo_texto(f, p, "codigo2", c2->codigo);
+    p = campo_texto(f, p, "nome2", c2->nome);
+    p = escrever_inteiro(abrir_campo(f, p, "resultado"), resultado);
+    concluir_registro(f, fechar_registro(f, p));
+}
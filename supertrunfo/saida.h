@@ -0,0 +1,66 @@
+/*
+ * Super Trunfo - Saída legível por máquina (JSON Lines e CSV)
+ *
+ * O formatador escreve registros de cartas, comparações e análises
+ * avançadas num buffer reutilizável e grava o buffer no descritor com
+ * write() quando ele enche (ou ao descarregar), sem passar pelo stdio.
+ * Números são convertidos sem printf: inteiros por tabela de dois dígitos e
+ * reais em ponto fixo com duas casas (o mesmo arredondamento de "%.2f" da
+ * saída em texto). Valores inválidos (negativos) saem como null em JSON e
+ * vazios em CSV.
+ *
+ * JSON Lines: um objeto por linha com "tipo" = "carta", "comparacao" ou
+ * "avancado". CSV: a primeira coluna é o tipo; o cabeçalho de cada tipo é
+ * emitido antes do seu primeiro registro.
+ */
+
+#ifndef SUPERTRUNFO_SAIDA_H
+#define SUPERTRUNFO_SAIDA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "carta.h"
+
+#define FORMATO_TEXTO 0
+#define FORMATO_JSONL 1
+#define FORMATO_CSV 2
+
+// Tamanho do buffer do formatador
+#define TAMANHO_BUFFER_SAIDA (1 << 20)
+
+// Formatador ligado a um descritor de arquivo
+typedef struct {
+    int formato;
+    int fd;
+    char *buffer;
+    size_t tamanho;
+    unsigned cabecalhos;   // Tipos cujo cabeçalho CSV já foi emitido
+    int erro;              // Alguma escrita falhou
+    uint64_t gravados;     // Bytes já gravados no descritor
+} FormatadorSaida;
+
+// Converte "texto"/"jsonl"/"csv" na constante; -1 se desconhecido
+int interpretar_formato(const char *nome);
+
+// Prepara o formatador; retorna 0 em sucesso, -1 sem memória
+int abrir_formatador(FormatadorSaida *f, int fd, int formato);
+
+// Acrescenta um registro de carta
+void formatar_carta(FormatadorSaida *f, const Carta *c);
+
+// Acrescenta um registro de comparação (resultado de comparar_cartas)
+void formatar_comparacao(FormatadorSaida *f, const Carta *c1, const Carta *c2,
+                         int atributo, int resultado);
+
+// Acrescenta um registro de análise avançada (resultado de comparacao_avancada)
+void formatar_resultado_avancado(FormatadorSaida *f, const Carta *c1, const Carta *c2,
+                                 int resultado);
+
+// Grava o buffer no descritor; retorna 0 em sucesso, -1 se alguma escrita falhou
+int descarregar_formatador(FormatadorSaida *f);
+
+// Descarrega e libera o buffer (o descritor não é fechado)
+int fechar_formatador(FormatadorSaida *f);
+
+#endif
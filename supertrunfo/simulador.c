@@ -0,0 +1,532 @@
+/*
+ * Super Trunfo - Simulador de partidas
+ *
+ * Cada jogador guarda a mão numa fila circular de índices do baralho; a carta
+ * do topo é jogada e as cartas ganhas entram no fim da fila.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "simulador.h"
+#include "aleatorio.h"
+#include "metricas.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Jogos por evento de rastreio na simulação em lote
+#define JOGOS_POR_LOTE 4096
+
+// Rodadas cobertas por cada reserva de espaço no registro (potência de 2)
+#define RODADAS_POR_RESERVA 1024
+
+// Jogos de mais de dois jogadores avançados juntos (uma rodada de cada por lote)
+#define JOGOS_POR_GRUPO 64
+
+// Jogos por etapa com pontos de retomada (um ponto possível no fim de cada etapa)
+#define JOGOS_POR_ETAPA 65536
+
+// Fila circular com os índices das cartas de um jogador
+typedef struct {
+    uint32_t *indices;
+    size_t inicio;
+    size_t tamanho;
+    size_t capacidade;
+} Mao;
+
+static void colocar_no_fim(Mao *m, uint32_t indice) {
+    m->indices[(m->inicio + m->tamanho) % m->capacidade] = indice;
+    m->tamanho++;
+}
+
+static uint32_t retirar_do_topo(Mao *m) {
+    uint32_t indice = m->indices[m->inicio];
+    m->inicio = (m->inicio + 1) % m->capacidade;
+    m->tamanho--;
+    return indice;
+}
+
+// Fila de cartas encadeada pelo vetor 'proxima' do jogo (sem cópias ao juntar)
+typedef struct {
+    uint32_t primeira;
+    uint32_t ultima;
+    uint32_t tamanho;
+} Fila;
+
+// Estado de um jogo de mais de dois jogadores
+typedef struct {
+    uint32_t *proxima;                   // Carta seguinte na fila de cada carta
+    Fila maos[MAXIMO_CARTAS_RODADA];
+    Fila monte;
+    uint64_t id;
+    int ativo;
+} JogoGrupo;
+
+static void colocar_na_fila(uint32_t *proxima, Fila *f, uint32_t carta) {
+    if (f->tamanho == 0) {
+        f->primeira = carta;
+    } else {
+        proxima[f->ultima] = carta;
+    }
+    f->ultima = carta;
+    f->tamanho++;
+}
+
+static uint32_t retirar_da_fila(const uint32_t *proxima, Fila *f) {
+    uint32_t carta = f->primeira;
+    f->primeira = proxima[carta];
+    f->tamanho--;
+    return carta;
+}
+
+// Passa todas as cartas de 'origem' para o fim de 'destino'
+static void juntar_filas(uint32_t *proxima, Fila *destino, Fila *origem) {
+    if (origem->tamanho == 0) {
+        return;
+    }
+    if (destino->tamanho == 0) {
+        destino->primeira = origem->primeira;
+    } else {
+        proxima[destino->ultima] = origem->primeira;
+    }
+    destino->ultima = origem->ultima;
+    destino->tamanho += origem->tamanho;
+    origem->tamanho = 0;
+}
+
+// Contexto da simulação paralela
+typedef struct {
+    const Baralho *b;
+    long inicio;
+    long jogos;
+    uint64_t semente;
+    const OpcoesSimulacao *o;
+    EstatisticasSimulacao *parciais;  // Uma por thread
+    int falhou;
+} ContextoSimulacao;
+
+// Embaralha o baralho do jogo (rodada 0 do contador)
+static void embaralhar_jogo(uint32_t *cartas, size_t n, uint64_t semente, uint64_t id_jogo) {
+    FluxoAleatorio f;
+    iniciar_fluxo(&f, semente, id_jogo, 0);
+    embaralhar_fluxo(&f, cartas, n);
+}
+
+// Atributo da rodada (1 em diante) do jogo
+static int sortear_atributo(uint64_t semente, uint64_t id_jogo, int rodada) {
+    FluxoAleatorio f;
+    iniciar_fluxo(&f, semente, id_jogo, (uint32_t)rodada);
+    return 1 + (int)sortear_fluxo(&f, NUM_ATRIBUTOS);
+}
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_simulacao(OpcoesSimulacao *o) {
+    o->max_rodadas = MAX_RODADAS_PADRAO;
+    o->jogadores = 2;
+    o->threads = 1;
+    o->recarga = NULL;
+    o->registro = NULL;
+    o->forca = NULL;
+    o->retomada = NULL;
+}
+
+// Encerra o jogo se restar um jogador ou acabarem as rodadas
+static int encerrar_jogo_grupo(JogoGrupo *g, int jogadores, int max_rodadas, ResultadoJogo *r) {
+    int restantes = 0;
+    for (int p = 0; p < jogadores; p++) {
+        restantes += g->maos[p].tamanho > 0;
+    }
+    if (restantes > 1 && r->rodadas < max_rodadas) {
+        return 0;
+    }
+
+    // Vence quem tiver mais cartas, se for um só
+    uint32_t maior = 0;
+    r->vencedor = 0;
+    for (int p = 0; p < jogadores; p++) {
+        if (g->maos[p].tamanho > maior) {
+            maior = g->maos[p].tamanho;
+            r->vencedor = p + 1;
+        } else if (g->maos[p].tamanho == maior) {
+            r->vencedor = 0;
+        }
+    }
+    g->ativo = 0;
+    return 1;
+}
+
+// Simula juntos os jogos primeiro..primeiro+quantidade-1 de mais de dois
+// jogadores; cada passo resolve uma rodada de cada jogo ativo num único lote
+static int simular_grupo(const Baralho *b, uint64_t semente, uint64_t primeiro, int quantidade,
+                         const OpcoesSimulacao *o, ResultadoJogo *resultados) {
+    RASTREAR_ESCOPO("grupo_de_jogos");
+    size_t n = b->quantidade;
+    int k = o->jogadores;
+    if (k < 2 || k > MAXIMO_CARTAS_RODADA || n < (size_t)k || quantidade > JOGOS_POR_GRUPO) {
+        return -1;
+    }
+
+    // Uma lista encadeada por jogo, o embaralhamento e, com a força das
+    // cartas, o espaço de trabalho da distribuição equilibrada
+    JogoGrupo *jogos = malloc((size_t)quantidade * sizeof(JogoGrupo));
+    size_t listas = (size_t)quantidade + 1 + (o->forca != NULL ? 2 : 0);
+    uint32_t *memoria = malloc(listas * n * sizeof(uint32_t));
+    uint32_t *cartas = malloc((size_t)JOGOS_POR_GRUPO * (size_t)k * sizeof(uint32_t));
+    if (jogos == NULL || memoria == NULL || cartas == NULL) {
+        free(jogos);
+        free(memoria);
+        free(cartas);
+        return -1;
+    }
+    uint32_t *embaralhadas = memoria + (size_t)quantidade * n;
+    uint8_t atributos[JOGOS_POR_GRUPO];
+    int indices[JOGOS_POR_GRUPO];
+    ResultadoRodada rodadas[JOGOS_POR_GRUPO];
+
+    // Embaralha e distribui uma carta por jogador de cada vez; o resto fica fora
+    for (int i = 0; i < quantidade; i++) {
+        JogoGrupo *g = &jogos[i];
+        memset(g, 0, sizeof(*g));
+        memset(&resultados[i], 0, sizeof(ResultadoJogo));
+        g->proxima = memoria + (size_t)i * n;
+        g->id = primeiro + (uint64_t)i;
+        g->ativo = 1;
+        embaralhar_jogo(embaralhadas, n, semente, g->id);
+        if (o->forca != NULL) {
+            distribuir_equilibrado(o->forca, embaralhadas, n, k, embaralhadas + n, NULL);
+        }
+        for (size_t c = 0; c < n / (size_t)k * (size_t)k; c++) {
+            colocar_na_fila(g->proxima, &g->maos[c % (size_t)k], embaralhadas[c]);
+        }
+    }
+
+    int ativos = quantidade;
+    while (ativos > 0) {
+        // Cada jogo ativo põe a carta do topo de cada jogador na mesa
+        int lote = 0;
+        for (int i = 0; i < quantidade; i++) {
+            JogoGrupo *g = &jogos[i];
+            if (!g->ativo) {
+                continue;
+            }
+            uint32_t *mesa = cartas + (size_t)lote * (size_t)k;
+            for (int p = 0; p < k; p++) {
+                mesa[p] = g->maos[p].tamanho > 0 ? retirar_da_fila(g->proxima, &g->maos[p])
+                                                 : SEM_CARTA;
+            }
+            atributos[lote] = (uint8_t)sortear_atributo(semente, g->id, resultados[i].rodadas + 1);
+            indices[lote++] = i;
+        }
+
+        resolver_rodadas(b, cartas, k, atributos, (size_t)lote, rodadas);
+
+        for (int q = 0; q < lote; q++) {
+            JogoGrupo *g = &jogos[indices[q]];
+            ResultadoJogo *r = &resultados[indices[q]];
+            const uint32_t *mesa = cartas + (size_t)q * (size_t)k;
+            int vencedor = rodadas[q].vencedor;
+            r->rodadas++;
+
+            // Empate: as cartas vão para o monte; senão o vencedor leva a
+            // própria carta, as dos outros e o monte acumulado
+            Fila *destino = vencedor < 0 ? &g->monte : &g->maos[vencedor];
+            if (vencedor < 0) {
+                r->empates++;
+            } else {
+                colocar_na_fila(g->proxima, destino, mesa[vencedor]);
+            }
+            for (int p = 0; p < k; p++) {
+                if (mesa[p] != SEM_CARTA && p != vencedor) {
+                    colocar_na_fila(g->proxima, destino, mesa[p]);
+                }
+            }
+            if (vencedor >= 0) {
+                juntar_filas(g->proxima, destino, &g->monte);
+            }
+            ativos -= encerrar_jogo_grupo(g, k, o->max_rodadas, r);
+        }
+    }
+
+    free(jogos);
+    free(memoria);
+    free(cartas);
+    return 0;
+}
+
+// Simula uma partida; retorna 0 em sucesso, -1 se o baralho tiver menos de 2 cartas
+int simular_jogo(const Baralho *b, uint64_t semente, int max_rodadas, ResultadoJogo *r) {
+    OpcoesSimulacao o;
+    iniciar_opcoes_simulacao(&o);
+    o.max_rodadas = max_rodadas;
+    return simular_jogo_opcoes(b, 0, semente, &o, r);
+}
+
+// Simula uma partida com opções
+int simular_jogo_opcoes(const Baralho *b, uint64_t id_jogo, uint64_t semente,
+                        const OpcoesSimulacao *o, ResultadoJogo *r) {
+    size_t n = b->quantidade;
+    if (o->jogadores != 2) {
+        return simular_grupo(b, semente, id_jogo, 1, o, r);
+    }
+    if (n < 2) {
+        return -1;
+    }
+
+    // Um único bloco para as duas mãos, o monte de empates e o embaralhamento
+    uint32_t *memoria = malloc(4 * n * sizeof(uint32_t));
+    if (memoria == NULL) {
+        return -1;
+    }
+    uint32_t *embaralhadas = memoria;
+    uint32_t *monte = memoria + n;
+    Mao maos[2] = {
+        { memoria + 2 * n, 0, 0, n },
+        { memoria + 3 * n, 0, 0, n },
+    };
+    size_t tamanho_monte = 0;
+
+    // Embaralha e distribui alternadamente; carta ímpar fica fora. O monte e
+    // a mão 0, ainda vazios e contíguos no bloco, são as n + n / 2 posições de
+    // trabalho da distribuição equilibrada
+    embaralhar_jogo(embaralhadas, n, semente, id_jogo);
+    if (o->forca != NULL) {
+        distribuir_equilibrado(o->forca, embaralhadas, n, 2, monte, NULL);
+    }
+    for (size_t i = 0; i + 1 < n; i += 2) {
+        colocar_no_fim(&maos[0], embaralhadas[i]);
+        colocar_no_fim(&maos[1], embaralhadas[i + 1]);
+    }
+
+    RegistroPartidas *registro = o->registro;
+    int max_rodadas = o->max_rodadas;
+    memset(r, 0, sizeof(*r));
+    if (registro != NULL) {
+        registrar_inicio_jogo(registro, id_jogo, semente);
+    }
+
+    uint64_t inicio_jogo = iniciar_medicao(METRICA_JOGO, AMOSTRAGEM_TOTAL);
+    while (r->rodadas < max_rodadas && maos[0].tamanho > 0 && maos[1].tamanho > 0) {
+        uint64_t inicio_rodada = iniciar_medicao(METRICA_RODADA, AMOSTRAGEM_QUENTE);
+        uint32_t carta1 = retirar_do_topo(&maos[0]);
+        uint32_t carta2 = retirar_do_topo(&maos[1]);
+        int atributo = sortear_atributo(semente, id_jogo, r->rodadas + 1);
+        int resultado = comparar_cartas(&b->cartas[carta1], &b->cartas[carta2], atributo);
+        if (registro != NULL) {
+            // Reserva espaço em blocos para o caminho quente não verificar o buffer
+            if ((r->rodadas & (RODADAS_POR_RESERVA - 1)) == 0) {
+                reservar_registro(registro, RODADAS_POR_RESERVA * TAMANHO_MAXIMO_RODADA +
+                                            TAMANHO_MAXIMO_EVENTO);
+            }
+            registrar_rodada(registro, carta1, carta2, atributo, resultado);
+        }
+        r->rodadas++;
+
+        if (resultado == 0) {
+            // Empate: as cartas vão para o monte e o mesmo jogador continua
+            monte[tamanho_monte++] = carta1;
+            monte[tamanho_monte++] = carta2;
+            r->empates++;
+            finalizar_medicao(METRICA_RODADA, inicio_rodada);
+            continue;
+        }
+
+        // O vencedor leva as duas cartas e o monte acumulado
+        Mao *vencedor = &maos[resultado - 1];
+        colocar_no_fim(vencedor, resultado == 1 ? carta1 : carta2);
+        colocar_no_fim(vencedor, resultado == 1 ? carta2 : carta1);
+        for (size_t i = 0; i < tamanho_monte; i++) {
+            colocar_no_fim(vencedor, monte[i]);
+        }
+        tamanho_monte = 0;
+        finalizar_medicao(METRICA_RODADA, inicio_rodada);
+    }
+    finalizar_medicao(METRICA_JOGO, inicio_jogo);
+
+    // Sem vencedor por eliminação: vence quem tiver mais cartas
+    if (maos[0].tamanho > maos[1].tamanho) {
+        r->vencedor = 1;
+    } else if (maos[1].tamanho > maos[0].tamanho) {
+        r->vencedor = 2;
+    } else {
+        r->vencedor = 0;
+    }
+    if (registro != NULL) {
+        registrar_fim_jogo(registro, r->vencedor, (uint32_t)r->rodadas);
+    }
+
+    free(memoria);
+    return 0;
+}
+
+// Semente da partida 'id_jogo' de uma simulação com semente 'semente'
+uint64_t semente_do_jogo(uint64_t semente, uint64_t id_jogo) {
+    uint64_t estado = semente + id_jogo;
+    return proximo_aleatorio(&estado);
+}
+
+// Simula os jogos 0..jogos-1 da semente e acumula as estatísticas
+int simular_partidas(const Baralho *b, long jogos, uint64_t semente, EstatisticasSimulacao *e) {
+    OpcoesSimulacao o;
+    iniciar_opcoes_simulacao(&o);
+    return simular_partidas_opcoes(b, jogos, semente, &o, e);
+}
+
+// Soma o resultado de um jogo às estatísticas
+static void acumular_jogo(EstatisticasSimulacao *e, const ResultadoJogo *r) {
+    e->jogos++;
+    e->rodadas += r->rodadas;
+    if (r->vencedor == 1) e->vitorias_jogador1++;
+    else if (r->vencedor == 2) e->vitorias_jogador2++;
+    if (r->vencedor > 0) e->vitorias[r->vencedor - 1]++;
+    else e->empates++;
+}
+
+// Baralho do próximo jogo (ou grupo): o fixo ou a versão atual da recarga
+static const Baralho *baralho_do_jogo(const Baralho *b, const OpcoesSimulacao *o, int vaga) {
+    return o->recarga != NULL ? &fixar_versao(o->recarga, vaga)->baralho : b;
+}
+
+// Fim do jogo (ou grupo): solta a versão fixada
+static void soltar_baralho_do_jogo(const OpcoesSimulacao *o, int vaga) {
+    if (o->recarga != NULL) {
+        soltar_versao(o->recarga, vaga);
+    }
+}
+
+// Simula os jogos [inicio, fim) e acumula as estatísticas; os de mais de
+// dois jogadores vão em grupos de JOGOS_POR_GRUPO
+static int simular_faixa(const Baralho *b, long inicio, long fim, uint64_t semente,
+                         const OpcoesSimulacao *o, EstatisticasSimulacao *e) {
+    ResultadoJogo resultados[JOGOS_POR_GRUPO];
+    int vaga = o->recarga != NULL ? ocupar_vaga_recarga(o->recarga) : 0;
+    int status = vaga < 0 ? -1 : 0;
+    if (o->jogadores != 2) {
+        for (long i = inicio; i < fim && status == 0; i += JOGOS_POR_GRUPO) {
+            int quantidade = (int)(fim - i < JOGOS_POR_GRUPO ? fim - i : JOGOS_POR_GRUPO);
+            status = simular_grupo(baralho_do_jogo(b, o, vaga), semente, (uint64_t)i, quantidade,
+                                   o, resultados);
+            soltar_baralho_do_jogo(o, vaga);
+            for (int q = 0; q < quantidade && status == 0; q++) {
+                acumular_jogo(e, &resultados[q]);
+            }
+        }
+    }
+
+    for (long lote = inicio; lote < fim && status == 0 && o->jogadores == 2;
+         lote += JOGOS_POR_LOTE) {
+        RASTREAR_ESCOPO("lote_de_jogos");
+        long limite = lote + JOGOS_POR_LOTE < fim ? lote + JOGOS_POR_LOTE : fim;
+        for (long i = lote; i < limite && status == 0; i++) {
+            status = simular_jogo_opcoes(baralho_do_jogo(b, o, vaga), (uint64_t)i, semente, o,
+                                         &resultados[0]);
+            soltar_baralho_do_jogo(o, vaga);
+            if (status == 0) {
+                acumular_jogo(e, &resultados[0]);
+            }
+        }
+    }
+    if (o->recarga != NULL && vaga >= 0) {
+        liberar_vaga_recarga(o->recarga, vaga);
+    }
+    return status;
+}
+
+// Cada thread simula uma faixa contígua de jogos
+static void tarefa_simulacao(void *contexto, int indice, int total) {
+    ContextoSimulacao *c = contexto;
+    RASTREAR_ESCOPO("simular_faixa");
+    long inicio = c->inicio + (long)inicio_da_parte((size_t)c->jogos, indice, total);
+    long fim = c->inicio + (long)inicio_da_parte((size_t)c->jogos, indice + 1, total);
+    if (simular_faixa(c->b, inicio, fim, c->semente, c->o, &c->parciais[indice]) != 0) {
+        c->falhou = 1;
+    }
+}
+
+// Soma as estatísticas de 'p' em 'e'
+static void somar_estatisticas(EstatisticasSimulacao *e, const EstatisticasSimulacao *p) {
+    e->jogos += p->jogos;
+    e->vitorias_jogador1 += p->vitorias_jogador1;
+    e->vitorias_jogador2 += p->vitorias_jogador2;
+    e->empates += p->empates;
+    e->rodadas += p->rodadas;
+    for (int j = 0; j < MAXIMO_CARTAS_RODADA; j++) {
+        e->vitorias[j] += p->vitorias[j];
+    }
+}
+
+// Simula os jogos [inicio, fim) em paralelo e soma as estatísticas em 'e'
+static int simular_intervalo(const Baralho *b, long inicio, long fim, uint64_t semente,
+                             const OpcoesSimulacao *o, EstatisticasSimulacao *e) {
+    // O registro é gravado em ordem, por uma única thread
+    long jogos = fim - inicio;
+    int threads = o->registro != NULL ? 1 : numero_de_threads(o->threads);
+    if (jogos < threads) {
+        threads = jogos > 0 ? (int)jogos : 1;
+    }
+    if (threads == 1) {
+        return simular_faixa(b, inicio, fim, semente, o, e);
+    }
+
+    ContextoSimulacao c = { b, inicio, jogos, semente, o,
+                            calloc((size_t)threads, sizeof(*e)), 0 };
+    if (c.parciais == NULL) {
+        return -1;
+    }
+    int rodaram = executar_em_paralelo(threads, tarefa_simulacao, &c);
+    for (int t = 0; t < rodaram; t++) {
+        somar_estatisticas(e, &c.parciais[t]);
+    }
+    free(c.parciais);
+    return c.falhou ? -1 : 0;
+}
+
+// Simulação em etapas, com um ponto de retomada no fim das etapas em que o
+// intervalo venceu; começa do último ponto da mesma simulação, se houver
+static int simular_com_retomada(const Baralho *b, long jogos, uint64_t semente,
+                                const OpcoesSimulacao *o, EstatisticasSimulacao *e) {
+    PontoRetomada *p = o->retomada;
+    uint64_t id = identificar_valor(RETOMADA_SIMULACAO, semente);
+    id = identificar_valor(id, (uint64_t)jogos);
+    id = identificar_valor(id, (uint64_t)o->jogadores);
+    id = identificar_valor(id, (uint64_t)o->max_rodadas);
+    id = identificar_valor(id, o->forca != NULL);
+    id = identificar_baralho(id, b);
+
+    uint64_t feitos = 0;
+    if (carregar_retomada(p, RETOMADA_SIMULACAO, id, &feitos, e, sizeof(*e)) != 0
+        || feitos > (uint64_t)jogos) {
+        memset(e, 0, sizeof(*e));
+        feitos = 0;
+    }
+
+    OpcoesSimulacao etapa = *o;
+    etapa.retomada = NULL;
+    while (feitos < (uint64_t)jogos) {
+        long fim = jogos - (long)feitos > JOGOS_POR_ETAPA ? (long)feitos + JOGOS_POR_ETAPA : jogos;
+        if (simular_intervalo(b, (long)feitos, fim, semente, &etapa, e) != 0) {
+            return -1;
+        }
+        feitos = (uint64_t)fim;
+        if (feitos < (uint64_t)jogos && retomada_vencida(p)) {
+            salvar_retomada(p, RETOMADA_SIMULACAO, id, feitos, e, sizeof(*e));
+        }
+    }
+
+    // O ponto final deixa uma nova execução igual só reler o resultado
+    esperar_retomada(p);
+    return salvar_retomada(p, RETOMADA_SIMULACAO, id, feitos, e, sizeof(*e)) < 0 ? -1 : 0;
+}
+
+// Igual a simular_partidas, com opções
+int simular_partidas_opcoes(const Baralho *b, long jogos, uint64_t semente,
+                            const OpcoesSimulacao *o, EstatisticasSimulacao *e) {
+    RASTREAR_ESCOPO("simular_partidas");
+    memset(e, 0, sizeof(*e));
+    if (o->registro != NULL) {
+        registrar_parametros_jogo(o->registro, o->jogadores, o->max_rodadas, o->forca != NULL);
+    }
+    if (o->retomada != NULL) {
+        return simular_com_retomada(b, jogos, semente, o, e);
+    }
+    return simular_intervalo(b, 0, jogos, semente, o, e);
+}
@@ -0,0 +1,100 @@
+/*
+ * Super Trunfo - Simulador de partidas
+ *
+ * Joga partidas completas entre dois jogadores automáticos sobre um baralho:
+ * as cartas são embaralhadas e distribuídas, o jogador da vez escolhe um
+ * atributo, a carta vencedora leva as duas (e o monte de empates) e o jogo
+ * termina quando um jogador fica sem cartas ou o limite de rodadas é atingido.
+ *
+ * Com mais de dois jogadores, cada rodada é resolvida pela rodada K-way
+ * (rodada.h): a carta vencedora leva todas as cartas da mesa e o monte; num
+ * empate as cartas vão para o monte. Quem fica sem cartas é eliminado e o
+ * jogo termina quando resta um jogador. Esses jogos avançam juntos, em
+ * grupos, e as rodadas de todos os jogos do grupo são resolvidas num único
+ * lote. O registro de partidas só grava jogos de dois jogadores.
+ *
+ * Os números de cada jogo vêm do contador (semente, jogo, rodada) do
+ * Philox (aleatorio.h): a rodada 0 embaralha o baralho e a rodada r sorteia
+ * o atributo da r-ésima rodada. O jogo N é o mesmo em qualquer execução,
+ * com qualquer número de threads, e as estatísticas somadas também.
+ *
+ * Com a força das cartas nas opções, o baralho embaralhado passa por
+ * distribuir_equilibrado antes de ser distribuído: as mãos começam com
+ * força quase igual.
+ *
+ * Com um ponto de retomada nas opções, os jogos rodam em etapas de
+ * JOGOS_POR_ETAPA; no fim de cada etapa em que o intervalo venceu, o número
+ * de jogos feitos e as estatísticas somadas vão para o arquivo de pontos, e
+ * uma execução interrompida recomeça da última etapa gravada.
+ */
+
+#ifndef SUPERTRUNFO_SIMULADOR_H
+#define SUPERTRUNFO_SIMULADOR_H
+
+#include <stdint.h>
+
+#include "baralho.h"
+#include "registro.h"
+#include "rodada.h"
+#include "recarga.h"
+#include "distribuicao.h"
+#include "retomada.h"
+
+// Limite padrão de rodadas por partida (evita partidas infinitas)
+#define MAX_RODADAS_PADRAO 1000
+
+// Resultado de uma partida simulada
+typedef struct {
+    int vencedor;   // 1 em diante; 0 se empate
+    int rodadas;    // Rodadas jogadas
+    int empates;    // Rodadas que terminaram empatadas
+} ResultadoJogo;
+
+// Estatísticas acumuladas de várias partidas
+typedef struct {
+    long jogos;
+    long vitorias_jogador1;
+    long vitorias_jogador2;
+    long empates;
+    long rodadas;
+    long vitorias[MAXIMO_CARTAS_RODADA];  // Vitórias de cada jogador (0 = jogador 1)
+} EstatisticasSimulacao;
+
+// Opções das partidas simuladas
+typedef struct {
+    int max_rodadas;
+    int jogadores;               // 2 a MAXIMO_CARTAS_RODADA
+    int threads;                 // simular_partidas: 0 = um por núcleo (padrão: 1)
+    RecargaBaralho *recarga;     // simular_partidas, opcional: cada jogo fixa a versão
+                                 // atual do baralho ao começar (no lugar de 'b')
+    RegistroPartidas *registro;  // Opcional: grava jogos e rodadas no log binário
+    const double *forca;         // Opcional, só sem recarga: força de cada carta
+                                 // (calcular_forca_cartas) para distribuir mãos
+                                 // equilibradas (distribuicao.h)
+    PontoRetomada *retomada;     // Opcional, sem recarga nem registro: grava pontos
+                                 // de retomada e continua do último (retomada.h)
+} OpcoesSimulacao;
+
+// Preenche as opções com os valores padrão
+void iniciar_opcoes_simulacao(OpcoesSimulacao *o);
+
+// Simula o jogo 0 da semente; retorna 0 em sucesso, -1 se o baralho tiver
+// menos cartas que jogadores
+int simular_jogo(const Baralho *b, uint64_t semente, int max_rodadas, ResultadoJogo *r);
+
+// Simula o jogo 'id_jogo' da semente 'semente', com opções
+int simular_jogo_opcoes(const Baralho *b, uint64_t id_jogo, uint64_t semente,
+                        const OpcoesSimulacao *o, ResultadoJogo *r);
+
+// Semente derivada para a partida 'id_jogo' (uso externo; o simulador usa o
+// contador (semente, id_jogo, rodada) diretamente)
+uint64_t semente_do_jogo(uint64_t semente, uint64_t id_jogo);
+
+// Simula os jogos 0..jogos-1 da semente e acumula as estatísticas
+int simular_partidas(const Baralho *b, long jogos, uint64_t semente, EstatisticasSimulacao *e);
+
+// Igual a simular_partidas, com opções (com registro, roda numa só thread)
+int simular_partidas_opcoes(const Baralho *b, long jogos, uint64_t semente,
+                            const OpcoesSimulacao *o, EstatisticasSimulacao *e);
+
+#endif
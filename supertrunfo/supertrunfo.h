@@ -0,0 +1,59 @@
+/*
+ * libsupertrunfo - API pública do núcleo do Super Trunfo
+ *
+ * Incluir este cabeçalho dá acesso a todo o núcleo: regras das cartas,
+ * baralhos, varredura de baralhos maiores que a memória, gerador de
+ * baralhos sintéticos, cadastro concorrente para carga paralela, regras da
+ * casa compiladas para a comparação avançada, esquemas de atributos com
+ * armazenamento colunar, acervo persistente, consultas por faixa com
+ * índices, baralho em memória compartilhada, recarga do baralho sem parar
+ * os jogos, interface de terminal, saída JSON Lines/CSV, simulador, pontos
+ * de retomada de execuções longas, rodadas com vários jogadores, cascatas
+ * de desempate com chaves ordenáveis, busca de cidades semelhantes, classes
+ * de raridade por agrupamento k-means, distribuição equilibrada das mãos e
+ * mesas por rating, estratégias, rating Elo, matriz de resultados
+ * pré-calculada, balanceamento, execução paralela, mesa multijogador com
+ * corrotinas, registro de partidas, métricas e rastreio. Os nomes e
+ * assinaturas aqui exportados são estáveis; mudanças incompatíveis,
+ * inclusive campos novos ou trocados em estruturas públicas (que mudam o
+ * layout), incrementam SUPERTRUNFO_VERSAO_API.
+ */
+
+#ifndef SUPERTRUNFO_H
+#define SUPERTRUNFO_H
+
+#define SUPERTRUNFO_VERSAO_API 2  // 2: campos novos em OpcoesSimulacao e EstatisticasSimulacao
+
+#include "carta.h"
+#include "baralho.h"
+#include "varredura.h"
+#include "gerador.h"
+#include "cadastro.h"
+#include "regras.h"
+#include "acervo.h"
+#include "consulta.h"
+#include "compartilhado.h"
+#include "recarga.h"
+#include "esquema.h"
+#include "interface.h"
+#include "saida.h"
+#include "rodada.h"
+#include "desempate.h"
+#include "vizinhos.h"
+#include "raridade.h"
+#include "distribuicao.h"
+#include "simulador.h"
+#include "retomada.h"
+#include "aleatorio.h"
+#include "paralelo.h"
+#include "estrategia.h"
+#include "matriz.h"
+#include "elo.h"
+#include "balanceamento.h"
+#include "corrotina.h"
+#include "mesa.h"
+#include "registro.h"
+#include "metricas.h"
+#include "rastreio.h"
+
+#endif
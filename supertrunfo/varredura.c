@@ -0,0 +1,431 @@
+/*
+ * Super Trunfo - Varredura de baralhos maiores que a memória
+ *
+ * Leitura em blocos com thread de leitura antecipada (buffer duplo) e
+ * resumo em memória de tamanho fixo.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "varredura.h"
+#include "baralho.h"
+#include "desempate.h"
+#include "rastreio.h"
+
+// Leitor com dois blocos: a thread enche um enquanto o outro é interpretado.
+// Cada bloco tem LINHA_MAXIMA_VARREDURA bytes livres no início, onde entra
+// o pedaço de linha que sobrou do bloco anterior.
+typedef struct {
+    int fd;
+    char *blocos[2];
+    size_t tamanhos[2];
+    int prontos[2];
+    int erro;
+    int encerrar;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    pthread_t thread;
+} LeitorVarredura;
+
+// Estado da varredura além do resumo
+typedef struct {
+    ResumoVarredura *r;
+    uint64_t *filtro;
+    uint64_t codigos;                                       // Inseridos no filtro
+    uint32_t chaves[NUM_ATRIBUTOS][TOPO_MAXIMO_VARREDURA];  // Heaps de mínimo
+    uint64_t ordens[NUM_ATRIBUTOS][TOPO_MAXIMO_VARREDURA];  // Ordem de chegada
+} EstadoVarredura;
+
+// Thread de leitura: enche os blocos alternadamente até o fim do arquivo
+static void *ler_em_segundo_plano(void *arg) {
+    LeitorVarredura *l = arg;
+
+    nomear_thread_rastreio("leitor da varredura");
+    for (int s = 0;; s ^= 1) {
+        pthread_mutex_lock(&l->trava);
+        while (l->prontos[s] && !l->encerrar) {
+            pthread_cond_wait(&l->sinal, &l->trava);
+        }
+        int encerrar = l->encerrar;
+        pthread_mutex_unlock(&l->trava);
+        if (encerrar) {
+            break;
+        }
+
+        // Lê o bloco inteiro (ou até o fim); tamanho 0 marca o fim do arquivo
+        char *destino = l->blocos[s] + LINHA_MAXIMA_VARREDURA;
+        size_t lido = 0;
+        int falhou = 0;
+        {
+            RASTREAR_ESCOPO("ler_bloco_varredura");
+            while (lido < BLOCO_VARREDURA) {
+                ssize_t n = read(l->fd, destino + lido, BLOCO_VARREDURA - lido);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    falhou = 1;
+                    break;
+                }
+                if (n == 0) {
+                    break;
+                }
+                lido += (size_t)n;
+            }
+        }
+
+        pthread_mutex_lock(&l->trava);
+        l->tamanhos[s] = falhou ? 0 : lido;
+        l->erro = falhou;
+        l->prontos[s] = 1;
+        pthread_cond_broadcast(&l->sinal);
+        pthread_mutex_unlock(&l->trava);
+        if (falhou || lido == 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+// Espera o bloco s ficar pronto; retorna o tamanho lido (0 no fim) ou -1
+static long esperar_bloco(LeitorVarredura *l, int s) {
+    pthread_mutex_lock(&l->trava);
+    while (!l->prontos[s]) {
+        pthread_cond_wait(&l->sinal, &l->trava);
+    }
+    long tamanho = l->erro ? -1 : (long)l->tamanhos[s];
+    pthread_mutex_unlock(&l->trava);
+    return tamanho;
+}
+
+// Devolve o bloco s para a thread de leitura
+static void liberar_bloco(LeitorVarredura *l, int s) {
+    pthread_mutex_lock(&l->trava);
+    l->prontos[s] = 0;
+    pthread_cond_broadcast(&l->sinal);
+    pthread_mutex_unlock(&l->trava);
+}
+
+// Balde do histograma: 0 abaixo de 1, depois 8 sub-baldes por potência de 2
+static int balde_varredura(double v) {
+    if (!(v >= 1.0)) {
+        return 0;
+    }
+    int expoente;
+    double mantissa = frexp(v, &expoente);  // v = mantissa * 2^expoente, mantissa em [0,5, 1)
+    if (expoente > 64) {
+        return BALDES_VARREDURA - 1;
+    }
+    int sub = (int)((mantissa * 2.0 - 1.0) * SUBBALDES_VARREDURA);
+    return 1 + (expoente - 1) * SUBBALDES_VARREDURA + sub;
+}
+
+// Limite inferior do balde 'indice' do histograma
+double limite_balde_varredura(int indice) {
+    if (indice <= 0) {
+        return 0.0;
+    }
+    int potencia = (indice - 1) / SUBBALDES_VARREDURA;
+    int sub = (indice - 1) % SUBBALDES_VARREDURA;
+    return ldexp(1.0 + (double)sub / SUBBALDES_VARREDURA, potencia);
+}
+
+// Quantil q do atributo pelo histograma
+double quantil_varredura(const ResumoVarredura *r, int atributo, double q) {
+    int a = atributo - 1;
+    if (a < 0 || a >= NUM_ATRIBUTOS || r->validos[a] == 0) {
+        return 0.0;
+    }
+    uint64_t alvo = (uint64_t)ceil(q * (double)r->validos[a]);
+    alvo = alvo < 1 ? 1 : alvo;
+    uint64_t acumulado = 0;
+    for (int i = 0; i < BALDES_VARREDURA; i++) {
+        acumulado += r->histograma[a][i];
+        if (acumulado >= alvo) {
+            return limite_balde_varredura(i);
+        }
+    }
+    return limite_balde_varredura(BALDES_VARREDURA - 1);
+}
+
+// Hash FNV-1a do código, misturado para as sondagens do filtro
+static uint64_t hash_codigo(const char *codigo) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const unsigned char *p = (const unsigned char *)codigo; *p; p++) {
+        h = (h ^ *p) * 1099511628211ULL;
+    }
+    return h;
+}
+
+// Insere o código no filtro; retorna 1 se ele (provavelmente) já estava lá
+static int marcar_codigo(EstadoVarredura *e, const char *codigo) {
+    uint64_t h1 = hash_codigo(codigo);
+    uint64_t h2 = (h1 ^ (h1 >> 31)) * 0xbf58476d1ce4e5b9ULL;
+    h2 = (h2 ^ (h2 >> 29)) | 1;
+    int presente = 1;
+    for (int i = 0; i < SONDAGENS_FILTRO; i++) {
+        uint64_t bit = (h1 + (uint64_t)i * h2) & (BITS_FILTRO_VARREDURA - 1);
+        uint64_t mascara = 1ULL << (bit & 63);
+        presente &= (e->filtro[bit >> 6] & mascara) != 0;
+        e->filtro[bit >> 6] |= mascara;
+    }
+    e->codigos++;
+    return presente;
+}
+
+// Pior entrada primeiro: chave menor, ou igual e que chegou depois
+static int pior(const EstadoVarredura *e, int a, int x, int y) {
+    if (e->chaves[a][x] != e->chaves[a][y]) {
+        return e->chaves[a][x] < e->chaves[a][y];
+    }
+    return e->ordens[a][x] > e->ordens[a][y];
+}
+
+// Troca duas entradas do topo do atributo
+static void trocar_topo(EstadoVarredura *e, int a, int x, int y) {
+    ResumoVarredura *r = e->r;
+    Carta c = r->topo[a][x];
+    r->topo[a][x] = r->topo[a][y];
+    r->topo[a][y] = c;
+    uint32_t chave = e->chaves[a][x];
+    e->chaves[a][x] = e->chaves[a][y];
+    e->chaves[a][y] = chave;
+    uint64_t ordem = e->ordens[a][x];
+    e->ordens[a][x] = e->ordens[a][y];
+    e->ordens[a][y] = ordem;
+}
+
+// Desce a entrada i no heap de mínimo das n primeiras
+static void descer_topo(EstadoVarredura *e, int a, int i, int n) {
+    for (;;) {
+        int menor = i;
+        int filho = 2 * i + 1;
+        if (filho < n && pior(e, a, filho, menor)) menor = filho;
+        if (filho + 1 < n && pior(e, a, filho + 1, menor)) menor = filho + 1;
+        if (menor == i) {
+            return;
+        }
+        trocar_topo(e, a, i, menor);
+        i = menor;
+    }
+}
+
+// Oferece a carta ao topo do atributo
+static void oferecer_topo(EstadoVarredura *e, int a, const Carta *c, uint32_t chave) {
+    ResumoVarredura *r = e->r;
+    int n = r->tamanho_topo[a];
+    if (n < r->k) {
+        // Ainda há vaga: sobe a carta nova no heap
+        r->topo[a][n] = *c;
+        e->chaves[a][n] = chave;
+        e->ordens[a][n] = r->cartas;
+        r->tamanho_topo[a] = ++n;
+        for (int i = n - 1; i > 0 && pior(e, a, i, (i - 1) / 2); i = (i - 1) / 2) {
+            trocar_topo(e, a, i, (i - 1) / 2);
+        }
+    } else if (n > 0 && chave > e->chaves[a][0]) {
+        // Substitui a pior (empate fica com a que chegou antes)
+        r->topo[a][0] = *c;
+        e->chaves[a][0] = chave;
+        e->ordens[a][0] = r->cartas;
+        descer_topo(e, a, 0, n);
+    }
+}
+
+// Valor do atributo, sem arredondar os inteiros para float
+static double valor_varredura(const Carta *c, int atributo) {
+    switch (atributo) {
+        case COMPARAR_POPULACAO: return c->populacao;
+        case COMPARAR_PONTOS_TURISTICOS: return c->pontos_turisticos;
+        default: return obter_valor_atributo(c, atributo);
+    }
+}
+
+// Acumula uma carta válida no resumo
+static void acumular_carta(EstadoVarredura *e, const Carta *c) {
+    ResumoVarredura *r = e->r;
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        double v = valor_varredura(c, a + 1);
+        if (!(v >= 0.0)) {
+            continue;
+        }
+        r->validos[a]++;
+        r->soma[a] += v;
+        r->minimo[a] = r->validos[a] == 1 || v < r->minimo[a] ? v : r->minimo[a];
+        r->maximo[a] = r->validos[a] == 1 || v > r->maximo[a] ? v : r->maximo[a];
+        r->histograma[a][balde_varredura(v)]++;
+        oferecer_topo(e, a, c, chave_atributo(c, a + 1));
+    }
+
+    unsigned char l1 = (unsigned char)c->estado[0], l2 = (unsigned char)c->estado[1];
+    if (l1 >= 'A' && l1 <= 'Z' && l2 >= 'A' && l2 <= 'Z') {
+        int u = (l1 - 'A') * 26 + (l2 - 'A');
+        r->cartas_estado[u]++;
+        r->populacao_estado[u] += (uint64_t)c->populacao;
+        r->pib_estado[u] += c->pib;
+    }
+    if (marcar_codigo(e, c->codigo)) {
+        r->codigos_repetidos++;
+    }
+    r->cartas++;
+}
+
+// Interpreta uma linha completa (terminada em '\0' no lugar do '\n')
+static void interpretar_linha_varredura(EstadoVarredura *e, const char *linha) {
+    ResumoVarredura *r = e->r;
+    r->linhas++;
+    if (linha[0] == '#' || linha[0] == '\0' || linha[0] == '\r') {
+        return;
+    }
+    Carta c;
+    if (interpretar_linha_carta(linha, &c) != 0) {
+        if (r->invalidas < INVALIDAS_EXIBIDAS) {
+            r->primeiras_invalidas[r->invalidas] = r->linhas;
+        }
+        r->invalidas++;
+        return;
+    }
+    acumular_carta(e, &c);
+}
+
+// Linha comprida demais: conta como inválida (o resto dela é descartado)
+static void linha_comprida(ResumoVarredura *r) {
+    r->linhas++;
+    if (r->invalidas < INVALIDAS_EXIBIDAS) {
+        r->primeiras_invalidas[r->invalidas] = r->linhas;
+    }
+    r->invalidas++;
+}
+
+// Ordena o topo de cada atributo da melhor para a pior carta
+static void ordenar_topos(EstadoVarredura *e) {
+    for (int a = 0; a < NUM_ATRIBUTOS; a++) {
+        for (int n = e->r->tamanho_topo[a]; n > 1; n--) {
+            trocar_topo(e, a, 0, n - 1);  // A pior vai para o fim
+            descer_topo(e, a, 0, n - 1);
+        }
+    }
+}
+
+// Varre o arquivo e preenche o resumo
+int varrer_baralho(const char *caminho, int k, ResumoVarredura *r) {
+    RASTREAR_ESCOPO("varrer_baralho");
+    memset(r, 0, sizeof(*r));
+    r->k = k < 0 ? 0 : k > TOPO_MAXIMO_VARREDURA ? TOPO_MAXIMO_VARREDURA : k;
+
+    EstadoVarredura *e = calloc(1, sizeof(EstadoVarredura));
+    LeitorVarredura l;
+    memset(&l, 0, sizeof(l));
+    l.fd = open(caminho, O_RDONLY);
+    if (e == NULL || l.fd < 0) {
+        free(e);
+        if (l.fd >= 0) close(l.fd);
+        return -1;
+    }
+    e->r = r;
+    e->filtro = calloc(BITS_FILTRO_VARREDURA / 64, sizeof(uint64_t));
+    l.blocos[0] = malloc(LINHA_MAXIMA_VARREDURA + BLOCO_VARREDURA + 1);
+    l.blocos[1] = malloc(LINHA_MAXIMA_VARREDURA + BLOCO_VARREDURA + 1);
+    if (e->filtro == NULL || l.blocos[0] == NULL || l.blocos[1] == NULL) {
+        free(e->filtro);
+        free(l.blocos[0]);
+        free(l.blocos[1]);
+        free(e);
+        close(l.fd);
+        return -1;
+    }
+    r->memoria = sizeof(EstadoVarredura) + BITS_FILTRO_VARREDURA / 8 +
+                 2 * (LINHA_MAXIMA_VARREDURA + BLOCO_VARREDURA + 1);
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(l.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    pthread_mutex_init(&l.trava, NULL);
+    pthread_cond_init(&l.sinal, NULL);
+    int criada = pthread_create(&l.thread, NULL, ler_em_segundo_plano, &l) == 0;
+    int erro = !criada;
+
+    // Pedaço de linha do bloco anterior; 'descartando' pula uma linha comprida
+    char resto[LINHA_MAXIMA_VARREDURA + 1];
+    size_t tamanho_resto = 0;
+    int descartando = 0;
+    for (int s = 0; !erro; s ^= 1) {
+        long tamanho = esperar_bloco(&l, s);
+        if (tamanho < 0) {
+            erro = 1;
+            break;
+        }
+        if (tamanho == 0) {
+            // Fim do arquivo: a última linha pode não ter '\n'
+            if (tamanho_resto > 0 && !descartando) {
+                resto[tamanho_resto] = '\0';
+                interpretar_linha_varredura(e, resto);
+            }
+            break;
+        }
+        r->bytes += (uint64_t)tamanho;
+
+        // O resto vem logo antes dos dados novos, formando linhas contínuas
+        char *dados = l.blocos[s] + LINHA_MAXIMA_VARREDURA;
+        char *p = dados - tamanho_resto;
+        char *fim = dados + tamanho;
+        memcpy(p, resto, tamanho_resto);
+        {
+            RASTREAR_ESCOPO("interpretar_bloco_varredura");
+            char *quebra;
+            while ((quebra = memchr(p, '\n', (size_t)(fim - p))) != NULL) {
+                if (descartando) {
+                    descartando = 0;
+                } else if (quebra - p >= LINHA_MAXIMA_VARREDURA) {
+                    linha_comprida(r);
+                } else {
+                    *quebra = '\0';
+                    interpretar_linha_varredura(e, p);
+                }
+                p = quebra + 1;
+            }
+        }
+
+        // Guarda o pedaço final para o próximo bloco
+        tamanho_resto = (size_t)(fim - p);
+        if (!descartando && tamanho_resto >= LINHA_MAXIMA_VARREDURA) {
+            linha_comprida(r);
+            descartando = 1;
+        }
+        if (descartando) {
+            tamanho_resto = 0;
+        } else {
+            memcpy(resto, p, tamanho_resto);
+        }
+        liberar_bloco(&l, s);
+    }
+
+    pthread_mutex_lock(&l.trava);
+    l.encerrar = 1;
+    pthread_cond_broadcast(&l.sinal);
+    pthread_mutex_unlock(&l.trava);
+    if (criada) {
+        pthread_join(l.thread, NULL);
+    }
+    pthread_mutex_destroy(&l.trava);
+    pthread_cond_destroy(&l.sinal);
+    close(l.fd);
+
+    // Taxa esperada de falsos positivos do filtro: (1 - e^(-kn/m))^k
+    double ocupacao = 1.0 - exp(-(double)SONDAGENS_FILTRO * (double)e->codigos /
+                                (double)BITS_FILTRO_VARREDURA);
+    r->falsos_positivos = pow(ocupacao, SONDAGENS_FILTRO);
+    ordenar_topos(e);
+
+    free(e->filtro);
+    free(l.blocos[0]);
+    free(l.blocos[1]);
+    free(e);
+    return erro ? -1 : 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Super Trunfo - Varredura de baralhos maiores que a memória
+ *
+ * Percorre um arquivo de baralho em blocos de BLOCO_VARREDURA bytes sem
+ * carregá-lo: uma thread de leitura antecipada enche um bloco enquanto o
+ * outro é interpretado (buffer duplo), e uma linha cortada no fim de um
+ * bloco é completada no início do seguinte. A memória usada (os dois
+ * blocos, o filtro de códigos e o resumo) não depende do tamanho do
+ * arquivo.
+ *
+ * Numa só passada o resumo reúne:
+ * - agregados: cartas, soma, mínimo e máximo de cada atributo, e cartas,
+ *   população e PIB por estado;
+ * - as k melhores cartas de cada atributo (heap de mínimo de k cartas, pela
+ *   chave ordenável de desempate.h: na densidade, menor é melhor);
+ * - validação: linhas inválidas (com as primeiras numeradas) e códigos
+ *   repetidos, estimados por um filtro de Bloom de tamanho fixo (pode
+ *   contar a mais, nunca a menos; a taxa de falsos positivos esperada vem
+ *   no resumo);
+ * - histogramas: 8 sub-baldes por potência de 2 do valor (erro relativo
+ *   até 12,5% nos quantis), com um balde para valores abaixo de 1.
+ */
+
+#ifndef SUPERTRUNFO_VARREDURA_H
+#define SUPERTRUNFO_VARREDURA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "carta.h"
+
+#define BLOCO_VARREDURA (4 << 20)
+#define LINHA_MAXIMA_VARREDURA 256
+#define TOPO_MAXIMO_VARREDURA 64
+#define INVALIDAS_EXIBIDAS 8
+
+// Histograma: balde 0 para valores abaixo de 1, depois 8 por potência de 2
+#define SUBBALDES_VARREDURA 8
+#define BALDES_VARREDURA (1 + 64 * SUBBALDES_VARREDURA)
+
+// Filtro de Bloom dos códigos (16 MiB) e sondagens por código
+#define BITS_FILTRO_VARREDURA (1ULL << 27)
+#define SONDAGENS_FILTRO 3
+
+// Estados indexados pelas duas letras da sigla
+#define ESTADOS_VARREDURA (26 * 26)
+
+// Resumo de uma varredura
+typedef struct {
+    uint64_t bytes;
+    uint64_t linhas;
+    uint64_t cartas;
+    uint64_t invalidas;
+    uint64_t primeiras_invalidas[INVALIDAS_EXIBIDAS];  // Números das linhas
+    uint64_t codigos_repetidos;
+    double falsos_positivos;                          // Taxa esperada do filtro
+    size_t memoria;                                   // Bytes alocados pela varredura
+
+    // Atributos 1 a NUM_ATRIBUTOS na posição atributo - 1 (só valores válidos)
+    uint64_t validos[NUM_ATRIBUTOS];
+    double soma[NUM_ATRIBUTOS];
+    double minimo[NUM_ATRIBUTOS];
+    double maximo[NUM_ATRIBUTOS];
+    uint64_t histograma[NUM_ATRIBUTOS][BALDES_VARREDURA];
+
+    // Melhores cartas de cada atributo, da melhor para a pior
+    int k;
+    int tamanho_topo[NUM_ATRIBUTOS];
+    Carta topo[NUM_ATRIBUTOS][TOPO_MAXIMO_VARREDURA];
+
+    // Por estado: índice (letra1 - 'A') * 26 + (letra2 - 'A')
+    uint64_t cartas_estado[ESTADOS_VARREDURA];
+    uint64_t populacao_estado[ESTADOS_VARREDURA];
+    double pib_estado[ESTADOS_VARREDURA];
+} ResumoVarredura;
+
+// Varre o arquivo e preenche o resumo com as k (até TOPO_MAXIMO_VARREDURA)
+// melhores cartas de cada atributo; retorna 0 em sucesso, -1 se o arquivo
+// não abrir, faltar memória ou a leitura falhar
+int varrer_baralho(const char *caminho, int k, ResumoVarredura *r);
+
+// Limite inferior do balde 'indice' do histograma
+double limite_balde_varredura(int indice);
+
+// Quantil q (0 a 1) do atributo, pelo histograma (limite inferior do balde)
+double quantil_varredura(const ResumoVarredura *r, int atributo, double q);
+
+#endif
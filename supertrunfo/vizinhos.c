@@ -0,0 +1,321 @@
+/*
+ * Super Trunfo - Cidades semelhantes (vizinhos mais próximos)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "vizinhos.h"
+#include "paralelo.h"
+#include "rastreio.h"
+
+// Valor do atributo antes da normalização; NAN se inválido
+static double valor_bruto(const Carta *c, int dimensao) {
+    int atributo = dimensao + 1;
+    double v = atributo == COMPARAR_POPULACAO ? (double)c->populacao
+             : atributo == COMPARAR_PONTOS_TURISTICOS ? (double)c->pontos_turisticos
+             : (double)obter_valor_atributo(c, atributo);
+    if (!(v >= 0)) {
+        return NAN;
+    }
+    return atributo == COMPARAR_PONTOS_TURISTICOS ? v : log1p(v);
+}
+
+// Calcula a normalização sobre as cartas do baralho
+void preparar_espaco_atributos(EspacoAtributos *e, const Baralho *b) {
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        double soma = 0, quadrados = 0;
+        size_t validos = 0;
+        for (size_t i = 0; i < b->quantidade; i++) {
+            double v = valor_bruto(&b->cartas[i], d);
+            if (!isnan(v)) {
+                soma += v;
+                quadrados += v * v;
+                validos++;
+            }
+        }
+        double media = validos > 0 ? soma / (double)validos : 0.0;
+        double variancia = validos > 0 ? quadrados / (double)validos - media * media : 0.0;
+        e->media[d] = media;
+        e->desvio[d] = variancia > 1e-12 ? sqrt(variancia) : 1.0;
+    }
+}
+
+// Ponto normalizado da carta
+void projetar_carta(const EspacoAtributos *e, const Carta *c, float *ponto) {
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        double v = valor_bruto(c, d);
+        ponto[d] = isnan(v) ? 0.0f : (float)((v - e->media[d]) / e->desvio[d]);
+    }
+}
+
+// Distância ao quadrado entre dois pontos
+static inline float distancia2(const float *a, const float *b) {
+    float soma = 0.0f;
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        float diferenca = a[d] - b[d];
+        soma += diferenca * diferenca;
+    }
+    return soma;
+}
+
+// Contexto da construção
+typedef struct {
+    ArvoreVizinhos *a;
+    const float *origem;    // Pontos na ordem do baralho
+    uint32_t *ordem;        // Permutação sendo particionada
+} Construcao;
+
+static float coordenada(const Construcao *c, uint32_t i, int d) {
+    return c->origem[(size_t)c->ordem[i] * DIMENSOES_VIZINHOS + d];
+}
+
+// Seleção da mediana (quickselect): ordem[meio] fica no lugar, com os
+// menores antes e os maiores depois
+static void selecionar(Construcao *c, uint32_t inicio, uint32_t fim, uint32_t meio, int d) {
+    while (fim - inicio > 1) {
+        float pivo = coordenada(c, inicio + (fim - inicio) / 2, d);
+        uint32_t i = inicio;
+        uint32_t j = fim - 1;
+        while (i <= j) {
+            while (coordenada(c, i, d) < pivo) i++;
+            while (coordenada(c, j, d) > pivo) j--;
+            if (i <= j) {
+                uint32_t t = c->ordem[i];
+                c->ordem[i] = c->ordem[j];
+                c->ordem[j] = t;
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (meio <= j) {
+            fim = j + 1;
+        } else if (meio >= i) {
+            inicio = i;
+        } else {
+            return;
+        }
+    }
+}
+
+// Constrói a subárvore dos pontos [inicio, fim); retorna o nó
+static int32_t construir_no(Construcao *c, uint32_t inicio, uint32_t fim) {
+    ArvoreVizinhos *a = c->a;
+    int32_t indice = (int32_t)a->quantidade_nos++;
+    NoVizinhos *no = &a->nos[indice];
+    no->inicio = inicio;
+    no->fim = fim;
+    no->esquerda = -1;
+    no->direita = -1;
+    no->dimensao = 0;
+    no->corte = 0.0f;
+    if (fim - inicio <= FOLHA_VIZINHOS) {
+        return indice;
+    }
+
+    // Dimensão de maior amplitude
+    float menor[DIMENSOES_VIZINHOS], maior[DIMENSOES_VIZINHOS];
+    for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+        menor[d] = maior[d] = coordenada(c, inicio, d);
+    }
+    for (uint32_t i = inicio + 1; i < fim; i++) {
+        for (int d = 0; d < DIMENSOES_VIZINHOS; d++) {
+            float v = coordenada(c, i, d);
+            menor[d] = v < menor[d] ? v : menor[d];
+            maior[d] = v > maior[d] ? v : maior[d];
+        }
+    }
+    int dimensao = 0;
+    for (int d = 1; d < DIMENSOES_VIZINHOS; d++) {
+        if (maior[d] - menor[d] > maior[dimensao] - menor[dimensao]) {
+            dimensao = d;
+        }
+    }
+
+    uint32_t meio = inicio + (fim - inicio) / 2;
+    selecionar(c, inicio, fim, meio, dimensao);
+    float corte = coordenada(c, meio, dimensao);
+    int32_t esquerda = construir_no(c, inicio, meio);
+    int32_t direita = construir_no(c, meio, fim);
+    no = &a->nos[indice];
+    no->dimensao = dimensao;
+    no->corte = corte;
+    no->esquerda = esquerda;
+    no->direita = direita;
+    return indice;
+}
+
+// Constrói a árvore
+int construir_arvore_vizinhos(ArvoreVizinhos *a, const Baralho *b) {
+    RASTREAR_ESCOPO("construir_arvore_vizinhos");
+    memset(a, 0, sizeof(*a));
+    size_t n = b->quantidade;
+    preparar_espaco_atributos(&a->espaco, b);
+    a->quantidade = n;
+    size_t maximo_nos = n < 1 ? 1 : 2 * (n / (FOLHA_VIZINHOS / 2) + 1);
+    float *origem = malloc((n + 1) * DIMENSOES_VIZINHOS * sizeof(float));
+    uint32_t *ordem = malloc((n + 1) * sizeof(uint32_t));
+    a->pontos = malloc((n + 1) * DIMENSOES_VIZINHOS * sizeof(float));
+    a->cartas = malloc((n + 1) * sizeof(uint32_t));
+    a->nos = malloc(maximo_nos * sizeof(NoVizinhos));
+    if (origem == NULL || ordem == NULL || a->pontos == NULL || a->cartas == NULL
+        || a->nos == NULL || n >= UINT32_MAX) {
+        free(origem);
+        free(ordem);
+        liberar_arvore_vizinhos(a);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        projetar_carta(&a->espaco, &b->cartas[i], origem + i * DIMENSOES_VIZINHOS);
+        ordem[i] = (uint32_t)i;
+    }
+    Construcao c = { a, origem, ordem };
+    construir_no(&c, 0, (uint32_t)n);
+
+    // Pontos contíguos na ordem da árvore
+    for (size_t i = 0; i < n; i++) {
+        memcpy(a->pontos + i * DIMENSOES_VIZINHOS, origem + (size_t)ordem[i] * DIMENSOES_VIZINHOS,
+               DIMENSOES_VIZINHOS * sizeof(float));
+        a->cartas[i] = ordem[i];
+    }
+    free(origem);
+    free(ordem);
+    return 0;
+}
+
+// Estado de uma busca: os melhores até agora, em ordem crescente
+typedef struct {
+    const float *consulta;
+    int k;
+    int achados;
+    uint32_t ignorar;
+    float distancias[MAXIMO_VIZINHOS];   // Ao quadrado
+    uint32_t pontos[MAXIMO_VIZINHOS];
+} Busca;
+
+// Limite atual: só entra quem estiver mais perto
+static inline float pior(const Busca *s) {
+    return s->achados < s->k ? INFINITY : s->distancias[s->k - 1];
+}
+
+// Insere o ponto na lista ordenada, se couber
+static inline void considerar(Busca *s, const ArvoreVizinhos *a, uint32_t ponto, float d) {
+    if (d >= pior(s) || a->cartas[ponto] == s->ignorar) {
+        return;
+    }
+    int i = s->achados < s->k ? s->achados++ : s->k - 1;
+    while (i > 0 && s->distancias[i - 1] > d) {
+        s->distancias[i] = s->distancias[i - 1];
+        s->pontos[i] = s->pontos[i - 1];
+        i--;
+    }
+    s->distancias[i] = d;
+    s->pontos[i] = ponto;
+}
+
+// Desce pela subárvore; 'caixa' é a distância ao quadrado da consulta à
+// célula do nó e deslocamentos[d] a parte dela na dimensão d (busca
+// incremental de Arya e Mount: a poda usa a célula, não só o último corte)
+static void buscar_no(const ArvoreVizinhos *a, int32_t indice, float caixa, float *deslocamentos,
+                      Busca *s) {
+    const NoVizinhos *no = &a->nos[indice];
+    if (no->esquerda < 0) {
+        for (uint32_t p = no->inicio; p < no->fim; p++) {
+            considerar(s, a, p, distancia2(s->consulta, a->pontos + (size_t)p * DIMENSOES_VIZINHOS));
+        }
+        return;
+    }
+    int d = no->dimensao;
+    float diferenca = s->consulta[d] - no->corte;
+    int32_t perto = diferenca < 0 ? no->esquerda : no->direita;
+    int32_t longe = diferenca < 0 ? no->direita : no->esquerda;
+    buscar_no(a, perto, caixa, deslocamentos, s);
+    float anterior = deslocamentos[d];
+    float distante = caixa - anterior * anterior + diferenca * diferenca;
+    if (distante < pior(s)) {
+        deslocamentos[d] = diferenca;
+        buscar_no(a, longe, distante, deslocamentos, s);
+        deslocamentos[d] = anterior;
+    }
+}
+
+// Copia os achados para o resultado
+static int concluir(const ArvoreVizinhos *a, const Busca *s, Vizinho *resultado) {
+    for (int i = 0; i < s->achados; i++) {
+        resultado[i].carta = a->cartas[s->pontos[i]];
+        resultado[i].distancia = sqrtf(s->distancias[i]);
+    }
+    return s->achados;
+}
+
+// Os k pontos mais próximos da consulta
+int buscar_vizinhos(const ArvoreVizinhos *a, const float *consulta, int k, uint32_t ignorar,
+                    Vizinho *resultado) {
+    Busca s;
+    s.consulta = consulta;
+    s.k = k < 1 ? 1 : k > MAXIMO_VIZINHOS ? MAXIMO_VIZINHOS : k;
+    s.achados = 0;
+    s.ignorar = ignorar;
+    float deslocamentos[DIMENSOES_VIZINHOS] = { 0 };
+    if (a->quantidade > 0) {
+        buscar_no(a, 0, 0.0f, deslocamentos, &s);
+    }
+    return concluir(a, &s, resultado);
+}
+
+// Mesmo resultado por varredura de todos os pontos
+int buscar_vizinhos_linear(const ArvoreVizinhos *a, const float *consulta, int k,
+                           uint32_t ignorar, Vizinho *resultado) {
+    Busca s;
+    s.consulta = consulta;
+    s.k = k < 1 ? 1 : k > MAXIMO_VIZINHOS ? MAXIMO_VIZINHOS : k;
+    s.achados = 0;
+    s.ignorar = ignorar;
+    for (size_t p = 0; p < a->quantidade; p++) {
+        considerar(&s, a, (uint32_t)p, distancia2(consulta, a->pontos + p * DIMENSOES_VIZINHOS));
+    }
+    return concluir(a, &s, resultado);
+}
+
+// Contexto das consultas em lote
+typedef struct {
+    const ArvoreVizinhos *a;
+    const float *consultas;
+    size_t m;
+    int k;
+    const uint32_t *ignorar;
+    Vizinho *resultados;
+    int *achados;
+} ContextoVizinhos;
+
+static void tarefa_vizinhos(void *contexto, int indice, int total) {
+    ContextoVizinhos *c = contexto;
+    size_t fim = inicio_da_parte(c->m, indice + 1, total);
+    for (size_t q = inicio_da_parte(c->m, indice, total); q < fim; q++) {
+        int n = buscar_vizinhos(c->a, c->consultas + q * DIMENSOES_VIZINHOS, c->k,
+                                c->ignorar != NULL ? c->ignorar[q] : SEM_VIZINHO,
+                                c->resultados + q * (size_t)c->k);
+        if (c->achados != NULL) {
+            c->achados[q] = n;
+        }
+    }
+}
+
+// m consultas em paralelo
+void buscar_vizinhos_lote(const ArvoreVizinhos *a, const float *consultas, size_t m, int k,
+                          const uint32_t *ignorar, Vizinho *resultados, int *achados,
+                          int threads) {
+    RASTREAR_ESCOPO("buscar_vizinhos_lote");
+    ContextoVizinhos c = { a, consultas, m, k, ignorar, resultados, achados };
+    executar_em_paralelo(numero_de_threads(threads), tarefa_vizinhos, &c);
+}
+
+// Libera a árvore
+void liberar_arvore_vizinhos(ArvoreVizinhos *a) {
+    free(a->pontos);
+    free(a->cartas);
+    free(a->nos);
+    memset(a, 0, sizeof(*a));
+}
@@ -0,0 +1,95 @@
+/*
+ * Super Trunfo - Cidades semelhantes (vizinhos mais próximos)
+ *
+ * Cada carta vira um ponto de seis dimensões, uma por atributo: população,
+ * área, PIB, densidade e PIB per capita, de cauda longa, passam por
+ * log(1 + x); pontos turísticos ficam lineares. Cada dimensão é então
+ * centrada na média e dividida pelo desvio padrão do baralho, para que
+ * nenhum atributo domine a distância (euclidiana). Valor inválido
+ * (negativo) fica na média.
+ *
+ * Os pontos ficam numa árvore k-d: cada nó divide as cartas pela mediana
+ * da dimensão de maior amplitude, até folhas de FOLHA_VIZINHOS cartas,
+ * guardadas contíguas na ordem da árvore. A busca dos k mais próximos
+ * desce primeiro pelo lado da consulta e só visita o outro lado se a
+ * célula dele (a caixa delimitada pelos cortes do caminho) estiver mais
+ * perto que o k-ésimo vizinho já achado.
+ */
+
+#ifndef SUPERTRUNFO_VIZINHOS_H
+#define SUPERTRUNFO_VIZINHOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "baralho.h"
+
+#define DIMENSOES_VIZINHOS NUM_ATRIBUTOS
+#define FOLHA_VIZINHOS 8
+#define MAXIMO_VIZINHOS 64
+
+// Nenhuma carta (consulta sem carta a ignorar)
+#define SEM_VIZINHO UINT32_MAX
+
+// Normalização dos atributos
+typedef struct {
+    double media[DIMENSOES_VIZINHOS];
+    double desvio[DIMENSOES_VIZINHOS];
+} EspacoAtributos;
+
+// Nó da árvore; folha quando esquerda < 0
+typedef struct {
+    float corte;
+    int32_t dimensao;
+    uint32_t inicio;        // Pontos [inicio, fim) da subárvore
+    uint32_t fim;
+    int32_t esquerda;
+    int32_t direita;
+} NoVizinhos;
+
+// Árvore k-d sobre as cartas de um baralho
+typedef struct {
+    EspacoAtributos espaco;
+    size_t quantidade;
+    float *pontos;          // quantidade * DIMENSOES_VIZINHOS, na ordem da árvore
+    uint32_t *cartas;       // Posição no baralho de cada ponto
+    NoVizinhos *nos;
+    size_t quantidade_nos;
+} ArvoreVizinhos;
+
+// Um vizinho encontrado
+typedef struct {
+    uint32_t carta;         // Posição no baralho
+    float distancia;
+} Vizinho;
+
+// Calcula a normalização sobre as cartas do baralho
+void preparar_espaco_atributos(EspacoAtributos *e, const Baralho *b);
+
+// Ponto normalizado da carta (DIMENSOES_VIZINHOS floats)
+void projetar_carta(const EspacoAtributos *e, const Carta *c, float *ponto);
+
+// Constrói a árvore; retorna 0 em sucesso, -1 sem memória
+int construir_arvore_vizinhos(ArvoreVizinhos *a, const Baralho *b);
+
+// Os k (até MAXIMO_VIZINHOS) pontos mais próximos da consulta, do mais
+// perto ao mais longe, sem a carta 'ignorar' (SEM_VIZINHO = nenhuma);
+// retorna quantos foram achados
+int buscar_vizinhos(const ArvoreVizinhos *a, const float *consulta, int k, uint32_t ignorar,
+                    Vizinho *resultado);
+
+// Mesmo resultado por varredura de todos os pontos (referência)
+int buscar_vizinhos_linear(const ArvoreVizinhos *a, const float *consulta, int k,
+                           uint32_t ignorar, Vizinho *resultado);
+
+// m consultas em paralelo: a consulta q é consultas[q * DIMENSOES_VIZINHOS],
+// ignora ignorar[q] (ignorar pode ser NULL) e preenche resultados[q * k];
+// achados[q] (pode ser NULL) recebe quantos vizinhos foram achados
+void buscar_vizinhos_lote(const ArvoreVizinhos *a, const float *consultas, size_t m, int k,
+                          const uint32_t *ignorar, Vizinho *resultados, int *achados,
+                          int threads);
+
+// Libera a árvore
+void liberar_arvore_vizinhos(ArvoreVizinhos *a);
+
+#endif